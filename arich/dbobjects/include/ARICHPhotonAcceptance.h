@@ -0,0 +1,107 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+#include <TObject.h>
+#include <vector>
+
+namespace Belle2 {
+  //! Tabulated geometrical acceptance of ARICH for Cherenkov photons
+  /*! Fractions of the Cherenkov photons emitted in an aerogel layer which reach the detector
+   *  plane (in total and in bins of the azimuthal Cherenkov angle) and which hit an active
+   *  channel. The fractions are given on a regular grid in the track position and direction
+   *  at the aerogel entrance and in the Cherenkov angle, and are interpolated linearly in
+   *  between. The two azimuthal variables are periodic.
+   */
+
+  class ARICHPhotonAcceptance : public TObject {
+
+  public:
+
+    //! Variables of the table
+    enum EVariable {
+      c_R = 0,              /**< track radius at the aerogel entrance */
+      c_Phi = 1,            /**< track azimuth at the aerogel entrance (periodic) */
+      c_TrackTheta = 2,     /**< polar angle of the track direction */
+      c_TrackPhi = 3,       /**< azimuth of the track direction relative to c_Phi (periodic) */
+      c_CherenkovAngle = 4, /**< Cherenkov angle */
+      c_NVariables = 5      /**< number of variables */
+    };
+
+    //! Number of bins in the azimuthal Cherenkov angle (in the track frame)
+    static const int c_NPhiBins = 20;
+
+    //! Tabulated values of a grid point
+    enum EValue {
+      c_Detected = 0,   /**< fraction of photons hitting an active channel */
+      c_Reached = 1,    /**< fraction of photons reaching the detector plane */
+      c_ReachedPhi = 2, /**< first of c_NPhiBins fractions reaching the detector plane, per azimuthal bin */
+      c_NValues = c_ReachedPhi + c_NPhiBins /**< number of values */
+    };
+
+    //! Default constructor
+    ARICHPhotonAcceptance() {};
+
+    //! Defines the default grid, all values are set to zero
+    //! @param nLayers number of aerogel layers
+    void initializeDefault(unsigned nLayers);
+
+    /**
+     * Defines the grid, all values are set to zero
+     * @param nLayers number of aerogel layers
+     * @param nPoints number of grid points for each variable (at least 2, at least 1 for the periodic ones)
+     * @param min lower edge of each variable (ignored for the periodic ones)
+     * @param max upper edge of each variable (ignored for the periodic ones)
+     */
+    void setGrid(unsigned nLayers, const std::vector<unsigned short>& nPoints,
+                 const std::vector<float>& min, const std::vector<float>& max);
+
+    /**
+     * Set values of a grid point
+     * @param layer aerogel layer
+     * @param point index of the grid point
+     * @param values array of c_NValues values
+     */
+    void setValues(unsigned layer, unsigned point, const double* values);
+
+    //! Returns number of aerogel layers
+    unsigned getNLayers() const { return m_nLayers; }
+
+    //! Returns number of grid points (per layer)
+    unsigned getNPoints() const;
+
+    //! Returns coordinates of a grid point
+    //! @param point index of the grid point
+    //! @param x array of c_NVariables coordinates
+    void getPoint(unsigned point, double* x) const;
+
+    //! Returns true if the variable is an azimuthal angle
+    static bool isPeriodic(int var) { return var == c_Phi or var == c_TrackPhi; }
+
+    /**
+     * Interpolate the values at given coordinates, out of range coordinates are moved to the edge
+     * @param layer aerogel layer
+     * @param x array of c_NVariables coordinates
+     * @param values array of c_NValues interpolated values (output)
+     * @return false if the layer is not in the table
+     */
+    bool getValues(unsigned layer, const double* x, double* values) const;
+
+  private:
+
+    unsigned m_nLayers = 0; /**< number of aerogel layers */
+    std::vector<unsigned short> m_nPoints; /**< number of grid points of each variable */
+    std::vector<float> m_min; /**< lower edge of each variable */
+    std::vector<float> m_max; /**< upper edge of each variable */
+    std::vector<float> m_values; /**< values, ordered by layer, grid point (last variable fastest) and value */
+
+    ClassDef(ARICHPhotonAcceptance, 1);  /**< ClassDef, must be the last term before the closing {}*/
+  };
+
+} // end namespace Belle2
@@ -0,0 +1,114 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <arich/dbobjects/ARICHPhotonAcceptance.h>
+#include <framework/logging/Logger.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace Belle2;
+
+
+void ARICHPhotonAcceptance::initializeDefault(unsigned nLayers)
+{
+  // radius and angles in cm and rad
+  setGrid(nLayers, {16, 36, 10, 6, 6}, {40., 0., 0., 0., 0.10}, {115., 0., 0.675, 0., 0.35});
+}
+
+void ARICHPhotonAcceptance::setGrid(unsigned nLayers, const std::vector<unsigned short>& nPoints,
+                                    const std::vector<float>& min, const std::vector<float>& max)
+{
+  if (nPoints.size() != c_NVariables or min.size() != c_NVariables or max.size() != c_NVariables) {
+    B2ERROR("ARICHPhotonAcceptance::setGrid: wrong number of variables, grid not set");
+    return;
+  }
+  for (int var = 0; var < c_NVariables; var++) {
+    if (nPoints[var] < (isPeriodic(var) ? 1 : 2)) {
+      B2ERROR("ARICHPhotonAcceptance::setGrid: too few grid points" << LogVar("variable", var));
+      return;
+    }
+  }
+  m_nLayers = nLayers;
+  m_nPoints = nPoints;
+  m_min = min;
+  m_max = max;
+  m_values.assign(m_nLayers * getNPoints() * c_NValues, 0);
+}
+
+unsigned ARICHPhotonAcceptance::getNPoints() const
+{
+  if (m_nPoints.empty()) return 0;
+  unsigned n = 1;
+  for (auto nPoints : m_nPoints) n *= nPoints;
+  return n;
+}
+
+void ARICHPhotonAcceptance::setValues(unsigned layer, unsigned point, const double* values)
+{
+  if (layer >= m_nLayers or point >= getNPoints()) {
+    B2ERROR("ARICHPhotonAcceptance::setValues: grid point out of range" << LogVar("layer", layer) << LogVar("point", point));
+    return;
+  }
+  std::copy(values, values + c_NValues, m_values.begin() + (layer * getNPoints() + point) * c_NValues);
+}
+
+void ARICHPhotonAcceptance::getPoint(unsigned point, double* x) const
+{
+  for (int var = c_NVariables - 1; var >= 0; var--) {
+    unsigned i = point % m_nPoints[var];
+    point /= m_nPoints[var];
+    if (isPeriodic(var)) x[var] = 2 * M_PI * i / m_nPoints[var];
+    else x[var] = m_min[var] + (m_max[var] - m_min[var]) * i / (m_nPoints[var] - 1);
+  }
+}
+
+bool ARICHPhotonAcceptance::getValues(unsigned layer, const double* x, double* values) const
+{
+  if (layer >= m_nLayers) return false;
+
+  // lower grid index and weight of the upper one for each variable
+  unsigned index[c_NVariables][2];
+  double weight[c_NVariables];
+  for (int var = 0; var < c_NVariables; var++) {
+    const unsigned n = m_nPoints[var];
+    if (isPeriodic(var)) {
+      double u = x[var] / (2 * M_PI) * n;
+      u -= n * std::floor(u / n);
+      const unsigned i = std::min(unsigned(u), n - 1);
+      index[var][0] = i;
+      index[var][1] = (i + 1) % n;
+      weight[var] = u - i;
+    } else {
+      double u = (x[var] - m_min[var]) / (m_max[var] - m_min[var]) * (n - 1);
+      u = std::max(0., std::min(u, double(n - 1)));
+      const unsigned i = std::min(unsigned(u), n - 2);
+      index[var][0] = i;
+      index[var][1] = i + 1;
+      weight[var] = u - i;
+    }
+  }
+
+  // sum over the corners of the cell
+  std::fill(values, values + c_NValues, 0.);
+  const float* table = m_values.data() + layer * getNPoints() * c_NValues;
+  for (unsigned corner = 0; corner < (1u << c_NVariables); corner++) {
+    double w = 1;
+    unsigned point = 0;
+    for (int var = 0; var < c_NVariables; var++) {
+      const unsigned upper = (corner >> var) & 1;
+      w *= upper ? weight[var] : 1 - weight[var];
+      point = point * m_nPoints[var] + index[var][upper];
+    }
+    if (w == 0) continue;
+    const float* v = table + point * c_NValues;
+    for (int k = 0; k < c_NValues; k++) values[k] += w * v[k];
+  }
+  return true;
+}
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""Compare the expected photon yields from the tabulated acceptance with the
+per-track integration of ARICHReconstructor on simulated tracks.
+
+1. With --create the acceptance table (ARICHPhotonAcceptance payload) is made
+   for the geometry of the run and stored in the local database.
+2. Particle gun pions and kaons are simulated once and written to a file.
+3. The file is reconstructed twice with the same random seed, with
+   useAcceptanceTable=False and True, using the MC track information from the
+   ARICHAeroHits. The expected numbers of photons of all hypotheses are
+   collected for every track.
+4. The mean and RMS of the relative differences of the expected yields are
+   printed in bins of the track polar angle, together with the number of
+   tracks whose most likely hypothesis changes. The time spent in the
+   reconstruction is shown in the module statistics.
+
+Usage:
+    $ basf2 ARICHAcceptanceTableValidation.py -- --create -n 1
+    $ basf2 ARICHAcceptanceTableValidation.py -- -n 2000
+"""
+
+import argparse
+import math
+import basf2 as b2
+from ROOT import Belle2
+from simulation import add_simulation
+
+#: hypotheses
+HYPOTHESES = [Belle2.Const.electron, Belle2.Const.muon, Belle2.Const.pion, Belle2.Const.kaon, Belle2.Const.proton]
+
+#: bin edges in the track polar angle (rad)
+THETA_BINS = [0.0, 0.3, 0.4, 0.5, 0.6, 0.7, math.pi / 2]
+
+
+class CollectYields(b2.Module):
+    """Collect the track polar angle, the expected yields and log likelihoods of all ARICH tracks"""
+
+    def __init__(self, results):
+        """Constructor, the results are appended to the given list"""
+        super().__init__()
+        #: one (theta, expected yields, log likelihoods) tuple per track
+        self.results = results
+
+    def event(self):
+        """Collect the tracks of the event"""
+        for track in Belle2.PyStoreArray('ARICHTracks'):
+            like = track.getRelated('ARICHLikelihoods')
+            if not like:
+                continue
+            self.results.append((track.getDirection().Theta(),
+                                 [like.getExpPhot(h) for h in HYPOTHESES],
+                                 [like.getLogL(h) for h in HYPOTHESES]))
+
+
+def reconstruct(filename, useTable):
+    """Reconstruct the simulated events and return the collected yields"""
+    results = []
+    b2.set_random_seed('ARICHAcceptance')
+    main = b2.create_path()
+    main.add_module('RootInput', inputFileName=filename)
+    main.add_module('Gearbox')
+    main.add_module('Geometry', components=['MagneticField', 'ARICH'])
+    main.add_module('ARICHFillHits')
+    main.add_module('ARICHReconstructor', inputTrackType=1, useAcceptanceTable=useTable).set_name(
+        'ARICHReconstructor_' + ('table' if useTable else 'perTrack'))
+    main.add_module(CollectYields(results))
+    b2.process(main)
+    print(b2.statistics)
+    return results
+
+
+def simulate(filename, nEvents, create):
+    """Simulate particle gun tracks into the ARICH acceptance, optionally tabulate the acceptance"""
+    main = b2.create_path()
+    main.add_module('EventInfoSetter', evtNumList=[nEvents])
+    main.add_module('ParticleGun', pdgCodes=[211, -211, 321, -321], nTracks=1,
+                    momentumGeneration='uniform', momentumParams=[0.5, 4.0],
+                    thetaGeneration='uniformCos', thetaParams=[15, 36], phiGeneration='uniform', phiParams=[0, 360])
+    add_simulation(main, components=['MagneticField', 'ARICH'])
+    if create:
+        main.add_module('ARICHFillHits')
+        main.add_module('ARICHReconstructor', inputTrackType=1, createAcceptanceTable=True)
+    else:
+        main.add_module('RootOutput', outputFileName=filename)
+    b2.process(main)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('-n', '--events', type=int, default=2000, help='number of events')
+    parser.add_argument('--create', action='store_true', help='tabulate the acceptance into the local database and exit')
+    parser.add_argument('--file', default='ARICHAcceptanceTableValidation.root', help='file with the simulated events')
+    args = parser.parse_args()
+
+    b2.set_log_level(b2.LogLevel.ERROR)
+    b2.conditions.prepend_testing_payloads('localdb/database.txt')
+
+    simulate(args.file, args.events, args.create)
+    if args.create:
+        b2.B2RESULT('acceptance table stored in localdb/database.txt')
+    else:
+        perTrack = reconstruct(args.file, False)
+        table = reconstruct(args.file, True)
+        assert len(perTrack) == len(table)
+
+        sums = [[0, 0., 0.] for i in range(len(THETA_BINS) - 1)]
+        changed = 0
+        for (theta, expected, logL), (theta2, expected2, logL2) in zip(perTrack, table):
+            assert abs(theta - theta2) < 1e-6, 'the two reconstructions do not see the same tracks'
+            if logL.index(max(logL)) != logL2.index(max(logL2)):
+                changed += 1
+            i = max(k for k in range(len(THETA_BINS) - 1) if theta >= THETA_BINS[k])
+            for n, n2 in zip(expected, expected2):
+                if n <= 0:
+                    continue
+                sums[i][0] += 1
+                sums[i][1] += n2 / n - 1
+                sums[i][2] += (n2 / n - 1)**2
+
+        b2.B2RESULT(f'tracks: {len(table)}, most likely hypothesis changed for {changed}')
+        for k, (n, total, squares) in enumerate(sums):
+            if n == 0:
+                continue
+            mean = total / n
+            rms = math.sqrt(max(0., squares / n - mean**2))
+            b2.B2RESULT(f'track theta {THETA_BINS[k]:.2f}-{THETA_BINS[k + 1]:.2f} rad: '
+                        f'expected yield table / per track - 1: mean {mean:.4f}, rms {rms:.4f} ({n} yields)')
@@ -14,6 +14,7 @@
 #include <arich/dbobjects/ARICHGlobalAlignment.h>
 #include <arich/dbobjects/ARICHMirrorAlignment.h>
 #include <arich/dbobjects/ARICHAeroTilesAlignment.h>
+#include <arich/dbobjects/ARICHPhotonAcceptance.h>
 #include "framework/datastore/StoreArray.h"
 #include "arich/dataobjects/ARICHHit.h"
 #include "arich/dataobjects/ARICHTrack.h"
@@ -38,7 +39,9 @@ namespace Belle2 {
    * the active area of the detection inside a HAPD
    * and the intersection point with the active area is determined.
    * Whether the photon was detected or not is determined by numerical
-   * simulation of the module's geometric acceptance.
+   * simulation of the module's geometric acceptance. If the ARICHPhotonAcceptance
+   * payload is available, the expected numbers of photons are instead interpolated
+   * from the acceptance tabulated with the same numerical simulation.
    */
   class ARICHReconstruction {
 
@@ -93,11 +96,27 @@ namespace Belle2 {
       m_alignMirrors = align;
     };
 
+    /**
+     * Use the tabulated photon acceptance (if available) or the numerical
+     * simulation of the acceptance for every track.
+     */
+    void useAcceptanceTable(bool use)
+    {
+      m_useAcceptanceTable = use;
+    };
+
     /**
      * Correct mean emission point z position.
      */
     void correctEmissionPoint(int tileID, double r);
 
+    /**
+     * Tabulates the photon acceptance for the current geometry, on the default
+     * grid of ARICHPhotonAcceptance.
+     * @param[in] nPhotons number of photons traced per emission point and grid point
+     */
+    ARICHPhotonAcceptance makeAcceptanceTable(unsigned nPhotons);
+
   private:
 
     static const int c_noOfHypotheses = Const::ChargedStable::c_SetSize; /**< Number of hypotheses to loop over */
@@ -111,6 +130,7 @@ namespace Belle2 {
     DBObjPtr<ARICHGlobalAlignment> m_alignp; /**< global alignment parameters from the DB */
     DBObjPtr<ARICHMirrorAlignment> m_mirrAlign; /**< global alignment parameters from the DB */
     OptionalDBObjPtr<ARICHAeroTilesAlignment> m_tileAlign; /**< alignment of aerogel tiles from DB */
+    OptionalDBObjPtr<ARICHPhotonAcceptance> m_acceptance; /**< tabulated photon acceptance from DB */
 
     std::vector<ROOT::Math::XYZVector > m_mirrorPoints; /**< vector of points on all mirror plates */
     std::vector<ROOT::Math::XYZVector > m_mirrorNorms;  /**< vector of normal vectors of all mirror plates */
@@ -118,6 +138,7 @@ namespace Belle2 {
     double m_trackPosRes; /**< track position resolution (from tracking) */
     double m_trackAngRes; /**< track direction resolution (from tracking) */
     bool   m_alignMirrors; /**< if set to true mirror alignment constants from DB are used*/
+    bool   m_useAcceptanceTable; /**< if set to true the tabulated photon acceptance is used if available */
 
     unsigned int m_nAerogelLayers; /**< number of aerogel layers */
     double  m_refractiveInd[c_noOfAerogels]; /**< refractive indices of aerogel layers */
@@ -129,6 +150,21 @@ namespace Belle2 {
     int m_storePhot; /**< set to 1 to store individual reconstructed photon information */
     double m_tilePars[124][2] = {{0}}; /**< array of tile parameters */
 
+    /**
+     * Traces photons emitted uniformly in azimuth at the Cherenkov angle from a point
+     * on the track to the detector plane.
+     * @param[in] epoint     Emission point.
+     * @param[in] edir       Track direction.
+     * @param[in] thetaCh    Cherenkov angle.
+     * @param[in] iAerogel   Aerogel layer of the emission point.
+     * @param[in] nPhotons   Number of photons to trace.
+     * @param[in,out] nDetected  Incremented for each photon hitting an active channel.
+     * @param[in,out] nReached   Incremented for each photon reaching the detector plane,
+     *                           in ARICHPhotonAcceptance::c_NPhiBins azimuthal bins.
+     */
+    void tracePhotons(const ROOT::Math::XYZVector& epoint, const ROOT::Math::XYZVector& edir, double thetaCh,
+                      int iAerogel, unsigned int nPhotons, double& nDetected, double* nReached);
+
     /**
      * Returns 1 if vector "a" lies on "copyno"-th detector active surface
      * of detector and 0 else.
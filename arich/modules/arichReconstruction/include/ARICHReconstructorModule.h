@@ -119,6 +119,15 @@ namespace Belle2 {
     /** Whether alignment constants for mirrors are used. */
     bool m_alignMirrors;
 
+    /** Whether the tabulated photon acceptance is used (if available). */
+    bool m_useAcceptanceTable;
+
+    /** Whether the photon acceptance is tabulated and stored in the local database. */
+    bool m_createAcceptanceTable;
+
+    /** Number of photons per emission point and grid point for the acceptance table. */
+    unsigned m_acceptanceTablePhotons;
+
   };
 
 } // Belle2 namespace
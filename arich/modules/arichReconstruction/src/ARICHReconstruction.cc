@@ -37,6 +37,7 @@ namespace Belle2 {
     m_trackPosRes(0),
     m_trackAngRes(0),
     m_alignMirrors(true),
+    m_useAcceptanceTable(true),
     m_nAerogelLayers(0),
     m_storePhot(storePhot)
   {
@@ -342,6 +343,76 @@ namespace Belle2 {
     return -1;
   }
 
+  void ARICHReconstruction::tracePhotons(const ROOT::Math::XYZVector& epoint, const ROOT::Math::XYZVector& edir,
+                                         double thetaCh, int iAerogel, unsigned int nPhotons, double& nDetected, double* nReached)
+  {
+    const int nPhiBins = ARICHPhotonAcceptance::c_NPhiBins;
+    for (unsigned int iPhoton = 0; iPhoton < nPhotons; iPhoton++) {
+      double fi = 2 * M_PI * iPhoton / float(nPhotons); // uniformly distributed in phi
+      ROOT::Math::XYZVector adirf = setThetaPhi(thetaCh, fi); // photon direction in track system
+      adirf =  TransformFromFixed(edir) * adirf;  // photon direction in global system
+      int ifi = int (fi * nPhiBins / 2. / M_PI); // phi bin
+      // track photon from emission point to the detector plane
+      ROOT::Math::XYZVector dposition = FastTracking(adirf, epoint, &m_refractiveInd[iAerogel], &m_zaero[iAerogel],
+                                                     m_nAerogelLayers - iAerogel, 1);
+      if (dposition.R() > 1.0) nReached[ifi] += 1;
+      else continue;
+      unsigned  copyno =  m_arichgp->getDetectorPlane().pointSlotID(dposition.X(), dposition.Y());
+      if (!copyno) continue;
+      // check if photon fell on photosensitive area
+      if (InsideDetector(dposition, copyno)) nDetected += 1;
+    }
+  }
+
+  ARICHPhotonAcceptance ARICHReconstruction::makeAcceptanceTable(unsigned nPhotons)
+  {
+    ARICHPhotonAcceptance table;
+    table.initializeDefault(m_nAerogelLayers);
+
+    const int nStep = 5; // number of steps in one aerogel layer, as in likelihood2
+    const double zEntrance = m_arichgp->getAerogelPlane().getAerogelZPosition();
+    double x[ARICHPhotonAcceptance::c_NVariables];
+    double values[ARICHPhotonAcceptance::c_NValues];
+
+    for (unsigned int iAerogel = 0; iAerogel < m_nAerogelLayers; iAerogel++) {
+      for (unsigned point = 0; point < table.getNPoints(); point++) {
+        table.getPoint(point, x);
+        double phi = x[ARICHPhotonAcceptance::c_Phi];
+        ROOT::Math::XYZVector position(x[ARICHPhotonAcceptance::c_R] * cos(phi), x[ARICHPhotonAcceptance::c_R] * sin(phi), zEntrance);
+        ROOT::Math::XYZVector edir = setThetaPhi(x[ARICHPhotonAcceptance::c_TrackTheta], phi + x[ARICHPhotonAcceptance::c_TrackPhi]);
+        ARICHTrack track(position, edir);
+
+        double dxx = m_thickness[iAerogel] / edir.Z() / double(nStep);
+        ROOT::Math::XYZVector exit_point = getTrackPositionAtZ(track, m_zaero[iAerogel]);
+
+        // emission points are weighted with the absorption in the layer
+        double abs = 1;
+        double sumWeights = 0;
+        double detected = 0;
+        double reached[ARICHPhotonAcceptance::c_NPhiBins] = {0.0};
+        for (int iepoint = 0; iepoint < nStep; iepoint++) {
+          ROOT::Math::XYZVector epoint = exit_point - (0.5 + iepoint) * dxx * edir;
+          abs *= exp(-dxx / m_transmissionLen[iAerogel]);
+          double nDetected = 0;
+          double nReached[ARICHPhotonAcceptance::c_NPhiBins] = {0.0};
+          tracePhotons(epoint, edir, x[ARICHPhotonAcceptance::c_CherenkovAngle], iAerogel, nPhotons, nDetected, nReached);
+          detected += abs * nDetected;
+          for (int ik = 0; ik < ARICHPhotonAcceptance::c_NPhiBins; ik++) reached[ik] += abs * nReached[ik];
+          sumWeights += abs * nPhotons;
+        }
+
+        values[ARICHPhotonAcceptance::c_Detected] = detected / sumWeights;
+        values[ARICHPhotonAcceptance::c_Reached] = 0;
+        for (int ik = 0; ik < ARICHPhotonAcceptance::c_NPhiBins; ik++) {
+          values[ARICHPhotonAcceptance::c_ReachedPhi + ik] = reached[ik] / sumWeights;
+          values[ARICHPhotonAcceptance::c_Reached] += reached[ik] / sumWeights;
+        }
+        table.setValues(iAerogel, point, values);
+      }
+    }
+    return table;
+  }
+
   int ARICHReconstruction::likelihood2(ARICHTrack& arichTrack, const StoreArray<ARICHHit>& arichHits,
                                        ARICHLikelihood& arichLikelihood)
   {
@@ -391,6 +462,18 @@ namespace Belle2 {
     float nphot_scaling = 20.; // number of photons to be traced is (expected number of emitted photons * nphot_scaling)
     int nStep = 5;             // number of steps in one aerogel layer
 
+    // with the tabulated acceptance only the yield of emitted photons is integrated here
+    const bool useTable = m_useAcceptanceTable && m_acceptance && m_acceptance->getNLayers() >= m_nAerogelLayers;
+    double acceptanceVars[ARICHPhotonAcceptance::c_NVariables] = {0.0};
+    double acceptance[ARICHPhotonAcceptance::c_NValues] = {0.0};
+    if (useTable) {
+      ROOT::Math::XYZVector entrance = getTrackPositionAtZ(arichTrack, m_arichgp->getAerogelPlane().getAerogelZPosition());
+      acceptanceVars[ARICHPhotonAcceptance::c_R] = entrance.Rho();
+      acceptanceVars[ARICHPhotonAcceptance::c_Phi] = entrance.Phi();
+      acceptanceVars[ARICHPhotonAcceptance::c_TrackTheta] = edir.Theta();
+      acceptanceVars[ARICHPhotonAcceptance::c_TrackPhi] = edir.Phi() - entrance.Phi();
+    }
+
     // loop over all particle hypotheses
     for (int iHyp = 0; iHyp < c_noOfHypotheses; iHyp++) {
 
@@ -414,6 +497,24 @@ namespace Belle2 {
         double nPhot = m_n0[iAerogel] * sin(thetaCh[iHyp][iAerogel]) * sin(thetaCh[iHyp][iAerogel]) * dxx * nphot_scaling;
         ROOT::Math::XYZVector exit_point = getTrackPositionAtZ(arichTrack, m_zaero[iAerogel]);
 
+        if (useTable) {
+          double nEmitted = 0;
+          for (int iepoint = 0; iepoint < nStep; iepoint++) {
+            abs *= exp(-dxx / m_transmissionLen[iAerogel]);
+            nEmitted += nPhot * abs;
+          }
+          nEmitted /= nphot_scaling;
+
+          acceptanceVars[ARICHPhotonAcceptance::c_CherenkovAngle] = thetaCh[iHyp][iAerogel];
+          m_acceptance->getValues(iAerogel, acceptanceVars, acceptance);
+          for (int ik = 0; ik < 20; ik++) {
+            nSig_wo_acc[iHyp][iAerogel][ik] = nEmitted * acceptance[ARICHPhotonAcceptance::c_ReachedPhi + ik];
+          }
+          nSig_w_acc[iHyp][iAerogel] = nEmitted * acceptance[ARICHPhotonAcceptance::c_Detected];
+          nSig_wo_accInt[iHyp][iAerogel] = nEmitted * acceptance[ARICHPhotonAcceptance::c_Reached];
+          continue;
+        }
+
         // loop over emmision point steps
         for (int iepoint = 0; iepoint < nStep; iepoint++) {
 
@@ -421,26 +522,13 @@ namespace Belle2 {
           abs *= exp(-dxx / m_transmissionLen[iAerogel]);
           unsigned int genPhot = nPhot * abs; // number of photons to emmit in current step, including scattering  correction
 
-          // loop over emmited "photons"
-          for (unsigned int iPhoton = 0; iPhoton < genPhot; iPhoton++) {
-            double fi = 2 * M_PI * iPhoton / float(genPhot); // uniformly distributed in phi
-            ROOT::Math::XYZVector adirf = setThetaPhi(thetaCh[iHyp][iAerogel], fi); // photon direction in track system
-            adirf =  TransformFromFixed(edir) * adirf;  // photon direction in global system
-            int ifi = int (fi * 20 / 2. / M_PI); // phi bin
-            // track photon from emission point to the detector plane
-            ROOT::Math::XYZVector dposition = FastTracking(adirf, epoint, &m_refractiveInd[iAerogel], &m_zaero[iAerogel],
-                                                           m_nAerogelLayers - iAerogel, 1);
-            if (dposition.R() > 1.0) {nSig_wo_acc[iHyp][iAerogel][ifi] += 1; nSig_wo_accInt[iHyp][iAerogel] += 1;}
-            else continue;
-            unsigned  copyno =  m_arichgp->getDetectorPlane().pointSlotID(dposition.X(), dposition.Y());
-            if (!copyno) continue;
-            // check if photon fell on photosensitive area
-            if (InsideDetector(dposition, copyno)) nSig_w_acc[iHyp][iAerogel] += 1;
-          }
+          // trace emmited "photons"
+          tracePhotons(epoint, edir, thetaCh[iHyp][iAerogel], iAerogel, genPhot, nSig_w_acc[iHyp][iAerogel], nSig_wo_acc[iHyp][iAerogel]);
         }
 
         // scale the obtained numbers
         for (int ik = 0; ik < 20; ik++) {
+          nSig_wo_accInt[iHyp][iAerogel] += nSig_wo_acc[iHyp][iAerogel][ik];
           nSig_wo_acc[iHyp][iAerogel][ik] /= nphot_scaling;
         }
         nSig_w_acc[iHyp][iAerogel] /= nphot_scaling;
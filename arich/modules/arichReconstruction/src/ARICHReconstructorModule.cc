@@ -22,6 +22,12 @@
 // framework - DataStore
 #include <framework/datastore/DataStore.h>
 #include <framework/datastore/StoreArray.h>
+#include <framework/datastore/StoreObjPtr.h>
+#include <framework/dataobjects/EventMetaData.h>
+
+// framework - Database
+#include <framework/database/DBImportObjPtr.h>
+#include <framework/database/IntervalOfValidity.h>
 
 // framework aux
 #include <framework/gearbox/Unit.h>
@@ -60,6 +66,15 @@ namespace Belle2 {
     addParam("storePhotons", m_storePhot, "Set to 1 to store reconstructed photon information (Ch. angle,...)", 0);
     addParam("useAlignment", m_align, "Use ARICH global position alignment constants", true);
     addParam("useMirrorAlignment", m_alignMirrors, "Use ARICH mirror alignment constants", true);
+    addParam("useAcceptanceTable", m_useAcceptanceTable,
+             "Use the tabulated photon acceptance (ARICHPhotonAcceptance payload) if available, "
+             "otherwise the acceptance is integrated numerically for each track. "
+             "The table does not include the per-track correction of the emission point for the aerogel tile alignment", true);
+    addParam("createAcceptanceTable", m_createAcceptanceTable,
+             "Tabulate the photon acceptance for the geometry, channel mask and alignment of the first run "
+             "and store it in the local database, valid for this run only", false);
+    addParam("acceptanceTablePhotons", m_acceptanceTablePhotons,
+             "Number of photons traced per emission point and grid point when tabulating the acceptance", 50u);
   }
 
   ARICHReconstructorModule::~ARICHReconstructorModule()
@@ -75,6 +90,7 @@ namespace Belle2 {
     m_ana->setTrackPositionResolution(m_trackPositionResolution);
     m_ana->setTrackAngleResolution(m_trackAngleResolution);
     m_ana->useMirrorAlignment(m_alignMirrors);
+    m_ana->useAcceptanceTable(m_useAcceptanceTable);
 
     // Input: ARICHDigits
     m_ARICHHits.isRequired();
@@ -110,6 +126,18 @@ namespace Belle2 {
   void ARICHReconstructorModule::beginRun()
   {
     m_ana->initialize();
+
+    if (m_createAcceptanceTable) {
+      StoreObjPtr<EventMetaData> evtMetaData;
+      B2INFO("ARICHReconstructorModule: tabulating the photon acceptance" << LogVar("experiment", evtMetaData->getExperiment())
+             << LogVar("run", evtMetaData->getRun()));
+      DBImportObjPtr<ARICHPhotonAcceptance> importObj;
+      importObj.construct(m_ana->makeAcceptanceTable(m_acceptanceTablePhotons));
+      // the table contains the channel mask and the alignment of this run
+      importObj.import(IntervalOfValidity(evtMetaData->getExperiment(), evtMetaData->getRun(),
+                                          evtMetaData->getExperiment(), evtMetaData->getRun()));
+      m_createAcceptanceTable = false;
+    }
   }
 
   void ARICHReconstructorModule::event()
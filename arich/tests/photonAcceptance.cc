@@ -0,0 +1,159 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <arich/dbobjects/ARICHPhotonAcceptance.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <functional>
+#include <random>
+
+namespace Belle2 {
+
+  /** Test fixture with a small grid: 3 radii, 4 azimuths, 3 track polar angles, 3 track azimuths, 3 Cherenkov angles */
+  class ARICHPhotonAcceptanceTest : public ::testing::Test {
+  protected:
+    /** Number of variables */
+    static const int c_NVar = ARICHPhotonAcceptance::c_NVariables;
+    /** Number of values */
+    static const int c_NVal = ARICHPhotonAcceptance::c_NValues;
+
+    /** Define the grid with two layers */
+    void SetUp() override
+    {
+      m_table.setGrid(2, {3, 4, 3, 3, 3}, {40., 0., 0., 0., 0.1}, {100., 0., 0.6, 0., 0.4});
+    }
+
+    /** Fill all grid points with f(layer, grid indices) + value index */
+    void fill(const std::function<double(unsigned, const unsigned*)>& f)
+    {
+      const std::vector<unsigned> nPoints = {3, 4, 3, 3, 3};
+      for (unsigned layer = 0; layer < m_table.getNLayers(); layer++) {
+        for (unsigned point = 0; point < m_table.getNPoints(); point++) {
+          unsigned index[c_NVar];
+          for (int var = c_NVar - 1, p = point; var >= 0; var--) {
+            index[var] = p % nPoints[var];
+            p /= nPoints[var];
+          }
+          double values[c_NVal];
+          for (int k = 0; k < c_NVal; k++) values[k] = f(layer, index) + k;
+          m_table.setValues(layer, point, values);
+        }
+      }
+    }
+
+    /** Interpolated value number 0 at x in the given layer */
+    double value(unsigned layer, const double* x) const
+    {
+      double values[c_NVal];
+      EXPECT_TRUE(m_table.getValues(layer, x, values));
+      for (int k = 1; k < c_NVal; k++) EXPECT_NEAR(values[k] - values[0], k, 1e-4);
+      return values[0];
+    }
+
+    ARICHPhotonAcceptance m_table; /**< table under test */
+  };
+
+  /** The stored values are returned at the grid points, layers out of range are rejected */
+  TEST_F(ARICHPhotonAcceptanceTest, GridPoints)
+  {
+    fill([](unsigned layer, const unsigned * i) {
+      return 1000 * layer + 81 * i[0] + 27 * i[1] + 9 * i[2] + 3 * i[3] + i[4];
+    });
+    EXPECT_EQ(m_table.getNPoints(), 324u);
+    for (unsigned layer = 0; layer < 2; layer++) {
+      for (unsigned point = 0; point < m_table.getNPoints(); point++) {
+        double x[c_NVar];
+        m_table.getPoint(point, x);
+        unsigned i[c_NVar] = {point / 108, point / 27 % 4, point / 9 % 3, point / 3 % 3, point % 3};
+        EXPECT_NEAR(value(layer, x), 1000 * layer + 81 * i[0] + 27 * i[1] + 9 * i[2] + 3 * i[3] + i[4], 1e-3)
+            << "layer " << layer << " point " << point;
+      }
+    }
+    double x[c_NVar] = {70., 0., 0.3, 0., 0.25};
+    double values[c_NVal];
+    EXPECT_FALSE(m_table.getValues(2, x, values));
+  }
+
+  /** The interpolation weights of the 32 corners: exact for functions linear in each variable */
+  TEST_F(ARICHPhotonAcceptanceTest, CornerWeights)
+  {
+    // a single grid point set to 1: the result is the product of the one dimensional weights
+    fill([](unsigned layer, const unsigned * i) {
+      return (layer == 1 and i[0] == 1 and i[1] == 2 and i[2] == 0 and i[3] == 1 and i[4] == 2) ? 1. : 0.;
+    });
+    // fractional positions 0.25 above the point in R, 0.5 below in Phi, 0.75 above in theta,
+    // exactly at the track azimuth and 0.1 below in the Cherenkov angle
+    double x[c_NVar] = {77.5, 0.75 * M_PI, 0.225, 2 * M_PI / 3, 0.385};
+    EXPECT_NEAR(value(1, x), 0.75 * 0.5 * 0.25 * 1. * 0.9, 1e-6);
+    EXPECT_NEAR(value(0, x), 0., 1e-6);
+
+    // weights add up to 1 and multilinear functions are reproduced
+    fill([](unsigned layer, const unsigned * i) {
+      const double r = i[0], t = i[2], c = i[4];
+      return 2 + layer + 3 * r - 2 * t + 0.5 * c + 1.5 * r * t * c;
+    });
+    std::mt19937 gen(46);
+    std::uniform_real_distribution<double> u(0., 1.);
+    for (int n = 0; n < 1000; n++) {
+      const double r = 2 * u(gen), t = 2 * u(gen), c = 2 * u(gen);
+      double y[c_NVar] = {40. + 30. * r, 2 * M_PI * u(gen), 0.3 * t, 2 * M_PI * u(gen), 0.1 + 0.15 * c};
+      EXPECT_NEAR(value(1, y), 3 + 3 * r - 2 * t + 0.5 * c + 1.5 * r * t * c, 1e-4);
+    }
+  }
+
+  /** The azimuthal variables wrap around between the last and the first grid point */
+  TEST_F(ARICHPhotonAcceptanceTest, PeriodicWrap)
+  {
+    fill([](unsigned, const unsigned * i) { return 10. * i[1] + i[3]; });
+    double x[c_NVar] = {70., 0., 0.3, 0., 0.25};
+    // Phi points at 0, pi/2, pi and 3 pi/2: half way between the last and the first one
+    x[ARICHPhotonAcceptance::c_Phi] = 1.75 * M_PI;
+    EXPECT_NEAR(value(0, x), 15., 1e-4);
+    x[ARICHPhotonAcceptance::c_Phi] = -0.25 * M_PI;
+    EXPECT_NEAR(value(0, x), 15., 1e-4);
+    x[ARICHPhotonAcceptance::c_Phi] = 2.25 * M_PI;
+    EXPECT_NEAR(value(0, x), 5., 1e-4);
+    x[ARICHPhotonAcceptance::c_Phi] = -4 * M_PI + 0.5 * M_PI;
+    EXPECT_NEAR(value(0, x), 10., 1e-4);
+    // track azimuth points at 0, 2 pi/3 and 4 pi/3
+    x[ARICHPhotonAcceptance::c_Phi] = 0;
+    x[ARICHPhotonAcceptance::c_TrackPhi] = 5 * M_PI / 3;
+    EXPECT_NEAR(value(0, x), 1., 1e-4);
+    x[ARICHPhotonAcceptance::c_TrackPhi] = -M_PI / 3;
+    EXPECT_NEAR(value(0, x), 1., 1e-4);
+    x[ARICHPhotonAcceptance::c_TrackPhi] = 2 * M_PI - 1e-9;
+    EXPECT_NEAR(value(0, x), 0., 1e-4);
+  }
+
+  /** Coordinates outside of the range of the non-periodic variables are moved to the edge */
+  TEST_F(ARICHPhotonAcceptanceTest, Clamping)
+  {
+    fill([](unsigned, const unsigned * i) { return 100. * i[0] + 10. * i[2] + i[4]; });
+    double x[c_NVar] = {70., 0., 0.3, 0., 0.25};
+    EXPECT_NEAR(value(0, x), 111., 1e-4);
+    x[ARICHPhotonAcceptance::c_R] = 10.;
+    EXPECT_NEAR(value(0, x), 11., 1e-4);
+    x[ARICHPhotonAcceptance::c_R] = 120.;
+    EXPECT_NEAR(value(0, x), 211., 1e-4);
+    x[ARICHPhotonAcceptance::c_TrackTheta] = -0.1;
+    EXPECT_NEAR(value(0, x), 201., 1e-4);
+    x[ARICHPhotonAcceptance::c_TrackTheta] = 1.2;
+    x[ARICHPhotonAcceptance::c_CherenkovAngle] = 0.;
+    EXPECT_NEAR(value(0, x), 220., 1e-4);
+    x[ARICHPhotonAcceptance::c_CherenkovAngle] = 1.;
+    EXPECT_NEAR(value(0, x), 222., 1e-4);
+    // exactly at the upper edge
+    x[ARICHPhotonAcceptance::c_R] = 100.;
+    x[ARICHPhotonAcceptance::c_TrackTheta] = 0.6;
+    x[ARICHPhotonAcceptance::c_CherenkovAngle] = 0.4;
+    EXPECT_NEAR(value(0, x), 222., 1e-4);
+  }
+
+}
@@ -0,0 +1,137 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <initializer_list>
+#include <string>
+#include <vector>
+#include <TNamed.h>
+
+class TCollection;
+class TDirectory;
+
+namespace Belle2 {
+  /**
+   * Mergeable table of numbers with a fixed set of columns for collecting per event (or per track, hit, ...)
+   * calibration data without the overhead of a TTree.
+   *
+   * Rows are appended with fill(). They are kept in a small row-wise buffer which is converted to a column-wise
+   * chunk and compressed with the ROOT compression algorithms once it contains getChunkSize() rows. Merging only
+   * appends the compressed chunks of the other objects so merging many collector outputs doesn't need to
+   * decompress anything. In the algorithm the data can be read back as one contiguous array per column:
+   *
+   *     auto data = getObjectPtr<ColumnarData>("hits");
+   *     std::vector<double> residuals = data->getColumn("residual");
+   *
+   * The object can be registered in a CalibrationCollectorModule like any other collector object:
+   *
+   *     registerObject<ColumnarData>("hits", new ColumnarData({"layer", "residual", "weight"}));
+   */
+  class ColumnarData : public TNamed {
+  public:
+    /// Default compression setting, algorithm * 100 + level as for TFile. LZ4 is fast to compress and decompress
+    static constexpr int c_DefaultCompression = 404;
+    /// Default number of rows per chunk
+    static constexpr unsigned int c_DefaultChunkSize = 4096;
+
+    /// Default constructor, needed for ROOT I/O
+    ColumnarData() : TNamed() {}
+
+    /**
+     * Create an empty table
+     * @param columns names of the columns
+     * @param chunkSize number of rows which are compressed together
+     * @param compression compression setting (algorithm * 100 + level), 0 keeps the chunks uncompressed
+     */
+    explicit ColumnarData(const std::vector<std::string>& columns, unsigned int chunkSize = c_DefaultChunkSize,
+                          int compression = c_DefaultCompression);
+
+    /// Append one row, values have to be given in the order of the columns
+    void fill(const double* values)
+    {
+      m_buffer.insert(m_buffer.end(), values, values + m_columns.size());
+      if (m_buffer.size() >= m_chunkSize * m_columns.size()) flush();
+    }
+
+    /// Append one row, the number of values has to match the number of columns
+    void fill(const std::vector<double>& values);
+
+    /// Append one row, the number of values has to match the number of columns
+    void fill(std::initializer_list<double> values) { fill(std::vector<double>(values)); }
+
+    /// Get the names of the columns
+    const std::vector<std::string>& getColumnNames() const { return m_columns; }
+
+    /// Get the number of columns
+    unsigned int getNColumns() const { return m_columns.size(); }
+
+    /// Get the index of a column or -1 if there is no column with this name
+    int getColumnIndex(const std::string& column) const;
+
+    /// Get the number of rows
+    unsigned long long getEntries() const;
+
+    /// Get the number of rows per chunk
+    unsigned int getChunkSize() const { return m_chunkSize; }
+
+    /// Get the number of complete (compressed) chunks
+    unsigned int getNChunks() const { return m_chunks.size(); }
+
+    /// Get the number of bytes used to store the complete chunks
+    unsigned long long getChunkBytes() const;
+
+    /// Get all values of one column
+    std::vector<double> getColumn(const std::string& column) const;
+
+    /// Get all values of one column by index
+    std::vector<double> getColumn(unsigned int column) const;
+
+    /// Get all values of several columns, every chunk is decompressed only once
+    std::vector<std::vector<double>> getColumns(const std::vector<std::string>& columns) const;
+
+    /// Compress the rows in the buffer into a new chunk even if it's not full
+    void flush();
+
+    /// Remove all rows but keep the columns
+    void clear();
+
+    /// Append the rows of other, which must have the same columns
+    void merge(const ColumnarData* other);
+
+    /// Allow merging using TFileMerger if saved directly to a file
+    Long64_t Merge(TCollection* hlist);
+
+    /// Root-like Reset function for "template compatibility" with ROOT objects. Alias for clear()
+    void Reset() { clear(); }
+
+    /// Root-like SetDirectory function for "template compatibility" with ROOT objects. Does nothing
+    void SetDirectory(TDirectory*) {}
+
+  private:
+    /// Decompress the chunk and store its values column-wise (column * rows + row) in values
+    void readChunk(unsigned int chunk, std::vector<double>& values) const;
+
+    /// Append the column values of the given columns in the buffer and all chunks to the output
+    void readColumns(const std::vector<unsigned int>& columns, std::vector<std::vector<double>>& output) const;
+
+    /// Names of the columns
+    std::vector<std::string> m_columns;
+    /// Number of rows compressed together
+    unsigned int m_chunkSize{c_DefaultChunkSize};
+    /// Compression setting for new chunks
+    int m_compression{c_DefaultCompression};
+    /// Complete chunks, column-wise and compressed unless compression didn't reduce the size
+    std::vector<std::vector<char>> m_chunks;
+    /// Number of rows in each chunk
+    std::vector<unsigned int> m_chunkEntries;
+    /// Rows not yet in a chunk, row-wise
+    std::vector<double> m_buffer;
+
+    ClassDef(ColumnarData, 1) /**< Mergeable table of numbers stored in compressed column-wise chunks */
+  };
+}
@@ -6,6 +6,7 @@
 #pragma link C++ nestedclasses;
 
 #pragma link C++ class Belle2::RunRange+; // checksum=0xb6b8592c, version=2
+#pragma link C++ class Belle2::ColumnarData+; // checksum=0xf7be1724, version=1
 #pragma link C++ class Belle2::XmlFile+; // checksum=0x1071844e, version=1
 
 #endif
@@ -0,0 +1,221 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <calibration/dataobjects/ColumnarData.h>
+#include <framework/logging/Logger.h>
+
+#include <TCollection.h>
+#include <RZip.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace Belle2;
+
+namespace {
+  /// ROOT compresses at most this many bytes in one block
+  const unsigned int c_maxBlockBytes = 0xffffff;
+}
+
+ColumnarData::ColumnarData(const vector<string>& columns, unsigned int chunkSize, int compression) :
+  TNamed(), m_columns(columns), m_compression(compression)
+{
+  // a chunk has to fit into a single compression block
+  const unsigned int maxChunkSize = c_maxBlockBytes / (sizeof(double) * max<size_t>(columns.size(), 1));
+  m_chunkSize = max(1u, min(chunkSize, maxChunkSize));
+  if (m_chunkSize != chunkSize) {
+    B2WARNING("ColumnarData: chunk size changed to fit into one compression block"
+              << LogVar("requested", chunkSize) << LogVar("used", m_chunkSize));
+  }
+  m_buffer.reserve(m_chunkSize * m_columns.size());
+}
+
+void ColumnarData::fill(const vector<double>& values)
+{
+  if (values.size() != m_columns.size()) {
+    B2ERROR("ColumnarData: number of values doesn't match the number of columns, row ignored"
+            << LogVar("name", GetName()) << LogVar("values", values.size()) << LogVar("columns", m_columns.size()));
+    return;
+  }
+  fill(values.data());
+}
+
+int ColumnarData::getColumnIndex(const string& column) const
+{
+  auto it = find(m_columns.begin(), m_columns.end(), column);
+  return (it == m_columns.end()) ? -1 : distance(m_columns.begin(), it);
+}
+
+unsigned long long ColumnarData::getEntries() const
+{
+  unsigned long long entries = m_columns.empty() ? 0 : m_buffer.size() / m_columns.size();
+  for (unsigned int chunkEntries : m_chunkEntries) entries += chunkEntries;
+  return entries;
+}
+
+unsigned long long ColumnarData::getChunkBytes() const
+{
+  unsigned long long bytes = 0;
+  for (const auto& chunk : m_chunks) bytes += chunk.size();
+  return bytes;
+}
+
+void ColumnarData::flush()
+{
+  if (m_buffer.empty() or m_columns.empty()) return;
+  const size_t nColumns = m_columns.size();
+  const size_t nRows = m_buffer.size() / nColumns;
+  // transpose to column-wise, values of one column compress much better together
+  vector<double> values(m_buffer.size());
+  for (size_t row = 0; row < nRows; ++row) {
+    for (size_t column = 0; column < nColumns; ++column) {
+      values[column * nRows + row] = m_buffer[row * nColumns + column];
+    }
+  }
+  m_buffer.clear();
+
+  int nin = values.size() * sizeof(double);
+  vector<char> chunk;
+  if (m_compression > 0) {
+    // the output has to be smaller than the input, otherwise we keep the values uncompressed
+    int nout = nin - 1, irep = 0;
+    chunk.resize(nout);
+    R__zipMultipleAlgorithm(m_compression % 100, &nin, reinterpret_cast<char*>(values.data()), &nout, chunk.data(), &irep,
+                            (ROOT::RCompressionSetting::EAlgorithm::EValues)(m_compression / 100));
+    if (irep > 0 and irep < nin) chunk.resize(irep);
+    else chunk.clear();
+  }
+  if (chunk.empty()) {
+    chunk.resize(nin);
+    memcpy(chunk.data(), values.data(), nin);
+  }
+  m_chunks.push_back(move(chunk));
+  m_chunkEntries.push_back(nRows);
+}
+
+void ColumnarData::readChunk(unsigned int chunk, vector<double>& values) const
+{
+  const vector<char>& data = m_chunks[chunk];
+  const size_t nbytes = static_cast<size_t>(m_chunkEntries[chunk]) * m_columns.size() * sizeof(double);
+  values.resize(nbytes / sizeof(double));
+  if (data.size() == nbytes) {
+    memcpy(values.data(), data.data(), nbytes);
+    return;
+  }
+  // ROOT wants unsigned char
+  auto* src = (unsigned char*) data.data();
+  auto* tgt = (unsigned char*) values.data();
+  int nzip{0}, nout{0}, irep{0};
+  if (R__unzip_header(&nzip, src, &nout) != 0 or nzip != (int)data.size() or nout != (int)nbytes) {
+    B2FATAL("ColumnarData: cannot uncompress chunk header" << LogVar("name", GetName()) << LogVar("chunk", chunk));
+  }
+  R__unzip(&nzip, src, &nout, tgt, &irep);
+  if (irep != (int)nbytes) {
+    B2FATAL("ColumnarData: cannot uncompress chunk" << LogVar("name", GetName()) << LogVar("chunk", chunk));
+  }
+}
+
+void ColumnarData::readColumns(const vector<unsigned int>& columns, vector<vector<double>>& output) const
+{
+  const unsigned long long entries = getEntries();
+  output.assign(columns.size(), {});
+  for (auto& values : output) values.reserve(entries);
+
+  vector<double> values;
+  for (unsigned int chunk = 0; chunk < m_chunks.size(); ++chunk) {
+    readChunk(chunk, values);
+    const unsigned int nRows = m_chunkEntries[chunk];
+    for (size_t i = 0; i < columns.size(); ++i) {
+      const double* first = values.data() + static_cast<size_t>(columns[i]) * nRows;
+      output[i].insert(output[i].end(), first, first + nRows);
+    }
+  }
+  // and the rows which are not yet in a chunk
+  const size_t nColumns = m_columns.size();
+  for (size_t i = 0; i < columns.size(); ++i) {
+    for (size_t index = columns[i]; index < m_buffer.size(); index += nColumns) {
+      output[i].push_back(m_buffer[index]);
+    }
+  }
+}
+
+vector<double> ColumnarData::getColumn(unsigned int column) const
+{
+  if (column >= m_columns.size()) {
+    B2ERROR("ColumnarData: column index out of range" << LogVar("name", GetName()) << LogVar("column", column));
+    return {};
+  }
+  vector<vector<double>> output;
+  readColumns({column}, output);
+  return move(output.front());
+}
+
+vector<double> ColumnarData::getColumn(const string& column) const
+{
+  const int index = getColumnIndex(column);
+  if (index < 0) {
+    B2ERROR("ColumnarData: no such column" << LogVar("name", GetName()) << LogVar("column", column));
+    return {};
+  }
+  return getColumn(index);
+}
+
+vector<vector<double>> ColumnarData::getColumns(const vector<string>& columns) const
+{
+  vector<unsigned int> indices;
+  for (const string& column : columns) {
+    const int index = getColumnIndex(column);
+    if (index < 0) {
+      B2ERROR("ColumnarData: no such column" << LogVar("name", GetName()) << LogVar("column", column));
+      return {};
+    }
+    indices.push_back(index);
+  }
+  vector<vector<double>> output;
+  readColumns(indices, output);
+  return output;
+}
+
+void ColumnarData::clear()
+{
+  m_chunks.clear();
+  m_chunkEntries.clear();
+  m_buffer.clear();
+}
+
+void ColumnarData::merge(const ColumnarData* other)
+{
+  if (other->m_columns != m_columns) {
+    B2ERROR("ColumnarData: cannot merge objects with different columns" << LogVar("name", GetName())
+            << LogVar("other", other->GetName()));
+    return;
+  }
+  // the compressed chunks can be taken as they are
+  m_chunks.insert(m_chunks.end(), other->m_chunks.begin(), other->m_chunks.end());
+  m_chunkEntries.insert(m_chunkEntries.end(), other->m_chunkEntries.begin(), other->m_chunkEntries.end());
+  // and the remaining rows are added to our buffer
+  const size_t nColumns = m_columns.size();
+  for (size_t index = 0; index + nColumns <= other->m_buffer.size(); index += nColumns) {
+    fill(other->m_buffer.data() + index);
+  }
+}
+
+Long64_t ColumnarData::Merge(TCollection* hlist)
+{
+  Long64_t nMerged = 0;
+  if (hlist) {
+    const ColumnarData* xh = 0;
+    TIter nxh(hlist);
+    while ((xh = dynamic_cast<ColumnarData*>(nxh()))) {
+      // Add xh to me
+      merge(xh);
+      ++nMerged;
+    }
+  }
+  return nMerged;
+}
@@ -13,8 +13,10 @@
 #include <vector>
 #include <map>
 #include <any>
+#include <functional>
 #include <utility>
 #include <list>
+#include <set>
 #include <nlohmann/json.hpp>
 #include <TClonesArray.h>
 #include <TDirectory.h>
@@ -183,6 +185,18 @@ namespace Belle2 {
     /// Get the granularity of collected data
     std::string getGranularity() const {return m_granularityOfData;};
 
+    /// Set the number of threads used to read and merge the collected objects in getObjectPtr(). Values below 2 read sequentially
+    void setNumberOfMergeThreads(unsigned int nThreads) {m_nMergeThreads = nThreads;}
+
+    /// Get the number of threads used to read and merge the collected objects in getObjectPtr()
+    unsigned int getNumberOfMergeThreads() const {return m_nMergeThreads;}
+
+    /// Set how many merged objects are kept between executions to be reused by getObjectPtr(), 0 disables the cache
+    void setMergedObjectCacheSize(unsigned int size) {m_mergedObjectCacheSize = size; trimMergedObjectCache();}
+
+    /// Clear the merged objects kept between executions
+    void clearMergedObjectCache() {m_mergedObjectCache.clear();}
+
     /**
      * Runs calibration over vector of runs for a given iteration. You can also specify the IoV to
      * save the database payload as. By default the Algorithm will create an IoV from your requested
@@ -357,6 +371,57 @@ namespace Belle2 {
 
   private:
 
+    /// Paths of collected objects inside the input files, grouped by file name in the order of the input files
+    typedef std::vector<std::pair<std::string, std::vector<std::string>>> ObjectFiles;
+
+    /// A merged object kept between executions together with the name and runs it was created for
+    struct MergedObject {
+      std::string name; /**< name of the object */
+      std::set<Calibration::ExpRun> runs; /**< runs which were merged into the object */
+      std::shared_ptr<TNamed> object; /**< the merged object, never handed out directly */
+    };
+
+    /** Merge the given objects from all files into one object.
+     * The files are distributed to m_nMergeThreads workers which each merge their objects
+     * into a partial result, the partial results are then merged into the final object.
+     * @param name name to give the merged object
+     * @param files objects to merge
+     * @param start if not empty the objects are merged into this object
+     */
+    template<class T>
+    std::shared_ptr<T> mergeObjects(const std::string& name, const ObjectFiles& files, std::shared_ptr<T> start);
+
+    /// Call task(iTask, iWorker) for all tasks using up to m_nMergeThreads threads. Returns the number of workers
+    size_t runMergeTasks(size_t nTasks, const std::function<void(size_t, size_t)>& task) const;
+
+    /// Return the number of workers runMergeTasks() will use for nTasks
+    size_t getNumberOfMergeWorkers(size_t nTasks) const;
+
+    /// Build the index of all collected objects with this name if not done yet and return the files containing the given runs
+    ObjectFiles getObjectFiles(const std::string& name, const std::vector<Calibration::ExpRun>& runs);
+
+    /// Return the files containing the object for granularity "all": only the object <name>_1 of each file is used
+    ObjectFiles getAllGranularityObjectFiles(const std::string& name);
+
+    /** Find the largest merged object from a previous getObjectPtr() call which contains only requested runs.
+     * @param name name of the object
+     * @param requestedRuns runs which are requested
+     * @param missingRuns will be filled with the requested runs not contained in the returned object
+     * @return the cached object which must not be modified or nullptr if there is none
+     */
+    std::shared_ptr<TNamed> getMergedObjectFromCache(const std::string& name, const std::vector<Calibration::ExpRun>& requestedRuns,
+                                                     std::vector<Calibration::ExpRun>& missingRuns);
+
+    /// Keep a merged object to be reused by later getObjectPtr() calls. The object must not be handed out to the algorithm
+    void addMergedObjectToCache(const std::string& name, const std::vector<Calibration::ExpRun>& runs,
+                                const std::shared_ptr<TNamed>& object);
+
+    /// Check whether merged objects should be kept between executions
+    bool useMergedObjectCache() const {return m_mergedObjectCacheSize > 0;}
+
+    /// Remove the least recently used merged objects until the cache has the configured size
+    void trimMergedObjectCache();
+
     static const Calibration::ExpRun m_allExpRun; /**< allExpRun */
 
     /// Gets the "exp.run" string repr. of (exp,run)
@@ -371,6 +436,20 @@ namespace Belle2 {
     /// Map of Runs to input files. Gets filled when you call getRunRangeFromAllData, gets cleared when setting input files again
     std::map<Calibration::ExpRun, std::vector<std::string>> m_runsToInputFiles;
 
+    /** Index of the collected objects: object name -> ExpRun -> (index in m_inputFileNames, key path in that file).
+     *  Built once per object name by listing the keys of all input files so that later requests don't have to
+     *  look into the files again. Gets cleared when setting input files again. */
+    std::map<std::string, std::map<Calibration::ExpRun, std::vector<std::pair<size_t, std::string>>>> m_objectIndex;
+
+    /// Merged objects kept between executions, most recently used first. Gets cleared when setting input files again
+    std::list<MergedObject> m_mergedObjectCache;
+
+    /// Maximum number of entries in m_mergedObjectCache
+    unsigned int m_mergedObjectCacheSize{8};
+
+    /// Number of threads used to read and merge the collected objects
+    unsigned int m_nMergeThreads{1};
+
     /// Granularity of input data. This only changes when the input files change so it isn't specific to an execution
     std::string m_granularityOfData;
 
@@ -406,6 +485,54 @@ namespace Belle2 {
    * Implementation of larger templates *
    *                                    *
    **************************************/
+  template<class T>
+  std::shared_ptr<T> CalibrationAlgorithm::mergeObjects(const std::string& name, const ObjectFiles& files,
+                                                        std::shared_ptr<T> start)
+  {
+    // Each worker merges all objects of the files it processes into its own partial result.
+    // Within one file we merge all objects before closing it since the objects belong to the file.
+    std::vector<std::shared_ptr<T>> partials(getNumberOfMergeWorkers(files.size()));
+    std::vector<char> failedFiles(files.size(), false);
+    runMergeTasks(files.size(), [&](size_t iFile, size_t iWorker) {
+      std::unique_ptr<TFile> f(TFile::Open(files[iFile].first.c_str(), "READ"));
+      if (!f || !f->IsOpen()) {
+        failedFiles[iFile] = true;
+        return;
+      }
+      std::shared_ptr<T>& partial = partials[iWorker];
+      TList list;
+      list.SetOwner(false);
+      for (const std::string& objectPath : files[iFile].second) {
+        T* objOther = dynamic_cast<T*>(f->Get(objectPath.c_str()));
+        if (!objOther) continue;
+        if (!partial) {
+          partial = std::shared_ptr<T>(dynamic_cast<T*>(objOther->Clone(name.c_str())));
+          partial->SetDirectory(0);
+        } else {
+          list.Add(objOther);
+        }
+      }
+      if (partial && list.GetSize() > 0)
+        partial->Merge(&list);
+    });
+    for (size_t iFile = 0; iFile < files.size(); ++iFile) {
+      if (failedFiles[iFile]) B2ERROR("Could not open input file " << files[iFile].first);
+    }
+
+    // And finally merge the partial results
+    std::shared_ptr<T> merged = start;
+    TList list;
+    list.SetOwner(false);
+    for (const std::shared_ptr<T>& partial : partials) {
+      if (!partial) continue;
+      if (!merged) merged = partial;
+      else list.Add(partial.get());
+    }
+    if (merged && list.GetSize() > 0)
+      merged->Merge(&list);
+    return merged;
+  }
+
   template<class T>
   std::shared_ptr<T> CalibrationAlgorithm::getObjectPtr(const std::string& name,
                                                         const std::vector<Calibration::ExpRun>& requestedRuns)
@@ -416,94 +543,30 @@ namespace Belle2 {
     if (objOutputPtr)
       return objOutputPtr;
 
-    std::shared_ptr<T> mergedObjPtr(nullptr);
-    bool mergedEmpty = true;
     TDirectory* dir = gDirectory;
 
-    // Technically we could grab all the objects from all files, add to list and then merge at the end.
-    // But I prefer the (maybe) more memory efficient way of merging with all objects
-    // in a file before moving on to the next one, just in case TDirectory stuff screws us.
-    TList list;
-    list.SetOwner(false);
-
-    // Construct the TDirectory names where we expect our objects to be
-    std::string runRangeObjName(getPrefix() + "/" + Calibration::RUN_RANGE_OBJ_NAME);
+    // Maybe a previous execution already merged (some of) the requested runs
+    std::vector<Calibration::ExpRun> runsToRead;
+    std::shared_ptr<T> mergedObjPtr(nullptr);
+    if (auto cachedObjPtr = std::dynamic_pointer_cast<T>(getMergedObjectFromCache(name, requestedRuns, runsToRead))) {
+      B2DEBUG(100, "Reusing merged " << name << " from a previous execution, " << runsToRead.size() << " runs missing");
+      // work on a copy, the algorithm might modify the object we return
+      mergedObjPtr = std::shared_ptr<T>(dynamic_cast<T*>(cachedObjPtr->Clone(name.c_str())));
+      mergedObjPtr->SetDirectory(0);
+    } else {
+      runsToRead = requestedRuns;
+    }
 
+    // Find the relevant files for the runs we still need
+    ObjectFiles files;
     if (strcmp(getGranularity().c_str(), "run") == 0) {
-      // Loop over our runs requested for the right files
-      for (auto expRunRequested : requestedRuns) {
-        // Find the relevant files for this ExpRun
-        auto searchFiles = m_runsToInputFiles.find(expRunRequested);
-        if (searchFiles == m_runsToInputFiles.end()) {
-          B2WARNING("No input file found with data collected from run "
-                    "(" << expRunRequested.first << "," << expRunRequested.second << ")");
-          continue;
-        } else {
-          auto files = searchFiles->second;
-          for (auto fileName : files) {
-            RunRange* runRangeData;
-            //Open TFile to get the objects
-            std::unique_ptr<TFile> f;
-            f.reset(TFile::Open(fileName.c_str(), "READ"));
-            runRangeData = dynamic_cast<RunRange*>(f->Get(runRangeObjName.c_str()));
-            // Check that nothing went wrong in the mapping and that this file definitely contains this run's data
-            auto runSet = runRangeData->getExpRunSet();
-            if (runSet.find(expRunRequested) == runSet.end()) {
-              B2WARNING("Something went wrong with the mapping of ExpRun -> Input Files. "
-                        "(" << expRunRequested.first << "," << expRunRequested.second << ") not in " << fileName);
-            }
-            // Get the path/directory of the Exp,Run TDirectory that holds the object(s)
-            std::string objDirName = getFullObjectPath(name, expRunRequested);
-            TDirectory* objDir = f->GetDirectory(objDirName.c_str());
-            if (!objDir) {
-              B2ERROR("Directory for requested object " << name << " not found: " << objDirName);
-              return nullptr;
-            }
-            // Find all the objects inside, there may be more than one
-            for (auto key : * (objDir->GetListOfKeys())) {
-              std::string keyName = key->GetName();
-              B2DEBUG(100, "Adding found object " << keyName << " in the directory " << objDir->GetPath());
-              T* objOther = (T*)objDir->Get(keyName.c_str());
-              if (objOther) {
-                if (mergedEmpty) {
-                  mergedObjPtr = std::shared_ptr<T>(dynamic_cast<T*>(objOther->Clone(name.c_str())));
-                  mergedObjPtr->SetDirectory(0);
-                  mergedEmpty = false;
-                } else {
-                  list.Add(objOther);
-                }
-              }
-            }
-            if (!mergedEmpty)
-              mergedObjPtr->Merge(&list);
-            list.Clear();
-          }
-        }
-      }
-    } else {
-      for (auto fileName : m_inputFileNames) {
-        //Open TFile to get the objects
-        std::unique_ptr<TFile> f;
-        f.reset(TFile::Open(fileName.c_str(), "READ"));
-        Calibration::ExpRun allGranExpRun = getAllGranularityExpRun();
-        std::string objDirName = getFullObjectPath(name, allGranExpRun);
-        std::string objPath = objDirName + "/" + name + "_1";
-        T* objOther = (T*)f->Get(objPath.c_str()); // Only one index for granularity == all
-        B2DEBUG(100, "Adding " << objPath);
-        if (objOther) {
-          if (mergedEmpty) {
-            mergedObjPtr = std::shared_ptr<T>(dynamic_cast<T*>(objOther->Clone(name.c_str())));
-            mergedObjPtr->SetDirectory(0);
-            mergedEmpty = false;
-          } else {
-            list.Add(objOther);
-          }
-        }
-        if (!mergedEmpty)
-          mergedObjPtr->Merge(&list);
-        list.Clear();
-      }
+      if (!runsToRead.empty())
+        files = getObjectFiles(name, runsToRead);
+    } else if (!mergedObjPtr) {
+      files = getAllGranularityObjectFiles(name);
     }
+    mergedObjPtr = mergeObjects<T>(name, files, mergedObjPtr);
+
     dir->cd();
     objOutputPtr = mergedObjPtr;
     if (!objOutputPtr) {
@@ -511,6 +574,12 @@ namespace Belle2 {
       return nullptr;
     }
     objOutputPtr->SetDirectory(0);
+    if (useMergedObjectCache()) {
+      std::shared_ptr<T> cachedObjPtr(dynamic_cast<T*>(objOutputPtr->Clone(name.c_str())));
+      cachedObjPtr->SetDirectory(0);
+      dir->cd();
+      addMergedObjectToCache(name, requestedRuns, cachedObjPtr);
+    }
     // make a TNamed version to input to the map of previous calib objects
     std::shared_ptr<TNamed> storedObjPtr = std::static_pointer_cast<TNamed>(objOutputPtr);
     m_data.setCalibObj(name, runRangeRequested, storedObjPtr);
@@ -7,11 +7,18 @@
  **************************************************************************/
 #include <set>
 #include <utility>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
 #include <filesystem>
+#include <iterator>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 #include <boost/python.hpp>
 #include <boost/python/list.hpp>
 #include <TChain.h>
+#include <TROOT.h>
 #include <calibration/CalibrationAlgorithm.h>
 #include <framework/logging/Logger.h>
 #include <framework/core/PyObjConvUtils.h>
@@ -219,6 +226,8 @@ void CalibrationAlgorithm::setInputFileNames(vector<string> inputFileNames)
   } else {
     // Reset the run -> files map as our files are likely different
     m_runsToInputFiles.clear();
+    m_objectIndex.clear();
+    m_mergedObjectCache.clear();
   }
 
   // Open TFile to check they can be accessed by ROOT
@@ -358,6 +367,149 @@ void CalibrationAlgorithm::fillRunToInputFilesMap()
   dir->cd();
 }
 
+size_t CalibrationAlgorithm::getNumberOfMergeWorkers(size_t nTasks) const
+{
+  return std::max<size_t>(1, std::min<size_t>(m_nMergeThreads, nTasks));
+}
+
+size_t CalibrationAlgorithm::runMergeTasks(size_t nTasks, const std::function<void(size_t, size_t)>& task) const
+{
+  const size_t nWorkers = getNumberOfMergeWorkers(nTasks);
+  if (nWorkers == 1) {
+    for (size_t iTask = 0; iTask < nTasks; ++iTask) task(iTask, 0);
+    return nWorkers;
+  }
+
+  // ROOT needs to know that we read files from several threads
+  ROOT::EnableThreadSafety();
+  std::atomic<size_t> nextTask{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr firstException = nullptr;
+  auto work = [&](size_t iWorker) {
+    for (size_t iTask = nextTask++; iTask < nTasks and not failed; iTask = nextTask++) {
+      try {
+        task(iTask, iWorker);
+      } catch (...) {
+        if (not failed.exchange(true)) firstException = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t iWorker = 1; iWorker < nWorkers; ++iWorker) {
+    workers.emplace_back(work, iWorker);
+  }
+  work(0);
+  for (std::thread& worker : workers) worker.join();
+  if (firstException) std::rethrow_exception(firstException);
+  return nWorkers;
+}
+
+CalibrationAlgorithm::ObjectFiles CalibrationAlgorithm::getObjectFiles(const string& name, const vector<ExpRun>& runs)
+{
+  auto indexIt = m_objectIndex.find(name);
+  if (indexIt == m_objectIndex.end()) {
+    // List the directories of this object in all files once: <prefix>/<name>/<name>_<exp>.<run>/<keys>
+    const string objectDirName = getPrefix() + "/" + name;
+    vector<vector<pair<ExpRun, string>>> pathsByFile(m_inputFileNames.size());
+    TDirectory* dir = gDirectory;
+    runMergeTasks(m_inputFileNames.size(), [&](size_t iFile, size_t) {
+      unique_ptr<TFile> f(TFile::Open(m_inputFileNames[iFile].c_str(), "READ"));
+      TDirectory* objectDir = f ? f->GetDirectory(objectDirName.c_str()) : nullptr;
+      if (!objectDir) return;
+      for (auto runKey : * (objectDir->GetListOfKeys())) {
+        const string runDirName = runKey->GetName();
+        ExpRun expRun;
+        if (runDirName.compare(0, name.size() + 1, name + "_") != 0 or
+            sscanf(runDirName.c_str() + name.size() + 1, "%d.%d", &expRun.first, &expRun.second) != 2) continue;
+        TDirectory* runDir = objectDir->GetDirectory(runDirName.c_str());
+        if (!runDir) continue;
+        for (auto key : * (runDir->GetListOfKeys())) {
+          pathsByFile[iFile].emplace_back(expRun, objectDirName + "/" + runDirName + "/" + key->GetName());
+        }
+      }
+    });
+    dir->cd();
+    auto& index = m_objectIndex[name];
+    for (size_t iFile = 0; iFile < pathsByFile.size(); ++iFile) {
+      for (auto& expRunPath : pathsByFile[iFile]) {
+        index[expRunPath.first].emplace_back(iFile, std::move(expRunPath.second));
+      }
+    }
+    indexIt = m_objectIndex.find(name);
+  }
+
+  // Collect the paths for all runs and group them by file
+  map<size_t, vector<string>> pathsByFile;
+  for (const auto& expRun : runs) {
+    auto runIt = indexIt->second.find(expRun);
+    if (runIt == indexIt->second.end()) {
+      B2WARNING("No input file found with data collected from run "
+                "(" << expRun.first << "," << expRun.second << ") for object " << name);
+      continue;
+    }
+    for (const auto& fileAndPath : runIt->second) {
+      pathsByFile[fileAndPath.first].push_back(fileAndPath.second);
+    }
+  }
+  ObjectFiles files;
+  for (auto& fileAndPaths : pathsByFile) {
+    files.emplace_back(m_inputFileNames[fileAndPaths.first], std::move(fileAndPaths.second));
+  }
+  return files;
+}
+
+CalibrationAlgorithm::ObjectFiles CalibrationAlgorithm::getAllGranularityObjectFiles(const string& name)
+{
+  // Only one index for granularity == all
+  const string keySuffix = "/" + name + "_1";
+  ObjectFiles files = getObjectFiles(name, {getAllGranularityExpRun()});
+  for (auto& fileAndPaths : files) {
+    auto& paths = fileAndPaths.second;
+    paths.erase(std::remove_if(paths.begin(), paths.end(), [&keySuffix](const string & path) {
+      return path.size() < keySuffix.size() or path.compare(path.size() - keySuffix.size(), keySuffix.size(), keySuffix) != 0;
+    }), paths.end());
+  }
+  files.erase(std::remove_if(files.begin(), files.end(), [](const auto & fileAndPaths) {
+    return fileAndPaths.second.empty();
+  }), files.end());
+  return files;
+}
+
+shared_ptr<TNamed> CalibrationAlgorithm::getMergedObjectFromCache(const string& name, const vector<ExpRun>& requestedRuns,
+    vector<ExpRun>& missingRuns)
+{
+  const set<ExpRun> requested(requestedRuns.begin(), requestedRuns.end());
+  auto best = m_mergedObjectCache.end();
+  for (auto it = m_mergedObjectCache.begin(); it != m_mergedObjectCache.end(); ++it) {
+    if (it->name != name or it->runs.size() > requested.size()) continue;
+    if (!std::includes(requested.begin(), requested.end(), it->runs.begin(), it->runs.end())) continue;
+    if (best == m_mergedObjectCache.end() or it->runs.size() > best->runs.size()) best = it;
+  }
+  missingRuns.clear();
+  if (best == m_mergedObjectCache.end()) {
+    missingRuns.assign(requested.begin(), requested.end());
+    return nullptr;
+  }
+  std::set_difference(requested.begin(), requested.end(), best->runs.begin(), best->runs.end(), std::back_inserter(missingRuns));
+  // most recently used goes to the front
+  m_mergedObjectCache.splice(m_mergedObjectCache.begin(), m_mergedObjectCache, best);
+  return best->object;
+}
+
+void CalibrationAlgorithm::addMergedObjectToCache(const string& name, const vector<ExpRun>& runs,
+                                                  const shared_ptr<TNamed>& object)
+{
+  set<ExpRun> runSet(runs.begin(), runs.end());
+  m_mergedObjectCache.remove_if([&](const MergedObject & cached) { return cached.name == name and cached.runs == runSet; });
+  m_mergedObjectCache.push_front(MergedObject{name, std::move(runSet), object});
+  trimMergedObjectCache();
+}
+
+void CalibrationAlgorithm::trimMergedObjectCache()
+{
+  while (m_mergedObjectCache.size() > m_mergedObjectCacheSize) m_mergedObjectCache.pop_back();
+}
+
 RunRange CalibrationAlgorithm::getRunRangeFromAllData() const
 {
   // Save TDirectory to change back at the end
@@ -429,54 +581,16 @@ namespace Belle2 {
     // If not we best make a new one
     shared_ptr<TChain> chain = make_shared<TChain>(name.c_str());
     chain->SetDirectory(0);
-    // Construct the TDirectory names where we expect our objects to be
-    string runRangeObjName(getPrefix() + "/" + RUN_RANGE_OBJ_NAME);
-
+    // Find the relevant files and trees from the index of collected objects
+    ObjectFiles files;
     if (strcmp(getGranularity().c_str(), "run") == 0) {
-      // Loop over our runs requested for the right files
-      for (auto expRunRequested : requestedRuns) {
-        // Find the relevant files for this ExpRun
-        auto searchFiles = m_runsToInputFiles.find(expRunRequested);
-        if (searchFiles == m_runsToInputFiles.end()) {
-          B2WARNING("No input file found with data collected from run "
-                    "(" << expRunRequested.first << "," << expRunRequested.second << ")");
-          continue;
-        } else {
-          auto files = searchFiles->second;
-          for (auto fileName : files) {
-            RunRange* runRangeData;
-            //Open TFile to get the objects
-            std::unique_ptr<TFile> f;
-            f.reset(TFile::Open(fileName.c_str(), "READ"));
-            runRangeData = dynamic_cast<RunRange*>(f->Get(runRangeObjName.c_str()));
-            // Check that nothing went wrong in the mapping and that this file definitely contains this run's data
-            auto runSet = runRangeData->getExpRunSet();
-            if (runSet.find(expRunRequested) == runSet.end()) {
-              B2WARNING("Something went wrong with the mapping of ExpRun -> Input Files. "
-                        "(" << expRunRequested.first << "," << expRunRequested.second << ") not in " << fileName);
-            }
-            // Get the path/directory of the Exp,Run TDirectory that holds the object(s)
-            std::string objDirName = getFullObjectPath(name, expRunRequested);
-            TDirectory* objDir = f->GetDirectory(objDirName.c_str());
-            if (!objDir) {
-              B2ERROR("Directory for requested object " << name << " not found: " << objDirName);
-              return nullptr;
-            }
-            // Find all the objects inside, there may be more than one
-            for (auto key : * (objDir->GetListOfKeys())) {
-              string keyName = key->GetName();
-              string objectPath = fileName + "/" + objDirName + "/" + keyName;
-              B2DEBUG(29, "Adding TTree " << objectPath);
-              chain->Add(objectPath.c_str());
-            }
-          }
-        }
-      }
+      files = getObjectFiles(name, requestedRuns);
     } else {
-      ExpRun allGranExpRun = getAllGranularityExpRun();
-      string objDirName = getFullObjectPath(name, allGranExpRun);
-      for (const auto& fileName : m_inputFileNames) {
-        string objectPath = fileName + "/" + objDirName + "/" + name + "_1";  // Only one index for this granularity
+      files = getAllGranularityObjectFiles(name);
+    }
+    for (const auto& fileAndPaths : files) {
+      for (const string& path : fileAndPaths.second) {
+        string objectPath = fileAndPaths.first + "/" + path;
         B2DEBUG(29, "Adding TTree " << objectPath);
         chain->Add(objectPath.c_str());
       }
@@ -0,0 +1,153 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <calibration/CalibrationAlgorithm.h>
+#include <calibration/Utilities.h>
+#include <calibration/dataobjects/RunRange.h>
+#include <framework/utilities/TestHelpers.h>
+
+#include <TFile.h>
+#include <TH1D.h>
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Belle2;
+using namespace Calibration;
+
+namespace {
+  /** Minimal algorithm giving access to the merging of collected objects */
+  class TestAlgorithm : public CalibrationAlgorithm {
+  public:
+    /** Use the objects of the TestCollector */
+    TestAlgorithm() : CalibrationAlgorithm("TestCollector") {}
+    using CalibrationAlgorithm::setInputFileNames;
+    using CalibrationAlgorithm::getObjectPtr;
+    using CalibrationAlgorithm::clearCalibrationData;
+  protected:
+    /** Nothing to calibrate */
+    EResult calibrate() override { return c_OK; }
+  };
+
+  /** Test fixture writing collector output files into a temporary directory */
+  class CalibrationAlgorithmTest : public ::testing::Test {
+  protected:
+    /**
+     * Write a collector output file with one histogram per run.
+     * @param fileName name of the file
+     * @param granularity granularity of the collected data, "run" or "all"
+     * @param contents bin content of the histogram for each run, stored in bin 1
+     * @param nKeys number of histograms <name>_1 ... <name>_<nKeys> in each run directory
+     */
+    void writeFile(const string& fileName, const string& granularity, const map<ExpRun, double>& contents, int nKeys = 1)
+    {
+      TDirectory* dir = gDirectory;
+      TFile file(fileName.c_str(), "RECREATE");
+      TDirectory* collectorDir = file.mkdir("TestCollector");
+      collectorDir->cd();
+      RunRange runRange;
+      runRange.setGranularity(granularity);
+      for (const auto& runAndContent : contents) runRange.add(runAndContent.first.first, runAndContent.first.second);
+      runRange.Write(RUN_RANGE_OBJ_NAME.c_str());
+      TDirectory* objectDir = collectorDir->mkdir("histogram");
+      for (const auto& runAndContent : contents) {
+        const ExpRun& expRun = runAndContent.first;
+        TDirectory* runDir = objectDir->mkdir(("histogram_" + to_string(expRun.first) + "." + to_string(expRun.second)).c_str());
+        runDir->cd();
+        for (int key = 1; key <= nKeys; ++key) {
+          TH1D histogram(("histogram_" + to_string(key)).c_str(), "", 3, 0, 3);
+          histogram.SetBinContent(1, runAndContent.second);
+          histogram.Write();
+        }
+      }
+      file.Close();
+      dir->cd();
+    }
+
+    /** Get the merged histogram for the given runs and return its content */
+    double getContent(TestAlgorithm& algorithm, const vector<ExpRun>& runs)
+    {
+      // objects of the current execution are always reused, we want to test the cache between executions
+      algorithm.clearCalibrationData();
+      auto histogram = algorithm.getObjectPtr<TH1D>("histogram", runs);
+      return histogram ? histogram->GetBinContent(1) : -1;
+    }
+
+    /** temporary directory for the files */
+    TestHelpers::TempDirCreator m_tempDir;
+  };
+
+  /** The index finds the objects of each run in all files */
+  TEST_F(CalibrationAlgorithmTest, Index)
+  {
+    writeFile("a.root", "run", {{{1, 1}, 1}, {{1, 2}, 10}});
+    writeFile("b.root", "run", {{{1, 2}, 100}, {{1, 3}, 1000}});
+    TestAlgorithm algorithm;
+    algorithm.setMergedObjectCacheSize(0);
+    algorithm.setInputFileNames(vector<string> {"a.root", "b.root"});
+    ASSERT_EQ("run", algorithm.getGranularity());
+
+    EXPECT_DOUBLE_EQ(1, getContent(algorithm, {{1, 1}}));
+    EXPECT_DOUBLE_EQ(110, getContent(algorithm, {{1, 2}}));
+    EXPECT_DOUBLE_EQ(1111, getContent(algorithm, {{1, 1}, {1, 2}, {1, 3}}));
+    // runs without data are skipped
+    EXPECT_DOUBLE_EQ(1001, getContent(algorithm, {{1, 1}, {1, 3}, {1, 4}}));
+
+    // the result must not depend on the number of threads
+    algorithm.setNumberOfMergeThreads(4);
+    EXPECT_DOUBLE_EQ(1111, getContent(algorithm, {{1, 1}, {1, 2}, {1, 3}}));
+
+    // a new set of input files needs a new index
+    writeFile("c.root", "run", {{{1, 1}, 5}});
+    algorithm.setInputFileNames(vector<string> {"c.root"});
+    EXPECT_DOUBLE_EQ(5, getContent(algorithm, {{1, 1}}));
+  }
+
+  /** Merged objects of previous executions are reused and the least recently used ones dropped */
+  TEST_F(CalibrationAlgorithmTest, MergedObjectCache)
+  {
+    writeFile("a.root", "run", {{{1, 1}, 1}, {{1, 2}, 10}, {{1, 3}, 100}});
+    TestAlgorithm algorithm;
+    algorithm.setMergedObjectCacheSize(1);
+    algorithm.setInputFileNames(vector<string> {"a.root"});
+    EXPECT_DOUBLE_EQ(11, getContent(algorithm, {{1, 1}, {1, 2}}));
+
+    // Change the file behind the algorithm's back: runs taken from the cache keep the old values
+    // and only the missing run is read
+    writeFile("a.root", "run", {{{1, 1}, 2}, {{1, 2}, 20}, {{1, 3}, 200}});
+    EXPECT_DOUBLE_EQ(211, getContent(algorithm, {{1, 1}, {1, 2}, {1, 3}}));
+    // the object returned to the algorithm is a copy, modifying it doesn't change the cache
+    algorithm.clearCalibrationData();
+    algorithm.getObjectPtr<TH1D>("histogram", {{1, 1}, {1, 2}, {1, 3}})->SetBinContent(1, -5);
+    EXPECT_DOUBLE_EQ(211, getContent(algorithm, {{1, 1}, {1, 2}, {1, 3}}));
+
+    // a request for other runs replaces the only cache entry
+    EXPECT_DOUBLE_EQ(200, getContent(algorithm, {{1, 3}}));
+    EXPECT_DOUBLE_EQ(22, getContent(algorithm, {{1, 1}, {1, 2}}));
+
+    // without the cache everything is read again
+    algorithm.setMergedObjectCacheSize(0);
+    EXPECT_DOUBLE_EQ(222, getContent(algorithm, {{1, 1}, {1, 2}, {1, 3}}));
+  }
+
+  /** For granularity "all" only the first object of each file is used, as before the index */
+  TEST_F(CalibrationAlgorithmTest, AllGranularity)
+  {
+    writeFile("a.root", "all", {{{ -1, -1}, 1}}, 2);
+    writeFile("b.root", "all", {{{ -1, -1}, 10}}, 2);
+    TestAlgorithm algorithm;
+    algorithm.setMergedObjectCacheSize(0);
+    algorithm.setInputFileNames(vector<string> {"a.root", "b.root"});
+    ASSERT_EQ("all", algorithm.getGranularity());
+    EXPECT_DOUBLE_EQ(11, getContent(algorithm, {{1, 1}}));
+  }
+}
@@ -0,0 +1,173 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <calibration/dataobjects/ColumnarData.h>
+#include <framework/utilities/TestHelpers.h>
+
+#include <TFile.h>
+#include <TList.h>
+#include <TRandom3.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Belle2;
+
+namespace {
+  /** Fill rows (i, 2 * i + offset, i % 3) for i in [first, last) */
+  void fillRows(ColumnarData& data, int first, int last, double offset = 0)
+  {
+    for (int i = first; i < last; ++i) data.fill({double(i), 2. * i + offset, double(i % 3)});
+  }
+
+  /** Get all rows of a table, sorted */
+  vector<vector<double>> getSortedRows(const ColumnarData& data)
+  {
+    const vector<vector<double>> columns = data.getColumns(data.getColumnNames());
+    vector<vector<double>> rows(data.getEntries());
+    for (size_t row = 0; row < rows.size(); ++row) {
+      for (const auto& column : columns) rows[row].push_back(column.at(row));
+    }
+    sort(rows.begin(), rows.end());
+    return rows;
+  }
+
+  /** Rows are compressed into chunks once the buffer is full or on flush() */
+  TEST(ColumnarDataTest, Flush)
+  {
+    ColumnarData data({"x", "y", "z"}, 10);
+    EXPECT_EQ(3u, data.getNColumns());
+    EXPECT_EQ(1, data.getColumnIndex("y"));
+    EXPECT_EQ(-1, data.getColumnIndex("w"));
+
+    fillRows(data, 0, 9);
+    EXPECT_EQ(9u, data.getEntries());
+    EXPECT_EQ(0u, data.getNChunks());
+    fillRows(data, 9, 10);
+    EXPECT_EQ(10u, data.getEntries());
+    EXPECT_EQ(1u, data.getNChunks());
+    fillRows(data, 10, 15);
+    EXPECT_EQ(1u, data.getNChunks());
+    data.flush();
+    EXPECT_EQ(15u, data.getEntries());
+    EXPECT_EQ(2u, data.getNChunks());
+    // nothing left to flush
+    data.flush();
+    EXPECT_EQ(2u, data.getNChunks());
+
+    // a row with the wrong number of values is ignored
+    data.fill({1., 2.});
+    EXPECT_EQ(15u, data.getEntries());
+
+    const vector<double> x = data.getColumn("x");
+    const vector<double> y = data.getColumn(1);
+    ASSERT_EQ(15u, x.size());
+    ASSERT_EQ(15u, y.size());
+    for (int i = 0; i < 15; ++i) {
+      EXPECT_EQ(i, x[i]);
+      EXPECT_EQ(2 * i, y[i]);
+    }
+
+    data.clear();
+    EXPECT_EQ(0u, data.getEntries());
+    EXPECT_EQ(0u, data.getNChunks());
+    EXPECT_EQ(3u, data.getNColumns());
+  }
+
+  /** Compressible chunks get smaller, uncompressed or incompressible chunks are stored as they are */
+  TEST(ColumnarDataTest, Compression)
+  {
+    const unsigned int rows = 1000;
+    const unsigned long long rawBytes = rows * 3 * sizeof(double);
+
+    ColumnarData compressed({"x", "y", "z"}, rows);
+    ColumnarData uncompressed({"x", "y", "z"}, rows, 0);
+    fillRows(compressed, 0, rows);
+    fillRows(uncompressed, 0, rows);
+    ASSERT_EQ(1u, compressed.getNChunks());
+    ASSERT_EQ(1u, uncompressed.getNChunks());
+    EXPECT_LT(compressed.getChunkBytes(), rawBytes);
+    EXPECT_EQ(rawBytes, uncompressed.getChunkBytes());
+    EXPECT_EQ(uncompressed.getColumns({"x", "y", "z"}), compressed.getColumns({"x", "y", "z"}));
+
+    // random numbers don't compress, the chunk is kept raw but still readable
+    ColumnarData random({"x", "y", "z"}, rows);
+    TRandom3 generator(42);
+    vector<double> values;
+    for (unsigned int i = 0; i < rows; ++i) {
+      const vector<double> row{generator.Rndm(), generator.Rndm(), generator.Rndm()};
+      random.fill(row);
+      values.push_back(row[2]);
+    }
+    ASSERT_EQ(1u, random.getNChunks());
+    EXPECT_LE(random.getChunkBytes(), rawBytes);
+    EXPECT_EQ(values, random.getColumn("z"));
+  }
+
+  /** Merging appends the chunks and the buffered rows of the other objects */
+  TEST(ColumnarDataTest, Merge)
+  {
+    ColumnarData a({"x", "y", "z"}, 10);
+    ColumnarData b({"x", "y", "z"}, 10);
+    ColumnarData c({"x", "y", "z"}, 10);
+    fillRows(a, 0, 25);
+    fillRows(b, 25, 32);
+    fillRows(c, 32, 60);
+    ColumnarData expected({"x", "y", "z"}, 10);
+    fillRows(expected, 0, 60);
+
+    TList list;
+    list.Add(&b);
+    list.Add(&c);
+    EXPECT_EQ(2, a.Merge(&list));
+    list.Clear("nodelete");
+    EXPECT_EQ(60u, a.getEntries());
+    // the chunks are taken as they are and the buffered rows are combined into new chunks
+    EXPECT_EQ(6u, a.getNChunks());
+    EXPECT_EQ(getSortedRows(expected), getSortedRows(a));
+
+    // objects with different columns are not merged
+    ColumnarData other({"x", "y"}, 10);
+    other.fill({1., 2.});
+    a.merge(&other);
+    EXPECT_EQ(60u, a.getEntries());
+  }
+
+  /** The table survives writing to and reading from a file */
+  TEST(ColumnarDataTest, WriteRead)
+  {
+    TestHelpers::TempDirCreator tempDir;
+    ColumnarData data({"x", "y", "z"}, 16);
+    fillRows(data, 0, 100, 0.5);
+    data.SetName("table");
+    {
+      TFile file("columnar.root", "RECREATE");
+      data.Write();
+      file.Close();
+    }
+
+    TFile file("columnar.root", "READ");
+    unique_ptr<ColumnarData> read(dynamic_cast<ColumnarData*>(file.Get("table")));
+    ASSERT_TRUE(read);
+    EXPECT_EQ(data.getColumnNames(), read->getColumnNames());
+    EXPECT_EQ(data.getChunkSize(), read->getChunkSize());
+    EXPECT_EQ(data.getEntries(), read->getEntries());
+    EXPECT_EQ(data.getNChunks(), read->getNChunks());
+    EXPECT_EQ(data.getChunkBytes(), read->getChunkBytes());
+    EXPECT_EQ(data.getColumns({"x", "y", "z"}), read->getColumns({"x", "y", "z"}));
+    // and it is still usable for filling
+    read->fill({100., 200.5, 1.});
+    EXPECT_EQ(101u, read->getEntries());
+    EXPECT_EQ(200.5, read->getColumn("y").back());
+  }
+}
@@ -308,6 +308,14 @@ namespace Belle2 {
         m_mapperPhiAngle = phi;
       }
 
+      /**
+       * Set switch for lookup tables of xt and sigma
+       */
+      void setLookupTables(bool torf)
+      {
+        m_lookupTables = torf;
+      }
+
 
       /**
        * Get debug flag
@@ -589,6 +597,14 @@ namespace Belle2 {
         return m_mapperPhiAngle;
       }
 
+      /**
+       * Get switch for lookup tables of xt and sigma
+       */
+      bool getLookupTables() const
+      {
+        return m_lookupTables;
+      }
+
     private:
       /** Singleton class */
       CDCGeoControlPar();
@@ -624,6 +640,7 @@ namespace Belle2 {
       double m_addFudgeFactorForSigmaForMC = 1.; /**< Additional fudge factor for space resol. for MC */
       bool m_mapperGeometry = false;  /**< B-field mapper geometry flag. */
       double m_mapperPhiAngle = 16.7; /**< B-field mapper phi-angle (deg). */
+      bool m_lookupTables = false; /**< Switch for lookup tables of xt and sigma. */
 
       std::string m_displacementFile = "displacement_v2.2.1.dat";  /**< Displacement file. */
       std::string m_alignmentFile = "alignment_v2.dat";  /**< Alignment file. */
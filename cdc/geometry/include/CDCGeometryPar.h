@@ -31,6 +31,7 @@
 
 #include <cdc/geometry/CDCGeometryParConstants.h>
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
@@ -936,6 +937,71 @@ namespace Belle2 {
        */
       double getSigma(double dist, unsigned short layer, unsigned short lr, double alpha = 0., double theta = 0.5 * M_PI) const;
 
+      /**
+       * Return the drift length at one (layer, lr, alpha, theta) point of the xt from the parametrization.
+       * @param time Drift time (ns).
+       * @param iCLayer Layer ID.
+       * @param lr Outgoing Left/Right.
+       * @param ialpha Index of the alpha point.
+       * @param itheta Index of the theta point.
+       */
+      double getDriftLengthFromParams(double time, unsigned short iCLayer, unsigned short lr, unsigned short ialpha,
+                                      unsigned short itheta) const;
+
+      /**
+       * Return the drift length at one (layer, lr, alpha, theta) point of the xt, from the lookup table if available.
+       * @param time Drift time (ns).
+       * @param iCLayer Layer ID.
+       * @param lr Outgoing Left/Right.
+       * @param ialpha Index of the alpha point.
+       * @param itheta Index of the theta point.
+       */
+      double getDriftLengthAtPoint(double time, unsigned short iCLayer, unsigned short lr, unsigned short ialpha,
+                                   unsigned short itheta) const;
+
+      /**
+       * Return the space resolution at one (layer, lr, alpha, theta) point of sigma from the parametrization, without the upper limit.
+       * @param driftL Drift length (cm).
+       * @param iCLayer Layer ID.
+       * @param lr Outgoing Left/Right.
+       * @param ialpha Index of the alpha point.
+       * @param itheta Index of the theta point.
+       */
+      double getSigmaFromParams(double driftL, unsigned short iCLayer, unsigned short lr, unsigned short ialpha,
+                                unsigned short itheta) const;
+
+      /**
+       * Return the space resolution at one (layer, lr, alpha, theta) point of sigma, from the lookup table if available,
+       * without the upper limit.
+       * @param driftL Drift length (cm).
+       * @param iCLayer Layer ID.
+       * @param lr Outgoing Left/Right.
+       * @param ialpha Index of the alpha point.
+       * @param itheta Index of the theta point.
+       */
+      double getSigmaAtPoint(double driftL, unsigned short iCLayer, unsigned short lr, unsigned short ialpha,
+                             unsigned short itheta) const;
+
+      /**
+       * Return the no. of alpha points for xt.
+       */
+      unsigned short getNumberOfAlphaPoints() const { return m_nAlphaPoints;}
+
+      /**
+       * Return the no. of theta points for xt.
+       */
+      unsigned short getNumberOfThetaPoints() const { return m_nThetaPoints;}
+
+      /**
+       * Return the no. of alpha points for sigma.
+       */
+      unsigned short getNumberOfAlphaPoints4Sgm() const { return m_nAlphaPoints4Sgm;}
+
+      /**
+       * Return the no. of theta points for sigma.
+       */
+      unsigned short getNumberOfThetaPoints4Sgm() const { return m_nThetaPoints4Sgm;}
+
       /**
        * Return the fuge factor for space resol.
        * @param target target sigma: =0: for sigma in data reconstruction; =1: for sigma in MC recon.; =2: for sigma in digitization in MC
@@ -1081,6 +1147,60 @@ namespace Belle2 {
       ushort getMaxNumberOfCellsPerLayer() const { return m_maxNCellsPerLayer;}
 
     private:
+      /** Number of equidistant samples per (layer, lr, alpha, theta) point in the xt and sigma lookup tables. */
+      static constexpr unsigned c_nLookupTableSamples = 256;
+
+      /**
+       * Function of one variable sampled in equidistant steps, for one (layer, lr, alpha, theta) point.
+       * Between the samples the function is interpolated linearly.
+       */
+      struct LookupTable {
+        float min = 0.;        /*!< Lower edge of the sampled range. */
+        float invStep = 0.;    /*!< Inverse of the distance between two samples. */
+        bool valid = false;    /*!< The table agrees with the parametrization within the tolerance. */
+        std::array<float, c_nLookupTableSamples> values{}; /*!< Sampled values. */
+
+        /**
+         * Interpolate the function at x.
+         * @return false, if the table is not valid or x is outside the sampled range.
+         */
+        bool get(double x, double& value) const
+        {
+          const double u = (x - min) * invStep;
+          if (!valid || !(u >= 0.) || u >= c_nLookupTableSamples - 1) return false;
+          const unsigned i = static_cast<unsigned>(u);
+          value = values[i] + (u - i) * (values[i + 1] - values[i]);
+          return true;
+        }
+      };
+
+      /**
+       * Index of a (layer, lr, alpha, theta) point in m_xtTables and m_sigmaTables.
+       */
+      static unsigned getLookupTableIndex(unsigned short iCLayer, unsigned short lr, unsigned short ialpha, unsigned short itheta)
+      {
+        return ((iCLayer * 2 + lr) * c_maxNAlphaPoints + ialpha) * c_maxNThetaPoints + itheta;
+      }
+
+      /**
+       * Build the xt lookup tables from m_XT and validate them against the parametrization.
+       * Points, for which the linear interpolation deviates by more than the tolerance, keep using the parametrization.
+       */
+      void setXtLookupTables();
+
+      /**
+       * Build the sigma lookup tables from m_Sigma and validate them against the parametrization.
+       * Points, for which the linear interpolation deviates by more than the tolerance, keep using the parametrization.
+       */
+      void setSigmaLookupTables();
+
+      /**
+       * Return the drift length interpolated linearly between the four closest (alpha, theta) points.
+       * The closest points and weights are the output of getClosestAlphaPoints() and getClosestThetaPoints().
+       */
+      double interpolateDriftLength(double time, unsigned short iCLayer, const unsigned short ilr[2], const unsigned short ial[2],
+                                    double wal, const unsigned short ith[2], double wth) const;
+
       /** Singleton class */
       CDCGeometryPar(const CDCGeometry* = nullptr);
       /** Singleton class */
@@ -1168,6 +1288,8 @@ namespace Belle2 {
 
       float m_XT[c_maxNSenseLayers][2][c_maxNAlphaPoints][c_maxNThetaPoints][c_nXTParams];  /*!< XT-relation coefficients for each layer, Left/Right, entrance angle and polar angle.  */
       float m_Sigma[c_maxNSenseLayers][2][c_maxNAlphaPoints][c_maxNThetaPoints][c_nSigmaParams];      /*!< position resulution for each layer. */
+      std::vector<LookupTable> m_xtTables;     /*!< xt lookup tables (drift length vs. time) for each layer, Left/Right, alpha and theta point; empty if switched off. */
+      std::vector<LookupTable> m_sigmaTables;  /*!< sigma lookup tables (resolution vs. drift length) for each layer, Left/Right, alpha and theta point; empty if switched off. */
       float m_propSpeedInv[c_maxNSenseLayers];  /*!< Inverse of propagation speed of the sense wire. */
       float m_t0[c_maxNSenseLayers][c_maxNDriftCells] = {};  /*!< t0 for each sense-wire (in nsec). */
       float m_timeWalkCoef[c_nBoards][2];  /*!< coefficients for time walk. */
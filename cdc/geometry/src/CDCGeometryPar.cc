@@ -18,6 +18,7 @@
 
 //#include <float.h>
 
+#include <algorithm>
 #include <cmath>
 #include <boost/format.hpp>
 //#include <iostream>
@@ -948,6 +949,7 @@ void CDCGeometryPar::newReadXT(const GearDir& gbxParams, const int mode)
     m_thetaPoints[i] *= degrad;
   }
 
+  setXtLookupTables();
 }
 
 
@@ -1069,6 +1071,8 @@ void CDCGeometryPar::newReadSigma(const GearDir& gbxParams, const int mode)
   }
 
   //  std::cout << "end of newreadsigma " << std::endl;
+
+  setSigmaLookupTables();
 }
 
 
@@ -1517,6 +1521,7 @@ void CDCGeometryPar::setXtRel()
     }
   }
 
+  setXtLookupTables();
 }
 
 
@@ -1560,6 +1565,7 @@ void CDCGeometryPar::setSResol()
     }
   }
 
+  setSigmaLookupTables();
 }
 
 
@@ -2153,6 +2159,8 @@ double CDCGeometryPar::getDriftV(const double time, const unsigned short iCLayer
     //use xt reversed at (x=0,t=tmin) for delta<0 ("negative drifttime")
     double timep = delta < 0. ? minTime - delta : time;
 
+    //    std::cout << "iCLayer,alpha,theta,lro= " << iCLayer <<" "<< (180./M_PI)*alpha <<" "<< (180./M_PI)*theta <<" "<< lro << std::endl;
+
     //compute linear interpolation (=weithed average over 4 points) in (alpha-theta) space
     for (unsigned k = 0; k < 4; ++k) {
       if (k == 0) {
@@ -2233,56 +2241,12 @@ double CDCGeometryPar::getDriftLength0(const double time, const unsigned short i
     unsigned short ith[2] = {0};
     getClosestThetaPoints(alpha, theta, wth, ith);
 
-    unsigned short jal(0), jlr(0), jth(0);
-    double w = 0.;
-
     //use xt reversed at (x=0,t=tmin) for delta<0 ("negative drifttime")
     double timep = time;
     //    std::cout << "iCLayer,alpha,theta,lro= " << iCLayer <<" "<< (180./M_PI)*alpha <<" "<< (180./M_PI)*theta <<" "<< lro << std::endl;
 
     //compute linear interpolation (=weithed average over 4 points) in (alpha-theta) space
-    for (unsigned k = 0; k < 4; ++k) {
-      if (k == 0) {
-        jal = ial[0];
-        jlr = ilr[0];
-        jth = ith[0];
-        w = (1. - wal) * (1. - wth);
-      } else if (k == 1) {
-        jal = ial[0];
-        jlr = ilr[0];
-        jth = ith[1];
-        w = (1. - wal) * wth;
-      } else if (k == 2) {
-        jal = ial[1];
-        jlr = ilr[1];
-        jth = ith[0];
-        w = wal * (1. - wth);
-      } else if (k == 3) {
-        jal = ial[1];
-        jlr = ilr[1];
-        jth = ith[1];
-        w = wal * wth;
-      }
-
-      double boundary = m_XT[iCLayer][jlr][jal][jth][6];
-
-      if (timep < boundary) {
-        if (m_xtParamMode == 1) {
-          dist += w * ROOT::Math::Chebyshev5(timep, m_XT[iCLayer][jlr][jal][jth][0], m_XT[iCLayer][jlr][jal][jth][1],
-                                             m_XT[iCLayer][jlr][jal][jth][2], m_XT[iCLayer][jlr][jal][jth][3], m_XT[iCLayer][jlr][jal][jth][4], m_XT[iCLayer][jlr][jal][jth][5]);
-        } else {
-          dist += w * (m_XT[iCLayer][jlr][jal][jth][0] + timep
-                       * (m_XT[iCLayer][jlr][jal][jth][1] + timep
-                          * (m_XT[iCLayer][jlr][jal][jth][2] + timep
-                             * (m_XT[iCLayer][jlr][jal][jth][3] + timep
-                                * (m_XT[iCLayer][jlr][jal][jth][4] + timep
-                                   * (m_XT[iCLayer][jlr][jal][jth][5]))))));
-        }
-      } else {
-        dist += w * (m_XT[iCLayer][jlr][jal][jth][7] * (timep - boundary) + m_XT[iCLayer][jlr][jal][jth][8]);
-      }
-      //      std::cout <<"k,w,dist= " << k <<" "<< w <<" "<< dist << std::endl;
-    } //end of weighted mean loop
+    dist = interpolateDriftLength(timep, iCLayer, ilr, ial, wal, ith, wth);
   }
 
   //  dist = fabs(dist);
@@ -2321,70 +2285,13 @@ double CDCGeometryPar::getDriftLength(const double time, const unsigned short iC
     unsigned short ith[2] = {0};
     getClosestThetaPoints(alpha, theta, wth, ith);
 
-    unsigned short jal(0), jlr(0), jth(0);
-    double w = 0.;
-
     //use xt reversed at (x=0,t=tmin) for delta<0 ("negative drifttime")
     double timep = delta < 0. ? minTime - delta : time;
 
     //    std::cout << "iCLayer,alpha,theta,lro= " << iCLayer <<" "<< (180./M_PI)*alpha <<" "<< (180./M_PI)*theta <<" "<< lro << std::endl;
 
     //compute linear interpolation (=weithed average over 4 points) in (alpha-theta) space
-    for (unsigned k = 0; k < 4; ++k) {
-      if (k == 0) {
-        jal = ial[0];
-        jlr = ilr[0];
-        jth = ith[0];
-        w = (1. - wal) * (1. - wth);
-      } else if (k == 1) {
-        jal = ial[0];
-        jlr = ilr[0];
-        jth = ith[1];
-        w = (1. - wal) * wth;
-      } else if (k == 2) {
-        jal = ial[1];
-        jlr = ilr[1];
-        jth = ith[0];
-        w = wal * (1. - wth);
-      } else if (k == 3) {
-        jal = ial[1];
-        jlr = ilr[1];
-        jth = ith[1];
-        w = wal * wth;
-      }
-
-      //      std::cout << "k,w= " << k <<" "<< w << std::endl;
-      //      std::cout << "ial[0],[1],jal,wal= " << ial[0] <<" "<< ial[1] <<" "<< jal <<" "<< wal << std::endl;
-      //      std::cout << "ith[0],[1],jth,wth= " << ith[0] <<" "<< ith[1] <<" "<< jth <<" "<< wth << std::endl;
-
-      /*
-      std::cout <<"iCLayer= " << iCLayer << std::endl;
-      std::cout <<"lr= " << lr << std::endl;
-      std::cout <<"jal,jth= " << jal <<" "<< jth << std::endl;
-      std::cout <<"wal,wth= " << wal <<" "<< wth << std::endl;
-      for (int i=0; i<9; ++i) {
-      std::cout <<"a= "<< i <<" "<< m_XT[iCLayer][lro][jal][jth][i] << std::endl;
-      }
-      */
-      double boundary = m_XT[iCLayer][jlr][jal][jth][6];
-
-      if (timep < boundary) {
-        if (m_xtParamMode == 1) {
-          dist += w * ROOT::Math::Chebyshev5(timep, m_XT[iCLayer][jlr][jal][jth][0], m_XT[iCLayer][jlr][jal][jth][1],
-                                             m_XT[iCLayer][jlr][jal][jth][2], m_XT[iCLayer][jlr][jal][jth][3], m_XT[iCLayer][jlr][jal][jth][4], m_XT[iCLayer][jlr][jal][jth][5]);
-        } else {
-          dist += w * (m_XT[iCLayer][jlr][jal][jth][0] + timep
-                       * (m_XT[iCLayer][jlr][jal][jth][1] + timep
-                          * (m_XT[iCLayer][jlr][jal][jth][2] + timep
-                             * (m_XT[iCLayer][jlr][jal][jth][3] + timep
-                                * (m_XT[iCLayer][jlr][jal][jth][4] + timep
-                                   * (m_XT[iCLayer][jlr][jal][jth][5]))))));
-        }
-      } else {
-        dist += w * (m_XT[iCLayer][jlr][jal][jth][7] * (timep - boundary) + m_XT[iCLayer][jlr][jal][jth][8]);
-      }
-      //      std::cout <<"k,w,dist= " << k <<" "<< w <<" "<< dist << std::endl;
-    } //end of weighted mean loop
+    dist = interpolateDriftLength(timep, iCLayer, ilr, ial, wal, ith, wth);
   }
 
   dist = fabs(dist);
@@ -2613,16 +2520,26 @@ double CDCGeometryPar::getDriftTime(const double dist, const unsigned short iCLa
   double minTime = getMinDriftTime(iCLayer, lr, alpha, theta);
   double t0 = minTime;
   //  std::cout << "minTime,x= " << t0 <<" "<< getDriftLength(t0, iCLayer, lr, alpha, theta) << std::endl;
-  const bool calMinTime = false;
   //  double d0 = getDriftLength(t0, iCLayer, lr, alpha, theta, calMinTime, minTime) - dist;
   double d0 = - dist;
 
+  //the closest (alpha,theta) points are the same for all trials, so determine them only once
+  unsigned short lro = getOutgoingLR(lr, alpha);
+  double wal(0.);
+  unsigned short ial[2] = {0};
+  unsigned short ilr[2] = {lro, lro};
+  getClosestAlphaPoints(alpha, wal, ial, ilr);
+  double wth(0.);
+  unsigned short ith[2] = {0};
+  getClosestThetaPoints(alpha, theta, wth, ith);
+
   unsigned i = 0;
   double t1 = maxTime;
   double time = dist * m_nominalDriftVInv;
   while (((t1 - t0) > eps) && (i < maxTrials)) {
     time = 0.5 * (t0 + t1);
-    double d1 = getDriftLength(time, iCLayer, lr, alpha, theta, calMinTime, minTime) - dist;
+    //same as getDriftLength(time, iCLayer, lr, alpha, theta, false, minTime), as time >= minTime
+    double d1 = fabs(interpolateDriftLength(time, iCLayer, ilr, ial, wal, ith, wth)) - dist;
     //    std::cout <<"i,dist,t0,t1,d0,d1= " << i <<" "<< dist <<" "<< t0 <<" "<< t1 <<" "<< d0 <<" "<< d1 << std::endl;
     if (d0 * d1 > 0.) {
       t0 = time;
@@ -2707,52 +2624,214 @@ double CDCGeometryPar::getSigma(const double DriftL0, const unsigned short iCLay
       std::cout <<"a= "<< i <<" "<< m_XT[iCLayer][lro][jal][jth][i] << std::endl;
       }
       */
-      const double& P0 = m_Sigma[iCLayer][jlr][jal][jth][0];
-      const double& P1 = m_Sigma[iCLayer][jlr][jal][jth][1];
-      const double& P2 = m_Sigma[iCLayer][jlr][jal][jth][2];
-      const double& P3 = m_Sigma[iCLayer][jlr][jal][jth][3];
-      const double& P4 = m_Sigma[iCLayer][jlr][jal][jth][4];
-      const double& P5 = m_Sigma[iCLayer][jlr][jal][jth][5];
-      const double& P6 = m_Sigma[iCLayer][jlr][jal][jth][6];
+      sigma += w * getSigmaAtPoint(driftL, iCLayer, jlr, jal, jth);
+    } //end of for loop
+  }
+
+  sigma = std::min(sigma, m_maxSpaceResol);
+  return sigma;
+}
+
+double CDCGeometryPar::getDriftLengthFromParams(const double time, const unsigned short iCLayer, const unsigned short lr,
+                                                const unsigned short ialpha, const unsigned short itheta) const
+{
+  const float* xt = m_XT[iCLayer][lr][ialpha][itheta];
+  const double boundary = xt[6];
+
+  if (time < boundary) {
+    if (m_xtParamMode == 1) {
+      return ROOT::Math::Chebyshev5(time, xt[0], xt[1], xt[2], xt[3], xt[4], xt[5]);
+    } else {
+      return xt[0] + time * (xt[1] + time * (xt[2] + time * (xt[3] + time * (xt[4] + time * xt[5]))));
+    }
+  } else {
+    return xt[7] * (time - boundary) + xt[8];
+  }
+}
+
+double CDCGeometryPar::getDriftLengthAtPoint(const double time, const unsigned short iCLayer, const unsigned short lr,
+                                             const unsigned short ialpha, const unsigned short itheta) const
+{
+  double dist = 0.;
+  if (m_xtTables.empty() || !m_xtTables[getLookupTableIndex(iCLayer, lr, ialpha, itheta)].get(time, dist)) {
+    dist = getDriftLengthFromParams(time, iCLayer, lr, ialpha, itheta);
+  }
+  return dist;
+}
+
+double CDCGeometryPar::getSigmaAtPoint(const double driftL, const unsigned short iCLayer, const unsigned short lr,
+                                       const unsigned short ialpha, const unsigned short itheta) const
+{
+  double sigma = 0.;
+  if (m_sigmaTables.empty() || !m_sigmaTables[getLookupTableIndex(iCLayer, lr, ialpha, itheta)].get(driftL, sigma)) {
+    sigma = getSigmaFromParams(driftL, iCLayer, lr, ialpha, itheta);
+  }
+  return sigma;
+}
+
+double CDCGeometryPar::interpolateDriftLength(const double time, const unsigned short iCLayer, const unsigned short ilr[2],
+                                              const unsigned short ial[2], const double wal,
+                                              const unsigned short ith[2], const double wth) const
+{
+  return (1. - wal) * ((1. - wth) * getDriftLengthAtPoint(time, iCLayer, ilr[0], ial[0], ith[0]) +
+                       wth * getDriftLengthAtPoint(time, iCLayer, ilr[0], ial[0], ith[1])) +
+         wal * ((1. - wth) * getDriftLengthAtPoint(time, iCLayer, ilr[1], ial[1], ith[0]) +
+                wth * getDriftLengthAtPoint(time, iCLayer, ilr[1], ial[1], ith[1]));
+}
+
+double CDCGeometryPar::getSigmaFromParams(const double driftL, const unsigned short iCLayer, const unsigned short lr,
+                                          const unsigned short ialpha, const unsigned short itheta) const
+{
+  const double& P0 = m_Sigma[iCLayer][lr][ialpha][itheta][0];
+  const double& P1 = m_Sigma[iCLayer][lr][ialpha][itheta][1];
+  const double& P2 = m_Sigma[iCLayer][lr][ialpha][itheta][2];
+  const double& P3 = m_Sigma[iCLayer][lr][ialpha][itheta][3];
+  const double& P4 = m_Sigma[iCLayer][lr][ialpha][itheta][4];
+  const double& P5 = m_Sigma[iCLayer][lr][ialpha][itheta][5];
+  const double& P6 = m_Sigma[iCLayer][lr][ialpha][itheta][6];
 
 #if defined(CDC_DEBUG)
-      cout << "driftL= " << driftL << endl;
-      cout << "iCLayer= " << iCLayer << " " << jlr << " " << jal << " " << jth << endl;
-      cout << "P0= " << P0 << endl;
-      cout << "P1= " << P1 << endl;
-      cout << "P2= " << P2 << endl;
-      cout << "P3= " << P3 << endl;
-      cout << "P4= " << P4 << endl;
-      cout << "P5= " << P5 << endl;
-      cout << "P6= " << P6 << endl;
+  cout << "driftL= " << driftL << endl;
+  cout << "iCLayer= " << iCLayer << " " << lr << " " << ialpha << " " << itheta << endl;
+  cout << "P0= " << P0 << endl;
+  cout << "P1= " << P1 << endl;
+  cout << "P2= " << P2 << endl;
+  cout << "P3= " << P3 << endl;
+  cout << "P4= " << P4 << endl;
+  cout << "P5= " << P5 << endl;
+  cout << "P6= " << P6 << endl;
 #endif
-      const double P7 = m_sigmaParamMode == 0 ? DBL_MAX : m_Sigma[iCLayer][jlr][jal][jth][7];
+  const double P7 = m_sigmaParamMode == 0 ? DBL_MAX : m_Sigma[iCLayer][lr][ialpha][itheta][7];
 
-      if (driftL < P7) {
-        sigma += w * sqrt(P0 / (driftL * driftL + P1) + P2 * driftL + P3 +
-                          P4 * exp(P5 * (driftL - P6) * (driftL - P6)));
-      } else {
-        double forthTermAtP7 = P4 * exp(P5 * (P7 - P6) * (P7 - P6));
-        const double& P8 = m_Sigma[iCLayer][jlr][jal][jth][8];
-        if (m_sigmaParamMode == 1) {
-          double sigmaAtP7 = sqrt(P0 / (P7 * P7 + P1) + P2 * P7 + P3 + forthTermAtP7);
-          sigma += w * (P8 * (driftL - P7) + sigmaAtP7);
-        } else if (m_sigmaParamMode == 2) {
-          double onePls4AtP7 = sqrt(P0 / (P7 * P7 + P1) + forthTermAtP7);
-          const double onePls4 = P8 * (driftL - P7) + onePls4AtP7;
-          sigma += w * sqrt(P2 * driftL + P3 + onePls4 * onePls4);
-        } else if (m_sigmaParamMode == 3) {
-          forthTermAtP7 = sqrt(forthTermAtP7);
-          const double forthTerm = P8 * (driftL - P7) + forthTermAtP7;
-          sigma += w * sqrt(P0 / (driftL * driftL + P1) + P2 * driftL + P3 +
-                            forthTerm * forthTerm);
-        } //end of mode
-      } // end of driftL
-    } //end of for loop
+  double sigma = 0.;
+  if (driftL < P7) {
+    sigma = sqrt(P0 / (driftL * driftL + P1) + P2 * driftL + P3 +
+                 P4 * exp(P5 * (driftL - P6) * (driftL - P6)));
+  } else {
+    double forthTermAtP7 = P4 * exp(P5 * (P7 - P6) * (P7 - P6));
+    const double& P8 = m_Sigma[iCLayer][lr][ialpha][itheta][8];
+    if (m_sigmaParamMode == 1) {
+      double sigmaAtP7 = sqrt(P0 / (P7 * P7 + P1) + P2 * P7 + P3 + forthTermAtP7);
+      sigma = P8 * (driftL - P7) + sigmaAtP7;
+    } else if (m_sigmaParamMode == 2) {
+      double onePls4AtP7 = sqrt(P0 / (P7 * P7 + P1) + forthTermAtP7);
+      const double onePls4 = P8 * (driftL - P7) + onePls4AtP7;
+      sigma = sqrt(P2 * driftL + P3 + onePls4 * onePls4);
+    } else if (m_sigmaParamMode == 3) {
+      forthTermAtP7 = sqrt(forthTermAtP7);
+      const double forthTerm = P8 * (driftL - P7) + forthTermAtP7;
+      sigma = sqrt(P0 / (driftL * driftL + P1) + P2 * driftL + P3 +
+                   forthTerm * forthTerm);
+    } //end of mode
+  } // end of driftL
+  return sigma;
+}
+
+// Build xt lookup tables
+void CDCGeometryPar::setXtLookupTables()
+{
+  m_xtTables.clear();
+  if (!CDCGeoControlPar::getInstance().getLookupTables()) return;
+
+  //the table starts below the min. drift time and ends at the boundary, above which the xt is linear anyway
+  const double minTime = -20.; //(ns)
+  //max. deviation between table and parametrization accepted; checked in the middle of the samples (worst case)
+  const double tolerance = 1.e-4; //(cm)
+
+  m_xtTables.resize(c_maxNSenseLayers * 2 * c_maxNAlphaPoints * c_maxNThetaPoints);
+  unsigned nValid = 0, nTotal = 0;
+  double maxDeviation = 0.;
+
+  for (unsigned short iCL = m_firstLayerOffset; iCL < c_maxNSenseLayers; ++iCL) {
+    for (unsigned short iLR = 0; iLR < 2; ++iLR) {
+      for (unsigned short iA = 0; iA < m_nAlphaPoints; ++iA) {
+        for (unsigned short iT = 0; iT < m_nThetaPoints; ++iT) {
+          ++nTotal;
+          LookupTable& table = m_xtTables[getLookupTableIndex(iCL, iLR, iA, iT)];
+          const double maxTime = m_XT[iCL][iLR][iA][iT][6];
+          if (!(maxTime > minTime)) continue;
+
+          const double step = (maxTime - minTime) / (c_nLookupTableSamples - 1);
+          table.min = minTime;
+          table.invStep = 1. / step;
+          for (unsigned i = 0; i < c_nLookupTableSamples; ++i) {
+            table.values[i] = getDriftLengthFromParams(minTime + i * step, iCL, iLR, iA, iT);
+          }
+
+          double deviation = 0.;
+          table.valid = true;
+          for (unsigned i = 0; i + 1 < c_nLookupTableSamples; ++i) {
+            const double time = minTime + (i + 0.5) * step;
+            double dist = 0.;
+            table.get(time, dist);
+            deviation = std::max(deviation, fabs(dist - getDriftLengthFromParams(time, iCL, iLR, iA, iT)));
+          }
+          //n.b. std::max ignores a nan deviation, so check the values explicitly
+          table.valid = std::all_of(table.values.begin(), table.values.end(), [](float value) { return std::isfinite(value); })
+                        && deviation < tolerance;
+          if (table.valid) {
+            ++nValid;
+            maxDeviation = std::max(maxDeviation, deviation);
+          }
+        }
+      }
+    }
   }
 
-  sigma = std::min(sigma, m_maxSpaceResol);
-  return sigma;
+  B2DEBUG(29, "CDCGeometryPar: xt lookup tables used for " << nValid << " of " << nTotal << " points; max. deviation (cm)= " <<
+          maxDeviation);
+}
+
+// Build sigma lookup tables
+void CDCGeometryPar::setSigmaLookupTables()
+{
+  m_sigmaTables.clear();
+  if (!CDCGeoControlPar::getInstance().getLookupTables()) return;
+
+  //range of drift lengths covered by the table
+  const double maxDriftL = 1.5; //(cm)
+  //max. deviation between table and parametrization accepted; checked in the middle of the samples (worst case)
+  const double tolerance = 1.e-4; //(cm)
+
+  m_sigmaTables.resize(c_maxNSenseLayers * 2 * c_maxNAlphaPoints * c_maxNThetaPoints);
+  unsigned nValid = 0, nTotal = 0;
+  double maxDeviation = 0.;
+
+  const double step = maxDriftL / (c_nLookupTableSamples - 1);
+  for (unsigned short iCL = m_firstLayerOffset; iCL < c_maxNSenseLayers; ++iCL) {
+    for (unsigned short iLR = 0; iLR < 2; ++iLR) {
+      for (unsigned short iA = 0; iA < m_nAlphaPoints4Sgm; ++iA) {
+        for (unsigned short iT = 0; iT < m_nThetaPoints4Sgm; ++iT) {
+          ++nTotal;
+          LookupTable& table = m_sigmaTables[getLookupTableIndex(iCL, iLR, iA, iT)];
+          table.min = 0.;
+          table.invStep = 1. / step;
+          for (unsigned i = 0; i < c_nLookupTableSamples; ++i) {
+            table.values[i] = getSigmaFromParams(i * step, iCL, iLR, iA, iT);
+          }
+
+          double deviation = 0.;
+          table.valid = true;
+          for (unsigned i = 0; i + 1 < c_nLookupTableSamples; ++i) {
+            const double driftL = (i + 0.5) * step;
+            double sigma = 0.;
+            table.get(driftL, sigma);
+            deviation = std::max(deviation, fabs(sigma - getSigmaFromParams(driftL, iCL, iLR, iA, iT)));
+          }
+          //n.b. std::max ignores a nan deviation, so check the values explicitly
+          table.valid = std::all_of(table.values.begin(), table.values.end(), [](float value) { return std::isfinite(value); })
+                        && deviation < tolerance;
+          if (table.valid) {
+            ++nValid;
+            maxDeviation = std::max(maxDeviation, deviation);
+          }
+        }
+      }
+    }
+  }
+
+  B2DEBUG(29, "CDCGeometryPar: sigma lookup tables used for " << nValid << " of " << nTotal << " points; max. deviation (cm)= " <<
+          maxDeviation);
 }
 
 unsigned short CDCGeometryPar::getOldLeftRight(const B2Vector3D& posOnWire, const B2Vector3D& posOnTrack,
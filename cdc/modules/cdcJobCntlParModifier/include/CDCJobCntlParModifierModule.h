@@ -50,6 +50,7 @@ namespace Belle2 {
     double m_addFudgeFactorForSigmaForMC;   /**< Additional fudge factor for space resol. for MC. */
     bool   m_mapperGeometry;  /**< Mapper geometry flag. */
     double m_mapperPhiAngle;  /**< Mapper phi-angle(deg). */
+    bool   m_lookupTables;  /**< Switch for lookup tables of xt and sigma. */
 
     //For Geometry
     bool m_debug4Geo;              /*!< Switch for debug printing. */
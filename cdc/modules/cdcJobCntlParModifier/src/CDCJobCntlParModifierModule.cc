@@ -18,7 +18,7 @@ REG_MODULE(CDCJobCntlParModifier);
 CDCJobCntlParModifierModule::CDCJobCntlParModifierModule() : Module(), m_scp(CDCSimControlPar::getInstance()),
   m_gcp(CDCGeoControlPar::getInstance()), m_timeWalk(), m_wireSag(), m_modLeftRightFlag(), m_debug4Sim(), m_thresholdEnergyDeposit(),
   m_minTrackLength(), m_addFudgeFactorForSigmaForData(), m_addFudgeFactorForSigmaForMC(),
-  m_mapperGeometry(), m_mapperPhiAngle(), m_debug4Geo(), m_printMaterialTable(),
+  m_mapperGeometry(), m_mapperPhiAngle(), m_lookupTables(), m_debug4Geo(), m_printMaterialTable(),
   m_materialDefinitionMode(), m_senseWireZposMode(),
   m_displacement(),
   m_alignment(),
@@ -150,6 +150,12 @@ CDCJobCntlParModifierModule::CDCJobCntlParModifierModule() : Module(), m_scp(CDC
   addParam("MapperPhiAngle", m_mapperPhiAngle, "Phi-angle (deg.) of B-field mapper used in GCR in 2017 summer. Tentative option.",
            double(16.7));
 
+  //lookup tables for xt and sigma
+  addParam("LookupTables", m_lookupTables,
+           "Evaluate xt and sigma from lookup tables built from the parametrizations (true) or evaluate the parametrizations directly (false). "
+           "The tables take about 29 MB per process (2 x 56 x 2 x 18 x 7 tables of 256 floats).",
+           bool(false));
+
 }
 
 void CDCJobCntlParModifierModule::initialize()
@@ -357,6 +363,11 @@ void CDCJobCntlParModifierModule::initialize()
     B2INFO("CDCJobCntlParModifier: mapper phi-angle modified: " << m_gcp.getMapperPhiAngle() << " to " << m_mapperPhiAngle);
     m_gcp.setMapperPhiAngle(m_mapperPhiAngle);
   }
+
+  if (m_gcp.getLookupTables() != m_lookupTables) {
+    B2INFO("CDCJobCntlParModifier: lookup tables for xt and sigma modified: " << m_gcp.getLookupTables() << " to " << m_lookupTables);
+    m_gcp.setLookupTables(m_lookupTables);
+  }
 }
 
 void CDCJobCntlParModifierModule::event()
@@ -0,0 +1,140 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <cdc/geometry/CDCGeometryPar.h>
+#include <cdc/geometry/CDCGeoControlPar.h>
+#include <cdc/dbobjects/CDCGeometry.h>
+
+#include <framework/database/Database.h>
+#include <framework/database/DBObjPtr.h>
+#include <framework/database/DBStore.h>
+#include <framework/datastore/DataStore.h>
+#include <framework/datastore/StoreObjPtr.h>
+#include <framework/dataobjects/EventMetaData.h>
+#include <framework/logging/Logger.h>
+#include <framework/utilities/TestHelpers.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace Belle2 {
+  namespace CDC {
+
+    /** Test fixture setting up CDCGeometryPar with the xt and sigma parameters from the database. */
+    class CDCGeometryParLookupTablesTest : public TestHelpers::TestWithGearbox {
+    public:
+      /** Open the database for experiment 0 and create CDCGeometryPar with the lookup tables switched on. */
+      static void SetUpTestCase()
+      {
+        TestWithGearbox::SetUpTestCase();
+        DataStore::Instance().reset();
+        StoreObjPtr<EventMetaData> evtPtr;
+        DataStore::Instance().setInitializeActive(true);
+        evtPtr.registerInDataStore();
+        DataStore::Instance().setInitializeActive(false);
+        evtPtr.construct(1, 0, 0);
+
+        Database::reset();
+        DBStore::Instance().update();
+
+        DBObjPtr<CDCGeometry> cdcGeometry;
+        ASSERT_TRUE(cdcGeometry.isValid());
+        CDCGeoControlPar::getInstance().setLookupTables(true);
+        CDCGeometryPar::Instance(&(*cdcGeometry));
+      }
+
+      /** Close the database and restore the default. */
+      static void TearDownTestCase()
+      {
+        CDCGeoControlPar::getInstance().setLookupTables(false);
+        Database::reset();
+        DataStore::Instance().reset();
+        TestWithGearbox::TearDownTestCase();
+      }
+    };
+
+    /**
+     * The drift length from the xt lookup tables agrees with the parametrization for every layer,
+     * left/right, alpha and theta point over the full range of drift times.
+     */
+    TEST_F(CDCGeometryParLookupTablesTest, DriftLength)
+    {
+      const CDCGeometryPar& cdcgp = CDCGeometryPar::Instance();
+      // the tables are validated to 1 um in the middle of each interval, allow for the curvature elsewhere
+      const double tolerance = 2.e-4; // cm
+
+      double maxDeviation = 0.;
+      unsigned nDifferent = 0;
+      for (unsigned short iCL = cdcgp.getOffsetOfFirstLayer(); iCL < c_maxNSenseLayers; ++iCL) {
+        for (unsigned short lr = 0; lr < 2; ++lr) {
+          for (unsigned short ialpha = 0; ialpha < cdcgp.getNumberOfAlphaPoints(); ++ialpha) {
+            for (unsigned short itheta = 0; itheta < cdcgp.getNumberOfThetaPoints(); ++itheta) {
+              double deviation = 0.;
+              // beyond the table range (-20 ns up to the xt boundary) the parametrization is used directly
+              for (double time = -30.; time < 1000.; time += 0.37) {
+                const double table = cdcgp.getDriftLengthAtPoint(time, iCL, lr, ialpha, itheta);
+                const double params = cdcgp.getDriftLengthFromParams(time, iCL, lr, ialpha, itheta);
+                if (!std::isfinite(params)) continue;
+                ASSERT_TRUE(std::isfinite(table)) << "layer " << iCL << " lr " << lr << " alpha " << ialpha << " theta " << itheta
+                                                  << " time " << time;
+                deviation = max(deviation, fabs(table - params));
+              }
+              EXPECT_LT(deviation, tolerance) << "layer " << iCL << " lr " << lr << " alpha " << ialpha << " theta " << itheta;
+              maxDeviation = max(maxDeviation, deviation);
+              if (deviation > 0.) ++nDifferent;
+            }
+          }
+        }
+      }
+      B2INFO("xt lookup tables: max. deviation (cm) " << maxDeviation << ", points using the tables " << nDifferent);
+      // make sure the tables are actually in use
+      EXPECT_GT(nDifferent, 0u);
+    }
+
+    /**
+     * The space resolution from the sigma lookup tables agrees with the parametrization for every layer,
+     * left/right, alpha and theta point over the full range of drift lengths.
+     */
+    TEST_F(CDCGeometryParLookupTablesTest, Sigma)
+    {
+      const CDCGeometryPar& cdcgp = CDCGeometryPar::Instance();
+      const double tolerance = 2.e-4; // cm
+
+      double maxDeviation = 0.;
+      unsigned nDifferent = 0;
+      for (unsigned short iCL = cdcgp.getOffsetOfFirstLayer(); iCL < c_maxNSenseLayers; ++iCL) {
+        for (unsigned short lr = 0; lr < 2; ++lr) {
+          for (unsigned short ialpha = 0; ialpha < cdcgp.getNumberOfAlphaPoints4Sgm(); ++ialpha) {
+            for (unsigned short itheta = 0; itheta < cdcgp.getNumberOfThetaPoints4Sgm(); ++itheta) {
+              double deviation = 0.;
+              // the tables cover drift lengths up to 1.5 cm
+              for (double driftL = 0.; driftL < 1.6; driftL += 0.00037) {
+                const double table = cdcgp.getSigmaAtPoint(driftL, iCL, lr, ialpha, itheta);
+                const double params = cdcgp.getSigmaFromParams(driftL, iCL, lr, ialpha, itheta);
+                if (!std::isfinite(params)) continue;
+                ASSERT_TRUE(std::isfinite(table)) << "layer " << iCL << " lr " << lr << " alpha " << ialpha << " theta " << itheta
+                                                  << " drift length " << driftL;
+                deviation = max(deviation, fabs(table - params));
+              }
+              EXPECT_LT(deviation, tolerance) << "layer " << iCL << " lr " << lr << " alpha " << ialpha << " theta " << itheta;
+              maxDeviation = max(maxDeviation, deviation);
+              if (deviation > 0.) ++nDifferent;
+            }
+          }
+        }
+      }
+      B2INFO("sigma lookup tables: max. deviation (cm) " << maxDeviation << ", points using the tables " << nDifferent);
+      EXPECT_GT(nDifferent, 0u);
+    }
+
+  }
+}
@@ -9,7 +9,7 @@
 #pragma once
 
 /* ECL headers. */
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 /* Basf2 headers. */
 #include <calibration/CalibrationAlgorithm.h>
@@ -106,7 +106,7 @@ namespace Belle2 {
       /** Name of the payload to be stored. options: ECLCrystalEnergy5x5, ECLExpee5x5E, ECLeedPhiData, ECLeedPhiMC, or None */
       std::string m_payloadName = "ECLCrystalEnergy5x5";
       bool m_storeConst = true; /**< write payload to localdb if true */
-      ECL::ECLNeighbours* m_eclNeighbours5x5{nullptr}; /**< Neighbours, used to get nCrys per ring*/
+      const ECL::ECLNeighbourMap* m_eclNeighbours5x5{nullptr}; /**< Neighbours, used to get nCrys per ring*/
       double m_fracLo = 0.2; /**< start dPhi fit where data is > fraclo*peak */
       double m_fracHiSym = 0.2; /**< end dPhi fit where data is > fracHiSym*peak */
       double m_fracHiASym = 0.4; /**< or fracHiASym*peak, at low values of thetaID */
@@ -146,7 +146,7 @@ CalibrationAlgorithm::EResult eclee5x5Algorithm::calibrate()
 
   /**-----------------------------------------------------------------------------------------------*/
   /** need crystal per ring for the dPhi payloads */
-  m_eclNeighbours5x5 = new ECL::ECLNeighbours("N", 2);
+  m_eclNeighbours5x5 = &ECL::ECLNeighbourMap::get("N", 2);
 
 
   /**-----------------------------------------------------------------------------------------------*/
@@ -333,7 +333,6 @@ CalibrationAlgorithm::EResult eclee5x5Algorithm::calibrate()
 
     //..Now copy these to each crystal to generate the payload and fill the output histogram.
     //  We will use ECLNeighours to get the number of crystals in each theta ring
-    m_eclNeighbours5x5 = new ECL::ECLNeighbours("N", 2);
     std::vector<float> tempCalib;
     std::vector<float> tempCalibWidth;
     tempCalib.resize(ECLElementNumbers::c_NCrystals);
@@ -0,0 +1,279 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+/* C++ headers. */
+#include <vector>
+
+namespace Belle2 {
+
+  /**
+   * Struct to keep upper triangle of the covariance matrix. Since the
+   * matrix is already inverted we do not need extra precision, so
+   * keep matrix elements in float type to save space.
+   * sigma is the average noise.
+   */
+  struct CovariancePacked {
+
+    /** Packed matrix. */
+    float m_covMatPacked[31 * (31 + 1) / 2] = {};
+
+    /** Sigma noise. */
+    float sigma{ -1};
+
+    /** Lvalue access by index. */
+    float& operator[](int i) { return m_covMatPacked[i];}
+
+    /** Rvalue access by index. */
+    const float& operator[](int i) const { return m_covMatPacked[i];}
+  };
+
+  /**
+   * Interpolation of signal shape using function values and
+   * the first derivative.
+   */
+  struct SignalInterpolation2 {
+
+    /**
+     * Signal function is sampled in c_nt time steps with c_ndt substeps
+     * and c_ntail steps. c_dt is the time step.
+     */
+    constexpr static int c_nt = 12;
+
+    /** Number of substeps. */
+    constexpr static int c_ndt = 5;
+
+    /** Number of tail steps. */
+    constexpr static int c_ntail = 20;
+
+    /** Time step. */
+    constexpr static double c_dt = 0.5;
+
+    /** Inverted time step */
+    constexpr static double c_idt = 1 / c_dt;
+
+    /** Time substep. */
+    constexpr static double c_dtn = c_dt / c_ndt;
+
+    /** Inverted time substep. */
+    constexpr static double c_idtn = c_ndt / c_dt;
+
+    /** Function values. */
+    double m_FunctionInterpolation[c_nt * c_ndt + c_ntail];
+
+    /** Derivative values. */
+    double m_DerivativeInterpolation[c_nt * c_ndt + c_ntail];
+
+    /**
+     * Assuming exponential drop of the signal function far away from 0,
+     * extrapolate it to +inf.
+     * f(i_last + i) = f(i_last)*m_r0^i
+     * f'(i_last + i) = f'(i_last)*m_r1^i
+     * where i_last is the last point within sampled values in
+     * m_FunctionInterpolation (m_DerivativeInterpolation).
+     */
+    double m_r0;
+
+    /** See above/ */
+    double m_r1;
+
+    /**
+     * Default constructor.
+     */
+    SignalInterpolation2() {};
+
+    /**
+     * Constructor with parameters with the parameter layout as
+     * in ECLDigitWaveformParameters.
+     */
+    explicit SignalInterpolation2(const std::vector<double>&);
+
+    /**
+     * Returns signal shape and derivatives in 31 equidistant time points
+     * starting from t0.
+     * @param[in]  t0          Time.
+     * @param[out] function    Function values.
+     * @param[out] derivatives Derivatives.
+     */
+    void getShape(double t0, double* function, double* derivatives) const;
+
+  };
+
+  namespace ECL {
+
+    /**
+     * Parameters of an offline waveform fit. The background photon
+     * parameters are only set by the fit with a background photon.
+     */
+    struct OfflineFitResult {
+
+      /** Pedestal. */
+      double pedestal{0};
+
+      /** Photon amplitude. */
+      double amplitudePhoton{0};
+
+      /** Signal time. */
+      double signalTime{0};
+
+      /** Hadron (or diode) amplitude. */
+      double amplitudeHadron{0};
+
+      /** Background-photon amplitude. */
+      double amplitudeBackgroundPhoton{0};
+
+      /** Background-photon time. */
+      double timeBackgroundPhoton{0};
+
+      /** Chi-squared. */
+      double chi2{ -1};
+
+      /** Number of iterations. */
+      int iterations{0};
+
+    };
+
+    /**
+     * Least-squares fit of the 31 samples of an ECL waveform with a
+     * pedestal and a photon and hadron (or diode) template sharing one
+     * signal time, optionally with an additional background photon.
+     *
+     * The model is linear in the pedestal and the amplitudes, so a
+     * bounded Levenberg-Marquardt minimization with the analytic Jacobian
+     * converges in a few iterations. The starting values and the parameter
+     * limits are the same as used for the TMinuit fits of ECLWaveformFit and
+     * the iteration stops once the expected chi2 decrease is below the
+     * MIGRAD convergence criterion.
+     *
+     * This is an experimental alternative to the TMinuit fits: it has not
+     * been compared with them on recorded waveforms yet, which can be done
+     * with ecl/examples/EclWaveformFitComparison.py.
+     *
+     * The only state is the inverse covariance matrix, so one fitter per
+     * thread can be used to fit waveforms concurrently.
+     */
+    class OfflineWaveformFitter {
+
+    public:
+
+      /** Number of fit points. */
+      static constexpr int c_NFitPoints = 31;
+
+      /** Number of fit points padded for vectorization. */
+      static constexpr int c_NFitPointsVector = 32;
+
+      /** Maximal number of iterations. */
+      static constexpr int c_MaxIterations = 100;
+
+      /** Expected chi2 decrease below which the fit has converged. */
+      static constexpr double c_Tolerance = 1e-4;
+
+      /** Noise (ADC counts) of the default diagonal covariance matrix. */
+      static constexpr double c_DefaultNoise = 7.5;
+
+      /**
+       * Constructor, the inverse covariance matrix is diagonal with the
+       * default noise as used by ECLWaveformFit without crystal-dependent
+       * covariance matrices.
+       */
+      OfflineWaveformFitter();
+
+      /**
+       * Set the inverse covariance matrix.
+       * @param[in] packed Packed inverse covariance matrix.
+       */
+      void setInverseCovariance(const CovariancePacked& packed);
+
+      /**
+       * Calculate chi2 for given parameters.
+       * @param[in] adc        Waveform (31 samples).
+       * @param[in] photon     Photon template.
+       * @param[in] hadron     Hadron or diode template.
+       * @param[in] parameters Parameters, pedestal, photon amplitude, time
+       *                       and hadron amplitude, optionally followed by
+       *                       background-photon amplitude and time.
+       * @param[in] nParameters Number of parameters (4 or 6).
+       */
+      double getChi2(const double* adc, const SignalInterpolation2& photon,
+                     const SignalInterpolation2& hadron,
+                     const double* parameters, int nParameters) const;
+
+      /**
+       * Fit with photon and hadron (or diode) templates.
+       * @param[in]  adc    Waveform (31 samples).
+       * @param[in]  photon Photon template.
+       * @param[in]  hadron Hadron or diode template.
+       * @param[out] result Fit result.
+       */
+      void fitPhotonHadron(const double* adc, const SignalInterpolation2& photon,
+                           const SignalInterpolation2& hadron,
+                           OfflineFitResult& result) const;
+
+      /**
+       * Fit with photon, hadron, and background photon.
+       * @param[in]  adc    Waveform (31 samples).
+       * @param[in]  photon Photon template, also used for the background photon.
+       * @param[in]  hadron Hadron template.
+       * @param[out] result Fit result.
+       */
+      void fitPhotonHadronBackgroundPhoton(
+        const double* adc, const SignalInterpolation2& photon,
+        const SignalInterpolation2& hadron, OfflineFitResult& result) const;
+
+    private:
+
+      /**
+       * Multiply vector by the inverse covariance matrix.
+       * @param[out] y Result vector.
+       * @param[in]  x Vector, the padding element has to be 0.
+       */
+      void multiplyInverseCovariance(double* y, const double* x) const;
+
+      /**
+       * Calculate chi2 and, if requested, half of its negative gradient
+       * and the Gauss-Newton approximation of half of its Hessian.
+       * @tparam     N          Number of parameters (4 or 6).
+       * @param[in]  adc        Waveform.
+       * @param[in]  photon     Photon template.
+       * @param[in]  hadron     Hadron or diode template.
+       * @param[in]  parameters Parameters.
+       * @param[out] gradient   Gradient, may be nullptr.
+       * @param[out] hessian    Hessian, only filled if gradient is given.
+       */
+      template<int N>
+      double evaluate(const double* adc, const SignalInterpolation2& photon,
+                      const SignalInterpolation2& hadron, const double* parameters,
+                      double* gradient, double (*hessian)[N]) const;
+
+      /**
+       * Minimize chi2 within the given limits.
+       * @tparam        N          Number of parameters (4 or 6).
+       * @param[in]     adc        Waveform.
+       * @param[in]     photon     Photon template.
+       * @param[in]     hadron     Hadron or diode template.
+       * @param[in,out] parameters Starting values and result.
+       * @param[in]     lower      Lower limits.
+       * @param[in]     upper      Upper limits.
+       * @param[out]    iterations Number of iterations.
+       * @return Minimal chi2.
+       */
+      template<int N>
+      double minimize(const double* adc, const SignalInterpolation2& photon,
+                      const SignalInterpolation2& hadron, double* parameters,
+                      const double* lower, const double* upper,
+                      int& iterations) const;
+
+      /** Inverse covariance matrix, rows are padded with 0. */
+      alignas(32) double m_InverseCovariance[c_NFitPoints][c_NFitPointsVector];
+
+    };
+
+  }
+
+}
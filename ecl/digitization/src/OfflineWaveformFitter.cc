@@ -0,0 +1,498 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+/* Own header. */
+#include <ecl/digitization/OfflineWaveformFitter.h>
+
+/* ECL headers. */
+#include <ecl/digitization/shaperdsp.h>
+
+/* C++ headers. */
+#include <algorithm>
+#include <cmath>
+
+using namespace Belle2;
+using namespace Belle2::ECL;
+
+namespace {
+
+  // Number of fit points.
+  const int c_NFitPoints = OfflineWaveformFitter::c_NFitPoints;
+
+  // Number of fit points for vectorized data.
+  const int c_NFitPointsVector = OfflineWaveformFitter::c_NFitPointsVector;
+
+  /** Damping of the first Levenberg-Marquardt step. */
+  const double c_InitialDamping = 1e-3;
+
+  /** Damping above which no better point can be found. */
+  const double c_MaxDamping = 1e10;
+
+  /**
+   * Solve (H + lambda * diag(H)) x = b with a Cholesky decomposition.
+   * Only the free parameters are varied, x is 0 for the others.
+   * @return False if the matrix is not positive definite.
+   */
+  template<int N>
+  bool solve(const double (*hessian)[N], const double* b, const bool* isFree,
+             double lambda, double* x)
+  {
+    int index[N];
+    int n = 0;
+    for (int i = 0; i < N; ++i) {
+      x[i] = 0;
+      if (isFree[i])
+        index[n++] = i;
+    }
+    double l[N][N], y[N];
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j <= i; ++j) {
+        double sum = hessian[index[i]][index[j]];
+        if (i == j)
+          sum *= 1 + lambda;
+        for (int k = 0; k < j; ++k)
+          sum -= l[i][k] * l[j][k];
+        if (i == j) {
+          if (!(sum > 0))
+            return false;
+          l[i][i] = std::sqrt(sum);
+        } else {
+          l[i][j] = sum / l[j][j];
+        }
+      }
+    }
+    for (int i = 0; i < n; ++i) {
+      double sum = b[index[i]];
+      for (int k = 0; k < i; ++k)
+        sum -= l[i][k] * y[k];
+      y[i] = sum / l[i][i];
+    }
+    for (int i = n - 1; i >= 0; --i) {
+      double sum = y[i];
+      for (int k = i + 1; k < n; ++k)
+        sum -= l[k][i] * x[index[k]];
+      x[index[i]] = sum / l[i][i];
+    }
+    return true;
+  }
+
+}
+
+SignalInterpolation2::SignalInterpolation2(const std::vector<double>& s)
+{
+  double T0 = -0.2;
+  std::vector<double> p(s.begin() + 1, s.end());
+  p[1] = std::max(0.0029, p[1]);
+  p[4] = std::max(0.0029, p[4]);
+
+  ShaperDSP_t dsp(p, s[0]);
+  dsp.settimestride(c_dtn);
+  dsp.settimeseed(T0);
+  dd_t t[(c_nt + c_ntail)*c_ndt];
+  dsp.fillarray(sizeof(t) / sizeof(t[0]), t);
+
+  for (int i = 0; i < c_nt * c_ndt; i++) {
+    m_FunctionInterpolation[i] = t[i].first;
+    m_DerivativeInterpolation[i] = t[i].second;
+  }
+  for (int i = 0; i < c_ntail; i++) {
+    int j = c_nt * c_ndt + i;
+    int k = c_nt * c_ndt + i * c_ndt;
+    m_FunctionInterpolation[j] = t[k].first;
+    m_DerivativeInterpolation[j] = t[k].second;
+  }
+  int i1 = c_nt * c_ndt + c_ntail - 2;
+  int i2 = c_nt * c_ndt + c_ntail - 1;
+  m_r0 = m_FunctionInterpolation[i2] / m_FunctionInterpolation[i1];
+  m_r1 = m_DerivativeInterpolation[i2] / m_DerivativeInterpolation[i1];
+}
+
+void SignalInterpolation2::getShape(
+  double t0, double* function, double* derivatives) const
+{
+  /* If before pulse start time (negative times), return 0. */
+  int k = 0;
+  while (t0 < 0) {
+    function[k] = 0;
+    derivatives[k] = 0;
+    t0 += c_dt;
+    ++k;
+    if (k >= c_NFitPoints)
+      return;
+  }
+
+  /* Function and derivative values. */
+  double function0[c_NFitPoints], function1[c_NFitPoints];
+  double derivative0[c_NFitPoints], derivative1[c_NFitPoints];
+
+  /* Interpolate first c_nt points (short time steps). */
+  double x = t0 * c_idtn;
+  double ix = floor(x);
+  double w = x - ix;
+  int j = ix;
+  double w2 = w * w;
+  double hw2 = 0.5 * w2;
+  double tw3 = ((1. / 6) * w) * w2;
+
+  /* Number of interpolation points. */
+  int iMax = k + c_nt;
+  if (iMax > c_NFitPoints)
+    iMax = c_NFitPoints;
+
+  /* Fill interpolation points. */
+  for (int i = k; i < iMax; ++i) {
+    function0[i] = m_FunctionInterpolation[j];
+    function1[i] = m_FunctionInterpolation[j + 1];
+    derivative0[i] = m_DerivativeInterpolation[j];
+    derivative1[i] = m_DerivativeInterpolation[j + 1];
+    j = j + c_ndt;
+  }
+
+  /* Interpolation. */
+  #pragma omp simd
+  for (int i = k; i < iMax; ++i) {
+    double a[4];
+    double dfdt = (function1[i] - function0[i]) * c_idtn;
+    double fp = derivative1[i] + derivative0[i];
+    a[0] = function0[i];
+    a[1] = derivative0[i];
+    a[2] = -((fp + derivative0[i]) - 3 * dfdt);
+    a[3] = fp - 2 * dfdt;
+    double b2 = 2 * a[2];
+    double b3 = 6 * a[3];
+    function[i] = a[0] + c_dtn * (a[1] * w + b2 * hw2 + b3 * tw3);
+    derivatives[i] = a[1] + b2 * w + b3 * hw2;
+  }
+  t0 = t0 + c_dt * c_nt;
+  if (iMax == c_NFitPoints)
+    return;
+  k = iMax;
+
+  /* Interpolate next c_ntail points (long time steps). */
+  x = t0 * c_idt;
+  ix = floor(x);
+  w = x - ix;
+  w2 = w * w;
+  hw2 = 0.5 * w2;
+  tw3 = ((1. / 6) * w) * w2;
+
+  /* Number of interpolation points. */
+  iMax = k + c_ntail - 1;
+  if (iMax > c_NFitPoints)
+    iMax = c_NFitPoints;
+
+  /* Interpolation. */
+  #pragma omp simd
+  for (int i = k; i < iMax; ++i) {
+    j = c_nt * c_ndt + i - k;
+    /*
+     * The interpolation step is the same as the distance between
+     * the fit points. It is possible to load the values in the interpolation
+     * loop while keeping its vectorization.
+     */
+    double f0 = m_FunctionInterpolation[j];
+    double f1 = m_FunctionInterpolation[j + 1];
+    double fp0 = m_DerivativeInterpolation[j];
+    double fp1 = m_DerivativeInterpolation[j + 1];
+    double a[4];
+    double dfdt = (f1 - f0) * c_idt;
+    double fp = fp1 + fp0;
+    a[0] = f0;
+    a[1] = fp0;
+    a[2] = -((fp + fp0) - 3 * dfdt);
+    a[3] = fp - 2 * dfdt;
+    double b2 = 2 * a[2];
+    double b3 = 6 * a[3];
+    function[i] = a[0] + c_dt * (a[1] * w + b2 * hw2 + b3 * tw3);
+    derivatives[i] = a[1] + b2 * w + b3 * hw2;
+  }
+  if (iMax == c_NFitPoints)
+    return;
+  k = iMax;
+
+  /* Exponential tail. */
+  while (k < c_NFitPoints) {
+    function[k] = function[k - 1] * m_r0;
+    derivatives[k] = derivatives[k - 1] * m_r1;
+    ++k;
+  }
+}
+
+OfflineWaveformFitter::OfflineWaveformFitter()
+{
+  const double isigma = 1 / c_DefaultNoise;
+  for (int i = 0; i < c_NFitPoints; ++i) {
+    for (int j = 0; j < c_NFitPointsVector; ++j)
+      m_InverseCovariance[i][j] = (i == j) * isigma * isigma;
+  }
+}
+
+void OfflineWaveformFitter::setInverseCovariance(const CovariancePacked& packed)
+{
+  int count = 0;
+  for (int i = 0; i < c_NFitPoints; ++i) {
+    for (int j = 0; j < i + 1; ++j) {
+      m_InverseCovariance[i][j] = packed[count];
+      m_InverseCovariance[j][i] = packed[count];
+      ++count;
+    }
+    m_InverseCovariance[i][c_NFitPoints] = 0;
+  }
+}
+
+void OfflineWaveformFitter::multiplyInverseCovariance(double* y, const double* x) const
+{
+  /* The matrix is symmetric, so add up its rows scaled by x. */
+  alignas(32) double sum[c_NFitPointsVector] = {};
+  for (int j = 0; j < c_NFitPoints; ++j) {
+    const double xj = x[j];
+    #pragma omp simd
+    for (int i = 0; i < c_NFitPointsVector; ++i)
+      sum[i] += m_InverseCovariance[j][i] * xj;
+  }
+  std::copy(sum, sum + c_NFitPointsVector, y);
+}
+
+template<int N>
+double OfflineWaveformFitter::evaluate(
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron, const double* parameters,
+  double* gradient, double (*hessian)[N]) const
+{
+  static_assert(N == 4 or N == 6, "Fit with 4 or 6 parameters");
+  const double B = parameters[0], Ag = parameters[1], T = parameters[2],
+               Ah = parameters[3];
+
+  /* Template shapes. */
+  alignas(32) double amplitudeGamma[c_NFitPointsVector], derivativesGamma[c_NFitPointsVector];
+  alignas(32) double amplitudeHadron[c_NFitPointsVector], derivativesHadron[c_NFitPointsVector];
+  alignas(32) double amplitudeGamma2[c_NFitPointsVector], derivativesGamma2[c_NFitPointsVector];
+  photon.getShape(T, amplitudeGamma, derivativesGamma);
+  hadron.getShape(T, amplitudeHadron, derivativesHadron);
+
+  /* Residuals. */
+  alignas(32) double df[c_NFitPointsVector], da[c_NFitPointsVector];
+  #pragma omp simd
+  for (int i = 0; i < c_NFitPoints; ++i)
+    df[i] = adc[i] - (Ag * amplitudeGamma[i] + Ah * amplitudeHadron[i] + B);
+  if constexpr(N == 6) {
+    photon.getShape(parameters[5], amplitudeGamma2, derivativesGamma2);
+    #pragma omp simd
+    for (int i = 0; i < c_NFitPoints; ++i)
+      df[i] -= parameters[4] * amplitudeGamma2[i];
+  }
+  df[c_NFitPoints] = 0;
+
+  multiplyInverseCovariance(da, df);
+  double chi2 = 0;
+  #pragma omp simd reduction(+:chi2)
+  for (int i = 0; i < c_NFitPointsVector; ++i)
+    chi2 += da[i] * df[i];
+  if (gradient == nullptr)
+    return chi2;
+
+  /* Derivatives of the model. */
+  alignas(32) double jacobian[N][c_NFitPointsVector];
+  #pragma omp simd
+  for (int i = 0; i < c_NFitPoints; ++i) {
+    jacobian[0][i] = 1;
+    jacobian[1][i] = amplitudeGamma[i];
+    jacobian[2][i] = derivativesGamma[i] * Ag + derivativesHadron[i] * Ah;
+    jacobian[3][i] = amplitudeHadron[i];
+  }
+  if constexpr(N == 6) {
+    #pragma omp simd
+    for (int i = 0; i < c_NFitPoints; ++i) {
+      jacobian[4][i] = amplitudeGamma2[i];
+      jacobian[5][i] = derivativesGamma2[i] * parameters[4];
+    }
+  }
+
+  alignas(32) double weighted[c_NFitPointsVector];
+  for (int k = 0; k < N; ++k) {
+    jacobian[k][c_NFitPoints] = 0;
+    double g = 0;
+    #pragma omp simd reduction(+:g)
+    for (int i = 0; i < c_NFitPointsVector; ++i)
+      g += jacobian[k][i] * da[i];
+    gradient[k] = g;
+    multiplyInverseCovariance(weighted, jacobian[k]);
+    for (int l = 0; l <= k; ++l) {
+      double h = 0;
+      #pragma omp simd reduction(+:h)
+      for (int i = 0; i < c_NFitPointsVector; ++i)
+        h += jacobian[l][i] * weighted[i];
+      hessian[k][l] = h;
+      hessian[l][k] = h;
+    }
+  }
+  return chi2;
+}
+
+template<int N>
+double OfflineWaveformFitter::minimize(
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron, double* parameters,
+  const double* lower, const double* upper, int& iterations) const
+{
+  double gradient[N], hessian[N][N], step[N], trial[N];
+  bool isFree[N];
+  double chi2 = evaluate<N>(adc, photon, hadron, parameters, gradient, hessian);
+  double lambda = c_InitialDamping;
+  for (iterations = 0; iterations < c_MaxIterations; ++iterations) {
+    /* Parameters at a limit are fixed if chi2 decreases beyond it. */
+    for (int k = 0; k < N; ++k) {
+      isFree[k] = !((parameters[k] <= lower[k] && gradient[k] < 0) ||
+                    (parameters[k] >= upper[k] && gradient[k] > 0));
+    }
+    /* Expected chi2 decrease of a Gauss-Newton step (EDM). */
+    if (solve<N>(hessian, gradient, isFree, 0, step)) {
+      double edm = 0;
+      for (int k = 0; k < N; ++k)
+        edm += step[k] * gradient[k];
+      if (edm < c_Tolerance)
+        break;
+    }
+    bool improved = false;
+    while (lambda < c_MaxDamping) {
+      if (solve<N>(hessian, gradient, isFree, lambda, step)) {
+        for (int k = 0; k < N; ++k)
+          trial[k] = std::clamp(parameters[k] + step[k], lower[k], upper[k]);
+        const double trialChi2 = evaluate<N>(adc, photon, hadron, trial, nullptr, nullptr);
+        if (trialChi2 < chi2) {
+          std::copy(trial, trial + N, parameters);
+          lambda = std::max(0.1 * lambda, 1e-9);
+          improved = true;
+          break;
+        }
+      }
+      lambda *= 10;
+    }
+    if (!improved)
+      break;
+    chi2 = evaluate<N>(adc, photon, hadron, parameters, gradient, hessian);
+  }
+  return chi2;
+}
+
+double OfflineWaveformFitter::getChi2(
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron, const double* parameters,
+  int nParameters) const
+{
+  if (nParameters == 6)
+    return evaluate<6>(adc, photon, hadron, parameters, nullptr, nullptr);
+  return evaluate<4>(adc, photon, hadron, parameters, nullptr, nullptr);
+}
+
+void OfflineWaveformFitter::fitPhotonHadron(
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron, OfflineFitResult& result) const
+{
+  /* Setting inital fit parameters. */
+  double dt = 0.5;
+  double amax = 0;
+  int jmax = 6;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if (amax < adc[j]) {
+      amax = adc[j];
+      jmax = j;
+    }
+  }
+  double sumB0 = 0;
+  int jsum = 0;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if (j < jmax - 3 || jmax + 4 < j) {
+      sumB0 += adc[j];
+      ++jsum;
+    }
+  }
+  double B0 = sumB0 / jsum;
+  amax -= B0;
+  if (amax < 0)
+    amax = 10;
+  double T0 = dt * (4.5 - jmax);
+  double A0 = amax;
+
+  /* Parameters B, Ag, T, Ah and their limits. */
+  double p[4] = {B0, A0, T0, 0};
+  const double lower[4] = {std::min(B0 / 1.5, B0 * 1.5), 0, T0 - 2.5, -A0};
+  const double upper[4] = {std::max(B0 / 1.5, B0 * 1.5), 2 * A0, T0 + 2.5, 2 * A0};
+  result.chi2 = minimize<4>(adc, photon, hadron, p, lower, upper,
+                            result.iterations);
+  result.pedestal = p[0];
+  result.amplitudePhoton = p[1];
+  result.signalTime = p[2];
+  result.amplitudeHadron = p[3];
+}
+
+void OfflineWaveformFitter::fitPhotonHadronBackgroundPhoton(
+  const double* adc, const SignalInterpolation2& photon,
+  const SignalInterpolation2& hadron, OfflineFitResult& result) const
+{
+  double dt = 0.5;
+  double amax = 0; int jmax = 6;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if (amax < adc[j]) {
+      amax = adc[j];
+      jmax = j;
+    }
+  }
+
+  double amax1 = 0; int jmax1 = 6;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if (j < jmax - 3 || jmax + 4 < j) {
+      if (j == 0) {
+        if (amax1 < adc[j] && adc[j + 1] < adc[j]) {
+          amax1 = adc[j];
+          jmax1 = j;
+        }
+      } else if (j == 30) {
+        if (amax1 < adc[j] && adc[j - 1] < adc[j]) {
+          amax1 = adc[j];
+          jmax1 = j;
+        }
+      } else {
+        if (amax1 < adc[j] && adc[j + 1] < adc[j] && adc[j - 1] < adc[j]) {
+          amax1 = adc[j];
+          jmax1 = j;
+        }
+      }
+    }
+  }
+
+  double sumB0 = 0;
+  int jsum = 0;
+  for (int j = 0; j < c_NFitPoints; j++) {
+    if ((j < jmax - 3 || jmax + 4 < j) && (j < jmax1 - 3 || jmax1 + 4 < j)) {
+      sumB0 += adc[j];
+      ++jsum;
+    }
+  }
+  double B0 = sumB0 / jsum;
+  amax -= B0;
+  amax = std::max(10.0, amax);
+  amax1 -= B0;
+  amax1 = std::max(10.0, amax1);
+  double T0 = dt * (4.5 - jmax);
+  double T01 = dt * (4.5 - jmax1);
+
+  /* Parameters B, Ag, T, Ah, A2, T2 and their limits. */
+  double A0 = amax, A01 = amax1;
+  double p[6] = {B0, A0, T0, 0, A01, T01};
+  const double lower[6] = {std::min(B0 / 1.5, B0 * 1.5), 0, T0 - 2.5, -A0, 0, T01 - 2.5};
+  const double upper[6] = {std::max(B0 / 1.5, B0 * 1.5), 2 * A0, T0 + 2.5, 2 * A0, 2 * A01, T01 + 2.5};
+  result.chi2 = minimize<6>(adc, photon, hadron, p, lower, upper,
+                            result.iterations);
+  result.pedestal = p[0];
+  result.amplitudePhoton = p[1];
+  result.signalTime = p[2];
+  result.amplitudeHadron = p[3];
+  result.amplitudeBackgroundPhoton = p[4];
+  result.timeBackgroundPhoton = p[5];
+}
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""Timing of the ECL connected region finder at high occupancy.
+
+Calibrated digits are generated directly, without simulation: a given
+fraction of all crystals gets an energy drawn from a falling spectrum
+(beam background), plus a few showers with energetic seeds. The call
+statistics of the ECLCRFinder module are printed at the end.
+
+Usage:
+    $ basf2 EclCRFinderBenchmark.py -n 1000 -- --occupancy 0.3
+"""
+
+import argparse
+import random
+import basf2 as b2
+from ROOT import Belle2
+
+
+class ECLCalDigitGenerator(b2.Module):
+    """Generate ECLCalDigits for a given crystal occupancy."""
+
+    def __init__(self, occupancy, showers):
+        """Constructor."""
+        super().__init__()
+        #: fraction of crystals with a digit
+        self.occupancy = occupancy
+        #: number of showers per event
+        self.showers = showers
+
+    def initialize(self):
+        """Register the digits and the event level clustering information."""
+        #: calibrated digits
+        self.digits = Belle2.PyStoreArray('ECLCalDigits')
+        self.digits.registerInDataStore()
+        #: event level clustering information, required by the CR finder
+        self.info = Belle2.PyStoreObj('EventLevelClusteringInfo')
+        self.info.registerInDataStore()
+
+    def event(self):
+        """Fill the digits."""
+        self.info.create()
+        nCrystals = 8736
+        energies = {}
+        for cellId in range(1, nCrystals + 1):
+            if random.random() < self.occupancy:
+                energies[cellId] = random.expovariate(1 / 0.002)
+        for i in range(self.showers):
+            seed = random.randint(1, nCrystals)
+            for cellId in range(max(1, seed - 2), min(nCrystals, seed + 2) + 1):
+                energies[cellId] = energies.get(cellId, 0) + random.uniform(0.01, 0.5)
+        for cellId, energy in energies.items():
+            digit = self.digits.appendNew()
+            digit.setCellId(cellId)
+            digit.setEnergy(energy)
+            digit.setTime(random.gauss(0, 50))
+            digit.setTimeResolution(10)
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--occupancy', type=float, default=0.2, help='Fraction of crystals with a digit')
+parser.add_argument('--showers', type=int, default=10, help='Number of showers per event')
+args = parser.parse_args()
+
+random.seed(12345)
+
+main = b2.create_path()
+main.add_module('EventInfoSetter')
+main.add_module('Gearbox')
+main.add_module('Geometry')
+main.add_module(ECLCalDigitGenerator(args.occupancy, args.showers))
+main.add_module('ECLCRFinder')
+
+b2.process(main)
+
+# Print call statistics
+print(b2.statistics)
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""Compare the TMinuit and the Levenberg-Marquardt fits of ECLWaveformFit.
+
+The ECL waveforms of recorded raw data are unpacked and fitted twice, first
+with TMinuit (UseMinuit=True) and then with the dedicated fitter. For every
+fitted waveform the results of both fits are written to a tree and a summary
+of the differences is printed at the end: agreement of the fit type, the
+distribution of the amplitude, hadron fraction and time differences and how
+often each fitter finds the lower chi2. The time spent in both modules is
+shown in the module statistics.
+
+Usage:
+    $ basf2 EclWaveformFitComparison.py -n 10000 -- raw_data.root --output comparison.root
+"""
+
+import argparse
+import math
+import basf2 as b2
+from ROOT import Belle2, TFile, TTree
+from array import array
+from rawdata import add_unpackers
+
+
+#: quantities stored for each fit
+FIT_QUANTITIES = ['fitType', 'chi2', 'totalAmp', 'hadronAmp', 'diodeAmp', 'time', 'baseline']
+
+
+class SaveFitResults(b2.Module):
+    """Remember the two-component fit results of all ECLDsps."""
+
+    def __init__(self, results):
+        """Constructor, results is filled with one dict per event and waveform."""
+        super().__init__()
+        #: cell id -> fit result of the current event
+        self.results = results
+
+    def event(self):
+        """Save the fit results of all fitted waveforms."""
+        self.results.clear()
+        for dsp in Belle2.PyStoreArray('ECLDsps'):
+            if dsp.getTwoComponentChi2() < 0:
+                continue
+            self.results[dsp.getCellId()] = {
+                'fitType': int(dsp.getTwoComponentFitType()),
+                'chi2': dsp.getTwoComponentChi2(),
+                'totalAmp': dsp.getTwoComponentTotalAmp(),
+                'hadronAmp': dsp.getTwoComponentHadronAmp(),
+                'diodeAmp': dsp.getTwoComponentDiodeAmp(),
+                'time': dsp.getTwoComponentTime(),
+                'baseline': dsp.getTwoComponentBaseline(),
+            }
+
+
+class CompareFitResults(b2.Module):
+    """Write the results of both fits to a tree and summarize the differences."""
+
+    def __init__(self, minuit, fitter, output):
+        """Constructor."""
+        super().__init__()
+        #: results of the TMinuit fits
+        self.minuit = minuit
+        #: results of the Levenberg-Marquardt fits
+        self.fitter = fitter
+        #: output file name
+        self.output = output
+
+    def initialize(self):
+        """Create the output tree."""
+        #: output file
+        self.file = TFile(self.output, 'RECREATE')
+        #: one entry per fitted waveform
+        self.tree = TTree('fits', 'ECL waveform fits with TMinuit and the Levenberg-Marquardt fitter')
+        #: branch buffers
+        self.buffers = {'cellId': array('i', [0])}
+        self.tree.Branch('cellId', self.buffers['cellId'], 'cellId/I')
+        for prefix in ['minuit', 'fitter']:
+            for quantity in FIT_QUANTITIES:
+                name = prefix + quantity[0].upper() + quantity[1:]
+                self.buffers[name] = array('d', [0])
+                self.tree.Branch(name, self.buffers[name], name + '/D')
+        #: number of compared waveforms
+        self.n = 0
+        #: number of waveforms with the same fit type
+        self.sameType = 0
+        #: number of waveforms where the fitter has a lower chi2 than TMinuit by more than 0.01
+        self.fitterBetter = 0
+        #: number of waveforms where TMinuit has a lower chi2 than the fitter by more than 0.01
+        self.minuitBetter = 0
+        #: sums and squared sums of the differences
+        self.sums = {key: [0., 0.] for key in ['relativeAmp', 'hadronFraction', 'time']}
+
+    def add(self, key, value):
+        """Add a difference to the sums."""
+        self.sums[key][0] += value
+        self.sums[key][1] += value * value
+
+    def event(self):
+        """Compare the fits of all waveforms fitted by both."""
+        for cellId, minuit in self.minuit.items():
+            fitter = self.fitter.get(cellId)
+            if fitter is None:
+                continue
+            self.buffers['cellId'][0] = cellId
+            for prefix, result in [('minuit', minuit), ('fitter', fitter)]:
+                for quantity in FIT_QUANTITIES:
+                    self.buffers[prefix + quantity[0].upper() + quantity[1:]][0] = result[quantity]
+            self.tree.Fill()
+
+            self.n += 1
+            if minuit['fitType'] != fitter['fitType']:
+                continue
+            self.sameType += 1
+            if fitter['chi2'] < minuit['chi2'] - 0.01:
+                self.fitterBetter += 1
+            elif minuit['chi2'] < fitter['chi2'] - 0.01:
+                self.minuitBetter += 1
+            if minuit['totalAmp'] > 0:
+                self.add('relativeAmp', fitter['totalAmp'] / minuit['totalAmp'] - 1)
+                self.add('hadronFraction', (fitter['hadronAmp'] - minuit['hadronAmp']) / minuit['totalAmp'])
+            self.add('time', fitter['time'] - minuit['time'])
+
+    def terminate(self):
+        """Write the tree and print the summary."""
+        self.tree.Write()
+        self.file.Close()
+        if self.n == 0:
+            b2.B2WARNING('No waveforms were fitted')
+            return
+        b2.B2RESULT(f'compared waveforms: {self.n}, same fit type: {self.sameType / self.n:.4%}')
+        if self.sameType == 0:
+            return
+        b2.B2RESULT(f'lower chi2 with the fitter: {self.fitterBetter / self.sameType:.4%}, '
+                    f'with TMinuit: {self.minuitBetter / self.sameType:.4%}')
+        for key, (total, squares) in self.sums.items():
+            mean = total / self.sameType
+            rms = math.sqrt(max(0., squares / self.sameType - mean * mean))
+            b2.B2RESULT(f'fitter - TMinuit {key}: mean {mean:.3g}, rms {rms:.3g}')
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('input', nargs='+', help='recorded raw data files')
+    parser.add_argument('--output', default='EclWaveformFitComparison.root', help='output file with the fit results')
+    args = parser.parse_args()
+
+    minuitResults, fitterResults = {}, {}
+    main = b2.Path()
+    main.add_module('RootInput', inputFileNames=args.input)
+    main.add_module('Gearbox')
+    main.add_module('Geometry', components=['ECL'], useDB=False)
+    add_unpackers(main, components=['ECL'])
+    main.add_module('ECLWaveformFit', UseMinuit=True).set_name('ECLWaveformFit_TMinuit')
+    main.add_module(SaveFitResults(minuitResults))
+    main.add_module('ECLWaveformFit', UseMinuit=False).set_name('ECLWaveformFit_LevenbergMarquardt')
+    main.add_module(SaveFitResults(fitterResults))
+    main.add_module(CompareFitResults(minuitResults, fitterResults, args.output))
+    main.add_module('Progress')
+
+    b2.process(main)
+    print(b2.statistics)
@@ -12,7 +12,7 @@
 namespace Belle2 {
   class ECLCrystalCalib;
   namespace ECL {
-    class ECLNeighbours;
+    class ECLNeighbourMap;
 
     /**
      * Class to get position information for a cluster for leakage corrections
@@ -50,7 +50,7 @@ namespace Belle2 {
       DBObjPtr<ECLCrystalCalib> m_ECLCrystalPhiWidth; /**< width in phi */
       std::vector<float> m_phiWidth; /**< crystal phi widths from DB object */
 
-      ECL::ECLNeighbours* m_neighbours{nullptr}; /**< 8 nearest neighbours to crystal */
+      const ECL::ECLNeighbourMap* m_neighbours{nullptr}; /**< 8 nearest neighbours to crystal */
 
       std::vector<int> m_thetaIDofCrysID; /**< thetaID of each crystal ID */
       std::vector<int> m_phiIDofCrysID; /**< phiID of each crystal ID */
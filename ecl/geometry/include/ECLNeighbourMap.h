@@ -0,0 +1,99 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+/* ECL headers. */
+#include <ecl/geometry/ECLNeighbours.h>
+
+/* C++ headers. */
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Belle2 {
+  namespace ECL {
+
+    /**
+     * Neighbours of all crystals for one definition of ECLNeighbours in
+     * flat arrays: the neighbours of cell id cid are
+     * m_cellIds[m_offsets[cid]] ... m_cellIds[m_offsets[cid + 1] - 1].
+     *
+     * The maps are built once per process for each set of parameters and
+     * shared by all modules, use ECLNeighbourMap::get() to obtain them.
+     */
+    class ECLNeighbourMap {
+
+    public:
+
+      /** Range of neighbour cell ids, to be used in range-based for loops. */
+      class Range {
+
+      public:
+
+        /** Constructor. */
+        Range(const short int* begin, const short int* end) : m_begin(begin), m_end(end) {}
+
+        /** First neighbour. */
+        const short int* begin() const { return m_begin; }
+
+        /** Behind the last neighbour. */
+        const short int* end() const { return m_end; }
+
+        /** Number of neighbours. */
+        size_t size() const { return m_end - m_begin; }
+
+        /** Neighbour with index i. */
+        short int operator[](size_t i) const { return m_begin[i]; }
+
+      private:
+
+        /** First neighbour. */
+        const short int* m_begin;
+
+        /** Behind the last neighbour. */
+        const short int* m_end;
+
+      };
+
+      /**
+       * Get the shared map, it is built on the first request.
+       * The parameters are the ones of the ECLNeighbours constructor.
+       */
+      static const ECLNeighbourMap& get(const std::string& neighbourDef, double par, bool sorted = false);
+
+      /** Return the neighbours for a given cell ID. */
+      Range getNeighbours(int cid) const
+      {
+        return Range(m_cellIds.data() + m_offsets[cid], m_cellIds.data() + m_offsets[cid + 1]);
+      }
+
+      /** return number of crystals in a given theta ring */
+      short int getCrystalsPerRing(const short int thetaid) const { return m_neighbours.getCrystalsPerRing(thetaid); }
+
+      /** Neighbour lists the map is built from, for users which need them as std::vector. */
+      const ECLNeighbours& getECLNeighbours() const { return m_neighbours; }
+
+    private:
+
+      /** Constructor, build neighbours and flat arrays. */
+      ECLNeighbourMap(const std::string& neighbourDef, double par, bool sorted);
+
+      /** Neighbour lists. */
+      const ECLNeighbours m_neighbours;
+
+      /** Index of the first neighbour of each cell id in m_cellIds. */
+      std::vector<int> m_offsets;
+
+      /** Neighbour cell ids of all crystals. */
+      std::vector<short int> m_cellIds;
+
+    };
+
+  } // end of namespace ECL
+} // end of namespace Belle2
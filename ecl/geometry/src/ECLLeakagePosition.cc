@@ -9,7 +9,7 @@
 //..ECL
 #include <ecl/geometry/ECLLeakagePosition.h>
 #include <ecl/dbobjects/ECLCrystalCalib.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 //..Other
 #include <iostream>
@@ -41,7 +41,7 @@ ECLLeakagePosition::ECLLeakagePosition() :
   }
 
   //..Eight nearest neighbours, plus crystal itself. Uses cellID, 1--8736
-  m_neighbours = new ECLNeighbours("N", 1);
+  m_neighbours = &ECLNeighbourMap::get("N", 1);
 
   //..Record the thetaID and phiID of each cellID
   for (int thID = 0; thID < 69; thID++) {
@@ -67,7 +67,6 @@ ECLLeakagePosition::ECLLeakagePosition() :
 
 ECLLeakagePosition::~ECLLeakagePosition()
 {
-  delete m_neighbours;
 }
 
 std::vector<int> ECLLeakagePosition::getLeakagePosition(const int cellIDFromEnergy, const float theta, const float phi,
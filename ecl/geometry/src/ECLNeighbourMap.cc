@@ -0,0 +1,52 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+/* ECL headers. */
+#include <ecl/dataobjects/ECLElementNumbers.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
+
+/* Basf2 headers. */
+#include <framework/logging/Logger.h>
+
+/* C++ headers. */
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+using namespace Belle2;
+using namespace ECL;
+
+ECLNeighbourMap::ECLNeighbourMap(const std::string& neighbourDef, double par, bool sorted) :
+  m_neighbours(neighbourDef, par, sorted)
+{
+  // cell id 0 is the fake entry of ECLNeighbours
+  m_offsets.reserve(ECLElementNumbers::c_NCrystals + 2);
+  m_offsets.push_back(0);
+  for (int cid = 0; cid <= ECLElementNumbers::c_NCrystals; cid++) {
+    const std::vector<short int>& neighbours = m_neighbours.getNeighbours(cid);
+    m_cellIds.insert(m_cellIds.end(), neighbours.begin(), neighbours.end());
+    m_offsets.push_back(m_cellIds.size());
+  }
+  m_cellIds.shrink_to_fit();
+}
+
+const ECLNeighbourMap& ECLNeighbourMap::get(const std::string& neighbourDef, double par, bool sorted)
+{
+  static std::map<std::tuple<std::string, double, bool>, std::unique_ptr<const ECLNeighbourMap>> maps;
+  static std::mutex mutex;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<const ECLNeighbourMap>& map = maps[std::make_tuple(neighbourDef, par, sorted)];
+  if (!map) {
+    B2DEBUG(150, "ECLNeighbourMap::get: building map" << LogVar("type", neighbourDef) << LogVar("parameter", par)
+            << LogVar("sorted", sorted));
+    map.reset(new ECLNeighbourMap(neighbourDef, par, sorted));
+  }
+  return *map;
+}
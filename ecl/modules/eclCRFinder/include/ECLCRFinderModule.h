@@ -14,7 +14,7 @@
 #include <framework/datastore/StoreObjPtr.h>
 
 // C++
-#include <set>
+#include <vector>
 
 namespace Belle2 {
   class ECLConnectedRegion;
@@ -22,7 +22,7 @@ namespace Belle2 {
   class EventLevelClusteringInfo;
 
   namespace ECL {
-    class ECLNeighbours;
+    class ECLNeighbourMap;
   }
 
   /** Class to find connected regions */
@@ -82,36 +82,35 @@ namespace Belle2 {
     int m_skipFailedTimeFitDigits; /**< Handling of digits with failed time fits.*/
 
     /** Digit vectors. */
-    std::vector <int>  m_cellIdToCheckVec; /**< cellid -> check digit. */
+    std::vector <int>  m_cellIdToCheckVec; /**< cellid -> 1: centre of a region, 2: attached to a centre. */
     std::vector <int>  m_cellIdToSeedVec; /**< cellid -> seed digit. */
     std::vector <int>  m_cellIdToGrowthVec; /**< cellid -> growth digits. */
     std::vector <int>  m_cellIdToDigitVec; /**< cellid -> above threshold digits. */
 
+    /** Digit lists. */
+    std::vector <int>  m_seedCells; /**< cell ids of seed digits. */
+    std::vector <int>  m_digitCells; /**< cell ids of above threshold digits. */
+    std::vector <int>  m_centreCells; /**< cell ids of seeds and of the growth digits attached to them. */
+
     /** vector (ECLElementNumbers::c_NCrystals + 1 entries) with cell id to store array positions */
     std::vector< int > m_calDigitStoreArrPosition;
 
     /** Connected Region map. */
-    std::vector < int > m_cellIdToTempCRIdVec; /**< cellid -> temporary CR.*/
-    std::map < int, int > m_cellIdToTempCRIdMap; /**< cellid -> temporary CR.*/
+    std::vector < int > m_cellIdToParentVec; /**< cellid -> parent cell in the disjoint-set forest.*/
+    std::vector < int > m_cellIdToTempCRIdVec; /**< cellid -> temporary CR (for root cells).*/
+    std::vector < std::vector<int> > m_tempCRCells; /**< temporary CR -> cell ids.*/
 
     /** Neighbour maps. */
-    std::vector<ECL::ECLNeighbours*> m_neighbourMaps;
-
-    /** Check if two crystals are neighbours. */
-    // void checkNeighbours(const int cellid, const int tempcrid, const int type);
-    bool areNeighbours(const int cellid1, const int cellid2, const int maptype);
-
-    /** Convert vector of cell ids to 0/1 vectors from 1-8737. */
-    std::vector<int> oneHotVector(std::vector<int>& A, const int n);
+    std::vector<const ECL::ECLNeighbourMap*> m_neighbourMaps;
 
-    /** Convert vector of vectors to one long vector. */
-    std::vector<int> flattenVector(std::vector<std::vector<int>>& A);
+    /** Add a cell to the centres of the connected regions if it is not one yet. */
+    void addCentre(const int cellid);
 
-    /** Find all lists of cell-ids that share at least one cell. */
-    std::vector<std::set<int>> mergeVectorsUsingSets(std::vector<std::vector<int>>& A);
+    /** Find the root of the set that contains the cell, with path halving. */
+    int findRoot(int cellid);
 
-    /** Get all connected regions. */
-    std::vector<std::vector<int>> getConnectedRegions(const std::vector<int>& A, const std::vector<int>& B, const int maptype);
+    /** Merge the sets that contain the two cells. */
+    void unite(const int cellid1, const int cellid2);
 
   };
 
@@ -12,7 +12,7 @@
 /* ECL headeers. */
 #include <ecl/dataobjects/ECLCalDigit.h>
 #include <ecl/dataobjects/ECLConnectedRegion.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 /* Basf2 headers. */
 #include <framework/gearbox/Unit.h>
@@ -99,14 +99,15 @@ void ECLCRFinderModule::initialize()
 
   // Initialize neighbour maps.
   m_neighbourMaps.resize(2);
-  m_neighbourMaps[0] = new ECL::ECLNeighbours(m_mapType[0], m_mapPar[0]);
-  m_neighbourMaps[1] = new ECL::ECLNeighbours(m_mapType[1], m_mapPar[1]);
+  m_neighbourMaps[0] = &ECL::ECLNeighbourMap::get(m_mapType[0], m_mapPar[0]);
+  m_neighbourMaps[1] = &ECL::ECLNeighbourMap::get(m_mapType[1], m_mapPar[1]);
 
   // Resize the vectors
   m_cellIdToCheckVec.resize(8737); /**< cellid -> check digit: true if digit has been checked for neighbours. */
   m_cellIdToSeedVec.resize(8737); /**< cellid -> seed digit (type 1). */
   m_cellIdToGrowthVec.resize(8737); /**< cellid -> growth digits (type 2). */
   m_cellIdToDigitVec.resize(8737); /**< cellid -> above threshold digits. */
+  m_cellIdToParentVec.resize(8737); /**< cellid -> parent cell. */
   m_cellIdToTempCRIdVec.resize(8737); /**< cellid -> CR. */
   m_calDigitStoreArrPosition.resize(8737);
 
@@ -126,7 +127,9 @@ void ECLCRFinderModule::event()
   std::fill(m_cellIdToSeedVec.begin(), m_cellIdToSeedVec.end(), 0);
   std::fill(m_cellIdToGrowthVec.begin(), m_cellIdToGrowthVec.end(), 0);
   std::fill(m_cellIdToDigitVec.begin(), m_cellIdToDigitVec.end(), 0);
-  std::fill(m_cellIdToTempCRIdVec.begin(), m_cellIdToTempCRIdVec.end(), 0);
+  m_seedCells.clear();
+  m_digitCells.clear();
+  m_centreCells.clear();
 
   // Fill a vector that can be used to map cellid -> store array position
   std::fill(m_calDigitStoreArrPosition.begin(), m_calDigitStoreArrPosition.end(), -1);
@@ -134,9 +137,6 @@ void ECLCRFinderModule::event()
     m_calDigitStoreArrPosition[m_eclCalDigits[i]->getCellId()] = i;
   }
 
-  // Clear the map(s).
-  m_cellIdToTempCRIdMap.clear();
-
   //-------------------------------------------------------
   // fill digits into maps
   for (const auto& eclCalDigit : m_eclCalDigits) {
@@ -161,6 +161,7 @@ void ECLCRFinderModule::event()
         if (m_timeCut[2] < -1e-9  and fabs(timeresidual) > fabs(m_timeCut[2])) continue;
       }
       m_cellIdToDigitVec[cellid] = 1;
+      m_digitCells.push_back(cellid);
       B2DEBUG(250, "ECLCRFinderModule::event(), adding 'all digit' cellid = " << cellid << " " << energy << " " << time << " " <<
               timeresidual);
 
@@ -184,6 +185,7 @@ void ECLCRFinderModule::event()
             if (m_timeCut[0] < -1e-9  and fabs(timeresidual) > fabs(m_timeCut[0])) continue;
           }
           m_cellIdToSeedVec[cellid] = 1;
+          m_seedCells.push_back(cellid);
           B2DEBUG(250, "ECLCRFinderModule::event(), adding 'seed digit' cellid = " << cellid << " " << energy << " " << time << " " <<
                   timeresidual);
         } // end seed
@@ -191,35 +193,66 @@ void ECLCRFinderModule::event()
     }// end digit
   }//end filling maps
 
+  const ECL::ECLNeighbourMap& neighbourMap = *m_neighbourMaps[0];
+
   // we start with seed crystals A and attach all growth crystals B
-  std::vector<std::vector<int>> connectedRegions_AB = getConnectedRegions(m_cellIdToSeedVec, m_cellIdToGrowthVec, 0);
-  std::vector<int> connectedRegions_AB_flattened = flattenVector(connectedRegions_AB);
-  std::vector<int> AB = oneHotVector(connectedRegions_AB_flattened, m_cellIdToSeedVec.size());
+  for (const int cellid : m_seedCells) {
+    addCentre(cellid);
+    for (const auto neighbour : neighbourMap.getNeighbours(cellid)) {
+      if (m_cellIdToGrowthVec[neighbour] > 0) addCentre(neighbour);
+    }
+  }
 
-  // Check if any of the growth crystals could grow to other growth crystals
-  std::vector<std::vector<int>> connectedRegions_ABB = getConnectedRegions(AB, m_cellIdToGrowthVec, 0);
-  std::vector<int> connectedRegions_ABB_flattened = flattenVector(connectedRegions_ABB);
-  std::vector<int> ABB = oneHotVector(connectedRegions_ABB_flattened, AB.size());
+  // Check if any of the growth crystals could grow to other growth crystals (one step only)
+  const size_t nAB = m_centreCells.size();
+  for (size_t i = 0; i < nAB; ++i) {
+    for (const auto neighbour : neighbourMap.getNeighbours(m_centreCells[i])) {
+      if (m_cellIdToGrowthVec[neighbour] > 0) addCentre(neighbour);
+    }
+  }
 
-  // and finally: attach all normal digits
-  std::vector<std::vector<int>> connectedRegions_ABBC = getConnectedRegions(ABB, m_cellIdToDigitVec, 0);
+  // and finally: attach all normal digits, regions that share at least one crystal are merged
+  for (const int cellid : m_digitCells) {
+    m_cellIdToParentVec[cellid] = cellid;
+    m_cellIdToTempCRIdVec[cellid] = -1;
+  }
+  for (const int cellid : m_centreCells) {
+    for (const auto neighbour : neighbourMap.getNeighbours(cellid)) {
+      if (m_cellIdToDigitVec[neighbour] > 0) {
+        if (m_cellIdToCheckVec[neighbour] == 0) m_cellIdToCheckVec[neighbour] = 2;
+        unite(cellid, neighbour);
+      }
+    }
+  }
 
-  //final step: merge all CRs that share at least one crystal
-  std::vector<std::set<int>> connectedRegionsMerged_ABBC_sets = mergeVectorsUsingSets(connectedRegions_ABBC);
+  // CRs are ordered by the largest centre cell id they contain (the centre
+  // cells with their attached digits were merged in ascending order before)
+  std::sort(m_centreCells.begin(), m_centreCells.end());
+  int nCR = 0;
+  for (auto it = m_centreCells.rbegin(); it != m_centreCells.rend(); ++it) {
+    const int root = findRoot(*it);
+    if (m_cellIdToTempCRIdVec[root] < 0) m_cellIdToTempCRIdVec[root] = nCR++;
+  }
+
+  if (m_tempCRCells.size() < static_cast<size_t>(nCR)) m_tempCRCells.resize(nCR);
+  for (int i = 0; i < nCR; ++i) m_tempCRCells[i].clear();
+  std::sort(m_digitCells.begin(), m_digitCells.end());
+  for (const int cellid : m_digitCells) {
+    if (m_cellIdToCheckVec[cellid] > 0)
+      m_tempCRCells[nCR - 1 - m_cellIdToTempCRIdVec[findRoot(cellid)]].push_back(cellid);
+  }
 
   // Create CRs and add relations to digits.
-  unsigned int connectedRegionID = 0;
-  for (const auto& xcr : connectedRegionsMerged_ABBC_sets) {
+  for (int connectedRegionID = 0; connectedRegionID < nCR; ++connectedRegionID) {
 
     // Append to store array
     const auto aCR = m_eclConnectedRegions.appendNew();
 
     // Set CR ID
     aCR->setCRId(connectedRegionID);
-    connectedRegionID++;
 
     // Add all digits
-    for (int x : xcr) {
+    for (int x : m_tempCRCells[connectedRegionID]) {
       const int pos = m_calDigitStoreArrPosition[x];
       aCR->addRelationTo(m_eclCalDigits[pos], 1.0);
     }
@@ -236,89 +269,29 @@ void ECLCRFinderModule::endRun()
 void ECLCRFinderModule::terminate()
 {
   B2DEBUG(200, "ECLCRFinderModule::terminate()");
-  for (unsigned int i = 0; i < m_neighbourMaps.size(); i++) {
-    if (m_neighbourMaps[i]) delete m_neighbourMaps[i];
-  }
-
-}
-
-bool ECLCRFinderModule::areNeighbours(const int cellid1, const int cellid2, const int maptype)
-{
-  for (const auto& neighbour : m_neighbourMaps[maptype]->getNeighbours(cellid1)) {
-    if (neighbour == cellid2) return true;
-  }
-  return false;
 }
 
-std::vector<int> ECLCRFinderModule::flattenVector(std::vector<std::vector<int>>& A)
+void ECLCRFinderModule::addCentre(const int cellid)
 {
-  std::vector<int> C;
-  for (const auto& B : A) {
-    C.insert(C.end(), B.begin(), B.end());
+  if (m_cellIdToCheckVec[cellid] == 0) {
+    m_cellIdToCheckVec[cellid] = 1;
+    m_centreCells.push_back(cellid);
   }
-  std::sort(C.begin(), C.end());
-  C.erase(std::unique(C.begin(), C.end()), C.end());
-  return C;
 }
 
-std::vector<int> ECLCRFinderModule::oneHotVector(std::vector<int>& A, const int n)
+int ECLCRFinderModule::findRoot(int cellid)
 {
-  std::vector<int> C(n, 0);
-  for (int x : A) {
-    if (x >= 0 && x < n) {
-      C[x] = 1;
-    }
+  while (m_cellIdToParentVec[cellid] != cellid) {
+    m_cellIdToParentVec[cellid] = m_cellIdToParentVec[m_cellIdToParentVec[cellid]];
+    cellid = m_cellIdToParentVec[cellid];
   }
-  return C;
+  return cellid;
 }
 
-std::vector<std::set<int>> ECLCRFinderModule::mergeVectorsUsingSets(std::vector<std::vector<int>>& A)
+void ECLCRFinderModule::unite(const int cellid1, const int cellid2)
 {
-
-  // Make empty list of sets "output"
-  std::vector< std::set<int> > output;
-
-  for (auto& vec : A) {
-    std::set<int> s(vec.begin(), vec.end());
-
-    //Check whether element intersects with any in output
-    for (auto it = output.begin(); it != output.end();) {
-      std::set<int> intersect;
-      std::set_intersection(it->begin(), it->end(), s.begin(), s.end(),
-                            std::inserter(intersect, intersect.begin()));
-
-      if (!intersect.empty()) {
-        s.insert(it->begin(), it->end());
-        it = output.erase(it);
-      } else ++it;
-    }
-    output.push_back(s);
-  }
-
-  return output;
-}
-
-std::vector<std::vector<int>> ECLCRFinderModule::getConnectedRegions(const std::vector<int>& A, const std::vector<int>& B,
-                           const int maptype)
-{
-  std::vector<std::vector<int>> connectedRegions;
-
-  for (unsigned int i = 0; i < A.size(); ++i) {
-    if (A[i] > 0) {
-      std::vector<int> region;
-      region.push_back(i);
-
-      for (unsigned int j = 0; j < B.size(); ++j) {
-        if (B[j] > 0 && areNeighbours(i, j, maptype)) {
-          region.push_back(j);
-        }
-      }
-
-      std::sort(region.begin(), region.end());
-      region.erase(unique(region.begin(), region.end()), region.end());
-      connectedRegions.push_back(region);
-    }
-  }
-
-  return connectedRegions;
+  const int root1 = findRoot(cellid1);
+  const int root2 = findRoot(cellid2);
+  if (root1 < root2) m_cellIdToParentVec[root2] = root1;
+  else if (root2 < root1) m_cellIdToParentVec[root1] = root2;
 }
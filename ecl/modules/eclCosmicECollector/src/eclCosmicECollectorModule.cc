@@ -14,7 +14,7 @@
 #include <ecl/dataobjects/ECLElementNumbers.h>
 #include <ecl/dbobjects/ECLCrystalCalib.h>
 #include <ecl/geometry/ECLGeometryPar.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 /* Basf2 headers. */
 #include <framework/dataobjects/EventMetaData.h>
@@ -221,10 +221,10 @@ void eclCosmicECollectorModule::prepare()
   /** Bulk of the ECL uses the neighbour code to find pairs of nearest neighbours. Excludes first and last ThetaID.  */
 
   /** Roughly four nearest neighbours, plus crystal itself. cellID starts from 1 in ECLNeighbours */
-  ECLNeighbours* myNeighbours4 = new ECLNeighbours("F", 0.95);
+  const ECLNeighbourMap& myNeighbours4 = ECLNeighbourMap::get("F", 0.95);
 
   for (int crysID = firstCrystal[1]; crysID < firstCrystal[68]; crysID++) {
-    std::vector<short int> neighbours = myNeighbours4->getNeighbours(crysID + 1);
+    const ECLNeighbourMap::Range neighbours = myNeighbours4.getNeighbours(crysID + 1);
 
     /** Find the two neighbours in the same Theta ring, and record neighbours in adjacent theta rings */
     int nA = -1;
@@ -13,6 +13,7 @@
 #include <ecl/dbobjects/ECLDigitWaveformParametersForMC.h>
 #include <ecl/digitization/EclConfiguration.h>
 #include <ecl/mapper/ECLChannelMapper.h>
+#include <ecl/utility/ECLDspEmulator.h>
 
 /* Basf2 headers. */
 #include <framework/core/Module.h>
@@ -137,18 +138,53 @@ namespace Belle2 {
     /** Storage for calibration constants */
     std::vector<calibration_t> m_calib;
 
+    /** Channels for which the electronic noise is generated in bulk */
+    std::vector<int> m_noiseChannels;
+
+    /** Uniform and standard normal random numbers for the bulk noise generation */
+    std::vector<double> m_randomNumbers;
+
+    /** Noise waveforms with pedestal for m_noiseChannels, 31 samples each */
+    std::vector<int> m_noiseWaveforms;
+
     /** Storage for waveform saving thresholds*/
     std::vector<double> m_Awave;
 
+    /** Bounds of the DSP amplitude estimates of one fit parameter set for the sparse digitization */
+    struct sparsebound_t {
+      long long pedestal; /**< largest |sum of the coefficients|, multiplies the sum of the smallest and largest sample */
+      long long range;    /**< largest sum of the |coefficients|, multiplies the range of the samples */
+      long long limit;    /**< twice the largest weighted sum which is rounded to at most m_ADCThreshold */
+    };
+    /** Amplitude bounds for each element of m_fitparams */
+    std::vector<sparsebound_t> m_sparseBounds;
+
     /** storage for trigger time in each ECL. The crate trigger time
      *  is an even number from 0 to 142, so here it is stored as
      *  numbers from 0 to 71 inclusive.
      */
     unsigned char m_ttime[ECL::ECL_CRATES] = {};
 
-    /** function wrapper for waveform fit */
-    void shapeFitterWrapper(const int j, const int* FitA, const int m_ttrig,
-                            int& m_lar, int& m_ltr, int& m_lq, int& m_chi) const ;
+    /** Channels [0-8735] with waveforms to fit in the current event */
+    std::vector<int> m_fitChannels;
+
+    /** Trigger times of m_fitChannels */
+    std::vector<int> m_fitTriggers;
+
+    /** Waveforms of m_fitChannels, 31 samples each */
+    std::vector<int> m_fitWaveforms;
+
+    /** Input of the batched waveform fit */
+    std::vector<ECL::ECLShapeFitInput<int>> m_fitInputs;
+
+    /** Results of the waveform fit, kept to reuse their memory */
+    std::vector<ECL::ECLShapeFit> m_fitResults;
+
+    /** function wrapper for waveform fit of all m_fitChannels */
+    void fitWaveforms();
+
+    /** chi^2 with the precision of the raw data */
+    static int getRawDataChi2(int chi);
 
     /** Always load waveform parameters at least once */
     bool m_loadOnce = true;
@@ -168,6 +204,12 @@ namespace Belle2 {
     void getfitparams(const ECLWaveformData&, const ECLWFAlgoParams&, fitparams_t&);
     /** fill the waveform array FitA by electronic noise and bias it for channel J [0-8735]*/
     void makeElectronicNoiseAndPedestal(int j, int* FitA);
+    /** fill m_noiseWaveforms with electronic noise and pedestal for all given channels at once */
+    void makeElectronicNoiseAndPedestal(const std::vector<int>& channels);
+    /** compute m_sparseBounds from the fit coefficients and m_ADCThreshold and report them relative to the noise */
+    void makeSparseBounds();
+    /** check if no DSP amplitude estimate of the waveform FitA of channel j [0-8735] can exceed m_ADCThreshold */
+    bool isBelowADCThreshold(int j, const int* FitA) const;
 
     /** Hadron signal shapes. */
     DBObjPtr<ECLDigitWaveformParametersForMC> m_waveformParametersMC;
@@ -249,6 +291,7 @@ namespace Belle2 {
     bool m_trigTime; /**< Use trigger time from beam background overlay */
     std::string m_eclWaveformsName;   /**< name of background waveforms storage*/
     bool m_HadronPulseShape; /**< hadron pulse shape flag */
+    bool m_sparse; /**< fit only channels with signal or with overlay waveforms which can exceed m_ADCThreshold */
 
     bool m_dspDataTest; /**< DSP data usage flag */
     /** If true, use m_waveformParameters, m_algoParameters, m_noiseParameters.
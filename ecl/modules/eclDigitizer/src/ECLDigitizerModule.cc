@@ -34,6 +34,10 @@
 #include <TRandom.h>
 #include <TTree.h>
 
+/* C++ headers. */
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 using namespace Belle2;
 using namespace ECL;
@@ -68,6 +72,10 @@ ECLDigitizerModule::ECLDigitizerModule() : Module(), m_waveformParametersMC("ECL
   addParam("HadronPulseShapes", m_HadronPulseShape, "Flag to include hadron component in pulse shape construction (default: true)",
            true);
   addParam("ADCThreshold", m_ADCThreshold, "ADC threshold for waveform fits (default: 25)", 25);
+  addParam("SparseDigitization", m_sparse,
+           "Generate the electronic noise of all channels with signal in one go and, with background overlay, "
+           "skip the waveform fit of overlay waveforms without signal whose samples are too close to each other to "
+           "give an amplitude above ADCThreshold. The output is identical to the one without it (default: false)", false);
   addParam("WaveformThresholdOverride", m_WaveformThresholdOverride,
            "If gt 0 value is applied to all crystals for waveform saving threshold. If lt 0 dbobject is used. (GeV)", -1.0);
   addParam("StoreDspWithExtraMCInfo", m_storeDspWithExtraMCInfo,
@@ -185,76 +193,84 @@ void ECLDigitizerModule::beginRun()
   }
 }
 
-// interface to C shape fitting function function
-void ECLDigitizerModule::shapeFitterWrapper(const int j, const int* FitA, const int ttrig,
-                                            int& m_lar, int& m_ltr, int& m_lq, int& m_chi) const
+// interface to C shape fitting function, fits all collected waveforms
+void ECLDigitizerModule::fitWaveforms()
 {
-  const crystallinks_t& t = m_tbl[j]; //lookup table [0,8735]
-  const fitparams_t& r = m_fitparams[t.ifunc];
-
-  ECLShapeFit result;
+  const EclConfiguration& ec = EclConfiguration::get();
+  const int n = m_fitChannels.size();
+  // the results are kept between events to reuse their memory
+  if (m_fitResults.size() < m_fitChannels.size()) m_fitResults.resize(n);
 
   if (!m_dspDataTest) {
-    short int* id = (short int*)m_idn[t.idn].id;
-
-    int A0  = (int) * (id + 0) - 128;
-    int Askip  = (int) * (id + 1) - 128;
-
-    int Ahard  = (int) * (id + 2);
-    int k_a = (int) * ((unsigned char*)id + 26);
-    int k_b = (int) * ((unsigned char*)id + 27);
-    int k_c = (int) * ((unsigned char*)id + 28);
-    int k_16 = (int) * ((unsigned char*)id + 29);
-    int k1_chi = (int) * ((unsigned char*)id + 24);
-    int k2_chi = (int) * ((unsigned char*)id + 25);
-
-    int chi_thres = (int) * (id + 15);
-
-    int trg_time = ttrig;
-
-    result = lftda_((int*)r.f, (int*)r.f1, (int*)r.fg41, (int*)r.fg43,
-                    (int*)r.fg31, (int*)r.fg32, (int*)r.fg33, (int*)FitA,
-                    trg_time, A0, Ahard, Askip, k_a, k_b, k_c, k_16, k1_chi,
-                    k2_chi, chi_thres);
+    m_fitInputs.resize(n);
+    for (int k = 0; k < n; k++) {
+      const crystallinks_t& t = m_tbl[m_fitChannels[k]]; //lookup table [0,8735]
+      const fitparams_t& r = m_fitparams[t.ifunc];
+      short int* id = (short int*)m_idn[t.idn].id;
+
+      ECLShapeFitInput<int>& in = m_fitInputs[k];
+      in.f = (int*)r.f;
+      in.f1 = (int*)r.f1;
+      in.fg41 = (int*)r.fg41;
+      in.fg43 = (int*)r.fg43;
+      in.fg31 = (int*)r.fg31;
+      in.fg32 = (int*)r.fg32;
+      in.fg33 = (int*)r.fg33;
+      in.y = &m_fitWaveforms[k * ec.m_nsmp];
+      in.ttrig2 = m_fitTriggers[k];
+      in.la_thr = (int) * (id + 0) - 128;
+      in.skip_thr = (int) * (id + 1) - 128;
+      in.hit_thr = (int) * (id + 2);
+      in.k_a = (int) * ((unsigned char*)id + 26);
+      in.k_b = (int) * ((unsigned char*)id + 27);
+      in.k_c = (int) * ((unsigned char*)id + 28);
+      in.k_16 = (int) * ((unsigned char*)id + 29);
+      in.k1_chi = (int) * ((unsigned char*)id + 24);
+      in.k2_chi = (int) * ((unsigned char*)id + 25);
+      in.chi_thres = (int) * (id + 15);
+    }
+    lftdaBatch_(m_fitInputs.data(), m_fitResults.data(), n);
   } else {
-    std::vector<int> adc(31);
-    for (int i = 0; i < 31; i++) adc[i] = FitA[i];
-    // NOTE: ttrig_packed is any even number in set {8*Z, 8*Z + 2, 8*Z + 4}
-    //       where Z is an integer number in 0..23 range
-    // ttrig = ttrig_packed - 2 * (ttrig_packed / 8);
-    // ttrig = 6*Z + q
-    int ttrig_packed = ttrig / 6 * 8 + ttrig % 6;
-    result = ECLDspUtilities::shapeFitter(j + 1, adc, ttrig_packed);
+    for (int k = 0; k < n; k++) {
+      const int* FitA = &m_fitWaveforms[k * ec.m_nsmp];
+      std::vector<int> adc(FitA, FitA + ec.m_nsmp);
+      // NOTE: ttrig_packed is any even number in set {8*Z, 8*Z + 2, 8*Z + 4}
+      //       where Z is an integer number in 0..23 range
+      // ttrig = ttrig_packed - 2 * (ttrig_packed / 8);
+      // ttrig = 6*Z + q
+      const int ttrig = m_fitTriggers[k];
+      int ttrig_packed = ttrig / 6 * 8 + ttrig % 6;
+      m_fitResults[k] = ECLDspUtilities::shapeFitter(m_fitChannels[k] + 1, adc, ttrig_packed);
+    }
   }
+}
 
-  m_lar = result.amp;
-  m_ltr = result.time;
-  m_lq  = result.quality;
-  m_chi = result.chi2;
-
+int ECLDigitizerModule::getRawDataChi2(int chi)
+{
   //== Set precision of chi^2 to be the same as in the raw data.
   int discarded_bits = 0;
-  if ((m_chi & 0x7800000) != 0) {
-    m_chi = 0x7800000;
-  } else if ((m_chi & 0x0600000) != 0) {
+  if ((chi & 0x7800000) != 0) {
+    chi = 0x7800000;
+  } else if ((chi & 0x0600000) != 0) {
     discarded_bits = 14;
-  } else if ((m_chi & 0x0180000) != 0) {
+  } else if ((chi & 0x0180000) != 0) {
     discarded_bits = 12;
-  } else if ((m_chi & 0x0060000) != 0) {
+  } else if ((chi & 0x0060000) != 0) {
     discarded_bits = 10;
-  } else if ((m_chi & 0x0018000) != 0) {
+  } else if ((chi & 0x0018000) != 0) {
     discarded_bits = 8;
-  } else if ((m_chi & 0x0006000) != 0) {
+  } else if ((chi & 0x0006000) != 0) {
     discarded_bits = 6;
-  } else if ((m_chi & 0x0001800) != 0) {
+  } else if ((chi & 0x0001800) != 0) {
     discarded_bits = 4;
-  } else if ((m_chi & 0x0000600) != 0) {
+  } else if ((chi & 0x0000600) != 0) {
     discarded_bits = 2;
   }
   if (discarded_bits > 0) {
-    m_chi >>= discarded_bits;
-    m_chi <<= discarded_bits;
+    chi >>= discarded_bits;
+    chi <<= discarded_bits;
   }
+  return chi;
 }
 
 void ECLDigitizerModule::shapeSignals()
@@ -357,6 +373,105 @@ void ECLDigitizerModule::makeElectronicNoiseAndPedestal(int J, int* FitA)
   for (int i = 0; i < ec.m_nsmp; i++) FitA[i] = 20 * AdcNoise[i] + 3000;
 }
 
+void ECLDigitizerModule::makeElectronicNoiseAndPedestal(const std::vector<int>& channels)
+{
+  const EclConfiguration& ec = EclConfiguration::get();
+  const int nsmp = ec.m_nsmp;
+
+  // standard normal numbers for all channels from pairs of uniform
+  // numbers with the Box-Muller transformation: the first half of the
+  // buffer provides the radii, the second half the angles
+  const int npairs = (channels.size() * nsmp + 1) / 2;
+  m_randomNumbers.resize(2 * npairs);
+  double* u = m_randomNumbers.data();
+  gRandom->RndmArray(2 * npairs, u);
+  #pragma omp simd
+  for (int i = 0; i < npairs; i++) {
+    const double r = sqrt(-2 * log(u[i])), phi = 2 * M_PI * u[npairs + i];
+    u[i] = r * cos(phi);
+    u[npairs + i] = r * sin(phi);
+  }
+
+  // correlate them with the lower triangular (Cholesky) factor of the
+  // covariance matrix of each channel
+  m_noiseWaveforms.resize(channels.size() * nsmp);
+  float z[nsmp], AdcNoise[nsmp];
+  for (size_t k = 0; k < channels.size(); k++) {
+    for (int i = 0; i < nsmp; i++) z[i] = u[k * nsmp + i];
+    m_noise[m_tbl[channels[k]].inoise].generateCorrelatedNoise(z, AdcNoise);
+    int* FitA = &m_noiseWaveforms[k * nsmp];
+    for (int i = 0; i < nsmp; i++) FitA[i] = 20 * AdcNoise[i] + 3000;
+  }
+}
+
+void ECLDigitizerModule::makeSparseBounds()
+{
+  // Every amplitude the DSP can return below the overflow is rounded from a
+  // weighted sum c[0] * (y[0] + ... + y[15]) + c[1] * y[16] + ... + c[15] * y[30]
+  // with the coefficients of one time index of fg41 or fg31. Writing the
+  // samples as y = (min + max) / 2 + d with |d| <= (max - min) / 2 gives
+  // 2 |sum| <= |S| * (min + max) + K * (max - min), S being the sum of the
+  // coefficients (close to 0, the pedestal cancels) and K the sum of their
+  // absolute values. The rounded amplitude (sum + 2^(k_a - 1)) >> k_a does not
+  // exceed m_ADCThreshold if 2 sum < (2 m_ADCThreshold + 1) 2^k_a.
+  const int n_16 = 16;
+  m_sparseBounds.assign(m_fitparams.size(), {0, 0, 0});
+  for (int j = 0; j < EclConfiguration::m_nch; j++) {
+    const crystallinks_t& t = m_tbl[j];
+    sparsebound_t& b = m_sparseBounds[t.ifunc];
+    if (b.limit != 0) continue;
+    const fitparams_t& r = m_fitparams[t.ifunc];
+    auto addCoefficients = [&b](const int* c) {
+      long long S = n_16 * c[0], K = n_16 * abs(c[0]);
+      for (int i = 1; i < 16; i++) {
+        S += c[i];
+        K += abs(c[i]);
+      }
+      b.pedestal = max(b.pedestal, abs(S));
+      b.range = max(b.range, K);
+    };
+    for (const auto& c : r.fg41) addCoefficients(c);
+    for (const auto& c : r.fg31) addCoefficients(c);
+    const int k_a = m_idn[t.idn].ic[26];
+    b.limit = (2LL * m_ADCThreshold + 1) * (1LL << k_a);
+  }
+
+  if (!m_sparse) return;
+  // The bound only saves time if pure noise waveforms fall below it: report the
+  // sample range allowed at the nominal pedestal of 3000 ADC counts in units of
+  // the noise of the single samples, the range of 31 independent normal
+  // samples is 4.9 sigma on average.
+  const int pedestal = 3000;
+  double sumRatio = 0;
+  int nNoisy = 0;
+  for (int j = 0; j < EclConfiguration::m_nch; j++) {
+    const sparsebound_t& b = m_sparseBounds[m_tbl[j].ifunc];
+    const ECLNoiseData& noise = m_noise[m_tbl[j].inoise];
+    double sigma = 0;
+    for (int i = 0, k = 0; i < EclConfiguration::m_nsmp; i++) {
+      double variance = 0;
+      for (int l = 0; l <= i; l++, k++) variance += pow(noise.getMatrixElement(k), 2);
+      sigma = max(sigma, 20 * sqrt(variance));
+    }
+    const double range = double(b.limit - 2 * pedestal * b.pedestal) / b.range;
+    const double ratio = sigma > 0 and b.range > 0 ? range / sigma : 0;
+    sumRatio += ratio;
+    if (ratio < 4) nNoisy++;
+  }
+  B2INFO("ECLDigitizer: overlay waveforms without signal are skipped below a sample range of "
+         << sumRatio / EclConfiguration::m_nch << " noise sigma on average for ADCThreshold " << m_ADCThreshold
+         << ", " << nNoisy << " channels allow less than 4 sigma");
+}
+
+bool ECLDigitizerModule::isBelowADCThreshold(int j, const int* FitA) const
+{
+  // all 31 samples enter, so pulses in the pedestal region are not lost
+  const EclConfiguration& ec = EclConfiguration::get();
+  const auto [lo, hi] = std::minmax_element(FitA, FitA + ec.m_nsmp);
+  const sparsebound_t& b = m_sparseBounds[m_tbl[j].ifunc];
+  return b.pedestal * (*lo + *hi) + b.range * (*hi - *lo) < b.limit;
+}
+
 void ECLDigitizerModule::makeWaveforms()
 {
   const EclConfiguration& ec = EclConfiguration::get();
@@ -367,10 +482,18 @@ void ECLDigitizerModule::makeWaveforms()
     B2FATAL("Unknown compression algorithm: " << m_compAlgo);
 
   int FitA[ec.m_nsmp]; // buffer for the waveform fitter
+  if (m_sparse) {
+    m_noiseChannels.resize(ec.m_nch);
+    for (int j = 0; j < ec.m_nch; j++) m_noiseChannels[j] = j;
+    makeElectronicNoiseAndPedestal(m_noiseChannels);
+  }
   // loop over entire calorimeter
   for (int j = 0; j < ec.m_nch; j++) {
     adccounts_t& a = m_adc[j];
-    makeElectronicNoiseAndPedestal(j, FitA);
+    if (m_sparse)
+      std::copy_n(&m_noiseWaveforms[j * ec.m_nsmp], ec.m_nsmp, FitA);
+    else
+      makeElectronicNoiseAndPedestal(j, FitA);
     for (int  i = 0; i < ec.m_nsmp; i++) {
       int A = 20000 * a.c[i] + FitA[i];
       FitA[i] = max(0, min(A, (1 << 18) - 1));
@@ -442,6 +565,21 @@ void ECLDigitizerModule::event()
 
   int FitA[ec.m_nsmp]; // buffer for the waveform fitter
 
+  // in the sparse digitization the noise of all channels with signal is
+  // generated before the loop
+  size_t iNoise = 0;
+  if (m_sparse and !isBGOverlay) {
+    m_noiseChannels.clear();
+    for (int j = 0; j < ec.m_nch; j++)
+      if (m_adc[j].total >= 0.0001) m_noiseChannels.push_back(j);
+    makeElectronicNoiseAndPedestal(m_noiseChannels);
+  }
+
+  // collect the waveforms to fit
+  m_fitChannels.clear();
+  m_fitTriggers.clear();
+  m_fitWaveforms.clear();
+
   // loop over entire calorimeter
   for (int j = 0; j < ec.m_nch; j++) {
     adccounts_t& a = m_adc[j];
@@ -460,7 +598,10 @@ void ECLDigitizerModule::event()
     } else {
       // Signal amplitude should be above 100 keV
       if (a.total < 0.0001) continue;
-      makeElectronicNoiseAndPedestal(j, FitA);
+      if (m_sparse)
+        std::copy_n(&m_noiseWaveforms[ec.m_nsmp * iNoise++], ec.m_nsmp, FitA);
+      else
+        makeElectronicNoiseAndPedestal(j, FitA);
     }
 
     for (int i = 0; i < ec.m_nsmp; i++) {
@@ -468,15 +609,31 @@ void ECLDigitizerModule::event()
       FitA[i] = max(0, min(A, (1 << 18) - 1));
     }
 
-    int  energyFit = 0; // fit output : Amplitude 18 bits
-    int       tFit = 0; // fit output : T_ave     12 bits
-    int qualityFit = 0; // fit output : quality    2 bits
-    int        chi = 0; // fit output : chi square   it is not available in the experiment
+    // the DSP emulation is skipped for overlay channels without signal
+    // which cannot give an amplitude above the ADC threshold; the DSP
+    // coefficients from the database are not covered by the bounds
+    if (m_sparse and isBGOverlay and !m_dspDataTest and a.total < 0.0001 and isBelowADCThreshold(j, FitA)) continue;
 
     int id = m_eclMapper.getCrateID(j + 1) - 1; // 0 .. 51
-    int ttrig = 2 * m_ttime[id];
+    m_fitChannels.push_back(j);
+    m_fitTriggers.push_back(2 * m_ttime[id]);
+    m_fitWaveforms.insert(m_fitWaveforms.end(), FitA, FitA + ec.m_nsmp);
+  }
+
+  // run the DSP emulation for all channels at once
+  fitWaveforms();
 
-    shapeFitterWrapper(j, FitA, ttrig, energyFit, tFit, qualityFit, chi);
+  // store the fit results in the order of the channels
+  for (size_t k = 0; k < m_fitChannels.size(); k++) {
+    const int j = m_fitChannels[k];
+    const adccounts_t& a = m_adc[j];
+    int* DspA = &m_fitWaveforms[k * ec.m_nsmp];
+
+    const ECLShapeFit& result = m_fitResults[k];
+    int  energyFit = result.amp;     // fit output : Amplitude 18 bits
+    int       tFit = result.time;    // fit output : T_ave     12 bits
+    int qualityFit = result.quality; // fit output : quality    2 bits
+    int        chi = getRawDataChi2(result.chi2); // fit output : chi square   it is not available in the experiment
 
     if (energyFit > m_ADCThreshold) {
       int CellId = j + 1;
@@ -486,14 +643,14 @@ void ECLDigitizerModule::event()
         //only save waveforms above ADC threshold
         const auto eclDsp = m_eclDsps.appendNew();
         eclDsp->setCellId(CellId);
-        eclDsp->setDspA(FitA);
+        eclDsp->setDspA(DspA);
       }
 
       // only store extra MC info if requested and above threshold
       if (m_storeDspWithExtraMCInfo and  a.totalDep >= m_DspWithExtraMCInfoThreshold) {
         const auto eclDspWithExtraMCInfo = m_eclDspsWithExtraMCInfo.appendNew();
         eclDspWithExtraMCInfo->setCellId(CellId);
-        eclDspWithExtraMCInfo->setDspA(FitA);
+        eclDspWithExtraMCInfo->setDspA(DspA);
         eclDspWithExtraMCInfo->setEnergyDep(a.totalDep);
         eclDspWithExtraMCInfo->setHadronEnergyDep(a.totalHadronDep);
         eclDspWithExtraMCInfo->setFlightTime(a.flighttime);
@@ -709,6 +866,8 @@ void ECLDigitizerModule::readDSPDB()
 
   if (eclWFData) delete eclWFData;
 
+  makeSparseBounds();
+
   if (!m_useWaveformParameters) rootfile->Close();
 }
 
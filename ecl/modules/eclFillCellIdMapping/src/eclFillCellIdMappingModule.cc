@@ -13,7 +13,7 @@
 #include <ecl/dataobjects/ECLCalDigit.h>
 #include <ecl/dataobjects/ECLCellIdMapping.h>
 #include <ecl/dataobjects/ECLElementNumbers.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 #include <ecl/geometry/ECLGeometryPar.h>
 
 /* Basf2 headers. */
@@ -44,10 +44,10 @@ void ECLFillCellIdMappingModule::initialize()
   m_eclCellIdMapping.registerInDataStore();
 
   // make neighbourmap
-  m_NeighbourMap5 = new ECLNeighbours("N", 2, true); //sort them for ecl variable getters
-  m_NeighbourMap7 = new ECLNeighbours("N", 3, true); //sort them for ecl variable getters
-  m_NeighbourMap9  = new ECLNeighbours("N", 4, true); //sort them for ecl variable getters
-  m_NeighbourMap11 = new ECLNeighbours("N", 5, true); //sort them for ecl variable getters
+  m_NeighbourMap5 = &ECLNeighbourMap::get("N", 2, true).getECLNeighbours(); //sort them for ecl variable getters
+  m_NeighbourMap7 = &ECLNeighbourMap::get("N", 3, true).getECLNeighbours(); //sort them for ecl variable getters
+  m_NeighbourMap9  = &ECLNeighbourMap::get("N", 4, true).getECLNeighbours(); //sort them for ecl variable getters
+  m_NeighbourMap11 = &ECLNeighbourMap::get("N", 5, true).getECLNeighbours(); //sort them for ecl variable getters
 
   // get phi, theta, phiid, thetaid values
   m_CellIdToPhi.resize(ECLElementNumbers::c_NCrystals + 1);
@@ -97,8 +97,4 @@ void ECLFillCellIdMappingModule::event()
 
 void ECLFillCellIdMappingModule::terminate()
 {
-  if (m_NeighbourMap5) delete m_NeighbourMap5;
-  if (m_NeighbourMap7) delete m_NeighbourMap7;
-  if (m_NeighbourMap9) delete m_NeighbourMap9;
-  if (m_NeighbourMap11) delete m_NeighbourMap11;
 }
@@ -29,7 +29,7 @@ namespace Belle2 {
   class ECLConnectedRegion;
 
   namespace ECL {
-    class ECLNeighbours;
+    class ECLNeighbourMap;
     class ECLGeometryPar;
   }
 
@@ -146,7 +146,7 @@ namespace Belle2 {
     std::vector< int > m_StoreArrPosition;
 
     /** Neighbour maps. */
-    ECL::ECLNeighbours* m_neighbourMap{nullptr};
+    const ECL::ECLNeighbourMap* m_neighbourMap{nullptr};
 
     /** Geometry */
     ECL::ECLGeometryPar* m_geom{nullptr};
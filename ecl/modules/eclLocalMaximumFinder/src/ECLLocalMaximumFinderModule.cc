@@ -17,7 +17,7 @@
 #include <ecl/dataobjects/ECLHit.h>
 #include <ecl/dataobjects/ECLLocalMaximum.h>
 #include <ecl/geometry/ECLGeometryPar.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 /* ROOT headers. */
 #include <TFile.h>
@@ -106,7 +106,7 @@ void ECLLocalMaximumFinderModule::initialize()
   m_geom = ECLGeometryPar::Instance();
 
   // Initialize neighbour map.
-  m_neighbourMap = new ECLNeighbours("N", 1);
+  m_neighbourMap = &ECLNeighbourMap::get("N", 1);
 
   // Reset all variables.
   resetClassifierVariables();
@@ -373,8 +373,6 @@ void ECLLocalMaximumFinderModule::terminate()
     delete m_outfile;
   }
 
-  if (m_neighbourMap) delete m_neighbourMap;
-
 }
 
 void ECLLocalMaximumFinderModule::makeLocalMaximum(const ECLConnectedRegion& aCR, const int cellId, const int lmId)
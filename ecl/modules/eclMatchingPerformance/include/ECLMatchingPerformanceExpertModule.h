@@ -9,7 +9,7 @@
 
 /* ECL headers. */
 #include <ecl/dataobjects/ECLCalDigit.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 /* Basf2 headers. */
 #include <framework/core/Module.h>
@@ -68,9 +68,9 @@ namespace Belle2 {
     /** Event metadata. */
     StoreObjPtr<EventMetaData> m_EventMetaData;
 
-    ECL::ECLNeighbours* m_eclNeighbours1x1{nullptr}; /**< Neighbour map of 1 crystal */
-    ECL::ECLNeighbours* m_eclNeighbours3x3{nullptr}; /**< Neighbour map of 9 crystals */
-    ECL::ECLNeighbours* m_eclNeighbours5x5{nullptr}; /**< Neighbour map of 25 crystals */
+    const ECL::ECLNeighbourMap* m_eclNeighbours1x1{nullptr}; /**< Neighbour map of 1 crystal */
+    const ECL::ECLNeighbourMap* m_eclNeighbours3x3{nullptr}; /**< Neighbour map of 9 crystals */
+    const ECL::ECLNeighbourMap* m_eclNeighbours5x5{nullptr}; /**< Neighbour map of 25 crystals */
 
     TFile* m_outputFile{nullptr}; /**< output root file */
     TTree* m_dataTree{nullptr}; /**< root tree with all output data. Tree will be written to the output root file */
@@ -186,7 +186,7 @@ namespace Belle2 {
     void addVariableToTree(const std::string& varName, int& varReference);
 
     /** find a match between crystals in which energy was deposited and the cell or its neighbors that a track entered  */
-    void findECLCalDigitMatchInNeighbouringCell(ECL::ECLNeighbours* eclneighbours, int& matchedToNeighbours, const int& cell);
+    void findECLCalDigitMatchInNeighbouringCell(const ECL::ECLNeighbourMap* eclneighbours, int& matchedToNeighbours, const int& cell);
 
     /** determine whether energy has been deposited in crystal with ID cell and write result to matched */
     void findECLCalDigitMatch(const int& cell, int& matched);
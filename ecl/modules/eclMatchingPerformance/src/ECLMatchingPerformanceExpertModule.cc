@@ -54,9 +54,9 @@ void ECLMatchingPerformanceExpertModule::initialize()
   m_extHits.isRequired();
   m_eclCalDigits.isRequired();
 
-  m_eclNeighbours1x1 = new ECL::ECLNeighbours("N", 0);
-  m_eclNeighbours3x3 = new ECL::ECLNeighbours("N", 1);
-  m_eclNeighbours5x5 = new ECL::ECLNeighbours("N", 2);
+  m_eclNeighbours1x1 = &ECL::ECLNeighbourMap::get("N", 0);
+  m_eclNeighbours3x3 = &ECL::ECLNeighbourMap::get("N", 1);
+  m_eclNeighbours5x5 = &ECL::ECLNeighbourMap::get("N", 2);
 
   m_outputFile = new TFile(m_outputFileName.c_str(), "RECREATE");
   TDirectory* oldDir = gDirectory;
@@ -246,9 +246,6 @@ void ECLMatchingPerformanceExpertModule::event()
 void ECLMatchingPerformanceExpertModule::terminate()
 {
   writeData();
-  delete m_eclNeighbours1x1;
-  delete m_eclNeighbours3x3;
-  delete m_eclNeighbours5x5;
 }
 
 void ECLMatchingPerformanceExpertModule::setupTree()
@@ -395,7 +392,7 @@ void ECLMatchingPerformanceExpertModule::addVariableToTree(const std::string& va
   m_dataTree->Branch(varName.c_str(), &varReference, leaf.str().c_str());
 }
 
-void ECLMatchingPerformanceExpertModule::findECLCalDigitMatchInNeighbouringCell(ECL::ECLNeighbours* eclneighbours,
+void ECLMatchingPerformanceExpertModule::findECLCalDigitMatchInNeighbouringCell(const ECL::ECLNeighbourMap* eclneighbours,
     int& matchedToNeighbours, const int& cell)
 {
   const auto& vec_of_neighbouring_cells = eclneighbours->getNeighbours(cell);
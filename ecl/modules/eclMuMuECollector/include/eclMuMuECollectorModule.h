@@ -23,7 +23,7 @@ namespace Belle2 {
   class TRGSummary;
 
   namespace ECL {
-    class ECLNeighbours;
+    class ECLNeighbourMap;
   }
 
   /** Calibration collector module that uses muon pairs to do ECL single crystal energy calibration */
@@ -54,8 +54,8 @@ namespace Belle2 {
     /** Neighbours of each ECL crystal. 4 Neighbours for barrel and outer endcap; ;~8 otherwise */
     int firstcellIDN4 = 1009; /**< first cellID where we only need 4 neighbours */
     int lastcellIDN4 = 7920; /**< last cellID where we only need 4 neighbours */
-    ECL::ECLNeighbours* myNeighbours4{nullptr}; /**< class to return 4 nearest neighbours to crystal */
-    ECL::ECLNeighbours* myNeighbours8{nullptr}; /**< class to return 8 nearest neighbours to crystal */
+    const ECL::ECLNeighbourMap* myNeighbours4{nullptr}; /**< class to return 4 nearest neighbours to crystal */
+    const ECL::ECLNeighbourMap* myNeighbours8{nullptr}; /**< class to return 8 nearest neighbours to crystal */
 
     /** Required arrays */
     StoreArray<Track> m_trackArray; /**< Required input array of tracks */
@@ -13,7 +13,7 @@
 #include <ecl/dataobjects/ECLDigit.h>
 #include <ecl/dataobjects/ECLElementNumbers.h>
 #include <ecl/dbobjects/ECLCrystalCalib.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 /* Basf2 headers. */
 #include <framework/dataobjects/EventMetaData.h>
@@ -117,8 +117,8 @@ void eclMuMuECollectorModule::prepare()
 
   //------------------------------------------------------------------------
   /** Four or ~eight nearest neighbours, plus crystal itself. ECLNeighbour uses cellID, 1--8736 */
-  myNeighbours4 = new ECLNeighbours("NC", 1);
-  myNeighbours8 = new ECLNeighbours("N", 1);
+  myNeighbours4 = &ECLNeighbourMap::get("NC", 1);
+  myNeighbours8 = &ECLNeighbourMap::get("N", 1);
 
 
   //------------------------------------------------------------------------
@@ -22,7 +22,7 @@ namespace Belle2 {
   class MCParticle;
 
   namespace ECL {
-    class ECLNeighbours;
+    class ECLNeighbourMap;
   }
 
   /** Collector that runs on single photon MC samples to find the number
@@ -70,7 +70,7 @@ namespace Belle2 {
     int nCrystalGroups; /**< sort the crystals into this many groups */
     int iGroupOfCrystal[ECLElementNumbers::c_NCrystals]; /**< group number of each crystal */
 
-    ECL::ECLNeighbours* neighbours{nullptr}; /**< neighbours to crystal */
+    const ECL::ECLNeighbourMap* neighbours{nullptr}; /**< neighbours to crystal */
     std::vector<int> thetaIDofCrysID; /**< thetaID of each crystal */
 
     bool storeParameters = true; /**< store parameters first event */
@@ -12,7 +12,7 @@
 /* ECL headers. */
 #include <ecl/dataobjects/ECLCalDigit.h>
 #include <ecl/dataobjects/ECLShower.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 /* Basf2 headers. */
 #include <mdst/dataobjects/MCParticle.h>
@@ -87,7 +87,7 @@ void eclNOptimalCollectorModule::prepare()
   //..Sort the crystals into groups of similar performance
 
   //..Record the thetaID of each cellID
-  neighbours = new ECLNeighbours("N", 1);
+  neighbours = &ECLNeighbourMap::get("N", 1);
   std::vector<int> nCrysPerRing;
   for (int thID = 0; thID < 69; thID++) {
     const int nCrys = neighbours->getCrystalsPerRing(thID);
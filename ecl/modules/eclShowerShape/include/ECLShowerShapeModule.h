@@ -33,7 +33,7 @@ namespace Belle2 {
   }
 
   namespace ECL {
-    class ECLNeighbours;
+    class ECLNeighbourMap;
   }
 
   /** Class to perform the shower correction */
@@ -114,10 +114,10 @@ namespace Belle2 {
     m_dataset; /**< Pointer to the current dataset. It is assumed it holds 22 entries, 11 Zernike moments of N2 shower, followed by 11 Zernike moments of N1 shower. */
 
     /** Neighbour map 9 neighbours, for E9oE21 and E1oE9. */
-    std::unique_ptr<ECL::ECLNeighbours> m_neighbourMap9;
+    const ECL::ECLNeighbourMap* m_neighbourMap9{nullptr};
 
     /** Neighbour map 21 neighbours, for E9oE21. */
-    std::unique_ptr<ECL::ECLNeighbours> m_neighbourMap21;
+    const ECL::ECLNeighbourMap* m_neighbourMap21{nullptr};
 
     /** initialize MVA weight files from DB
      */
@@ -31,7 +31,7 @@
 #include <ecl/dataobjects/ECLConnectedRegion.h>
 #include <ecl/geometry/ECLGeometryPar.h>
 #include <ecl/dataobjects/ECLShower.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 #include <ecl/dbobjects/ECLShowerShapeSecondMomentCorrection.h>
 
 using namespace Belle2;
@@ -105,8 +105,8 @@ void ECLShowerShapeModule::initialize()
   eclShowers.requireRelationTo(eclCalDigits);
 
   // Initialize neighbour maps.
-  m_neighbourMap9 = std::unique_ptr<ECL::ECLNeighbours>(new ECL::ECLNeighbours("N", 1));
-  m_neighbourMap21 = std::unique_ptr<ECL::ECLNeighbours>(new ECL::ECLNeighbours("NC", 2));
+  m_neighbourMap9 = &ECL::ECLNeighbourMap::get("N", 1);
+  m_neighbourMap21 = &ECL::ECLNeighbourMap::get("NC", 2);
 
   initializeMVAweightFiles(m_zernike_MVAidentifier_FWD, m_weightfile_representation_FWD);
   initializeMVAweightFiles(m_zernike_MVAidentifier_BRL, m_weightfile_representation_BRL);
@@ -485,7 +485,7 @@ double ECLShowerShapeModule::computeE1oE9(const ECLShower& shower) const
   if (centralCellId == 0) return 0.0; //cell id starts at 1
 
   // get list of 9 neighbour ids
-  const std::vector< short int > n9 = m_neighbourMap9->getNeighbours(centralCellId);
+  const ECL::ECLNeighbourMap::Range n9 = m_neighbourMap9->getNeighbours(centralCellId);
 
   double energy1 = 0.0; // to check: 'highest energy' data member may not always be the right one
   double energy9 = 0.0;
@@ -522,8 +522,8 @@ double ECLShowerShapeModule::computeE9oE21(const ECLShower& shower) const
   if (centralCellId == 0) return 0.0; //cell id starts at 1
 
   // get list of 9 and 21 neighbour ids
-  const std::vector< short int > n9 = m_neighbourMap9->getNeighbours(centralCellId);
-  const std::vector< short int > n21 = m_neighbourMap21->getNeighbours(centralCellId);
+  const ECL::ECLNeighbourMap::Range n9 = m_neighbourMap9->getNeighbours(centralCellId);
+  const ECL::ECLNeighbourMap::Range n21 = m_neighbourMap21->getNeighbours(centralCellId);
 
   double energy9 = 0.0;
   double energy21 = 0.0;
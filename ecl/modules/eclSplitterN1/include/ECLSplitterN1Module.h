@@ -30,7 +30,7 @@ namespace Belle2 {
   class ECLnOptimal;
 
   namespace ECL {
-    class ECLNeighbours;
+    class ECLNeighbourMap;
     class ECLGeometryPar;
   }
 
@@ -104,8 +104,8 @@ namespace Belle2 {
     std::vector< int > m_cellIdInCR;
 
     /** Neighbour maps */
-    ECL::ECLNeighbours* m_NeighbourMap9{nullptr}; /**< 3x3 = 9 neighbours */
-    ECL::ECLNeighbours* m_NeighbourMap21{nullptr}; /**< 5x5 neighbours excluding corners = 21 */
+    const ECL::ECLNeighbourMap* m_NeighbourMap9{nullptr}; /**< 3x3 = 9 neighbours */
+    const ECL::ECLNeighbourMap* m_NeighbourMap21{nullptr}; /**< 5x5 neighbours excluding corners = 21 */
 
     /** Store array: ECLCalDigit. */
     StoreArray<ECLCalDigit> m_eclCalDigits;
@@ -17,7 +17,7 @@
 #include <ecl/dataobjects/ECLShower.h>
 #include <ecl/dbobjects/ECLnOptimal.h>
 #include <ecl/geometry/ECLGeometryPar.h>
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 #include <ecl/utility/Position.h>
 
 /* Basf2 headers. */
@@ -120,8 +120,8 @@ void ECLSplitterN1Module::initialize()
   m_eclConnectedRegions.requireRelationTo(m_eclCalDigits);
 
   // Initialize neighbour maps (we will optimize the endcaps later, there is more than just a certain energy containment to be considered)
-  m_NeighbourMap9 = new ECLNeighbours("N", 1); // N: 3x3 = 9
-  m_NeighbourMap21 = new ECLNeighbours("NC", 2); // NC: 5x5 excluding corners = 21
+  m_NeighbourMap9 = &ECLNeighbourMap::get("N", 1); // N: 3x3 = 9
+  m_NeighbourMap21 = &ECLNeighbourMap::get("NC", 2); // NC: 5x5 excluding corners = 21
 
   // initialize the vector that gives the relation between cellid and store array position
   m_StoreArrPosition.resize(ECLElementNumbers::c_NCrystals + 1);
@@ -209,8 +209,6 @@ void ECLSplitterN1Module::endRun()
 
 void ECLSplitterN1Module::terminate()
 {
-  if (m_NeighbourMap9) delete m_NeighbourMap9;
-  if (m_NeighbourMap21) delete m_NeighbourMap21;
 }
 
 void ECLSplitterN1Module::splitConnectedRegion(ECLConnectedRegion& aCR)
@@ -261,7 +259,7 @@ void ECLSplitterN1Module::splitConnectedRegion(ECLConnectedRegion& aCR)
     const double energyEstimation = estimateEnergy(highestEnergyID);
 
     // Check if 21 would be better in the present background conditions:
-    ECLNeighbours* neighbourMap; // FIXME pointer needed?
+    const ECLNeighbourMap* neighbourMap;
     int nNeighbours = getNeighbourMap(energyEstimation, backgroundLevel);
     if (nNeighbours == 9 and !m_useOptimalNumberOfDigitsForEnergy) neighbourMap = m_NeighbourMap9;
     else neighbourMap = m_NeighbourMap21;
@@ -652,13 +650,13 @@ void ECLSplitterN1Module::splitConnectedRegion(ECLConnectedRegion& aCR)
       const double energyEstimation = estimateEnergy(locmaxcellid);
 
       // Get the neighbour list.
-      ECLNeighbours* neighbourMap; // FIXME need pointer?
+      const ECLNeighbourMap* neighbourMap;
       int nNeighbours = getNeighbourMap(energyEstimation, backgroundLevel);
       if (nNeighbours == 9 and !m_useOptimalNumberOfDigitsForEnergy) neighbourMap = m_NeighbourMap9;
       else neighbourMap = m_NeighbourMap21;
 
       // Get the neighbour list.
-      std::vector<short int> neighbourlist = neighbourMap->getNeighbours(locmaxcellid);
+      const ECLNeighbourMap::Range neighbourlist = neighbourMap->getNeighbours(locmaxcellid);
 
       // Get the weight vector.
       std::vector < double > myWeights = (*weightMap.find(locmaxcellid)).second;
@@ -15,6 +15,7 @@
 #include <ecl/dbobjects/ECLCrystalCalib.h>
 #include <ecl/dbobjects/ECLDigitWaveformParameters.h>
 #include <ecl/dbobjects/ECLDigitWaveformParametersForMC.h>
+#include <ecl/digitization/OfflineWaveformFitter.h>
 
 /* Basf2 headers. */
 #include <framework/core/Module.h>
@@ -25,98 +26,6 @@ class TMinuit;
 
 namespace Belle2 {
 
-  /**
-   * Struct to keep upper triangle of the covariance matrix. Since the
-   * matrix is already inverted we do not need extra precision, so
-   * keep matrix elements in float type to save space.
-   * sigma is the average noise.
-   */
-  struct CovariancePacked {
-
-    /** Packed matrix. */
-    float m_covMatPacked[31 * (31 + 1) / 2] = {};
-
-    /** Sigma noise. */
-    float sigma{ -1};
-
-    /** Lvalue access by index. */
-    float& operator[](int i) { return m_covMatPacked[i];}
-
-    /** Rvalue access by index. */
-    const float& operator[](int i) const { return m_covMatPacked[i];}
-  };
-
-  /**
-   * Interpolation of signal shape using function values and
-   * the first derivative.
-   */
-  struct SignalInterpolation2 {
-
-    /**
-     * Signal function is sampled in c_nt time steps with c_ndt substeps
-     * and c_ntail steps. c_dt is the time step.
-     */
-    constexpr static int c_nt = 12;
-
-    /** Number of substeps. */
-    constexpr static int c_ndt = 5;
-
-    /** Number of tail steps. */
-    constexpr static int c_ntail = 20;
-
-    /** Time step. */
-    constexpr static double c_dt = 0.5;
-
-    /** Inverted time step */
-    constexpr static double c_idt = 1 / c_dt;
-
-    /** Time substep. */
-    constexpr static double c_dtn = c_dt / c_ndt;
-
-    /** Inverted time substep. */
-    constexpr static double c_idtn = c_ndt / c_dt;
-
-    /** Function values. */
-    double m_FunctionInterpolation[c_nt * c_ndt + c_ntail];
-
-    /** Derivative values. */
-    double m_DerivativeInterpolation[c_nt * c_ndt + c_ntail];
-
-    /**
-     * Assuming exponential drop of the signal function far away from 0,
-     * extrapolate it to +inf.
-     * f(i_last + i) = f(i_last)*m_r0^i
-     * f'(i_last + i) = f'(i_last)*m_r1^i
-     * where i_last is the last point within sampled values in
-     * m_FunctionInterpolation (m_DerivativeInterpolation).
-     */
-    double m_r0;
-
-    /** See above/ */
-    double m_r1;
-
-    /**
-     * Default constructor.
-     */
-    SignalInterpolation2() {};
-
-    /**
-     * Constructor with parameters with the parameter layout as
-     * in ECLDigitWaveformParameters.
-     */
-    explicit SignalInterpolation2(const std::vector<double>&);
-
-    /**
-     * Returns signal shape and derivatives in 31 equidistant time points
-     * starting from t0.
-     * @param[in]  t0          Time.
-     * @param[out] function    Function values.
-     * @param[out] derivatives Derivatives.
-     */
-    void getShape(double t0, double* function, double* derivatives) const;
-
-  };
-
   /**
    * Module performs offline fit for saved ECL waveforms.
    */
@@ -165,31 +74,24 @@ namespace Belle2 {
     void loadTemplateParameterArray();
 
     /**
-     * Fit with photon and hadron.
-     * @param[out] pedestal        Pedestal.
-     * @param[out] amplitudePhoton Photon amplitude.
-     * @param[out] signalTime      Signal time.
-     * @param[out] amplitudeHadron Hadron amplitude.
-     * @param[out] chi2            Chi-squared.
+     * Fit the waveform with photon and hadron (or diode) templates.
+     * @param[in]  photonSignal Photon template.
+     * @param[in]  hadronSignal Hadron or diode template.
+     * @param[out] result       Fit result.
      */
-    void fitPhotonHadron(
-      double& pedestal, double& amplitudePhoton, double& signalTime,
-      double& amplitudeHadron, double& chi2);
+    void fitPhotonHadron(const SignalInterpolation2& photonSignal,
+                         const SignalInterpolation2& hadronSignal,
+                         ECL::OfflineFitResult& result);
 
     /**
-     * Fit with photon, hadron, and background photon.
-     * @param[out] pedestal                  Pedestal.
-     * @param[out] amplitudePhoton           Photon amplitude.
-     * @param[out] signalTime                Signal time.
-     * @param[out] amplitudeHadron           Hadron amplitude.
-     * @param[out] amplitudeBackgroundPhoton Background-photon amplitude.
-     * @param[out] timeBackgroundPhoton      Background-photon time.
-     * @param[out] chi2                      Chi-squared.
+     * Fit the waveform with photon, hadron, and background photon.
+     * @param[in]  photonSignal Photon template.
+     * @param[in]  hadronSignal Hadron template.
+     * @param[out] result       Fit result.
      */
-    void fitPhotonHadronBackgroundPhoton(
-      double& pedestal, double& amplitudePhoton, double& signalTime,
-      double& amplitudeHadron, double& amplitudeBackgroundPhoton,
-      double& timeBackgroundPhoton, double& chi2);
+    void fitPhotonHadronBackgroundPhoton(const SignalInterpolation2& photonSignal,
+                                         const SignalInterpolation2& hadronSignal,
+                                         ECL::OfflineFitResult& result);
 
     /** Energy threshold to fit pulse offline. */
     double m_EnergyThreshold{0.03};
@@ -203,6 +105,9 @@ namespace Belle2 {
     /** Option to use crystal dependent covariance matrices. */
     bool m_CovarianceMatrix{true};
 
+    /** Fit with TMinuit instead of the experimental Levenberg-Marquardt fitter. */
+    bool m_UseMinuit{true};
+
     /** Flag to indicate if waveform templates are loaded from database. */
     bool m_TemplatesLoaded{false};
 
@@ -215,6 +120,12 @@ namespace Belle2 {
     /** Minuit minimizer for fit with photon, hadron, and background photon. */
     TMinuit* m_MinuitPhotonHadronBackgroundPhoton = nullptr;
 
+    /** Levenberg-Marquardt waveform fitter. */
+    ECL::OfflineWaveformFitter m_Fitter;
+
+    /** ECLDigit for each cell id, used to set the ECLDsp relations. */
+    std::vector<const ECLDigit*> m_DigitByCellId;
+
     /** ShaperDSP signal shapes. */
     SignalInterpolation2 m_SignalInterpolation[ECLElementNumbers::c_NCrystals][3];
 
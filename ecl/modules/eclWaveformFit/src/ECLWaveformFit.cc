@@ -11,7 +11,6 @@
 
 /* ECL headers. */
 #include <ecl/digitization/EclConfiguration.h>
-#include <ecl/digitization/shaperdsp.h>
 
 /* Basf2 headers. */
 #include <framework/core/Environment.h>
@@ -51,13 +50,13 @@ extern "C" {
 namespace {
 
   // Number of fit points.
-  const int c_NFitPoints = 31;
+  const int c_NFitPoints = OfflineWaveformFitter::c_NFitPoints;
 
   // Number of fit points for vectorized data.
-  const int c_NFitPointsVector = 32;
+  const int c_NFitPointsVector = OfflineWaveformFitter::c_NFitPointsVector;
 
   //adc data array
-  double fitA[c_NFitPoints];
+  double fitA[c_NFitPointsVector];
 
   /** Photon template signal shape. */
   const SignalInterpolation2* g_PhotonSignal;
@@ -65,9 +64,6 @@ namespace {
   /** Hadron template signal shape. */
   const SignalInterpolation2* g_HadronSignal;
 
-  /** Noise level. */
-  double aNoise;
-
   //Function to minimize in photon template + hadron template fit. (chi2)
   // cppcheck-suppress constParameter ; TF1 fit functions cannot have const parameters
   void fcnPhotonHadron(int&, double* grad, double& f, double* p, int)
@@ -204,6 +200,10 @@ ECLWaveformFitModule::ECLWaveformFitModule()
   addParam("CovarianceMatrix", m_CovarianceMatrix,
            "Option to use crystal-dependent covariance matrices (false uses identity matrix).",
            true);
+  addParam("UseMinuit", m_UseMinuit,
+           "Fit with TMinuit (true) or with the experimental Levenberg-Marquardt fitter (false). "
+           "The Levenberg-Marquardt fitter has not been validated against TMinuit on recorded data yet.",
+           true);
 }
 
 ECLWaveformFitModule::~ECLWaveformFitModule()
@@ -286,6 +286,7 @@ void ECLWaveformFitModule::beginRun()
         k++;
       }
     }
+    m_Fitter.setInverseCovariance(packedDefaultCovariance);
     ecl_waveform_fit_load_inverse_covariance(
       packedDefaultCovariance.m_covMatPacked);
   }
@@ -301,37 +302,39 @@ void ECLWaveformFitModule::initialize()
   // is already register in previous modules: let's require it here
   m_eclDSPs.registerRelationTo(m_eclDigits);
 
-  //initializing fit minimizer
-  m_MinuitPhotonHadron = new TMinuit(4);
-  m_MinuitPhotonHadron->SetFCN(fcnPhotonHadron);
-  double arglist[10];
-  int ierflg = 0;
-  arglist[0] = -1;
-  m_MinuitPhotonHadron->mnexcm("SET PRIntout", arglist, 1, ierflg);
-  m_MinuitPhotonHadron->mnexcm("SET NOWarnings", arglist, 0, ierflg);
-  arglist[0] = 1;
-  m_MinuitPhotonHadron->mnexcm("SET ERR", arglist, 1, ierflg);
-  arglist[0] = 0;
-  m_MinuitPhotonHadron->mnexcm("SET STRategy", arglist, 1, ierflg);
-  arglist[0] = 1;
-  m_MinuitPhotonHadron->mnexcm("SET GRAdient", arglist, 1, ierflg);
-  arglist[0] = 1e-6;
-  m_MinuitPhotonHadron->mnexcm("SET EPSmachine", arglist, 1, ierflg);
-
-  //initializing fit minimizer photon+hadron + background photon
-  m_MinuitPhotonHadronBackgroundPhoton = new TMinuit(6);
-  m_MinuitPhotonHadronBackgroundPhoton->SetFCN(fcnPhotonHadronBackgroundPhoton);
-  arglist[0] = -1;
-  m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET PRIntout", arglist, 1, ierflg);
-  m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET NOWarnings", arglist, 0, ierflg);
-  arglist[0] = 1;
-  m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET ERR", arglist, 1, ierflg);
-  arglist[0] = 0;
-  m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET STRategy", arglist, 1, ierflg);
-  arglist[0] = 1;
-  m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET GRAdient", arglist, 1, ierflg);
-  arglist[0] = 1e-6;
-  m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET EPSmachine", arglist, 1, ierflg);
+  if (m_UseMinuit) {
+    //initializing fit minimizer
+    m_MinuitPhotonHadron = new TMinuit(4);
+    m_MinuitPhotonHadron->SetFCN(fcnPhotonHadron);
+    double arglist[10];
+    int ierflg = 0;
+    arglist[0] = -1;
+    m_MinuitPhotonHadron->mnexcm("SET PRIntout", arglist, 1, ierflg);
+    m_MinuitPhotonHadron->mnexcm("SET NOWarnings", arglist, 0, ierflg);
+    arglist[0] = 1;
+    m_MinuitPhotonHadron->mnexcm("SET ERR", arglist, 1, ierflg);
+    arglist[0] = 0;
+    m_MinuitPhotonHadron->mnexcm("SET STRategy", arglist, 1, ierflg);
+    arglist[0] = 1;
+    m_MinuitPhotonHadron->mnexcm("SET GRAdient", arglist, 1, ierflg);
+    arglist[0] = 1e-6;
+    m_MinuitPhotonHadron->mnexcm("SET EPSmachine", arglist, 1, ierflg);
+
+    //initializing fit minimizer photon+hadron + background photon
+    m_MinuitPhotonHadronBackgroundPhoton = new TMinuit(6);
+    m_MinuitPhotonHadronBackgroundPhoton->SetFCN(fcnPhotonHadronBackgroundPhoton);
+    arglist[0] = -1;
+    m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET PRIntout", arglist, 1, ierflg);
+    m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET NOWarnings", arglist, 0, ierflg);
+    arglist[0] = 1;
+    m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET ERR", arglist, 1, ierflg);
+    arglist[0] = 0;
+    m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET STRategy", arglist, 1, ierflg);
+    arglist[0] = 1;
+    m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET GRAdient", arglist, 1, ierflg);
+    arglist[0] = 1e-6;
+    m_MinuitPhotonHadronBackgroundPhoton->mnexcm("SET EPSmachine", arglist, 1, ierflg);
+  }
 
   //flag for callback to load templates each run
   m_TemplatesLoaded = false;
@@ -347,6 +350,14 @@ void ECLWaveformFitModule::event()
       loadTemplateParameterArray();
   }
 
+  /* First ECLDigit of each cell. */
+  m_DigitByCellId.assign(ECLElementNumbers::c_NCrystals, nullptr);
+  for (const ECLDigit& aECLDigit : m_eclDigits) {
+    const int id = aECLDigit.getCellId() - 1;
+    if (id >= 0 && id < ECLElementNumbers::c_NCrystals && !m_DigitByCellId[id])
+      m_DigitByCellId[id] = &aECLDigit;
+  }
+
   for (ECLDsp& aECLDsp : m_eclDSPs) {
 
     aECLDsp.setTwoComponentTotalAmp(-1);
@@ -367,92 +378,81 @@ void ECLWaveformFitModule::event()
       fitA[j] = aECLDsp.getDspA()[j];
 
     //setting relation of eclDSP to aECLDigit
-    const ECLDigit* d = nullptr;
-    for (const ECLDigit& aECLDigit : m_eclDigits) {
-      if (aECLDigit.getCellId() - 1 == id) {
-        d = &aECLDigit;
-        aECLDsp.addRelationTo(&aECLDigit);
-        break;
-      }
-    }
+    const ECLDigit* d = (id >= 0 && id < ECLElementNumbers::c_NCrystals) ? m_DigitByCellId[id] : nullptr;
     if (d == nullptr)
       continue;
+    aECLDsp.addRelationTo(d);
 
     //Skipping low amplitude waveforms
     if (d->getAmp() * m_ADCtoEnergy[id] < m_EnergyThreshold)
       continue;
 
     //loading template for waveform
+    const SignalInterpolation2* photonSignal;
+    const SignalInterpolation2* hadronSignal;
     if (m_IsMCFlag == 0) {
       //data cell id dependent
-      g_PhotonSignal = &m_SignalInterpolation[id][0];
-      g_HadronSignal = &m_SignalInterpolation[id][1];
+      photonSignal = &m_SignalInterpolation[id][0];
+      hadronSignal = &m_SignalInterpolation[id][1];
     } else {
       // mc uses same waveform
-      g_PhotonSignal = &m_SignalInterpolation[0][0];
-      g_HadronSignal = &m_SignalInterpolation[0][1];
+      photonSignal = &m_SignalInterpolation[0][0];
+      hadronSignal = &m_SignalInterpolation[0][1];
     }
 
     //get covariance matrix for cell id
     if (m_CovarianceMatrix) {
-      ecl_waveform_fit_load_inverse_covariance(
-        m_PackedCovariance[id].m_covMatPacked);
-      aNoise = m_PackedCovariance[id].sigma;
+      if (m_UseMinuit)
+        ecl_waveform_fit_load_inverse_covariance(
+          m_PackedCovariance[id].m_covMatPacked);
+      else
+        m_Fitter.setInverseCovariance(m_PackedCovariance[id]);
     }
 
     /* Fit with photon and hadron templates (fit type = 0). */
-    double pedestal, amplitudePhoton, signalTime, amplitudeHadron,
-           amplitudeBackgroundPhoton, timeBackgroundPhoton, chi2;
+    OfflineFitResult fit;
     ECLDsp::TwoComponentFitType fitType = ECLDsp::photonHadron;
-    chi2 = -1;
-    fitPhotonHadron(pedestal, amplitudePhoton, signalTime, amplitudeHadron,
-                    chi2);
-    aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonHadron, chi2);
+    fitPhotonHadron(*photonSignal, *hadronSignal, fit);
+    aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonHadron, fit.chi2);
 
     /* If failed, try photon, hadron, and background photon (fit type = 1). */
-    if (chi2 >= m_Chi2Threshold27dof) {
+    if (fit.chi2 >= m_Chi2Threshold27dof) {
 
       fitType = ECLDsp::photonHadronBackgroundPhoton;
-      chi2 = -1;
-      fitPhotonHadronBackgroundPhoton(
-        pedestal, amplitudePhoton, signalTime, amplitudeHadron,
-        amplitudeBackgroundPhoton, timeBackgroundPhoton, chi2);
+      fitPhotonHadronBackgroundPhoton(*photonSignal, *hadronSignal, fit);
       aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonHadronBackgroundPhoton,
-                                       chi2);
+                                       fit.chi2);
 
       /* If failed, try diode fit (fit type = 2). */
-      if (chi2 >= m_Chi2Threshold25dof) {
+      if (fit.chi2 >= m_Chi2Threshold25dof) {
         /* Set second component to diode. */
-        g_HadronSignal = &m_SignalInterpolation[0][2];
         fitType = ECLDsp::photonDiodeCrossing;
-        chi2 = -1;
-        fitPhotonHadron(pedestal, amplitudePhoton, signalTime, amplitudeHadron,
-                        chi2);
-        aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonDiodeCrossing, chi2);
+        fitPhotonHadron(*photonSignal, m_SignalInterpolation[0][2], fit);
+        aECLDsp.setTwoComponentSavedChi2(ECLDsp::photonDiodeCrossing, fit.chi2);
 
         /* Indicates that all fits tried had bad chi^2. */
-        if (chi2 >= m_Chi2Threshold27dof)
+        if (fit.chi2 >= m_Chi2Threshold27dof)
           fitType = ECLDsp::poorChi2;
       }
 
     }
 
     /* Storing fit results. */
-    aECLDsp.setTwoComponentTotalAmp(amplitudePhoton + amplitudeHadron);
+    aECLDsp.setTwoComponentTotalAmp(fit.amplitudePhoton + fit.amplitudeHadron);
     if (fitType == ECLDsp::photonDiodeCrossing) {
       aECLDsp.setTwoComponentHadronAmp(0.0);
-      aECLDsp.setTwoComponentDiodeAmp(amplitudeHadron);
+      aECLDsp.setTwoComponentDiodeAmp(fit.amplitudeHadron);
     } else {
-      aECLDsp.setTwoComponentHadronAmp(amplitudeHadron);
+      aECLDsp.setTwoComponentHadronAmp(fit.amplitudeHadron);
       aECLDsp.setTwoComponentDiodeAmp(0.0);
     }
-    aECLDsp.setTwoComponentChi2(chi2);
-    aECLDsp.setTwoComponentTime(signalTime);
-    aECLDsp.setTwoComponentBaseline(pedestal);
+    aECLDsp.setTwoComponentChi2(fit.chi2);
+    aECLDsp.setTwoComponentTime(fit.signalTime);
+    aECLDsp.setTwoComponentBaseline(fit.pedestal);
     aECLDsp.setTwoComponentFitType(fitType);
     if (fitType == ECLDsp::photonHadronBackgroundPhoton) {
-      aECLDsp.setBackgroundPhotonEnergy(amplitudeBackgroundPhoton);
-      aECLDsp.setBackgroundPhotonTime(timeBackgroundPhoton);
+      aECLDsp.setBackgroundPhotonEnergy(fit.amplitudeBackgroundPhoton);
+      aECLDsp.setBackgroundPhotonTime(fit.timeBackgroundPhoton);
     }
   }
 }
@@ -466,9 +466,16 @@ void ECLWaveformFitModule::terminate()
 }
 
 void ECLWaveformFitModule::fitPhotonHadron(
-  double& pedestal, double& amplitudePhoton, double& signalTime,
-  double& amplitudeHadron, double& chi2)
+  const SignalInterpolation2& photonSignal,
+  const SignalInterpolation2& hadronSignal, OfflineFitResult& result)
 {
+  if (!m_UseMinuit) {
+    m_Fitter.fitPhotonHadron(fitA, photonSignal, hadronSignal, result);
+    return;
+  }
+  g_PhotonSignal = &photonSignal;
+  g_HadronSignal = &hadronSignal;
+
   //minuit parameters
   double arglist[10] = {0};
   int ierflg = 0;
@@ -511,21 +518,27 @@ void ECLWaveformFitModule::fitPhotonHadron(
 
   double edm, errdef;
   int nvpar, nparx, icstat;
-  m_MinuitPhotonHadron->mnstat(chi2, edm, errdef, nvpar, nparx, icstat);
+  m_MinuitPhotonHadron->mnstat(result.chi2, edm, errdef, nvpar, nparx, icstat);
 
   //get fit results
   double error;
-  m_MinuitPhotonHadron->GetParameter(0, pedestal, error);
-  m_MinuitPhotonHadron->GetParameter(1, amplitudePhoton, error);
-  m_MinuitPhotonHadron->GetParameter(2, signalTime, error);
-  m_MinuitPhotonHadron->GetParameter(3, amplitudeHadron, error);
+  m_MinuitPhotonHadron->GetParameter(0, result.pedestal, error);
+  m_MinuitPhotonHadron->GetParameter(1, result.amplitudePhoton, error);
+  m_MinuitPhotonHadron->GetParameter(2, result.signalTime, error);
+  m_MinuitPhotonHadron->GetParameter(3, result.amplitudeHadron, error);
 }
 
 void ECLWaveformFitModule::fitPhotonHadronBackgroundPhoton(
-  double& pedestal, double& amplitudePhoton, double& signalTime,
-  double& amplitudeHadron, double& amplitudeBackgroundPhoton,
-  double& timeBackgroundPhoton, double& chi2)
+  const SignalInterpolation2& photonSignal,
+  const SignalInterpolation2& hadronSignal, OfflineFitResult& result)
 {
+  if (!m_UseMinuit) {
+    m_Fitter.fitPhotonHadronBackgroundPhoton(fitA, photonSignal, hadronSignal, result);
+    return;
+  }
+  g_PhotonSignal = &photonSignal;
+  g_HadronSignal = &hadronSignal;
+
   double arglist[10] = {0};
   int ierflg = 0;
   double dt = 0.5;
@@ -596,154 +609,14 @@ void ECLWaveformFitModule::fitPhotonHadronBackgroundPhoton(
 
   double edm, errdef;
   int nvpar, nparx, icstat;
-  m_MinuitPhotonHadronBackgroundPhoton->mnstat(chi2, edm, errdef, nvpar, nparx, icstat);
+  m_MinuitPhotonHadronBackgroundPhoton->mnstat(result.chi2, edm, errdef, nvpar, nparx, icstat);
   double error;
-  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(0, pedestal, error);
-  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(1, amplitudePhoton, error);
-  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(2, signalTime, error);
-  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(3, amplitudeHadron, error);
+  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(0, result.pedestal, error);
+  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(1, result.amplitudePhoton, error);
+  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(2, result.signalTime, error);
+  m_MinuitPhotonHadronBackgroundPhoton->GetParameter(3, result.amplitudeHadron, error);
   m_MinuitPhotonHadronBackgroundPhoton->GetParameter(
-    4, amplitudeBackgroundPhoton, error);
+    4, result.amplitudeBackgroundPhoton, error);
   m_MinuitPhotonHadronBackgroundPhoton->GetParameter(
-    5, timeBackgroundPhoton, error);
-}
-
-SignalInterpolation2::SignalInterpolation2(const std::vector<double>& s)
-{
-  double T0 = -0.2;
-  std::vector<double> p(s.begin() + 1, s.end());
-  p[1] = std::max(0.0029, p[1]);
-  p[4] = std::max(0.0029, p[4]);
-
-  ShaperDSP_t dsp(p, s[0]);
-  dsp.settimestride(c_dtn);
-  dsp.settimeseed(T0);
-  dd_t t[(c_nt + c_ntail)*c_ndt];
-  dsp.fillarray(sizeof(t) / sizeof(t[0]), t);
-
-  for (int i = 0; i < c_nt * c_ndt; i++) {
-    m_FunctionInterpolation[i] = t[i].first;
-    m_DerivativeInterpolation[i] = t[i].second;
-  }
-  for (int i = 0; i < c_ntail; i++) {
-    int j = c_nt * c_ndt + i;
-    int k = c_nt * c_ndt + i * c_ndt;
-    m_FunctionInterpolation[j] = t[k].first;
-    m_DerivativeInterpolation[j] = t[k].second;
-  }
-  int i1 = c_nt * c_ndt + c_ntail - 2;
-  int i2 = c_nt * c_ndt + c_ntail - 1;
-  m_r0 = m_FunctionInterpolation[i2] / m_FunctionInterpolation[i1];
-  m_r1 = m_DerivativeInterpolation[i2] / m_DerivativeInterpolation[i1];
-}
-
-void SignalInterpolation2::getShape(
-  double t0, double* function, double* derivatives) const
-{
-  /* If before pulse start time (negative times), return 0. */
-  int k = 0;
-  while (t0 < 0) {
-    function[k] = 0;
-    derivatives[k] = 0;
-    t0 += c_dt;
-    ++k;
-    if (k >= c_NFitPoints)
-      return;
-  }
-
-  /* Function and derivative values. */
-  double function0[c_NFitPoints], function1[c_NFitPoints];
-  double derivative0[c_NFitPoints], derivative1[c_NFitPoints];
-
-  /* Interpolate first c_nt points (short time steps). */
-  double x = t0 * c_idtn;
-  double ix = floor(x);
-  double w = x - ix;
-  int j = ix;
-  double w2 = w * w;
-  double hw2 = 0.5 * w2;
-  double tw3 = ((1. / 6) * w) * w2;
-
-  /* Number of interpolation points. */
-  int iMax = k + c_nt;
-  if (iMax > c_NFitPoints)
-    iMax = c_NFitPoints;
-
-  /* Fill interpolation points. */
-  for (int i = k; i < iMax; ++i) {
-    function0[i] = m_FunctionInterpolation[j];
-    function1[i] = m_FunctionInterpolation[j + 1];
-    derivative0[i] = m_DerivativeInterpolation[j];
-    derivative1[i] = m_DerivativeInterpolation[j + 1];
-    j = j + c_ndt;
-  }
-
-  /* Interpolation. */
-  #pragma omp simd
-  for (int i = k; i < iMax; ++i) {
-    double a[4];
-    double dfdt = (function1[i] - function0[i]) * c_idtn;
-    double fp = derivative1[i] + derivative0[i];
-    a[0] = function0[i];
-    a[1] = derivative0[i];
-    a[2] = -((fp + derivative0[i]) - 3 * dfdt);
-    a[3] = fp - 2 * dfdt;
-    double b2 = 2 * a[2];
-    double b3 = 6 * a[3];
-    function[i] = a[0] + c_dtn * (a[1] * w + b2 * hw2 + b3 * tw3);
-    derivatives[i] = a[1] + b2 * w + b3 * hw2;
-  }
-  t0 = t0 + c_dt * c_nt;
-  if (iMax == c_NFitPoints)
-    return;
-  k = iMax;
-
-  /* Interpolate next c_ntail points (long time steps). */
-  x = t0 * c_idt;
-  ix = floor(x);
-  w = x - ix;
-  w2 = w * w;
-  hw2 = 0.5 * w2;
-  tw3 = ((1. / 6) * w) * w2;
-
-  /* Number of interpolation points. */
-  iMax = k + c_ntail - 1;
-  if (iMax > c_NFitPoints)
-    iMax = c_NFitPoints;
-
-  /* Interpolation. */
-  #pragma omp simd
-  for (int i = k; i < iMax; ++i) {
-    j = c_nt * c_ndt + i - k;
-    /*
-     * The interpolation step is the same as the distance between
-     * the fit points. It is possible to load the values in the interpolation
-     * loop while keeping its vectorization.
-     */
-    double f0 = m_FunctionInterpolation[j];
-    double f1 = m_FunctionInterpolation[j + 1];
-    double fp0 = m_DerivativeInterpolation[j];
-    double fp1 = m_DerivativeInterpolation[j + 1];
-    double a[4];
-    double dfdt = (f1 - f0) * c_idt;
-    double fp = fp1 + fp0;
-    a[0] = f0;
-    a[1] = fp0;
-    a[2] = -((fp + fp0) - 3 * dfdt);
-    a[3] = fp - 2 * dfdt;
-    double b2 = 2 * a[2];
-    double b3 = 6 * a[3];
-    function[i] = a[0] + c_dt * (a[1] * w + b2 * hw2 + b3 * tw3);
-    derivatives[i] = a[1] + b2 * w + b3 * hw2;
-  }
-  if (iMax == c_NFitPoints)
-    return;
-  k = iMax;
-
-  /* Exponential tail. */
-  while (k < c_NFitPoints) {
-    function[k] = function[k - 1] * m_r0;
-    derivatives[k] = derivatives[k - 1] * m_r1;
-    ++k;
-  }
+    5, result.timeBackgroundPhoton, error);
 }
@@ -9,7 +9,7 @@
 #pragma once
 
 /* ECL headers. */
-#include <ecl/geometry/ECLNeighbours.h>
+#include <ecl/geometry/ECLNeighbourMap.h>
 
 /* Basf2 headers. */
 #include <analysis/utility/PCmsLabTransform.h>
@@ -66,7 +66,7 @@ namespace Belle2 {
     std::vector<float> m_dPhiMax; /**< maximum dPhi* as a function of thetaID */
     bool storeCalib = true; /**< force the input calibration constants to be saved first event */
     std::vector<float> EperCrys; /**< Energy for each crystal from ECLDigit or ECLCalDigit (GeV) */
-    ECL::ECLNeighbours* m_eclNeighbours5x5{nullptr}; /**< Neighbour map of 25 crystals */
+    const ECL::ECLNeighbourMap* m_eclNeighbours5x5{nullptr}; /**< Neighbour map of 25 crystals */
     PCmsLabTransform m_boostrotate; /**< boost from COM to lab and visa versa */
     double m_sqrts = 10.58; /**< sqrt s from m_boostrotate */
     std::vector<int> m_thetaID; /**< thetaID of each crystal */
@@ -138,7 +138,7 @@ void eclee5x5CollectorModule::prepare()
   m_thetaID.resize(ECLElementNumbers::c_NCrystals);
 
   /** ECL geometry */
-  m_eclNeighbours5x5 = new ECL::ECLNeighbours("N", 2);
+  m_eclNeighbours5x5 = &ECL::ECLNeighbourMap::get("N", 2);
 
   /**----------------------------------------------------------------------------------------*/
   /** Get expected energies and calibration constants from DB. Need to call hasChanged() for later comparison */
@@ -368,7 +368,7 @@ void eclee5x5CollectorModule::collect()
     int crysMax = crysIDMax[ic];
     float expE = abs(Expee5x5E[crysMax]);
     float sigmaExp = Expee5x5Sigma[crysMax];
-    std::vector<short int> neighbours = m_eclNeighbours5x5->getNeighbours(crysMax + 1);
+    const ECL::ECLNeighbourMap::Range neighbours = m_eclNeighbours5x5->getNeighbours(crysMax + 1);
 
     //** Energy in 5x5, and expected energy corrected for crystals that will not be calibrated */
     double reducedExpE = expE;
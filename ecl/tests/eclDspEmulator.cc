@@ -0,0 +1,199 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <ecl/utility/ECLDspEmulator.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+namespace Belle2 {
+  namespace ECL {
+
+    /**
+     * Comparison of the scalar and the AVX2 implementation of the ShaperDSP
+     * emulation and of single and batched fits. The emulation has to be
+     * bit-exact, so all result fields are compared.
+     */
+    template <typename INT>
+    class ECLDspEmulatorTest : public ::testing::Test {
+    protected:
+      /** Coefficient tables of one channel. */
+      struct Tables {
+        vector<INT> f, f1, fg31, fg32, fg33, fg41, fg43; /**< tables */
+      };
+
+      /** Random generator. */
+      mt19937 m_Generator{20240601};
+
+      /**
+       * Random coefficient tables in the 16 bit range of the DSP. The
+       * amplitude and time coefficients subtract the pedestal and the
+       * pedestal coefficients are positive like the real ones, so that all
+       * branches of the fit are reached.
+       */
+      Tables makeTables()
+      {
+        uniform_int_distribution<int> coefficient(-32768, 32767), weight(0, 2000);
+        Tables t;
+        for (auto* table : {&t.f, &t.f1, &t.fg31, &t.fg32, &t.fg33, &t.fg41, &t.fg43}) {
+          table->resize((table == &t.fg41 or table == &t.fg43) ? 24 * 16 : 192 * 16);
+          for (INT& c : *table) c = coefficient(m_Generator);
+        }
+        for (auto* table : {&t.fg33, &t.fg43})
+          for (INT& c : *table) c = weight(m_Generator);
+        for (auto* table : {&t.fg31, &t.fg32, &t.fg41}) {
+          for (size_t row = 0; row < table->size(); row += 16) {
+            int sum = 0;
+            for (int i = 1; i < 16; i++) {
+              const int w = (table == &t.fg32) ? weight(m_Generator) - 1000 : weight(m_Generator);
+              (*table)[row + i] = w;
+              sum += w;
+            }
+            (*table)[row] = -sum / 16;
+          }
+        }
+        return t;
+      }
+
+      /** Waveform with pedestal, noise and a rough pulse of given amplitude. */
+      vector<int> makeWaveform(int amplitude)
+      {
+        normal_distribution<double> noise(0, 10);
+        vector<int> y(31);
+        for (int i = 0; i < 31; i++) {
+          const double pulse = (i >= 18) ? amplitude * (i - 17) * exp(2 - 0.5 * (i - 17)) / 4 : 0;
+          y[i] = min((1 << 18) - 1, max(0, int(3000 + pulse + noise(m_Generator))));
+        }
+        return y;
+      }
+
+      /** Input for one channel, the thresholds are at least 1 (A1 is a divisor). */
+      ECLShapeFitInput<INT> makeInput(const Tables& t, const vector<int>& y, int ttrig2)
+      {
+        uniform_int_distribution<int> threshold(1, 200), k_a(14, 17), k_b(11, 15), k_c(14, 17),
+                                  k1(14, 18), k2(2, 8),
+                                  chi(1, 1 << 30);
+        return {t.f.data(), t.f1.data(), t.fg41.data(), t.fg43.data(), t.fg31.data(),
+                t.fg32.data(), t.fg33.data(), y.data(), ttrig2, threshold(m_Generator),
+                threshold(m_Generator), threshold(m_Generator), k_a(m_Generator),
+                k_b(m_Generator), k_c(m_Generator), 0, k1(m_Generator), k2(m_Generator),
+                chi(m_Generator)
+               };
+      }
+
+      /** Single channel fit. */
+      static ECLShapeFit fit(const ECLShapeFitInput<INT>& in, bool adjusted)
+      {
+        return lftda_(in.f, in.f1, in.fg41, in.fg43, in.fg31, in.fg32, in.fg33,
+                      const_cast<int*>(in.y), in.ttrig2, in.la_thr, in.hit_thr,
+                      in.skip_thr, in.k_a, in.k_b, in.k_c, in.k_16, in.k1_chi,
+                      in.k2_chi, in.chi_thres, adjusted);
+      }
+
+      /** Compare all fields of two fit results. */
+      static void expectEqual(const ECLShapeFit& a, const ECLShapeFit& b)
+      {
+        EXPECT_EQ(a.amp, b.amp);
+        EXPECT_EQ(a.time, b.time);
+        EXPECT_EQ(a.quality, b.quality);
+        EXPECT_EQ(a.pedestal, b.pedestal);
+        EXPECT_EQ(a.hit_thr, b.hit_thr);
+        EXPECT_EQ(a.skip_thr, b.skip_thr);
+        EXPECT_EQ(a.low_amp, b.low_amp);
+        EXPECT_EQ(a.chi2, b.chi2);
+        EXPECT_EQ(a.fit, b.fit);
+      }
+
+      /** Restore the default implementation. */
+      void TearDown() override
+      {
+        ShapeFitter::useAVX2(true);
+      }
+    };
+
+    /**
+     * Bound of the packed trigger time, ttrig2 / 6 has to be a valid row of
+     * the 24-row tables FG41 and FG43.
+     */
+    static constexpr int c_MaxTrigger = 144;
+
+    /** Coefficients as stored in the database and as used by the digitizer. */
+    typedef ::testing::Types<short, int> CoefficientTypes;
+    TYPED_TEST_SUITE(ECLDspEmulatorTest, CoefficientTypes);
+
+    /**
+     * Scan all trigger times and a range of amplitudes from negative to
+     * overflowing ones, which covers all branches of the fit.
+     */
+    TYPED_TEST(ECLDspEmulatorTest, ScalarAVX2)
+    {
+      if (!ShapeFitter::useAVX2(true)) GTEST_SKIP() << "AVX2 is not supported";
+      for (int table = 0; table < 4; table++) {
+        const auto t = this->makeTables();
+        for (int amplitude : { -3000, -50, 0, 20, 100, 1000, 30000, 250000}) {
+          const vector<int> y = this->makeWaveform(amplitude);
+          for (int ttrig2 = 0; ttrig2 < c_MaxTrigger; ttrig2++) {
+            const auto input = this->makeInput(t, y, ttrig2);
+            for (bool adjusted : {false, true}) {
+              ShapeFitter::useAVX2(false);
+              const ECLShapeFit scalar = this->fit(input, adjusted);
+              ShapeFitter::useAVX2(true);
+              const ECLShapeFit vector = this->fit(input, adjusted);
+              this->expectEqual(scalar, vector);
+            }
+          }
+        }
+      }
+    }
+
+    /** Extreme samples and coefficients. */
+    TYPED_TEST(ECLDspEmulatorTest, Extremes)
+    {
+      if (!ShapeFitter::useAVX2(true)) GTEST_SKIP() << "AVX2 is not supported";
+      auto t = this->makeTables();
+      for (auto* table : {&t.fg31, &t.fg32, &t.fg33, &t.fg41, &t.fg43})
+        for (size_t i = 0; i < table->size(); i++) (*table)[i] = (i % 3 == 0) ? -32768 : 32767;
+      for (int value : {0, 1, (1 << 18) - 1}) {
+        const vector<int> y(31, value);
+        for (int ttrig2 = 0; ttrig2 < c_MaxTrigger; ttrig2 += 7) {
+          const auto input = this->makeInput(t, y, ttrig2);
+          ShapeFitter::useAVX2(false);
+          const ECLShapeFit scalar = this->fit(input, false);
+          ShapeFitter::useAVX2(true);
+          this->expectEqual(scalar, this->fit(input, false));
+        }
+      }
+    }
+
+    /** Batched fits with reused results are identical to single fits. */
+    TYPED_TEST(ECLDspEmulatorTest, Batch)
+    {
+      vector<typename TestFixture::Tables> tables;
+      for (int i = 0; i < 3; i++) tables.push_back(this->makeTables());
+      vector<vector<int>> waveforms;
+      vector<ECLShapeFitInput<TypeParam>> inputs;
+      uniform_int_distribution<int> amplitude(-100, 5000), ttrig(0, c_MaxTrigger - 1);
+      for (int i = 0; i < 500; i++)
+        waveforms.push_back(this->makeWaveform(amplitude(this->m_Generator)));
+      for (int i = 0; i < 500; i++)
+        inputs.push_back(this->makeInput(tables[i % 3], waveforms[i], ttrig(this->m_Generator)));
+      vector<ECLShapeFit> results(inputs.size());
+      // twice, so that the second call reuses the results of the first one
+      for (int pass = 0; pass < 2; pass++) {
+        lftdaBatch_(inputs.data(), results.data(), inputs.size(), pass == 1);
+        for (size_t i = 0; i < inputs.size(); i++)
+          this->expectEqual(results[i], this->fit(inputs[i], pass == 1));
+      }
+    }
+
+  }
+}
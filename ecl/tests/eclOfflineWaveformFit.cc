@@ -0,0 +1,189 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <ecl/digitization/OfflineWaveformFitter.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+using namespace std;
+
+namespace Belle2 {
+  namespace ECL {
+
+    /** Test of the offline waveform fitter with synthetic waveforms. */
+    class OfflineWaveformFitterTest : public ::testing::Test {
+    protected:
+      /** Photon template, normalized to a maximum of about 1. */
+      SignalInterpolation2 m_Photon{{27.7, 0.5, 0.6483, 0.4017, 0.3741, 0.8494, 0.00144547, 4.7071, 0.8156, 0.5556, 0.2752}};
+
+      /** Hadron template with a different shape. */
+      SignalInterpolation2 m_Hadron{{27.7, 0.5, 0.6483, 0.4017, 0.3741, 0.8494, 0.00144547, 4.7071, 1.6312, 0.5556, 0.2752}};
+
+      /** Fitter with identity covariance. */
+      OfflineWaveformFitter m_Fitter;
+
+      /** Use the identity as inverse covariance matrix. */
+      void SetUp() override
+      {
+        CovariancePacked identity;
+        int count = 0;
+        for (int i = 0; i < OfflineWaveformFitter::c_NFitPoints; ++i)
+          for (int j = 0; j < i + 1; ++j)
+            identity[count++] = (i == j);
+        m_Fitter.setInverseCovariance(identity);
+      }
+
+      /** Fill the waveform for given parameters (4 or 6). */
+      void makeWaveform(const double* p, int n, double* adc) const
+      {
+        double fg[32], dg[32], fh[32], dh[32], fb[32], db[32];
+        m_Photon.getShape(p[2], fg, dg);
+        m_Hadron.getShape(p[2], fh, dh);
+        if (n == 6)
+          m_Photon.getShape(p[5], fb, db);
+        for (int i = 0; i < OfflineWaveformFitter::c_NFitPoints; ++i)
+          adc[i] = p[0] + p[1] * fg[i] + p[3] * fh[i] + ((n == 6) ? p[4] * fb[i] : 0);
+      }
+
+      /**
+       * Reference minimum of the photon and hadron fit: the amplitudes are
+       * obtained by linear least squares for each time of a fine scan.
+       */
+      double scanMinimum(const double* adc, double tMin, double tMax, double& tBest) const
+      {
+        double best = INFINITY;
+        for (double t = tMin; t <= tMax; t += 1e-3) {
+          double fg[32], dg[32], fh[32], dh[32];
+          m_Photon.getShape(t, fg, dg);
+          m_Hadron.getShape(t, fh, dh);
+          // normal equations for pedestal, photon and hadron amplitude
+          double a[3][4] = {};
+          for (int i = 0; i < OfflineWaveformFitter::c_NFitPoints; ++i) {
+            const double x[4] = {1, fg[i], fh[i], adc[i]};
+            for (int r = 0; r < 3; ++r)
+              for (int c = 0; c < 4; ++c)
+                a[r][c] += x[r] * x[c];
+          }
+          for (int r = 0; r < 3; ++r) {
+            for (int q = r + 1; q < 3; ++q) {
+              const double f = a[q][r] / a[r][r];
+              for (int c = r; c < 4; ++c)
+                a[q][c] -= f * a[r][c];
+            }
+          }
+          double s[3];
+          for (int r = 2; r >= 0; --r) {
+            s[r] = a[r][3];
+            for (int c = r + 1; c < 3; ++c)
+              s[r] -= a[r][c] * s[c];
+            s[r] /= a[r][r];
+          }
+          const double p[4] = {s[0], s[1], t, s[2]};
+          const double chi2 = m_Fitter.getChi2(adc, m_Photon, m_Hadron, p, 4);
+          if (chi2 < best) {
+            best = chi2;
+            tBest = t;
+          }
+        }
+        return best;
+      }
+    };
+
+    /** A waveform without noise is described exactly. */
+    TEST_F(OfflineWaveformFitterTest, PhotonHadronExact)
+    {
+      const double p[4] = {3000, 1000, -8.2, 150};
+      double adc[31];
+      makeWaveform(p, 4, adc);
+      OfflineFitResult result;
+      m_Fitter.fitPhotonHadron(adc, m_Photon, m_Hadron, result);
+      EXPECT_LT(result.chi2, 1e-4);
+      EXPECT_NEAR(result.pedestal, p[0], 0.1);
+      EXPECT_NEAR(result.amplitudePhoton, p[1], 1);
+      EXPECT_NEAR(result.signalTime, p[2], 1e-3);
+      EXPECT_NEAR(result.amplitudeHadron, p[3], 1);
+      EXPECT_LT(result.iterations, OfflineWaveformFitter::c_MaxIterations);
+    }
+
+    /** Noisy waveforms reach the minimum found by a scan of the signal time. */
+    TEST_F(OfflineWaveformFitterTest, PhotonHadronNoise)
+    {
+      mt19937 generator(12345);
+      normal_distribution<double> noise(0, 10);
+      for (int n = 0; n < 20; ++n) {
+        const double p[4] = {3000 + 10. * n, 500 + 50. * n, -9 + 0.1 * n, 20. * (n % 5)};
+        double adc[31];
+        makeWaveform(p, 4, adc);
+        for (double& a : adc)
+          a += noise(generator);
+        OfflineFitResult result;
+        m_Fitter.fitPhotonHadron(adc, m_Photon, m_Hadron, result);
+        double tBest;
+        const double reference = scanMinimum(adc, result.signalTime - 0.5, result.signalTime + 0.5, tBest);
+        EXPECT_LT(result.chi2, reference + 1e-3);
+        EXPECT_NEAR(result.signalTime, tBest, 2e-3);
+      }
+    }
+
+    /** A second photon is fitted as background photon. */
+    TEST_F(OfflineWaveformFitterTest, BackgroundPhoton)
+    {
+      const double p[6] = {3000, 1000, -8.2, 100, 300, -3.1};
+      double adc[31];
+      makeWaveform(p, 6, adc);
+      OfflineFitResult result;
+      m_Fitter.fitPhotonHadronBackgroundPhoton(adc, m_Photon, m_Hadron, result);
+      EXPECT_LT(result.chi2, 1e-3);
+      EXPECT_NEAR(result.amplitudePhoton, p[1], 1);
+      EXPECT_NEAR(result.signalTime, p[2], 1e-3);
+      EXPECT_NEAR(result.amplitudeHadron, p[3], 1);
+      EXPECT_NEAR(result.amplitudeBackgroundPhoton, p[4], 1);
+      EXPECT_NEAR(result.timeBackgroundPhoton, p[5], 1e-2);
+    }
+
+    /**
+     * The inverse covariance matrix scales chi2 but not the result, the
+     * default is diagonal with a noise of 7.5 ADC counts.
+     */
+    TEST_F(OfflineWaveformFitterTest, Covariance)
+    {
+      mt19937 generator(1);
+      normal_distribution<double> noise(0, 7.5);
+      const double p[4] = {3000, 800, -8.6, 50};
+      double adc[31];
+      makeWaveform(p, 4, adc);
+      for (double& a : adc)
+        a += noise(generator);
+
+      OfflineFitResult identity;
+      m_Fitter.fitPhotonHadron(adc, m_Photon, m_Hadron, identity);
+
+      CovariancePacked packed;
+      int count = 0;
+      for (int i = 0; i < OfflineWaveformFitter::c_NFitPoints; ++i)
+        for (int j = 0; j < i + 1; ++j)
+          packed[count++] = (i == j) / (7.5 * 7.5);
+      OfflineWaveformFitter fitter;
+      fitter.setInverseCovariance(packed);
+      OfflineFitResult scaled;
+      fitter.fitPhotonHadron(adc, m_Photon, m_Hadron, scaled);
+      EXPECT_NEAR(scaled.chi2, identity.chi2 / (7.5 * 7.5), 1e-3);
+      EXPECT_NEAR(scaled.signalTime, identity.signalTime, 1e-3);
+      EXPECT_NEAR(scaled.amplitudePhoton, identity.amplitudePhoton, 0.5);
+
+      OfflineWaveformFitter defaultFitter;
+      OfflineFitResult byDefault;
+      defaultFitter.fitPhotonHadron(adc, m_Photon, m_Hadron, byDefault);
+      EXPECT_NEAR(byDefault.chi2, scaled.chi2, 1e-4);
+      EXPECT_NEAR(byDefault.signalTime, scaled.signalTime, 1e-4);
+    }
+
+  }
+}
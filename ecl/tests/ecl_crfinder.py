@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""
+Check the connected regions of ECLCRFinder and their relations to the
+ECLCalDigits on a fixed sample of generated digits at occupancies from 5% to
+50%. The reference is a direct implementation of the definition: every seed
+is attached to its growth neighbours, every crystal found so far once more
+to its growth neighbours and every crystal found then to all its digit
+neighbours; regions sharing a crystal are merged in the order in which they
+were found and the digits of each region are related in ascending cell id
+order.
+"""
+
+import random
+import basf2
+from ROOT import Belle2
+import b2test_utils
+
+#: number of crystals
+N_CRYSTALS = 8736
+
+#: fraction of crystals with a digit in the events
+OCCUPANCIES = [0.05, 0.1, 0.2, 0.3, 0.5]
+
+#: seed, growth and digit energy cuts of ECLCRFinder
+ENERGY_CUTS = [10 * Belle2.Unit.MeV, 10 * Belle2.Unit.MeV, 0.5 * Belle2.Unit.MeV]
+
+
+class GenerateDigits(basf2.Module):
+    """Fill ECLCalDigits from a fixed random sequence"""
+
+    def initialize(self):
+        """register the digits and the event level clustering information"""
+        #: calibrated digits
+        self.digits = Belle2.PyStoreArray('ECLCalDigits')
+        self.digits.registerInDataStore()
+        #: event level clustering information, required by the CR finder
+        self.info = Belle2.PyStoreObj('EventLevelClusteringInfo')
+        self.info.registerInDataStore()
+        #: random numbers independent of the basf2 random seed
+        self.random = random.Random(20231018)
+
+    def event(self):
+        """background digits at the occupancy of the event plus a few showers"""
+        self.info.create()
+        occupancy = OCCUPANCIES[(Belle2.PyStoreObj('EventMetaData').obj().getEvent() - 1) % len(OCCUPANCIES)]
+        energies = {}
+        for cellId in range(1, N_CRYSTALS + 1):
+            if self.random.random() < occupancy:
+                energies[cellId] = self.random.expovariate(1 / 0.003)
+        for i in range(10):
+            seed = self.random.randint(1, N_CRYSTALS)
+            for cellId in range(max(1, seed - 2), min(N_CRYSTALS, seed + 2) + 1):
+                energies[cellId] = energies.get(cellId, 0) + self.random.uniform(0.01, 0.5)
+        cellIds = list(energies)
+        self.random.shuffle(cellIds)
+        for cellId in cellIds:
+            digit = self.digits.appendNew()
+            digit.setCellId(cellId)
+            digit.setEnergy(energies[cellId])
+            digit.setTime(self.random.gauss(0, 50))
+            digit.setTimeResolution(10)
+
+
+class CheckConnectedRegions(basf2.Module):
+    """Compare the connected regions with the reference"""
+
+    def initialize(self):
+        """get the neighbours used by ECLCRFinder by default"""
+        #: nearest neighbours
+        self.neighbours = Belle2.ECL.ECLNeighbours('N', 1)
+        #: number of checked regions
+        self.nRegions = 0
+
+    def reference(self, energies):
+        """connected regions for the given cell id -> energy map"""
+        cells = [{cellId for cellId, energy in energies.items() if energy >= cut} for cut in ENERGY_CUTS]
+
+        def grow(start, attach):
+            regions = []
+            for cellId in sorted(start):
+                regions.append({cellId} | {n for n in self.neighbours.getNeighbours(cellId) if n in attach})
+            return regions
+
+        AB = set().union(*grow(cells[0], cells[1]))
+        ABB = set().union(*grow(AB, cells[1]))
+        merged = []
+        for region in grow(ABB, cells[2]):
+            for other in [other for other in merged if other & region]:
+                region |= other
+                merged.remove(other)
+            merged.append(region)
+        return [sorted(region) for region in merged]
+
+    def event(self):
+        """check the regions and the relations of the event"""
+        energies = {digit.getCellId(): digit.getEnergy() for digit in Belle2.PyStoreArray('ECLCalDigits')}
+        expected = self.reference(energies)
+        regions = Belle2.PyStoreArray('ECLConnectedRegions')
+        assert regions.getEntries() == len(expected), f'{regions.getEntries()} regions, expected {len(expected)}'
+        for i, (region, cells) in enumerate(zip(regions, expected)):
+            assert region.getCRId() == i
+            relations = region.getRelationsTo('ECLCalDigits')
+            found = [relations.object(k).getCellId() for k in range(relations.size())]
+            assert found == cells, f'region {i}: {found}, expected {cells}'
+            assert all(relations.weight(k) == 1 for k in range(relations.size()))
+        self.nRegions += len(expected)
+
+    def terminate(self):
+        """make sure that regions were found"""
+        assert self.nRegions > 0
+
+
+if __name__ == '__main__':
+    main = basf2.Path()
+    main.add_module('EventInfoSetter', evtNumList=[2 * len(OCCUPANCIES)])
+    main.add_module('Gearbox')
+    main.add_module('Geometry', components=['ECL'], useDB=False)
+    main.add_module(GenerateDigits())
+    main.add_module('ECLCRFinder')
+    main.add_module(CheckConnectedRegions())
+    with b2test_utils.show_only_errors():
+        b2test_utils.safe_process(main)
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""
+Check that the sparse digitization of ECLDigitizer gives exactly the same
+ECLDigits and ECLDsps as the full digitization with beam background overlay.
+
+The overlay waveforms are produced with low energy photons whose hit times are
+spread such that many pulses end up in the pedestal region of the waveforms.
+"""
+
+import basf2
+from ROOT import Belle2, gRandom
+import b2test_utils
+
+#: number of events
+N_EVENTS = 10
+
+
+class SpreadHitTimes(basf2.Module):
+    """Move the ECLHits to random times, also before the trigger"""
+
+    def event(self):
+        """shift all hits of a cell by the same random time"""
+        shifts = {}
+        for hit in Belle2.PyStoreArray('ECLHits'):
+            shift = shifts.setdefault(hit.getCellId(), gRandom.Uniform(-8000., 2000.))
+            hit.setTimeAve(hit.getTimeAve() + shift)
+
+
+class DumpDigits(basf2.Module):
+    """Write the ECLDigits and ECLDsps to a text file"""
+
+    def __init__(self, filename):
+        """remember the output file name"""
+        super().__init__()
+        #: output file
+        self.output = open(filename, 'w')
+
+    def event(self):
+        """dump all digits and waveforms of the event"""
+        for digit in Belle2.PyStoreArray('ECLDigits'):
+            self.output.write(f'digit {digit.getCellId()} {digit.getAmp()} {digit.getTimeFit()} '
+                              f'{digit.getQuality()} {digit.getChi()}\n')
+        for dsp in Belle2.PyStoreArray('ECLDsps'):
+            self.output.write(f'dsp {dsp.getCellId()} {" ".join(str(a) for a in dsp.getDspA())}\n')
+        self.output.write('end of event\n')
+
+    def terminate(self):
+        """close the output file"""
+        self.output.close()
+
+
+def add_photons(path):
+    """add simulated low energy photons to the path"""
+    path.add_module('Gearbox')
+    path.add_module('Geometry', components=['ECL'], useDB=False)
+    path.add_module('ParticleGun', pdgCodes=[22], nTracks=20, momentumGeneration='uniform', momentumParams=[0.002, 0.05])
+    path.add_module('FullSim')
+
+
+def make_overlay():
+    """produce overlay waveforms"""
+    basf2.set_random_seed('overlay')
+    path = basf2.Path()
+    path.add_module('EventInfoSetter', evtNumList=[N_EVENTS])
+    add_photons(path)
+    path.add_module(SpreadHitTimes())
+    path.add_module('ECLDigitizer', WaveformMaker=True)
+    path.add_module('RootOutput', outputFileName='overlay.root', branchNames=['ECLWaveforms'])
+    b2test_utils.safe_process(path)
+
+
+def digitize(sparse, filename):
+    """digitize photons with background overlay in the sparse or full mode"""
+    basf2.set_random_seed('signal')
+    path = basf2.Path()
+    path.add_module('EventInfoSetter', evtNumList=[N_EVENTS])
+    path.add_module('BGOverlayInput', inputFileNames=['overlay.root'])
+    add_photons(path)
+    path.add_module('ECLDigitizer', Background=True, SparseDigitization=sparse)
+    path.add_module(DumpDigits(filename))
+    b2test_utils.safe_process(path)
+
+
+if __name__ == '__main__':
+    with b2test_utils.clean_working_directory():
+        with b2test_utils.show_only_errors():
+            assert b2test_utils.run_in_subprocess(target=make_overlay) == 0
+            for sparse in [False, True]:
+                assert b2test_utils.run_in_subprocess(sparse, f'digits_{sparse}.txt', target=digitize) == 0
+
+        with open('digits_False.txt') as full, open('digits_True.txt') as sparse:
+            full, sparse = full.readlines(), sparse.readlines()
+        assert sum(line.startswith('digit') for line in full) > 0
+        assert sum(line.startswith('dsp') for line in full) > 0
+        assert len(full) == len(sparse), f'{len(full)} lines in the full and {len(sparse)} in the sparse digitization'
+        for line, (a, b) in enumerate(zip(full, sparse)):
+            assert a == b, f'line {line} differs:\n{a}{b}'
@@ -34,6 +34,30 @@ namespace Belle2 {
       unsigned long long chi2;
     } ECLShapeFit;
 
+    /** Coefficients, waveform and settings of one channel for lftdaBatch_ */
+    template <typename INT>
+    struct ECLShapeFitInput {
+      const INT* f;    /**< Tabulated signal waveform [192][16] */
+      const INT* f1;   /**< Tabulated derivative of signal waveform [192][16] */
+      const INT* fg41; /**< Amplitude coefficients for small signals [24][16] */
+      const INT* fg43; /**< Pedestal coefficients for small signals [24][16] */
+      const INT* fg31; /**< Amplitude coefficients [192][16] */
+      const INT* fg32; /**< Amplitude * delta_t coefficients [192][16] */
+      const INT* fg33; /**< Pedestal coefficients [192][16] */
+      const int* y;    /**< Signal measurements [31] */
+      int ttrig2;      /**< Trigger time (0-191) */
+      int la_thr;      /**< Low amplitude threshold */
+      int hit_thr;     /**< Hit threshold */
+      int skip_thr;    /**< Skip threshold */
+      int k_a;         /**< Number of bits for FG31, FG41 */
+      int k_b;         /**< Number of bits for FG32 */
+      int k_c;         /**< Number of bits for FG33, FG43 */
+      int k_16;        /**< Start point for pedestal calculation */
+      int k1_chi;      /**< Bit shift for chi2 calculation */
+      int k2_chi;      /**< Bit shift for chi2 threshold calculation */
+      int chi_thres;   /**< Base value for chi2 threshold */
+    };
+
     /**
      * @brief Function that emulates shape fitting algorithm used in ShaperDSP.
      *        f, f1, fg* are coefficients from ECLDspData
@@ -78,5 +102,30 @@ namespace Belle2 {
                        int k_c, int k_16, int k1_chi, int k2_chi,
                        int chi_thres, bool adjusted_timing = false);
 
+    /**
+     * @brief Shape fits of n channels, identical to calling lftda_ for each
+     *        of them. The fit functions of the results are reused, so
+     *        keeping the results between calls avoids the allocations of
+     *        lftda_.
+     *
+     * @param[in]  inputs  Coefficients, waveforms and settings [n]
+     * @param[out] results Fit results [n]
+     * @param[in]  n       Number of channels
+     * @param[in]  adjusted_timing See lftda_
+     */
+    template <typename INT>
+    void lftdaBatch_(const ECLShapeFitInput<INT>* inputs, ECLShapeFit* results,
+                     int n, bool adjusted_timing = false);
+
+    namespace ShapeFitter {
+      /**
+       * Select the implementation of the weighted sums of the fit: AVX2
+       * (default if the CPU supports it) or scalar. Both give identical
+       * results, the switch is meant for tests.
+       * @return True if the AVX2 implementation is used.
+       */
+      bool useAVX2(bool enable);
+    }
+
   }
 }
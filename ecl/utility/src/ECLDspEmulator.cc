@@ -9,6 +9,10 @@
 #include <ecl/utility/ECLDspEmulator.h>
 //Framework
 #include <framework/logging/Logger.h>
+//C++
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 namespace Belle2 {
   namespace ECL {
@@ -29,20 +33,106 @@ namespace Belle2 {
         static const long long max_amp = 0x3FFFF - 128;
         return amp > max_amp;
       }
+
+#if defined(__x86_64__)
+      /** Load 8 coefficients as 32 bit integers. */
+      __attribute__((target("avx2")))
+      inline __m256i loadCoefficients(const int* c)
+      {
+        return _mm256_loadu_si256((const __m256i*)c);
+      }
+
+      /** Load 8 coefficients as 32 bit integers. */
+      __attribute__((target("avx2")))
+      inline __m256i loadCoefficients(const short* c)
+      {
+        return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)c));
+      }
+
+      /**
+       * Sum of c[i] * y[15 + i] for i = 1..15 with 64 bit products.
+       * _mm256_mul_epi32 multiplies the even 32 bit elements, the odd ones
+       * are shifted to the even positions first.
+       */
+      template <typename INT>
+      __attribute__((target("avx2")))
+      long long sumProductsAVX2(const INT* c, const int* y)
+      {
+        // the first coefficient belongs to the pedestal sum, not to y[15]
+        const __m256i c0 = _mm256_blend_epi32(loadCoefficients(c), _mm256_setzero_si256(), 1);
+        const __m256i c1 = loadCoefficients(c + 8);
+        const __m256i y0 = _mm256_loadu_si256((const __m256i*)(y + 15));
+        const __m256i y1 = _mm256_loadu_si256((const __m256i*)(y + 23));
+        __m256i sum = _mm256_add_epi64(_mm256_mul_epi32(c0, y0), _mm256_mul_epi32(c1, y1));
+        sum = _mm256_add_epi64(sum, _mm256_mul_epi32(_mm256_srli_epi64(c0, 32), _mm256_srli_epi64(y0, 32)));
+        sum = _mm256_add_epi64(sum, _mm256_mul_epi32(_mm256_srli_epi64(c1, 32), _mm256_srli_epi64(y1, 32)));
+        const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        return _mm_cvtsi128_si64(half) + _mm_extract_epi64(half, 1);
+      }
+
+      /** True if the AVX2 kernel is used. */
+      bool s_useAVX2 = __builtin_cpu_supports("avx2");
+#else
+      /** No AVX2 kernel on this architecture. */
+      const bool s_useAVX2 = false;
+#endif
+
+      /**
+       * Weighted sum c[0] * z0 + sum(c[i] * y[15 + i], i = 1..15) used for
+       * all amplitude, time and pedestal estimates of the fit.
+       */
+      template <typename INT>
+      long long weightedSum(const INT* c, long long z0, const int* y)
+      {
+        long long sum = c[0] * z0;
+#if defined(__x86_64__)
+        if (s_useAVX2) return sum + sumProductsAVX2(c, y);
+#endif
+        for (int i = 1; i < 16; i++)
+          sum += c[i] * (long long)y[15 + i];
+        return sum;
+      }
+
+      bool useAVX2(bool enable)
+      {
+#if defined(__x86_64__)
+        s_useAVX2 = enable and __builtin_cpu_supports("avx2");
+#else
+        (void)enable;
+#endif
+        return s_useAVX2;
+      }
     }
   }
 }
 
 namespace Belle2 {
   namespace ECL {
+    /** Shape fit for one channel, the result is filled in place. */
     template <typename INT>
-    ECLShapeFit lftda_(const INT* f, const INT* f1, const INT* fg41,
-                       const INT* fg43, const INT* fg31, const INT* fg32,
-                       const INT* fg33, int* y, int ttrig2, int la_thr,
-                       int hit_thr, int skip_thr, int k_a, int k_b,
-                       int k_c, int k_16, int k1_chi, int k2_chi,
-                       int chi_thres, bool adjusted_timing)
+    void lftda(const ECLShapeFitInput<INT>& input, ECLShapeFit& result,
+               bool adjusted_timing)
     {
+      const INT* f = input.f;
+      const INT* f1 = input.f1;
+      const INT* fg41 = input.fg41;
+      const INT* fg43 = input.fg43;
+      const INT* fg31 = input.fg31;
+      const INT* fg32 = input.fg32;
+      const INT* fg33 = input.fg33;
+      const int* y = input.y;
+      const int ttrig2 = input.ttrig2;
+      const int la_thr = input.la_thr;
+      const int hit_thr = input.hit_thr;
+      const int skip_thr = input.skip_thr;
+      const int k_a = input.k_a;
+      const int k_b = input.k_b;
+      const int k_c = input.k_c;
+      const int k_16 = input.k_16;
+      const int k1_chi = input.k1_chi;
+      const int k2_chi = input.k2_chi;
+      const int chi_thres = input.chi_thres;
+
       //                Typical plot of y_i (i=0..31)
       // +-------------------------------------------------------+
       // |                                                       |
@@ -150,9 +240,8 @@ namespace Belle2 {
       const int kz_s = 0;
       const long long z0 = z00 >> kz_s;
 
-      // Struct with fit results
-      ECLShapeFit result;
-      result.fit.resize(31);
+      // Fit function, reuses the memory of a previous fit
+      result.fit.assign(31, 0);
 
       //== Check for pedestal amplitude overflow
 
@@ -167,10 +256,7 @@ namespace Belle2 {
       //== First approximation without time correction
       //   (assuming t_0 == trigger time)
 
-      A2 = fg41[ttrig * 16] * z0;
-
-      for (int i = 1; i < 16; i++)
-        A2 += y[15 + i] * (long long)fg41[ttrig * 16 + i];
+      A2 = weightedSum(fg41 + ttrig * 16, z0, y);
 
       A2 += (1 << (k_a - 1));
       A2 >>= k_a;
@@ -207,13 +293,8 @@ namespace Belle2 {
           //== Get amplitude and (ampl*time)
           //   at time index 'it'
 
-          A1 = fg31[it * 16] * z0;
-          B1 = fg32[it * 16] * z0;
-
-          for (int i = 1; i < 16; i++) {
-            A1 += fg31[it * 16 + i] * (long long)y[15 + i];
-            B1 += fg32[it * 16 + i] * (long long)y[15 + i];
-          }
+          A1 = weightedSum(fg31 + it * 16, z0, y);
+          B1 = weightedSum(fg32 + it * 16, z0, y);
           A1 += (1 << (k_a - 1));
           A1 >>= k_a;
 
@@ -307,9 +388,7 @@ namespace Belle2 {
 
             //== Estimate pedestal
 
-            C1 = fg33[it * 16] * z0;
-            for (int i = 1; i < 16; i++)
-              C1 += fg33[it * 16 + i] * (long long)y[15 + i];
+            C1 = weightedSum(fg33 + it * 16, z0, y);
             C1 += (1 << (k_c - 1));
             C1 >>= k_c;
           }
@@ -330,9 +409,7 @@ namespace Belle2 {
 
           //== Estimate pedestal
 
-          C1 = fg43[ttrig * 16] * z0;
-          for (int i = 1; i < 16; i++)
-            C1 += fg43[ttrig * 16 + i] * (long long)y[15 + i];
+          C1 = weightedSum(fg43 + ttrig * 16, z0, y);
           C1 += (1 << (k_c - 1));
           C1 >>= k_c;
         }
@@ -413,10 +490,34 @@ namespace Belle2 {
       result.pedestal = result.fit[0];
 
       result.chi2 = chi_sq;
+    }
 
+    template <typename INT>
+    ECLShapeFit lftda_(const INT* f, const INT* f1, const INT* fg41,
+                       const INT* fg43, const INT* fg31, const INT* fg32,
+                       const INT* fg33, int* y, int ttrig2, int la_thr,
+                       int hit_thr, int skip_thr, int k_a, int k_b,
+                       int k_c, int k_16, int k1_chi, int k2_chi,
+                       int chi_thres, bool adjusted_timing)
+    {
+      const ECLShapeFitInput<INT> input = {f, f1, fg41, fg43, fg31, fg32, fg33, y,
+                                           ttrig2, la_thr, hit_thr, skip_thr,
+                                           k_a, k_b, k_c, k_16, k1_chi, k2_chi,
+                                           chi_thres
+                                          };
+      ECLShapeFit result;
+      lftda(input, result, adjusted_timing);
       return result;
     }
 
+    template <typename INT>
+    void lftdaBatch_(const ECLShapeFitInput<INT>* inputs, ECLShapeFit* results,
+                     int n, bool adjusted_timing)
+    {
+      for (int i = 0; i < n; i++)
+        lftda(inputs[i], results[i], adjusted_timing);
+    }
+
     template ECLShapeFit lftda_<short>(const short* f, const short* f1, const short* fg41,
                                        const short* fg43, const short* fg31, const short* fg32,
                                        const short* fg33, int* y, int ttrig2, int la_thr,
@@ -429,6 +530,11 @@ namespace Belle2 {
                                      int hit_thr, int skip_thr, int k_a, int k_b,
                                      int k_c, int k_16, int k1_chi, int k2_chi,
                                      int chi_thres, bool adjusted_timing);
+    template void lftdaBatch_<short>(const ECLShapeFitInput<short>* inputs,
+                                     ECLShapeFit* results, int n,
+                                     bool adjusted_timing);
+    template void lftdaBatch_<int>(const ECLShapeFitInput<int>* inputs,
+                                   ECLShapeFit* results, int n,
+                                   bool adjusted_timing);
   }
 }
-
@@ -0,0 +1,123 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+#include <framework/core/Module.h>
+#include <framework/core/EventProcessor.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace Belle2 {
+  class Path;
+
+  /** Framework-internal module that implements Path.add_concurrent_paths().
+   *
+   * In each event the given paths are executed concurrently on a small pool of
+   * threads, the modules within each path are executed in order. This is meant
+   * for independent modules with a sizable fixed cost per event like the
+   * unpackers of the different detectors.
+   *
+   * Initialization, run changes and termination happen sequentially in the
+   * calling thread so all DataStore registrations and conditions updates work as
+   * usual. To keep the output deterministic and to avoid data races it is
+   * checked after initialization that no path writes an object, array or
+   * relation which another path reads or writes. Modules in the paths cannot
+   * have conditions.
+   *
+   * Log messages are serialized by the LogSystem and each thread uses the log
+   * configuration of the module it executes. Relations are added and looked up
+   * under the DataStore mutex. The event() time of the modules executed
+   * concurrently is added to their statistics after all paths are done, memory
+   * and hardware counters are not measured for them. The statistics of this
+   * module show the wall time of the whole concurrent execution.
+   */
+  class ConcurrentPathsModule : public Module, public EventProcessor {
+  public:
+    ConcurrentPathsModule();
+    ~ConcurrentPathsModule();
+
+    /** used by Path::addConcurrentPaths() to actually set parameters. */
+    void init(const std::vector<std::shared_ptr<Path>>& paths, unsigned int nThreads);
+
+    virtual void initialize() override;
+    virtual void beginRun() override;
+    virtual void endRun() override;
+    virtual void event() override;
+    virtual void terminate() override;
+
+  private:
+    /** Set properties for this module based on the modules found in m_paths */
+    void setProperties();
+    /** Check that the paths can safely run concurrently, abort otherwise */
+    void checkPaths() const;
+    /** Call event() of all modules in one path */
+    void runPath(size_t index);
+    /** Take paths to process until none are left, called by the workers and the main thread
+     * @param logConfig log configuration to restore afterwards in this thread
+     * @param moduleName module name to restore afterwards in this thread
+     */
+    void processPaths(const LogConfig* logConfig, const std::string& moduleName);
+    /** Add the times measured by runPath() to the module statistics and the event trace */
+    void recordStatistics();
+    /** Main function of the worker threads */
+    void workerLoop();
+    /** Start the worker threads if not done yet in this process */
+    void startWorkers();
+    /** Stop and join the worker threads */
+    void stopWorkers();
+
+    /** Paths to execute concurrently */
+    std::vector<std::shared_ptr<Path>> m_paths;
+    /** Modules in each of the paths */
+    std::vector<ModulePtrList> m_pathModules;
+
+    /** Execution time of a module in the current event */
+    struct ModuleTiming {
+      double time{0}; /**< event() time as used by the module statistics */
+      int64_t traceStart{0}; /**< start of the event() call for the event trace */
+      int64_t traceEnd{0}; /**< end of the event() call for the event trace */
+    };
+    /** Execution times of the modules in each of the paths, filled by the thread executing the path */
+    std::vector<std::vector<ModuleTiming>> m_timings;
+    /** Maximum number of threads to use including the calling thread */
+    unsigned int m_nThreads{2};
+    /** when using multi-processing contains the ID of the process where
+     * event() is called (in that process only). -1 otherwise. */
+    int m_processID{ -1};
+
+    /** Worker threads, not including the calling thread */
+    std::vector<std::thread> m_workers;
+    /** Process which started the worker threads */
+    pid_t m_workersPID{0};
+    /** Protects the members used to hand out work and to wait for it */
+    std::mutex m_mutex;
+    /** Wakes up the workers for the next event or to stop */
+    std::condition_variable m_startCondition;
+    /** Wakes up the calling thread once all workers are done */
+    std::condition_variable m_doneCondition;
+    /** Incremented for each event so the workers know there is new work */
+    unsigned long m_generation{0};
+    /** Number of workers still working on the current event */
+    size_t m_pendingWorkers{0};
+    /** Set to stop the workers */
+    bool m_stopWorkers{false};
+    /** Index of the next path to process in the current event */
+    std::atomic<size_t> m_nextPath{0};
+    /** First exception thrown by any path in the current event */
+    std::exception_ptr m_exception;
+  };
+}
@@ -193,6 +193,30 @@ namespace Belle2 {
 
     /** Disable collection of statistics during event processing. */
     bool getNoStats() const { return m_noStats; }
+
+    /** Enable collection of hardware performance counters for all module calls. */
+    void setStatsHardwareCounters(bool on) { m_statsHardwareCounters = on; }
+
+    /** Enable collection of hardware performance counters for all module calls. */
+    bool getStatsHardwareCounters() const { return m_statsHardwareCounters; }
+
+    /** Measure the memory consumption in the event statistics only for every N-th event. */
+    void setStatsMemoryInterval(unsigned int interval) { m_statsMemoryInterval = interval; }
+
+    /** Measure the memory consumption in the event statistics only for every N-th event. */
+    unsigned int getStatsMemoryInterval() const { return m_statsMemoryInterval; }
+
+    /** Set the file to write a trace of all module event() calls to, empty disables tracing. */
+    void setTraceOutput(const std::string& filename) { m_traceOutput = filename; }
+
+    /** Get the file to write a trace of all module event() calls to, empty if tracing is disabled. */
+    const std::string& getTraceOutput() const { return m_traceOutput; }
+
+    /** Set the interval in events for tracing, only every N-th event of each process is recorded. */
+    void setTraceInterval(unsigned int interval) { m_traceInterval = interval; }
+
+    /** Get the interval in events for tracing. */
+    unsigned int getTraceInterval() const { return m_traceInterval; }
     /** Read steering file, but do not start any actually start any event processing. Prints information on input/output files and number of events that that would be used during normal execution. */
     void setDryRun(bool dryRun) { m_dryRun = dryRun; }
     /** Read steering file, but do not start any actually start any event processing. Prints information on input/output files and number of events that that would be used during normal execution. */
@@ -398,6 +422,10 @@ namespace Belle2 {
     int m_logLevelOverride; /**< Override global log level if != LogConfig::c_Default. */
     bool m_visualizeDataFlow; /**< Wether to generate DOT files with data store inputs/outputs of each module. */
     bool m_noStats; /**< Disable collection of statistics during event processing. Useful for very high-rate applications. */
+    bool m_statsHardwareCounters{false}; /**< Collect hardware performance counters for all module calls. */
+    unsigned int m_statsMemoryInterval{1}; /**< Measure the memory consumption only for every N-th event. */
+    std::string m_traceOutput; /**< File to write the event trace to, empty if disabled. */
+    unsigned int m_traceInterval{1}; /**< Only trace every N-th event of each process. */
     bool m_dryRun; /**< Read steering file, but do not start any actually start any event processing. Prints information on input/output files that that would be used during normal execution. */
     std::string m_jobInfoOutput; /**< Output for printJobInformation(), generated by setJobInformation(). */
     std::string m_profileModuleName; /**< Name of the module which should be profiled, empty if no profiling requested */
@@ -0,0 +1,140 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace Belle2 {
+
+  class Module;
+  class EventMetaData;
+
+  /**
+   * Records the start and end time of every module event() call and of each
+   * complete event to find the modules and events responsible for latency
+   * tails.
+   *
+   * Tracing is enabled with ``basf2 --trace-output=trace.json``. The records
+   * are kept in a fixed size ring buffer per process which is allocated once,
+   * so recording is just a clock readout and a store without any locking or
+   * allocation. If the buffer overflows the oldest records are overwritten.
+   * With ``--trace-interval N`` only every N-th event of each process is
+   * recorded.
+   *
+   * At the end of processing each process writes its records to
+   * ``<output>.<job>.<pid>.part``, where ``<job>`` is the pid of the process
+   * which configured the tracing, and the parent process merges the files of
+   * its job into one file in the Chrome trace event format, which can be opened with
+   * ``chrome://tracing`` or https://ui.perfetto.dev. Each process is shown as
+   * a separate track named after its role (input, worker, output) and all
+   * timestamps use the wall clock so the tracks of different processes can
+   * be compared directly.
+   */
+  class EventTracer {
+  public:
+    /** Return the instance for this process */
+    static EventTracer& Instance();
+
+    /**
+     * Configure the tracing.
+     * @param filename name of the trace file to write, empty disables tracing
+     * @param interval record only every interval-th event
+     * @param capacity maximum number of records kept in the ring buffer
+     */
+    void configure(const std::string& filename, unsigned int interval = 1, size_t capacity = c_DefaultCapacity);
+
+    /** Check if tracing is enabled at all */
+    bool isEnabled() const { return !m_filename.empty(); }
+
+    /** Check if the current event is recorded */
+    bool isActive() const { return m_active; }
+
+    /** Current wall clock time in ns. Utils::getClock() returns a double
+     * which is too coarse for absolute timestamps with ns resolution */
+    static int64_t now()
+    {
+      timespec ts;
+      clock_gettime(CLOCK_REALTIME, &ts);
+      return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    /** Mark the begin of a new event and decide whether to record it */
+    void beginEvent()
+    {
+      m_active = isEnabled() and (m_eventCounter++ % m_interval == 0);
+    }
+
+    /**
+     * Record one call if the current event is sampled.
+     * @param module module which was called or nullptr for the whole event
+     * @param start start time as returned by now()
+     * @param end end time as returned by now()
+     * @param eventMetaData event meta data of the current event if available
+     */
+    void record(const Module* module, int64_t start, int64_t end, const EventMetaData* eventMetaData);
+
+    /** Write the records of this process to its part file and clear them.
+     * Has to be called while the recorded modules are still alive. */
+    void writePart();
+
+    /** Merge the part files of all processes of this job into the trace file and remove them.
+     * Part files of other jobs writing to the same trace file are left alone. */
+    void merge();
+
+    /** Name of the part file for the process with the given pid */
+    std::string getPartFilename(int pid) const;
+
+    /** Default number of records in the ring buffer */
+    static constexpr size_t c_DefaultCapacity = 1 << 18;
+
+  private:
+    /** A single recorded call */
+    struct Record {
+      /** module called or nullptr for a complete event */
+      const Module* module;
+      /** start time in ns */
+      int64_t start;
+      /** end time in ns */
+      int64_t end;
+      /** experiment number */
+      int experiment;
+      /** run number */
+      int run;
+      /** event number */
+      unsigned int event;
+    };
+
+    /** Singleton, use Instance() */
+    EventTracer() = default;
+    /** No copies */
+    EventTracer(const EventTracer&) = delete;
+    /** No assignment */
+    EventTracer& operator=(const EventTracer&) = delete;
+
+    /** name of the merged trace file */
+    std::string m_filename;
+    /** identifier of this job in the part file names: the pid of the configuring process,
+     * which is inherited by all forked processes */
+    std::string m_jobId;
+    /** record only every m_interval-th event */
+    unsigned int m_interval{1};
+    /** number of events started in this process */
+    unsigned long m_eventCounter{0};
+    /** whether the current event is recorded */
+    bool m_active{false};
+    /** ring buffer of records */
+    std::vector<Record> m_records;
+    /** total number of records written, the next record goes to m_written % capacity */
+    size_t m_written{0};
+  };
+
+} //end of namespace Belle2
@@ -9,6 +9,9 @@
 #pragma once
 
 #include <framework/utilities/CalcMeanCov.h>
+#include <framework/utilities/HardwareCounters.h>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <ostream>
 
@@ -19,6 +22,12 @@ namespace Belle2 {
    * processing steps (initialize, beginRun, event, endRun, terminate and
    * total). It will automatically calculate a running mean, stddev and
    * correlation factor between time and memory consumption.
+   *
+   * For event() calls the execution times are also filled into a histogram
+   * with logarithmic bins to obtain percentiles of the time per call. Like
+   * HDR histograms each power of two is split into c_TimeSubBins linear bins
+   * so the relative precision is better than 1/c_TimeSubBins over the whole
+   * range from c_TimeMinimum to c_TimeMinimum * 2^c_TimeOctaves.
    */
   class ModuleStatistics {
   public:
@@ -41,6 +50,18 @@ namespace Belle2 {
     /** type of float variable to use for calculations and storage */
     typedef double value_type;
 
+    enum {
+      /** Number of linear bins per power of two in the time histogram */
+      c_TimeSubBins = 8,
+      /** Number of powers of two covered by the time histogram */
+      c_TimeOctaves = 32,
+      /** Number of bins in the time histogram including underflow and overflow */
+      c_TimeBins = c_TimeSubBins * c_TimeOctaves + 2
+    };
+    /** Lower edge of the first regular bin in the time histogram: 128 ns,
+     * the histogram then goes up to 128 ns * 2^32 = 9 minutes */
+    static constexpr value_type c_TimeMinimum = 128;
+
     /** Construct with a given name */
     explicit ModuleStatistics(const std::string& name = ""): m_index(0), m_name(name) {}
 
@@ -54,6 +75,38 @@ namespace Belle2 {
       m_stats[type].add(time, memory);
       if (type != c_Total)
         m_stats[c_Total].add(time, memory);
+      if (type == c_Event)
+        m_eventTimeHistogram[getTimeBin(time)] += 1;
+    }
+
+    /** Add a time measurement of a call without memory measurement to the
+     * counter of a given type. The memory statistics only include the calls
+     * with memory measurement.
+     * @param type Type of counter to add the value to
+     * @param time time used during execution
+     */
+    void addTime(EStatisticCounters type, value_type time)
+    {
+      m_timeOnlyStats[type].add(time);
+      if (type != c_Total)
+        m_timeOnlyStats[c_Total].add(time);
+      if (type == c_Event)
+        m_eventTimeHistogram[getTimeBin(time)] += 1;
+    }
+
+    /** Add hardware counter differences measured during one call to the
+     * counter of a given type.
+     * @param type Type of counter to add the values to
+     * @param values counter differences during execution
+     */
+    void addHardwareCounters(EStatisticCounters type, const HardwareCounters::Values& values)
+    {
+      for (int i = 0; i < HardwareCounters::c_NCounters; ++i) {
+        m_hardwareCounters[type][i] += values[i];
+        if (type != c_Total) m_hardwareCounters[c_Total][i] += values[i];
+      }
+      m_hardwareCounterCalls[type] += 1;
+      if (type != c_Total) m_hardwareCounterCalls[c_Total] += 1;
     }
 
     /** Add statistics for each category. */
@@ -61,6 +114,14 @@ namespace Belle2 {
     {
       for (int i = c_Init; i <= c_Total; i++) {
         m_stats[i].add(other.m_stats[i]);
+        m_timeOnlyStats[i].add(other.m_timeOnlyStats[i]);
+        for (int j = 0; j < HardwareCounters::c_NCounters; ++j) {
+          m_hardwareCounters[i][j] += other.m_hardwareCounters[i][j];
+        }
+        m_hardwareCounterCalls[i] += other.m_hardwareCounterCalls[i];
+      }
+      for (int i = 0; i < c_TimeBins; ++i) {
+        m_eventTimeHistogram[i] += other.m_eventTimeHistogram[i];
       }
     }
 
@@ -77,30 +138,43 @@ namespace Belle2 {
     /** return the number of calls for a given counter type */
     value_type getCalls(EStatisticCounters type = c_Total) const
     {
-      return m_stats[type].getEntries();
+      return m_stats[type].getEntries() + m_timeOnlyStats[type].getEntries();
     }
 
     /** return the sum of all execution times for a given counter */
     value_type getTimeSum(EStatisticCounters type = c_Total) const
     {
-      return m_stats[type].getSum<0>();
+      return m_stats[type].getSum<0>() + m_timeOnlyStats[type].getSum<0>();
     }
     /** return the mean execution time for a given counter */
     value_type getTimeMean(EStatisticCounters type = c_Total) const
     {
-      return m_stats[type].getMean<0>();
+      const value_type calls = getCalls(type);
+      return calls > 0 ? getTimeSum(type) / calls : 0;
     }
     /** return the stddev of the execution times for a given counter */
     value_type getTimeStddev(EStatisticCounters type = c_Total) const
     {
-      return m_stats[type].getStddev<0>();
+      const CalcMeanCov<2, value_type>& measured = m_stats[type];
+      const CalcMeanCov<1, value_type>& timeOnly = m_timeOnlyStats[type];
+      const value_type calls = getCalls(type);
+      if (calls <= 0) return 0;
+      // combine the variances of the calls with and without memory measurement
+      const value_type mean = getTimeMean(type);
+      const value_type deltaMeasured = measured.getMean<0>() - mean;
+      const value_type deltaTimeOnly = timeOnly.getMean<0>() - mean;
+      const value_type variance = (measured.getEntries() * (measured.getVariance<0>() + deltaMeasured * deltaMeasured) +
+                                   timeOnly.getEntries() * (timeOnly.getVariance<0>() + deltaTimeOnly * deltaTimeOnly)) / calls;
+      return std::sqrt(variance);
     }
-    /** return the total used memory for a given counter */
+    /** return the total used memory for a given counter. If the memory was
+     * only measured for some of the calls this is extrapolated from the
+     * average of the measured calls */
     value_type getMemorySum(EStatisticCounters type = c_Total) const
     {
-      return m_stats[type].getSum<1>();
+      return m_stats[type].getMean<1>() * getCalls(type);
     }
-    /** return the average memory change per call */
+    /** return the average memory change per call with memory measurement */
     value_type getMemoryMean(EStatisticCounters type = c_Total) const
     {
       return m_stats[type].getMean<1>();
@@ -117,6 +191,62 @@ namespace Belle2 {
       return m_stats[type].getCorrelation<0, 1>();
     }
 
+    /** return the time per event() call below which the given fraction of
+     * all calls are, e.g. 0.99 for the 99th percentile. The value is the
+     * upper edge of the histogram bin containing the percentile so it
+     * overestimates the true value by less than one bin width */
+    value_type getEventTimePercentile(double fraction) const;
+
+    /** return the number of entries in a bin of the event() time histogram */
+    unsigned long long getEventTimeBinContent(int bin) const { return m_eventTimeHistogram[bin]; }
+
+    /** return the bin of the event() time histogram for a given time */
+    static int getTimeBin(value_type time)
+    {
+      if (!(time >= c_TimeMinimum)) return 0;
+      int exponent;
+      // mantissa is in [0.5, 1)
+      const double mantissa = std::frexp(time / c_TimeMinimum, &exponent);
+      if (exponent > c_TimeOctaves) return c_TimeBins - 1;
+      const int subBin = static_cast<int>((2 * mantissa - 1) * c_TimeSubBins);
+      return 1 + (exponent - 1) * c_TimeSubBins + subBin;
+    }
+
+    /** return the upper edge of a bin in the event() time histogram */
+    static value_type getTimeBinUpperEdge(int bin)
+    {
+      if (bin <= 0) return c_TimeMinimum;
+      if (bin >= c_TimeBins - 1) return std::numeric_limits<value_type>::infinity();
+      const int octave = (bin - 1) / c_TimeSubBins;
+      const int subBin = (bin - 1) % c_TimeSubBins;
+      return std::ldexp(c_TimeMinimum, octave) * (1 + (subBin + 1.0) / c_TimeSubBins);
+    }
+
+    /** return the number of calls for which hardware counters were recorded */
+    value_type getHardwareCounterCalls(EStatisticCounters type = c_Total) const
+    {
+      return m_hardwareCounterCalls[type];
+    }
+
+    /** return the sum of a hardware counter over all calls for a given counter type */
+    value_type getHardwareCounterSum(HardwareCounters::ECounter counter, EStatisticCounters type = c_Total) const
+    {
+      return m_hardwareCounters[type][counter];
+    }
+
+    /** return the mean of a hardware counter per call for a given counter type */
+    value_type getHardwareCounterMean(HardwareCounters::ECounter counter, EStatisticCounters type = c_Total) const
+    {
+      return m_hardwareCounterCalls[type] > 0 ? m_hardwareCounters[type][counter] / m_hardwareCounterCalls[type] : 0;
+    }
+
+    /** return the number of instructions per cycle for a given counter type */
+    value_type getInstructionsPerCycle(EStatisticCounters type = c_Total) const
+    {
+      const value_type cycles = m_hardwareCounters[type][HardwareCounters::c_Cycles];
+      return cycles > 0 ? m_hardwareCounters[type][HardwareCounters::c_Instructions] / cycles : 0;
+    }
+
     /** write csv header to the given stream */
     void csv_header(std::ostream& output) const;
     /** write data to the given stream in csv format */
@@ -131,6 +261,12 @@ namespace Belle2 {
     void clear()
     {
       for (auto& stat : m_stats) stat.clear();
+      for (auto& stat : m_timeOnlyStats) stat.clear();
+      for (auto& counters : m_hardwareCounters) {
+        for (auto& counter : counters) counter = 0;
+      }
+      for (auto& calls : m_hardwareCounterCalls) calls = 0;
+      for (auto& entries : m_eventTimeHistogram) entries = 0;
     }
   private:
     /** display index of the module */
@@ -139,6 +275,14 @@ namespace Belle2 {
     std::string m_name;
     /** array with  mean/covariance for all counters */
     CalcMeanCov<2, value_type> m_stats[c_Total + 1];
+    /** array with mean/variance of the time for all calls without memory measurement */
+    CalcMeanCov<1, value_type> m_timeOnlyStats[c_Total + 1];
+    /** array with the sums of all hardware counters for all counters */
+    value_type m_hardwareCounters[c_Total + 1][HardwareCounters::c_NCounters] {};
+    /** array with the number of calls with hardware counter values for all counters */
+    value_type m_hardwareCounterCalls[c_Total + 1] {};
+    /** histogram of the time per event() call, see getTimeBin() for the binning */
+    unsigned long long m_eventTimeHistogram[c_TimeBins] {};
   };
 
 } //Belle2 namespace
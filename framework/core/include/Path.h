@@ -117,6 +117,9 @@ namespace Belle2 {
     void addIndependentMergePath(const PathPtr& independent_path, std::string ds_ID, const boost::python::list& merge_back,
                                  std::string consistency_check, bool event_mixing, bool mergeSameFile);
 
+    /** See 'pydoc3 basf2.Path' */
+    void addConcurrentPaths(const boost::python::list& paths, unsigned int threads);
+
 
     /** return a string of the form [module a -> module b -> [another path]]
      *
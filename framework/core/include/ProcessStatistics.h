@@ -12,6 +12,7 @@
 #include <framework/pcore/Mergeable.h>
 #include <framework/core/Module.h>
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -67,6 +68,21 @@ namespace Belle2 {
    *  - name:                         name of the module
    *  - time(type=statistics.EVENT):  time in seconds spent in function
    *  - calls(type=statistics.EVENT): number of calls to function
+   *  - time_percentile(fraction):    time per event() call below which the
+   *    given fraction of calls are, e.g. 0.999 for the 99.9th percentile
+   *  - hardware_counter_sum(hwcounter, type=statistics.TOTAL): sum of a
+   *    hardware counter like statistics.CYCLES or statistics.INSTRUCTIONS
+   *  - instructions_per_cycle(type=statistics.TOTAL): instructions per cycle
+   *
+   * The hardware counters are only filled if requested with
+   * ``basf2 --stats-hardware-counters``. They are read with one system call
+   * before and after each module call and only count user space.
+   *
+   * Reading the memory consumption for every module call is comparably
+   * expensive so with ``basf2 --stats-memory-interval N`` it is only measured
+   * for every N-th event. The memory means and standard deviations are
+   * computed from the measured events only and the memory sums are
+   * extrapolated to all events. Times always include all events.
    *
    * The global statistics for the framework can be accessed via
    * statistics.framework
@@ -84,6 +100,17 @@ namespace Belle2 {
       m_global("Total"), m_globalTime(0), m_globalMemory(0), m_moduleTime(0), m_moduleMemory(0), m_suspendedTime(0),
       m_suspendedMemory(0) { }
 
+    /** Enable or disable reading the hardware counters for all module calls.
+     * Returns false if they were requested but are not available. */
+    bool setCollectHardwareCounters(bool collect)
+    {
+      m_collectHardwareCounters = collect and HardwareCounters::isAvailable();
+      return m_collectHardwareCounters == collect;
+    }
+
+    /** Set the interval in events to measure the memory consumption during event processing */
+    void setMemorySamplingInterval(unsigned int interval) { m_memorySamplingInterval = std::max(interval, 1u); }
+
     /**
      * Return string with statistics for all modules.
      *
@@ -103,8 +130,20 @@ namespace Belle2 {
     /** Get entire statistics map. */
     const std::vector<Belle2::ModuleStatistics>& getAll() const { return m_stats; }
 
-    /** Start timer for global measurement */
-    void startGlobal() { setCounters(m_globalTime, m_globalMemory); }
+    /** Start timer for global measurement
+     * @param type counter type which will be measured. For c_Event the
+     *             memory is only measured for every N-th call if a memory
+     *             sampling interval is set.
+     */
+    void startGlobal(ModuleStatistics::EStatisticCounters type = ModuleStatistics::c_Init)
+    {
+      m_measureMemory = true;
+      if (type == ModuleStatistics::c_Event and m_memorySamplingInterval > 1) {
+        m_measureMemory = (m_sampledEvents++ % m_memorySamplingInterval == 0);
+      }
+      setCounters(m_globalTime, m_globalMemory);
+      setHardwareCounters(m_globalCounters);
+    }
 
     /** Suspend timer for global measurement, needed for newRun.
      * resumeGlobal should be called once endRun/newRun handling is
@@ -113,13 +152,17 @@ namespace Belle2 {
     {
       setCounters(m_suspendedTime, m_suspendedMemory,
                   m_globalTime, m_globalMemory);
+      setHardwareCounters(m_suspendedCounters, &m_globalCounters);
+      m_suspendedMeasureMemory = m_measureMemory;
     }
 
     /** Resume timer after call to suspendGlobal() */
     void resumeGlobal()
     {
+      m_measureMemory = m_suspendedMeasureMemory;
       setCounters(m_globalTime, m_globalMemory,
                   m_suspendedTime, m_suspendedMemory);
+      setHardwareCounters(m_globalCounters, &m_suspendedCounters);
     }
 
     /** Stop global timer and add values to the statistic counter */
@@ -127,13 +170,18 @@ namespace Belle2 {
     {
       setCounters(m_globalTime, m_globalMemory,
                   m_globalTime, m_globalMemory);
-      m_global.add(type, m_globalTime, m_globalMemory);
+      addMeasurement(m_global, type, m_globalTime, m_globalMemory);
+      if (m_collectHardwareCounters) {
+        setHardwareCounters(m_globalCounters, &m_globalCounters);
+        m_global.addHardwareCounters(type, m_globalCounters);
+      }
     }
 
     /** Start module timer */
     void startModule()
     {
       setCounters(m_moduleTime, m_moduleMemory);
+      setHardwareCounters(m_moduleCounters);
     }
 
     /** Stop module counter and attribute values to appropriate module */
@@ -141,8 +189,11 @@ namespace Belle2 {
     {
       setCounters(m_moduleTime, m_moduleMemory,
                   m_moduleTime, m_moduleMemory);
+      setHardwareCounters(m_moduleCounters, &m_moduleCounters);
       if (module && module->hasProperties(Module::c_DontCollectStatistics)) return;
-      m_stats[getIndex(module)].add(type, m_moduleTime, m_moduleMemory);
+      ModuleStatistics& stats = m_stats[getIndex(module)];
+      addMeasurement(stats, type, m_moduleTime, m_moduleMemory);
+      if (m_collectHardwareCounters) stats.addHardwareCounters(type, m_moduleCounters);
     }
 
     /** Init module statistics: Set name from module if still empty and
@@ -201,6 +252,30 @@ namespace Belle2 {
     void setCounters(double& time, double& memory,
                      double startTime = 0, double startMemory = 0);
 
+    /** Add the measured values to the statistics, the memory only if it was measured for this call */
+    void addMeasurement(ModuleStatistics& stats, ModuleStatistics::EStatisticCounters type, double time, double memory) const
+    {
+      if (m_measureMemory) {
+        stats.add(type, time, memory);
+      } else {
+        stats.addTime(type, time);
+      }
+    }
+
+    /** Set the hardware counters to the current values if they are collected.
+     * @param counters variable to store the counter values
+     * @param start if given, values to subtract from the counters
+     */
+    void setHardwareCounters(HardwareCounters::Values& counters, const HardwareCounters::Values* start = nullptr)
+    {
+      if (!m_collectHardwareCounters) return;
+      HardwareCounters::Values current;
+      if (!HardwareCounters::read(current)) return;
+      for (int i = 0; i < HardwareCounters::c_NCounters; ++i) {
+        counters[i] = current[i] - (start ? (*start)[i] : 0);
+      }
+    }
+
     ModuleStatistics m_global; /**< Statistics object for global time and memory consumption */
     std::vector<Belle2::ModuleStatistics> m_stats; /**< module statistics */
 
@@ -225,6 +300,22 @@ namespace Belle2 {
      * would be a stack of values but we know that we need at most one
      * element so we keep it a plain double. */
     double m_suspendedMemory; //! (transient)
+    /** hardware counter values for global measurement */
+    HardwareCounters::Values m_globalCounters{}; //! (transient)
+    /** hardware counter values for measurement of modules */
+    HardwareCounters::Values m_moduleCounters{}; //! (transient)
+    /** hardware counter values for suspended measurement */
+    HardwareCounters::Values m_suspendedCounters{}; //! (transient)
+    /** whether the hardware counters are read for all calls */
+    bool m_collectHardwareCounters{false}; //! (transient)
+    /** measure the memory consumption only for every N-th event */
+    unsigned int m_memorySamplingInterval{1}; //! (transient)
+    /** number of events started, used to select the events with memory measurement */
+    unsigned int m_sampledEvents{0}; //! (transient)
+    /** whether the memory is measured for the current call */
+    bool m_measureMemory{true}; //! (transient)
+    /** whether the memory is measured for the suspended measurement */
+    bool m_suspendedMeasureMemory{true}; //! (transient)
 
     ClassDefOverride(ProcessStatistics, 2); /**< Class to collect call statistics for all modules. */
   };
@@ -7,7 +7,8 @@
 
 #pragma link C++ class Belle2::CalcMeanCov<2, float>+; // checksum=0x29b138d9, implicit, version=-1
 #pragma link C++ class Belle2::CalcMeanCov<2, double>+; // checksum=0x799a9631, implicit, version=-1
-#pragma link C++ class Belle2::ModuleStatistics+; // checksum=0x90989198, version=-1
+#pragma link C++ class Belle2::CalcMeanCov<1, double>+; // checksum=0x2e74aa89, implicit, version=-1
+#pragma link C++ class Belle2::ModuleStatistics+; // checksum=0xcb421157, version=-1
 #pragma link C++ class vector<Belle2::ModuleStatistics>+; // checksum=0x88bd6342, version=6
 #pragma link C++ class Belle2::ProcessStatistics+; // checksum=0x70dfd8a3, version=2
 #pragma link C++ class Belle2::Environment-;
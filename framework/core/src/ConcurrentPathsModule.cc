@@ -0,0 +1,338 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/core/ConcurrentPathsModule.h>
+
+#include <framework/core/Environment.h>
+#include <framework/core/EventTracer.h>
+#include <framework/core/ModuleManager.h>
+#include <framework/core/ProcessStatistics.h>
+#include <framework/dataobjects/EventMetaData.h>
+#include <framework/pcore/ProcHandler.h>
+#include <framework/datastore/DataStore.h>
+#include <framework/datastore/DependencyMap.h>
+#include <framework/datastore/StoreObjPtr.h>
+#include <framework/logging/LogSystem.h>
+#include <framework/utilities/Utils.h>
+
+#include <TClass.h>
+#include <TROOT.h>
+
+#include <algorithm>
+#include <set>
+#include <unistd.h>
+
+using namespace Belle2;
+
+//REG_MODLUE needed for --execute-path functionality
+//Note: should not appear in module list since we're not in the right directory
+REG_MODULE(ConcurrentPaths);
+
+ConcurrentPathsModule::ConcurrentPathsModule(): Module(), EventProcessor()
+{
+  setDescription(R"DOC(Internal module to handle Path.add_concurrent_paths().
+
+  Warning:
+    Don't add this module directly with `Path.add_module` or
+    `basf2.register_module` but use `Path.add_concurrent_paths()`
+
+  This module shouldn't appear in ``basf2 -m`` output.
+  If it does, check REG_MODULE() handling.)DOC");
+
+  addParam("paths", m_paths, "Paths to execute concurrently.", m_paths);
+  addParam("threads", m_nThreads, "Maximum number of threads, including the calling one. 1 executes the paths sequentially.",
+           m_nThreads);
+}
+
+ConcurrentPathsModule::~ConcurrentPathsModule()
+{
+  stopWorkers();
+}
+
+void ConcurrentPathsModule::init(const std::vector<std::shared_ptr<Path>>& paths, unsigned int nThreads)
+{
+  m_paths = paths;
+  m_nThreads = nThreads;
+  std::string name;
+  for (const auto& path : m_paths) {
+    if (!name.empty()) name += " | ";
+    name += path->getPathString();
+  }
+  setName("concurrent(" + name + ")");
+  setProperties();
+}
+
+void ConcurrentPathsModule::setProperties()
+{
+  m_moduleList.clear();
+  m_pathModules.clear();
+  m_timings.clear();
+  for (const auto& path : m_paths) {
+    m_pathModules.push_back(path->buildModulePathList());
+    m_moduleList.insert(m_moduleList.end(), m_pathModules.back().begin(), m_pathModules.back().end());
+    m_timings.emplace_back(m_pathModules.back().size());
+  }
+  //set c_ParallelProcessingCertified flag if _all_ modules have it set
+  auto flag = Module::c_ParallelProcessingCertified;
+  if (ModuleManager::allModulesHaveFlag(m_moduleList, flag))
+    setPropertyFlags(c_TerminateInAllProcesses | flag);
+  else
+    setPropertyFlags(c_TerminateInAllProcesses);
+}
+
+void ConcurrentPathsModule::checkPaths() const
+{
+  // collect what each path reads and writes
+  const auto& moduleInfos = DataStore::Instance().getDependencyMap().getModuleInfoMap();
+  const auto& storeEntries = DataStore::Instance().getStoreEntryMap(DataStore::c_Event);
+  std::vector<std::set<std::string>> inputs(m_pathModules.size()), outputs(m_pathModules.size());
+  std::vector<std::set<const TClass*>> arrayClasses(m_pathModules.size());
+  for (size_t i = 0; i < m_pathModules.size(); ++i) {
+    for (const ModulePtr& module : m_pathModules[i]) {
+      if (module->hasCondition()) {
+        B2FATAL("Modules in Path.add_concurrent_paths() cannot have any conditions" << LogVar("module", module->getName()));
+      }
+      // the worker threads don't hold the python interpreter lock
+      if (m_nThreads > 1 and module->getType() == "PyModule") {
+        B2FATAL("Python modules cannot be executed in Path.add_concurrent_paths() with more than one thread"
+                << LogVar("module", module->getName()));
+      }
+      auto it = moduleInfos.find(DependencyMap::getModuleID(*module));
+      if (it == moduleInfos.end()) continue;
+      const DependencyMap::ModuleInfo& info = it->second;
+      for (const auto* names : {info.entries, info.relations}) {
+        outputs[i].insert(names[DependencyMap::c_Output].begin(), names[DependencyMap::c_Output].end());
+        inputs[i].insert(names[DependencyMap::c_Input].begin(), names[DependencyMap::c_Input].end());
+        inputs[i].insert(names[DependencyMap::c_OptionalInput].begin(), names[DependencyMap::c_OptionalInput].end());
+      }
+    }
+    for (const std::string& name : outputs[i]) {
+      auto entry = storeEntries.find(name);
+      if (entry != storeEntries.end() and entry->second.isArray) arrayClasses[i].insert(entry->second.objClass);
+    }
+  }
+  // and make sure no path touches the output of another one
+  for (size_t i = 0; i < m_pathModules.size(); ++i) {
+    for (size_t j = 0; j < m_pathModules.size(); ++j) {
+      if (i == j) continue;
+      for (const std::string& name : outputs[i]) {
+        if (outputs[j].count(name) > 0 or inputs[j].count(name) > 0) {
+          B2FATAL("Paths in Path.add_concurrent_paths() have to be independent but an output of one path is used by another"
+                  << LogVar("name", name) << LogVar("written by", m_paths[i]->getPathString())
+                  << LogVar("used by", m_paths[j]->getPathString()));
+        }
+      }
+      // relations are looked up by scanning all arrays of the object's class, so these have to be distinct as well
+      for (const TClass* arrayClass : arrayClasses[i]) {
+        if (arrayClasses[j].count(arrayClass) > 0) {
+          B2FATAL("Paths in Path.add_concurrent_paths() cannot both write arrays of the same class"
+                  << LogVar("class", arrayClass->GetName()) << LogVar("first path", m_paths[i]->getPathString())
+                  << LogVar("second path", m_paths[j]->getPathString()));
+        }
+      }
+    }
+  }
+}
+
+void ConcurrentPathsModule::initialize()
+{
+  if (m_paths.empty()) {
+    B2FATAL("ConcurrentPaths module not initialised properly.");
+  }
+  if (m_pathModules.size() != m_paths.size()) setProperties();
+
+  StoreObjPtr<ProcessStatistics> processStatistics("", DataStore::c_Persistent);
+  processStatistics->suspendGlobal();
+
+  processInitialize(m_moduleList, false);
+  checkPaths();
+  // creating arrays and objects in several threads requires ROOT to be thread safe
+  if (m_nThreads > 1) ROOT::EnableThreadSafety();
+
+  //don't screw up statistics for this module
+  processStatistics->startModule();
+  processStatistics->resumeGlobal();
+}
+
+void ConcurrentPathsModule::terminate()
+{
+  stopWorkers();
+
+  StoreObjPtr<ProcessStatistics> processStatistics("", DataStore::c_Persistent);
+  processStatistics->suspendGlobal();
+
+  if (!ProcHandler::parallelProcessingUsed() or m_processID == ProcHandler::EvtProcID()) {
+    processTerminate(m_moduleList);
+  } else {
+    //we're in another process than we actually belong to, only call terminate where approriate
+    ModulePtrList tmpModuleList;
+    for (const ModulePtr& m : m_moduleList) {
+      if (m->hasProperties(c_TerminateInAllProcesses))
+        tmpModuleList.push_back(m);
+    }
+    processTerminate(tmpModuleList);
+  }
+
+  //don't screw up statistics for this module
+  processStatistics->startModule();
+  processStatistics->resumeGlobal();
+}
+
+void ConcurrentPathsModule::beginRun()
+{
+  m_processID = ProcHandler::EvtProcID();
+
+  StoreObjPtr<ProcessStatistics> processStatistics("", DataStore::c_Persistent);
+  processStatistics->suspendGlobal();
+  processBeginRun();
+
+  //don't screw up statistics for this module
+  processStatistics->startModule();
+  processStatistics->resumeGlobal();
+}
+
+void ConcurrentPathsModule::endRun()
+{
+  StoreObjPtr<ProcessStatistics> processStatistics("", DataStore::c_Persistent);
+  processStatistics->suspendGlobal();
+  processEndRun();
+
+  //don't screw up statistics for this module
+  processStatistics->startModule();
+  processStatistics->resumeGlobal();
+}
+
+void ConcurrentPathsModule::event()
+{
+  const size_t nThreads = std::min<size_t>(m_nThreads, m_pathModules.size());
+  if (nThreads <= 1) {
+    // sequential execution, for example to check the output of the concurrent one
+    for (const ModulePtrList& modules : m_pathModules) {
+      for (const ModulePtr& module : modules) callEvent(module.get());
+    }
+    //don't screw up statistics for this module
+    StoreObjPtr<ProcessStatistics> processStatistics("", DataStore::c_Persistent);
+    processStatistics->startModule();
+    return;
+  }
+
+  startWorkers();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nextPath = 0;
+    m_exception = nullptr;
+    m_pendingWorkers = m_workers.size();
+    ++m_generation;
+  }
+  m_startCondition.notify_all();
+  // the calling thread takes its share of the paths as well
+  processPaths(&getLogConfig(), getName());
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_pendingWorkers == 0; });
+  }
+  if (m_exception) std::rethrow_exception(m_exception);
+  recordStatistics();
+}
+
+void ConcurrentPathsModule::runPath(size_t index)
+{
+  LogSystem& logSystem = LogSystem::Instance();
+  const EventTracer& tracer = EventTracer::Instance();
+  const ModulePtrList& modules = m_pathModules[index];
+  std::vector<ModuleTiming>& timings = m_timings[index];
+  for (size_t i = 0; i < modules.size(); ++i) {
+    Module* module = modules[i].get();
+    ModuleTiming& timing = timings[i];
+    // the log configuration is per thread
+    logSystem.updateModule(&(module->getLogConfig()), module->getName());
+    timing.traceStart = tracer.isActive() ? EventTracer::now() : 0;
+    const double start = Utils::getClock();
+    module->event();
+    timing.time = Utils::getClock() - start;
+    timing.traceEnd = tracer.isActive() ? EventTracer::now() : 0;
+  }
+}
+
+void ConcurrentPathsModule::processPaths(const LogConfig* logConfig, const std::string& moduleName)
+{
+  for (size_t index = m_nextPath++; index < m_pathModules.size(); index = m_nextPath++) {
+    try {
+      runPath(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (!m_exception) m_exception = std::current_exception();
+    }
+  }
+  LogSystem::Instance().updateModule(logConfig, moduleName);
+}
+
+void ConcurrentPathsModule::recordStatistics()
+{
+  // the shared statistics and trace buffer are only filled by the calling thread after all paths are done
+  StoreObjPtr<ProcessStatistics> processStatistics("", DataStore::c_Persistent);
+  const bool collectStats = !Environment::Instance().getNoStats() and processStatistics.isValid();
+  EventTracer& tracer = EventTracer::Instance();
+  StoreObjPtr<EventMetaData> eventMetaData;
+  for (size_t index = 0; index < m_pathModules.size(); ++index) {
+    for (size_t i = 0; i < m_pathModules[index].size(); ++i) {
+      const Module* module = m_pathModules[index][i].get();
+      const ModuleTiming& timing = m_timings[index][i];
+      if (collectStats and !module->hasProperties(Module::c_DontCollectStatistics)) {
+        processStatistics->getStatistics(module).addTime(ModuleStatistics::c_Event, timing.time);
+      }
+      if (tracer.isActive()) {
+        tracer.record(module, timing.traceStart, timing.traceEnd, eventMetaData.isValid() ? &*eventMetaData : nullptr);
+      }
+    }
+  }
+}
+
+void ConcurrentPathsModule::workerLoop()
+{
+  unsigned long generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_startCondition.wait(lock, [&] { return m_stopWorkers or m_generation != generation; });
+      if (m_stopWorkers) return;
+      generation = m_generation;
+    }
+    processPaths(nullptr, "");
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_pendingWorkers == 0) m_doneCondition.notify_one();
+    }
+  }
+}
+
+void ConcurrentPathsModule::startWorkers()
+{
+  // threads don't survive a fork so they are started on the first event in
+  // the process which actually executes the paths
+  if (!m_workers.empty() and m_workersPID == getpid()) return;
+  m_workersPID = getpid();
+  m_stopWorkers = false;
+  const size_t nWorkers = std::min<size_t>(m_nThreads, m_pathModules.size()) - 1;
+  B2DEBUG(20, "Starting worker threads" << LogVar("threads", nWorkers));
+  for (size_t i = 0; i < nWorkers; ++i) {
+    m_workers.emplace_back(&ConcurrentPathsModule::workerLoop, this);
+  }
+}
+
+void ConcurrentPathsModule::stopWorkers()
+{
+  if (m_workers.empty() or m_workersPID != getpid()) return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopWorkers = true;
+  }
+  m_startCondition.notify_all();
+  for (std::thread& worker : m_workers) worker.join();
+  m_workers.clear();
+}
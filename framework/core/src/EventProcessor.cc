@@ -18,6 +18,7 @@
 #include <framework/logging/Logger.h>
 #include <framework/core/Environment.h>
 #include <framework/core/DataFlowVisualization.h>
+#include <framework/core/EventTracer.h>
 #include <framework/core/RandomNumbers.h>
 #include <framework/core/MetadataService.h>
 #include <framework/gearbox/Unit.h>
@@ -198,6 +199,7 @@ void EventProcessor::process(const PathPtr& startPath, long maxEvent)
 
   //Terminate modules
   processTerminate(moduleList);
+  EventTracer::Instance().merge();
 
   LogSystem::Instance().printErrorSummary();
 
@@ -231,9 +233,12 @@ void EventProcessor::callEvent(Module* module)
   logSystem.updateModule(&(module->getLogConfig()), module->getName());
   // set up statistics is requested
   if (collectStats) m_processStatisticsPtr->startModule();
+  EventTracer& tracer = EventTracer::Instance();
+  const int64_t traceStart = tracer.isActive() ? EventTracer::now() : 0;
   // call module
   CALL_MODULE(module, event);
   // stop timing
+  if (tracer.isActive()) tracer.record(module, traceStart, EventTracer::now(), m_eventMetaDataPtr.isValid() ? &*m_eventMetaDataPtr : nullptr);
   if (collectStats) m_processStatisticsPtr->stopModule(module, ModuleStatistics::c_Event);
   // reset logging
   logSystem.updateModule(nullptr);
@@ -250,6 +255,12 @@ void EventProcessor::processInitialize(const ModulePtrList& modulePathList, bool
   //     Maybe make this a function argument?
   if (!m_processStatisticsPtr)
     m_processStatisticsPtr.create();
+  const Environment& environment = Environment::Instance();
+  if (!m_processStatisticsPtr->setCollectHardwareCounters(environment.getStatsHardwareCounters())) {
+    B2WARNING("Hardware performance counters are not available, module statistics will not contain them");
+  }
+  m_processStatisticsPtr->setMemorySamplingInterval(environment.getStatsMemoryInterval());
+  EventTracer::Instance().configure(environment.getTraceOutput(), environment.getTraceInterval());
   m_processStatisticsPtr->startGlobal();
 
   MetadataService::Instance().addBasf2Status("initializing");
@@ -411,16 +422,20 @@ void EventProcessor::processCore(const PathPtr& startPath, const ModulePtrList&
   m_previousEventMetaData.setEndOfData(); //invalid start state
 
   const bool collectStats = !Environment::Instance().getNoStats();
+  EventTracer& tracer = EventTracer::Instance();
 
   //Loop over the events
   long currEvent = 0;
   bool endProcess = false;
   while (!endProcess) {
     if (collectStats)
-      m_processStatisticsPtr->startGlobal();
+      m_processStatisticsPtr->startGlobal(ModuleStatistics::c_Event);
+    tracer.beginEvent();
+    const int64_t traceStart = tracer.isActive() ? EventTracer::now() : 0;
 
     PathIterator moduleIter(startPath);
     endProcess = processEvent(moduleIter, isInputProcess && currEvent == 0);
+    if (tracer.isActive()) tracer.record(nullptr, traceStart, EventTracer::now(), m_eventMetaDataPtr.isValid() ? &*m_eventMetaDataPtr : nullptr);
 
     //Delete event related data in DataStore
     DataStore::Instance().invalidateData(DataStore::c_Event);
@@ -461,6 +476,9 @@ void EventProcessor::processTerminate(const ModulePtrList& modulePathList)
   }
 
   m_processStatisticsPtr->stopGlobal(ModuleStatistics::c_Term);
+
+  // modules are still alive so we can write the trace of this process
+  EventTracer::Instance().writePart();
 }
 
 
@@ -0,0 +1,148 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/core/EventTracer.h>
+#include <framework/core/Module.h>
+#include <framework/dataobjects/EventMetaData.h>
+#include <framework/logging/Logger.h>
+#include <framework/pcore/GlobalProcHandler.h>
+#include <framework/pcore/ProcHandler.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using namespace Belle2;
+namespace fs = std::filesystem;
+
+namespace {
+  /** Name of the current process to be shown in the trace */
+  std::string getProcessLabel()
+  {
+    if (GlobalProcHandler::parallelProcessingUsed()) return GlobalProcHandler::getProcessName();
+    if (ProcHandler::parallelProcessingUsed()) return ProcHandler::getProcessName();
+    return "basf2";
+  }
+}
+
+EventTracer& EventTracer::Instance()
+{
+  static EventTracer instance;
+  return instance;
+}
+
+void EventTracer::configure(const std::string& filename, unsigned int interval, size_t capacity)
+{
+  m_filename = filename;
+  m_jobId = std::to_string(getpid());
+  m_interval = std::max(interval, 1u);
+  m_eventCounter = 0;
+  m_active = false;
+  m_written = 0;
+  m_records.clear();
+  // allocate everything now so that recording never allocates
+  if (isEnabled()) m_records.resize(std::max<size_t>(capacity, 1));
+  else m_records.shrink_to_fit();
+}
+
+void EventTracer::record(const Module* module, int64_t start, int64_t end, const EventMetaData* eventMetaData)
+{
+  if (!m_active) return;
+  Record& record = m_records[m_written++ % m_records.size()];
+  record.module = module;
+  record.start = start;
+  record.end = end;
+  record.experiment = eventMetaData ? eventMetaData->getExperiment() : 0;
+  record.run = eventMetaData ? eventMetaData->getRun() : 0;
+  record.event = eventMetaData ? eventMetaData->getEvent() : 0;
+}
+
+std::string EventTracer::getPartFilename(int pid) const
+{
+  return m_filename + "." + m_jobId + "." + std::to_string(pid) + ".part";
+}
+
+void EventTracer::writePart()
+{
+  if (!isEnabled() or m_written == 0) return;
+  const int pid = getpid();
+  const size_t capacity = m_records.size();
+  const size_t first = m_written > capacity ? m_written - capacity : 0;
+  if (first > 0) {
+    B2WARNING("Trace buffer overflow, only the most recent calls are written to the trace file"
+              << LogVar("dropped records", first) << LogVar("capacity", capacity));
+  }
+
+  std::ofstream output(getPartFilename(pid));
+  if (!output) {
+    B2ERROR("Cannot write event trace" << LogVar("filename", getPartFilename(pid)));
+    return;
+  }
+  // one trace event per line so the parent can merge without parsing
+  nlohmann::json processName = {
+    {"name", "process_name"}, {"ph", "M"}, {"pid", pid}, {"tid", 0},
+    {"args", {{"name", getProcessLabel() + " " + std::to_string(pid)}}}
+  };
+  output << processName.dump() << "\n";
+  for (size_t i = first; i < m_written; ++i) {
+    const Record& record = m_records[i % capacity];
+    nlohmann::json entry = {
+      {"name", record.module ? record.module->getName() : "event"},
+      {"cat", record.module ? "module" : "event"},
+      {"ph", "X"}, {"pid", pid}, {"tid", 0},
+      {"ts", record.start / 1e3},
+      {"dur", (record.end - record.start) / 1e3},
+      {"args", {{"exp", record.experiment}, {"run", record.run}, {"evt", record.event}}}
+    };
+    output << entry.dump() << "\n";
+  }
+  m_written = 0;
+}
+
+void EventTracer::merge()
+{
+  if (!isEnabled()) return;
+  const fs::path target = fs::absolute(m_filename);
+  // only the parts of this job, other jobs might write to the same file name
+  const std::string prefix = target.filename().string() + "." + m_jobId + ".";
+  std::vector<fs::path> parts;
+  std::error_code ec;
+  for (const auto& entry : fs::directory_iterator(target.parent_path(), ec)) {
+    const std::string name = entry.path().filename().string();
+    if (name.size() > prefix.size() + 5 and name.compare(0, prefix.size(), prefix) == 0
+        and name.compare(name.size() - 5, 5, ".part") == 0) {
+      parts.push_back(entry.path());
+    }
+  }
+  std::sort(parts.begin(), parts.end());
+
+  std::ofstream output(target);
+  if (!output) {
+    B2ERROR("Cannot write event trace" << LogVar("filename", m_filename));
+    return;
+  }
+  output << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+  bool first = true;
+  for (const fs::path& part : parts) {
+    std::ifstream input(part);
+    std::string line;
+    while (std::getline(input, line)) {
+      if (line.empty()) continue;
+      if (!first) output << ",\n";
+      output << line;
+      first = false;
+    }
+    input.close();
+    fs::remove(part, ec);
+  }
+  output << "\n]}\n";
+  B2INFO("Event trace written" << LogVar("filename", m_filename) << LogVar("processes", parts.size()));
+}
@@ -10,6 +10,21 @@
 
 using namespace Belle2;
 
+ModuleStatistics::value_type ModuleStatistics::getEventTimePercentile(double fraction) const
+{
+  unsigned long long entries = 0;
+  for (auto content : m_eventTimeHistogram) entries += content;
+  if (entries == 0) return 0;
+  // number of entries which have to be at or below the percentile
+  const double required = fraction * entries;
+  unsigned long long sum = 0;
+  for (int bin = 0; bin < c_TimeBins; ++bin) {
+    sum += m_eventTimeHistogram[bin];
+    if (sum > 0 and sum >= required) return getTimeBinUpperEdge(bin);
+  }
+  return getTimeBinUpperEdge(c_TimeBins - 1);
+}
+
 void ModuleStatistics::csv_header(std::ostream& output) const
 {
   output << "name";
@@ -16,6 +16,7 @@
 #include <framework/core/Module.h>
 #include <framework/core/ModuleManager.h>
 #include <framework/core/SubEventModule.h>
+#include <framework/core/ConcurrentPathsModule.h>
 #include <framework/core/SwitchDataStoreModule.h>
 #include <framework/core/MergeDataStoreModule.h>
 #include <framework/core/SteerRootInputModule.h>
@@ -106,6 +107,17 @@ void Path::doWhile(PathPtr path, const std::string& condition, unsigned int maxI
   addModule(module);
 }
 
+void Path::addConcurrentPaths(const boost::python::list& paths, unsigned int threads)
+{
+  auto pathList = PyObjConvUtils::convertPythonObject(paths, std::vector<PathPtr>());
+  for (const PathPtr& path : pathList) {
+    if (path.get() == this) B2FATAL("Attempting to add a path to itself!");
+  }
+  ModulePtr module = ModuleManager::Instance().registerModule("ConcurrentPaths");
+  static_cast<ConcurrentPathsModule&>(*module).init(pathList, threads);
+  addModule(module);
+}
+
 void Path::addIndependentPath(const PathPtr& independent_path, std::string ds_ID, const boost::python::list& merge_back)
 {
   if (ds_ID.empty()) {
@@ -328,6 +340,31 @@ Parameters:
   max_iterations (int): Maximum number of iterations per event. If this number is exceeded
     the execution is aborted.
        )", (bparg("path"), bparg("condition") = "<1", bparg("max_iterations") = 10000))
+  .def("add_concurrent_paths", &Path::addConcurrentPaths, R"(add_concurrent_paths(paths, threads=2)
+
+Similar to `add_path()` this will execute all given ``paths`` at the current
+position but in each event the paths are executed concurrently using up to
+``threads`` threads. The modules within each path are still executed in order.
+This is useful for independent modules which take a sizable time per event,
+for example the unpackers of the different detectors:
+
+    >>> path.add_concurrent_paths([pxd_path, svd_path, cdc_path], threads=3)
+
+The paths have to be independent: after initialization it is checked that no
+path registers an object, array or relation which is used by another path, that
+no two paths write arrays of the same class and the modules cannot have conditions
+or be Python modules. Initialization, run changes and termination of the modules
+happen sequentially as usual.
+
+The modules keep their log configuration. Their event() time is included in the
+module statistics but memory and hardware counters are not measured for them, the
+concurrent paths entry shows the wall time of the concurrent execution.
+
+Parameters:
+  paths (list(basf2.Path)): paths to execute concurrently
+  threads (int): maximum number of threads including the main thread. With 1
+    the paths are executed one after another which gives the same result.
+       )", (bparg("paths"), bparg("threads") = 2))
   .def("_add_independent_path", &Path::addIndependentPath)
   .def("_add_independent_merge_path", &Path::addIndependentMergePath)
   .def("__contains__", &Path::contains, R"(Does this Path contain a module of the given type?
@@ -56,8 +56,10 @@ string ProcessStatistics::getStatisticsString(ModuleStatistics::EStatisticCounte
 {
   const ModuleStatistics& global = getGlobal();
   if (!modules) modules = &(getAll());
+  // the time per call percentiles are only available for event() calls
+  const bool percentiles = mode == ModuleStatistics::c_Event;
   int moduleNameLength = 21; //minimum: 80 characters
-  const int lengthOfRest = 80 - moduleNameLength;
+  const int lengthOfRest = 80 - moduleNameLength + (percentiles ? 34 : 0);
   for (const ModuleStatistics& stats : *modules) {
     int len = stats.getName().length();
     if (len > moduleNameLength)
@@ -65,21 +67,53 @@ string ProcessStatistics::getStatisticsString(ModuleStatistics::EStatisticCounte
   }
   const std::string numTabsModule = (boost::format("%d") % (moduleNameLength + 1)).str();
   const std::string numWidth = (boost::format("%d") % (moduleNameLength + 1 + lengthOfRest)).str();
-  boost::format outputheader("%s %|" + numTabsModule + "t|| %10s | %10s | %10s | %17s\n");
-  boost::format output("%s %|" + numTabsModule + "t|| %10.0f | %10.0f | %10.2f | %7.2f +-%7.2f\n");
+  std::string headerFormat = "%s %|" + numTabsModule + "t|| %10s | %10s | %10s | %17s";
+  std::string rowFormat = "%s %|" + numTabsModule + "t|| %10.0f | %10.0f | %10.2f | %7.2f +-%7.2f";
+  if (percentiles) {
+    headerFormat += " | %8s | %8s | %9s";
+    rowFormat += " | %8.2f | %8.2f | %9.2f";
+  }
+  boost::format outputheader(headerFormat + "\n");
+  boost::format output(rowFormat + "\n");
   if (html) {
-    outputheader = boost::format("<thead><tr><th>%s</th><th>%s</th><th>%s</th><th>%s</th><th>%s</th></tr></thead>");
-    output = boost::format("<tr><td>%s</td><td>%.0f</td><td>%.0f</td><td>%.2f</td><td>%.2f &plusmn; %.2f</td></tr>");
+    headerFormat = "<thead><tr><th>%s</th><th>%s</th><th>%s</th><th>%s</th><th>%s</th>";
+    rowFormat = "<tr><td>%s</td><td>%.0f</td><td>%.0f</td><td>%.2f</td><td>%.2f &plusmn; %.2f</td>";
+    if (percentiles) {
+      headerFormat += "<th>%s</th><th>%s</th><th>%s</th>";
+      rowFormat += "<td>%.2f</td><td>%.2f</td><td>%.2f</td>";
+    }
+    outputheader = boost::format(headerFormat + "</tr></thead>");
+    output = boost::format(rowFormat + "</tr>");
   }
+  outputheader % "Name" % "Calls" % "Memory(MB)" % "Time(s)" % "Time(ms)/Call";
+  if (percentiles) outputheader % "p50(ms)" % "p99(ms)" % "p99.9(ms)";
+
+  // fill one row of the table
+  auto addRow = [&](const std::string & name, const ModuleStatistics & stats) -> boost::format& {
+    output
+        % name
+        % stats.getCalls(mode)
+        % (stats.getMemorySum(mode) / 1024)
+        % (stats.getTimeSum(mode) / Unit::s)
+        % (stats.getTimeMean(mode) / Unit::ms)
+        % (stats.getTimeStddev(mode) / Unit::ms);
+    if (percentiles) {
+      output
+          % (stats.getEventTimePercentile(0.5) / Unit::ms)
+          % (stats.getEventTimePercentile(0.99) / Unit::ms)
+          % (stats.getEventTimePercentile(0.999) / Unit::ms);
+    }
+    return output;
+  };
 
   stringstream out;
   if (!html) {
     out << boost::format("%|" + numWidth + "T=|\n");
-    out << outputheader % "Name" % "Calls" % "Memory(MB)" % "Time(s)" % "Time(ms)/Call";
+    out << outputheader;
     out << boost::format("%|" + numWidth + "T=|\n");
   } else {
     out << "<table border=0>";
-    out << outputheader % "Name" % "Calls" % "Memory(MB)" % "Time(s)" % "Time(ms)/Call";
+    out << outputheader;
     out << "<tbody>";
   }
 
@@ -87,13 +121,7 @@ string ProcessStatistics::getStatisticsString(ModuleStatistics::EStatisticCounte
   sort(modulesSortedByIndex.begin(), modulesSortedByIndex.end(), [](const ModuleStatistics & a, const ModuleStatistics & b) { return a.getIndex() < b.getIndex(); });
 
   for (const ModuleStatistics& stats : modulesSortedByIndex) {
-    out << output
-        % stats.getName()
-        % stats.getCalls(mode)
-        % (stats.getMemorySum(mode) / 1024)
-        % (stats.getTimeSum(mode) / Unit::s)
-        % (stats.getTimeMean(mode) / Unit::ms)
-        % (stats.getTimeStddev(mode) / Unit::ms);
+    out << addRow(stats.getName(), stats);
   }
 
   if (!html) {
@@ -101,13 +129,7 @@ string ProcessStatistics::getStatisticsString(ModuleStatistics::EStatisticCounte
   } else {
     out << "</tbody><tfoot>";
   }
-  out << output
-      % (ProcHandler::isOutputProcess() ? "Total (output proc.)" : "Total")
-      % global.getCalls(mode)
-      % (global.getMemorySum(mode) / 1024)
-      % (global.getTimeSum(mode) / Unit::s)
-      % (global.getTimeMean(mode) / Unit::ms)
-      % (global.getTimeStddev(mode) / Unit::ms);
+  out << addRow(ProcHandler::isOutputProcess() ? "Total (output proc.)" : "Total", global);
   if (!html) {
     out << boost::format("%|" + numWidth + "T=|\n");
   } else {
@@ -202,6 +224,14 @@ void ProcessStatistics::setTransientCounters(const ProcessStatistics* otherObjec
   m_moduleMemory = otherObject->m_moduleMemory;
   m_suspendedTime = otherObject->m_suspendedTime;
   m_suspendedMemory = otherObject->m_suspendedMemory;
+  m_globalCounters = otherObject->m_globalCounters;
+  m_moduleCounters = otherObject->m_moduleCounters;
+  m_suspendedCounters = otherObject->m_suspendedCounters;
+  m_collectHardwareCounters = otherObject->m_collectHardwareCounters;
+  m_memorySamplingInterval = otherObject->m_memorySamplingInterval;
+  m_sampledEvents = otherObject->m_sampledEvents;
+  m_measureMemory = otherObject->m_measureMemory;
+  m_suspendedMeasureMemory = otherObject->m_suspendedMeasureMemory;
 }
 
 void ProcessStatistics::clear()
@@ -214,7 +244,8 @@ void ProcessStatistics::setCounters(double& time, double& memory,
                                     double startTime, double startMemory)
 {
   time = Utils::getClock() - startTime;
-  memory = Utils::getRssMemoryKB() - startMemory;
+  // reading the memory is expensive, skip it if the call is not sampled
+  memory = m_measureMemory ? Utils::getRssMemoryKB() - startMemory : 0;
 }
 
 TObject* ProcessStatistics::Clone(const char*) const
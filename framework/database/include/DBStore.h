@@ -16,6 +16,8 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Belle2 {
 
@@ -98,6 +100,18 @@ namespace Belle2 {
      */
     void update(const EventMetaData& event);
 
+    /**
+     * Announce that the given run will be processed soon.
+     *
+     * This resolves the payload information for all entries in the background
+     * so that the update at the beginning of this run doesn't have to wait for
+     * the conditions database. It only helps if called well before the run
+     * starts and does nothing if no entries have been requested yet.
+     *
+     * \sa Database::prefetchData()
+     */
+    void prefetch(int experiment, int run);
+
     /**
      * Updates all intra-run dependent objects.
      * This method is called by the framework for each event.
@@ -164,6 +178,19 @@ namespace Belle2 {
     /** List of intra-run dependent conditions. */
     std::set<DBStoreEntry*> m_intraRunDependencies;
 
+    /**
+     * Min-heap of the intra-run dependent conditions ordered by the last event
+     * number for which their current object is valid. So when moving forward
+     * in the run only the entries at the top of the heap need to be updated.
+     */
+    std::vector<std::pair<unsigned int, DBStoreEntry*>> m_intraRunBoundaries;
+
+    /** Range of event numbers for which none of the intra-run dependent objects changes */
+    std::pair<unsigned int, unsigned int> m_intraRunValidity{0, 0};
+
+    /** Whether m_intraRunBoundaries and m_intraRunValidity are up to date with m_intraRunDependencies */
+    bool m_intraRunIndexValid{false};
+
     /**
      * StoreObjPtr for the EventMetaData to get the current experiment and run from the DataStore.
      */
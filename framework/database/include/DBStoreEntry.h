@@ -11,6 +11,7 @@
 #include <framework/database/IntraRunDependency.h>
 
 #include <string>
+#include <utility>
 #include <unordered_set>
 
 class TFile;
@@ -115,6 +116,9 @@ namespace Belle2 {
     bool isIntraRunDependent() const { return (bool)m_intraRunDependency; }
     /** return the boundaries of the intra-run changes of the payload, if any */
     const std::vector<unsigned int> getIntraRunBoundaries() const { if (isIntraRunDependent()) return m_intraRunDependency->getBoundaries(); return std::vector<unsigned int> {}; }
+    /** return the first and last event number (inclusive) for which the
+     * current object of an intra-run dependent payload stays valid */
+    std::pair<unsigned int, unsigned int> getIntraRunValidity() const { return m_intraRunValidity; }
     /** Register an Accessor object to be notified on changes by calling DBAccessorBase::storeEntryChanged() */
     void registerAccessor(DBAccessorBase* object) { m_accessors.insert(object); }
     /** Deregister an Accessor object and remove it from the list of registered objects */
@@ -194,6 +198,8 @@ namespace Belle2 {
     /** If the payload has intra run dependency this will point to the whole
      * payload and m_object will just point to the part currently valid */
     IntraRunDependency* m_intraRunDependency{nullptr};
+    /** Range of event numbers for which the current object of an intra-run dependency is valid */
+    std::pair<unsigned int, unsigned int> m_intraRunValidity{0, 0};
     /** Vector of all the accessors registered with this entry */
     std::unordered_set<DBAccessorBase*> m_accessors;
     /** Allow only the DBStore class to update the payload contents */
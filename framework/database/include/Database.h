@@ -17,7 +17,12 @@
 #include <string>
 #include <utility>
 #include <list>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <future>
+#include <atomic>
+#include <condition_variable>
 
 class TObject;
 
@@ -121,6 +126,34 @@ namespace Belle2 {
      */
     bool getData(const EventMetaData& event, std::vector<DBQuery>& query);
 
+    /**
+     * Announce that objects from the database will be needed for the given
+     * experiment and run soon.
+     *
+     * The payload metadata for the queries is resolved and the payload files
+     * are located, and downloaded into the cache directory if necessary, in a
+     * background thread. A later call to getData() for this run then uses the
+     * prefetched information for all payloads that could be found instead of
+     * doing this work while the event loop is waiting.
+     *
+     * The background work is done in steps, the metadata lookup and then one
+     * step per payload file, and each step holds the lock on the providers and
+     * the downloader. Requests from getData() go first: they wait at most for
+     * the step in progress and the prefetch only continues once they are done.
+     * Payloads which cannot be found during prefetching are not reported but
+     * looked up again when they are actually requested.
+     *
+     * This only helps single process jobs which know their upcoming runs in
+     * advance, like reading many input files with short runs. With
+     * multi-processing, including the ZMQ based HLT workers, each worker
+     * process resolves its conditions data by itself, so this does nothing.
+     *
+     * @param experiment The experiment number.
+     * @param run        The run number.
+     * @param query      A list of DBQuery entries with the names of the payloads to prefetch.
+     */
+    void prefetchData(int experiment, int run, std::vector<DBQuery> query);
+
     /**
      * Convenience function to get an object for an arbitrary experiment and run.
      *
@@ -187,6 +220,7 @@ namespace Belle2 {
      */
     bool addPayload(const std::string& name, const std::string& fileName, const IntervalOfValidity& iov)
     {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
       if (!m_payloadCreation) initialize();
       return m_payloadCreation->storePayload(name, fileName, iov);
     }
@@ -222,6 +256,18 @@ namespace Belle2 {
     ~Database();
     /** Enable the next metadataprovider in the list */
     void nextMetadataProvider();
+    /** Reset the queries and fill them from testing payloads, prefetched
+     * information or the metadata provider. The caller has to hold the lock on m_mutex */
+    void lookupMetadata(const EventMetaData& event, std::vector<DBQuery>& query);
+    /** Locate the payload file of a query with known metadata, downloading it
+     * if necessary. Returns false if a required payload cannot be found. The
+     * caller has to hold the lock on m_mutex */
+    bool locatePayload(DBQuery& payload);
+    /** Fill all queries not yet resolved with prefetched information for this
+     * run if available. Returns true if afterwards all queries are resolved */
+    bool usePrefetchedData(const EventMetaData& event, std::vector<DBQuery>& query);
+    /** Lock m_mutex for one step of prefetching once no getData() request is waiting */
+    std::unique_lock<std::recursive_mutex> lockForPrefetch();
     /** List of available metadata providers (which haven't been tried yet) */
     std::vector<std::string> m_metadataConfigurations;
     /** Name of the currently used metadata provider */
@@ -240,5 +286,20 @@ namespace Belle2 {
     std::vector<Conditions::TestingPayloadStorage> m_testingPayloads;
     /** Current configuration state of the database */
     EDatabaseState m_configState{c_PreInit};
+    /** Mutex to serialize the access to the providers and the downloader
+     * between requests and prefetching. Recursive as initialize() is called
+     * both directly and while handling a request */
+    std::recursive_mutex m_mutex;
+    /** Number of getData() requests waiting for or holding m_mutex */
+    std::atomic<int> m_waitingRequests{0};
+    /** Signalled whenever a getData() request is done */
+    std::condition_variable_any m_requestDone;
+    /** Mutex to protect m_prefetched */
+    std::mutex m_prefetchMutex;
+    /** Prefetched payload information for each experiment and run */
+    std::map<std::pair<int, int>, std::vector<DBQuery>> m_prefetched;
+    /** Prefetching tasks running in the background. Declared last so they
+     * are finished before any other member is destroyed */
+    std::vector<std::future<void>> m_prefetchTasks;
   };
 } // namespace Belle2
@@ -28,6 +28,8 @@ namespace Belle2 {
     /**
      * Add an object to the intra run dependency.
      * Note that the EventDependency object takes ownership of the added object by default.
+     * The boundaries are kept in ascending order of event numbers: an object
+     * added with a smaller event number than an earlier one is inserted at its place.
      * @param event    the event number from which on the given conditions object is valid.
      * @param object   the object which is valid starting from the given event number.
      */
@@ -52,6 +54,12 @@ namespace Belle2 {
      * In general for n payloads there are n-1 boundaries.
      */
     const std::vector<unsigned int>& getBoundaries() const override { return getEventNumbers(); }
+    /**
+     * Get the range of event numbers for which the object valid for the given event stays the same.
+     * @param event   meta data of the event for which we want to have the conditions.
+     * @return        first and last (inclusive) event number between the surrounding boundaries.
+     */
+    std::pair<unsigned int, unsigned int> getValidityRange(const EventMetaData& event) const override;
 
   protected:
     /**
@@ -62,9 +70,18 @@ namespace Belle2 {
     virtual int getIndex(const EventMetaData& event) const override;
 
   private:
+    /**
+     * Check whether the boundaries are in ascending order. Objects written
+     * before add() kept the boundaries sorted might not be.
+     */
+    bool isSorted() const;
+
     /** Vector of event number boundaries. */
     std::vector<unsigned int> m_eventNumbers;
 
+    /** Whether the boundaries are sorted: -1 if not checked yet, 0 if not sorted, 1 if sorted */
+    mutable int m_sorted{ -1}; //! transient
+
     ClassDefOverride(EventDependency, 1);  /**< class for event number dependent conditions. */
   };
 }
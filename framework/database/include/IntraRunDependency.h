@@ -10,6 +10,9 @@
 #include <TObject.h>
 #include <TObjArray.h>
 
+#include <utility>
+#include <vector>
+
 
 namespace Belle2 {
   class EventMetaData;
@@ -61,6 +64,15 @@ namespace Belle2 {
      * The method must be implemented by the derived classes.
      */
     virtual const std::vector<unsigned int>& getBoundaries() const = 0;
+    /**
+     * Get the range of event numbers for which the object valid for the given
+     * event stays the same. This allows to skip looking up the object again
+     * for all events in this range.
+     * The default implementation only returns the given event itself.
+     * @param event   meta data of the event for which we want to have the conditions.
+     * @return        first and last (inclusive) event number of the range.
+     */
+    virtual std::pair<unsigned int, unsigned int> getValidityRange(const EventMetaData& event) const;
 
   protected:
     TObjArray m_objects;   /**< Array of intra-run dependent objects **/
@@ -14,6 +14,10 @@
 
 #include <TClass.h>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+
 namespace Belle2 {
 
   DBStore::~DBStore()
@@ -60,6 +64,7 @@ namespace Belle2 {
         dbEntry.updatePayload(query.revision, query.iov, query.filename, query.checksum, query.globaltag, *m_manualEvent);
       }
       if (dbEntry.isIntraRunDependent()) m_intraRunDependencies.insert(&dbEntry);
+      m_intraRunIndexValid = false;
     }
     // Otherwise use the DataStore if it is valid
     else if (m_storeEvent.isValid()) {
@@ -68,6 +73,7 @@ namespace Belle2 {
         dbEntry.updatePayload(query.revision, query.iov, query.filename, query.checksum, query.globaltag, *m_storeEvent);
       }
       if (dbEntry.isIntraRunDependent()) m_intraRunDependencies.insert(&dbEntry);
+      m_intraRunIndexValid = false;
     }
     return &dbEntry;
   }
@@ -110,6 +116,7 @@ namespace Belle2 {
     // this requirement.
     std::vector<Database::DBQuery> entries;
     entries.reserve(m_dbEntries.size());
+    m_intraRunIndexValid = false;
     for (auto& entry : m_dbEntries) {
       bool expired = !entry.second.getIoV().contains(event);
       if (expired) {
@@ -135,6 +142,19 @@ namespace Belle2 {
     }
   }
 
+  void DBStore::prefetch(int experiment, int run)
+  {
+    const EventMetaData event(1, run, experiment);
+    std::vector<Database::DBQuery> entries;
+    entries.reserve(m_dbEntries.size());
+    for (const auto& entry : m_dbEntries) {
+      // same selection as in performUpdate(): overrides only need an update once expired
+      if (!entry.second.keepUntilExpired() || !entry.second.getIoV().contains(event))
+        entries.emplace_back(entry.first, entry.second.isRequired());
+    }
+    Database::Instance().prefetchData(experiment, run, std::move(entries));
+  }
+
   void DBStore::updateEvent()
   {
     if (!m_manualEvent) {
@@ -164,10 +184,40 @@ namespace Belle2 {
 
   void DBStore::performUpdateEvent(const EventMetaData& event)
   {
-    // loop over intra-run dependent conditions and update the objects if needed
+    const unsigned int eventNumber = event.getEvent();
+    // as long as we stay in the range where no object changes there's nothing to do
+    if (m_intraRunIndexValid and eventNumber >= m_intraRunValidity.first and eventNumber <= m_intraRunValidity.second) return;
+
+    const auto heapOrder = std::greater<std::pair<unsigned int, DBStoreEntry*>>();
+    if (m_intraRunIndexValid and eventNumber > m_intraRunValidity.second) {
+      // moving forward: only the conditions whose current object expired need
+      // an update and they are all at the top of the heap
+      while (m_intraRunBoundaries.front().first < eventNumber) {
+        std::pop_heap(m_intraRunBoundaries.begin(), m_intraRunBoundaries.end(), heapOrder);
+        DBStoreEntry* dbEntry = m_intraRunBoundaries.back().second;
+        dbEntry->updateObject(event);
+        const auto validity = dbEntry->getIntraRunValidity();
+        m_intraRunValidity.first = std::max(m_intraRunValidity.first, validity.first);
+        m_intraRunBoundaries.back().first = validity.second;
+        std::push_heap(m_intraRunBoundaries.begin(), m_intraRunBoundaries.end(), heapOrder);
+      }
+      m_intraRunValidity.second = m_intraRunBoundaries.front().first;
+      return;
+    }
+
+    // otherwise loop over all intra-run dependent conditions, update the
+    // objects if needed and rebuild the heap
+    m_intraRunBoundaries.clear();
+    m_intraRunValidity = {0, std::numeric_limits<unsigned int>::max()};
     for (auto& dbEntry : m_intraRunDependencies) {
       dbEntry->updateObject(event);
+      const auto validity = dbEntry->getIntraRunValidity();
+      m_intraRunValidity.first = std::max(m_intraRunValidity.first, validity.first);
+      m_intraRunValidity.second = std::min(m_intraRunValidity.second, validity.second);
+      m_intraRunBoundaries.emplace_back(validity.second, dbEntry);
     }
+    std::make_heap(m_intraRunBoundaries.begin(), m_intraRunBoundaries.end(), heapOrder);
+    m_intraRunIndexValid = true;
   }
 
   void DBStore::reset(bool keepEntries)
@@ -175,6 +225,8 @@ namespace Belle2 {
     if (!m_dbEntries.empty())
       B2DEBUG(31, "DBStore::reset(): Cleaning all database information");
     m_intraRunDependencies.clear();
+    m_intraRunBoundaries.clear();
+    m_intraRunIndexValid = false;
     if (!keepEntries) {
       m_dbEntries.clear();
     } else {
@@ -221,6 +273,7 @@ namespace Belle2 {
     // we need to remove this entry from the intraRunDependencies list now.
     // Otherwise it will reset the object on the next event call
     m_intraRunDependencies.erase(&dbEntry);
+    m_intraRunIndexValid = false;
     B2WARNING("An override for DBEntry " << name << " was created.");
   }
 
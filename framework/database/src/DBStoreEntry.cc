@@ -55,6 +55,7 @@ namespace Belle2 {
     // otherwise update the object and call notify all accessors on change
     TObject* old = m_object;
     m_object = m_intraRunDependency->getObject(event);
+    m_intraRunValidity = m_intraRunDependency->getValidityRange(event);
     if (old != m_object) {
       B2DEBUG(35, "IntraRunDependency for " << m_name << ": new object (" << old << ", " << m_object << "), notifying accessors");
       notifyAccessors();
@@ -143,6 +144,7 @@ namespace Belle2 {
         if (m_object->InheritsFrom(IntraRunDependency::Class())) {
           m_intraRunDependency = static_cast<IntraRunDependency*>(m_object);
           m_object = m_intraRunDependency->getObject(event);
+          m_intraRunValidity = m_intraRunDependency->getValidityRange(event);
           B2DEBUG(34, "Found intra run dependency for " << m_name << ": " << m_intraRunDependency << ", " << m_object);
         }
         // TODO: depending on the object type we could now close the file. I
@@ -29,8 +29,11 @@
 #include <framework/database/LocalMetadataProvider.h>
 #include <framework/database/CentralMetadataProvider.h>
 #include <framework/database/Configuration.h>
+#include <framework/database/Downloader.h>
+#include <framework/core/Environment.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
 
 namespace Belle2 {
@@ -45,6 +48,10 @@ namespace Belle2 {
 
   void Database::reset(bool keepConfig)
   {
+    // wait for any prefetching to finish before we remove the providers
+    Instance().m_prefetchTasks.clear();
+    Instance().m_prefetched.clear();
+    std::lock_guard<std::recursive_mutex> lock(Instance().m_mutex);
     auto& conf = Conditions::Configuration::getInstance();
     conf.setInitialized(false);
     DBStore::Instance().reset(true);
@@ -57,12 +64,20 @@ namespace Belle2 {
 
   ScopeGuard Database::createScopedUpdateSession()
   {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     // make sure we reread testing text files in case they got updated
     for (auto& testing : m_testingPayloads) {
       testing.reset();
     }
-    // and return a downloader session guard for the downloader we use
-    return Conditions::Downloader::getDefaultInstance().ensureSession();
+    // and return a downloader session guard for the downloader we use. The
+    // session is finished while holding the lock as a prefetch might use it
+    auto& downloader = Conditions::Downloader::getDefaultInstance();
+    const bool started = downloader.startSession();
+    return ScopeGuard([this, &downloader, started] {
+      if (!started) return;
+      std::lock_guard<std::recursive_mutex> sessionLock(m_mutex);
+      downloader.finishSession();
+    });
   }
 
   std::pair<TObject*, IntervalOfValidity> Database::getData(const EventMetaData& event, const std::string& name)
@@ -75,6 +90,105 @@ namespace Belle2 {
   }
 
   bool Database::getData(const EventMetaData& event, std::vector<DBQuery>& query)
+  {
+    {
+      std::lock_guard<std::mutex> lock(m_prefetchMutex);
+      // prefetched information for earlier runs will not be needed anymore
+      m_prefetched.erase(m_prefetched.begin(), m_prefetched.lower_bound({event.getExperiment(), event.getRun()}));
+    }
+    // announce the request so that prefetching pauses after its current step
+    ++m_waitingRequests;
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    ScopeGuard requestDone([this] {
+      --m_waitingRequests;
+      m_requestDone.notify_all();
+    });
+    lookupMetadata(event, query);
+    // and if we could find the metadata lets also locate the payloads ...
+    const size_t payloadsLocated = std::count_if(query.begin(), query.end(), [this](auto & payload) {
+      return locatePayload(payload);
+    });
+    // did we find all payloads?
+    return payloadsLocated == query.size();
+  }
+
+  void Database::prefetchData(int experiment, int run, std::vector<DBQuery> query)
+  {
+    if (query.empty()) return;
+    // The worker processes of a multi-processing job have their own database
+    // instance and don't know the upcoming runs, so prefetching in the input
+    // process would not help them. Also we must not fork while a prefetch is
+    // running in the background.
+    if (Environment::Instance().getNumberProcesses() > 0) {
+      B2DEBUG(31, "Conditions data: prefetching is not supported with multi-processing");
+      return;
+    }
+    {
+      std::lock_guard<std::recursive_mutex> lock(m_mutex);
+      // initialization might need python so it has to happen in this thread
+      if (!m_metadataProvider) initialize();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_prefetchMutex);
+      if (m_prefetched.count({experiment, run}) > 0) return;
+    }
+    // forget about prefetching tasks which are already done
+    m_prefetchTasks.erase(std::remove_if(m_prefetchTasks.begin(), m_prefetchTasks.end(), [](const auto & task) {
+      return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), m_prefetchTasks.end());
+    B2DEBUG(31, "Conditions data: prefetching payloads" << LogVar("experiment", experiment) << LogVar("run", run)
+            << LogVar("payloads", query.size()));
+    m_prefetchTasks.emplace_back(std::async(std::launch::async, [this, experiment, run, query = std::move(query)]() mutable {
+      // missing payloads will be reported once they are actually requested
+      for (auto& payload : query) payload.required = false;
+      {
+        auto lock = lockForPrefetch();
+        auto session = Conditions::Downloader::getDefaultInstance().ensureSession();
+        lookupMetadata(EventMetaData(1, run, experiment), query);
+      }
+      // locate the payloads one at a time so that requests for the current
+      // run don't have to wait for all downloads of the upcoming run
+      for (auto& payload : query) {
+        if (!payload.filename.empty() or payload.revision == 0) continue;
+        auto lock = lockForPrefetch();
+        auto session = Conditions::Downloader::getDefaultInstance().ensureSession();
+        locatePayload(payload);
+      }
+      // and only keep what we could find
+      query.erase(std::remove_if(query.begin(), query.end(), [](const auto & payload) {
+        return payload.filename.empty();
+      }), query.end());
+      std::lock_guard<std::mutex> lock(m_prefetchMutex);
+      m_prefetched[{experiment, run}] = std::move(query);
+    }));
+  }
+
+  std::unique_lock<std::recursive_mutex> Database::lockForPrefetch()
+  {
+    std::unique_lock<std::recursive_mutex> lock(m_mutex);
+    m_requestDone.wait(lock, [this] { return m_waitingRequests == 0; });
+    return lock;
+  }
+
+  bool Database::usePrefetchedData(const EventMetaData& event, std::vector<DBQuery>& query)
+  {
+    std::lock_guard<std::mutex> lock(m_prefetchMutex);
+    const auto prefetched = m_prefetched.find({event.getExperiment(), event.getRun()});
+    if (prefetched == m_prefetched.end()) return false;
+    const size_t resolved = std::count_if(query.begin(), query.end(), [&prefetched](auto & payload) {
+      // don't replace testing payloads
+      if (!payload.filename.empty()) return true;
+      const auto& found = std::find_if(prefetched->second.begin(), prefetched->second.end(), [&payload](const auto & p) {
+        return p.name == payload.name;
+      });
+      if (found == prefetched->second.end()) return false;
+      payload.update(*found);
+      return true;
+    });
+    return resolved == query.size();
+  }
+
+  void Database::lookupMetadata(const EventMetaData& event, std::vector<DBQuery>& query)
   {
     // initialize lazily ...
     if (!m_metadataProvider) initialize();
@@ -91,7 +205,10 @@ namespace Belle2 {
       return false;
     });
     // if we already found all just return here
-    if (testingPayloads == query.size()) return true;
+    if (testingPayloads == query.size()) return;
+    // otherwise take whatever we have prefetched for this run, the metadata
+    // provider will skip those as they already have a valid revision
+    if (usePrefetchedData(event, query)) return;
     // nooow, lets look for proper payloads;
     try {
       m_metadataProvider->getPayloads(event.getExperiment(), event.getRun(), query);
@@ -100,31 +217,30 @@ namespace Belle2 {
       B2WARNING("Conditions data: Problem with payload metadata provider, trying to fall back to next provider..."
                 << LogVar("provider", m_currentProvider));
       nextMetadataProvider();
-      return getData(event, query);
+      lookupMetadata(event, query);
     }
-    // and if we could find the metadata lets also locate the payloads ...
-    const size_t payloadsLocated = std::count_if(query.begin(), query.end(), [this](auto & payload) {
-      // make sure we don't overwrite local payloads or otherwise already valid filenames;
-      if (!payload.filename.empty()) return true;
-      // but don't check for payloads we could not find. But this is only a
-      // problem if they are required so report success for not required
-      // payloads
-      if (payload.revision == 0) return not payload.required;
-      // and locate the payload.
-      if (not m_payloadProvider->find(payload)) {
-        // if that fails lets let the user know: Even for optional payloads, if
-        // we know the metadata but cannot find the file something is fishy and
-        // should be reported.
-        auto loglevel = payload.required ? LogConfig::c_Error : LogConfig::c_Warning;
-        B2LOG(loglevel, 0, "Conditions data: Could not find file for payload"
-              << LogVar("name", payload.name) << LogVar("revision", payload.revision)
-              << LogVar("checksum", payload.checksum) << LogVar("globaltag", payload.globaltag));
-        return not payload.required;
-      }
-      return true;
-    });
-    // did we find all payloads?
-    return payloadsLocated == query.size();
+  }
+
+  bool Database::locatePayload(DBQuery& payload)
+  {
+    // make sure we don't overwrite local payloads or otherwise already valid filenames;
+    if (!payload.filename.empty()) return true;
+    // but don't check for payloads we could not find. But this is only a
+    // problem if they are required so report success for not required
+    // payloads
+    if (payload.revision == 0) return not payload.required;
+    // and locate the payload.
+    if (not m_payloadProvider->find(payload)) {
+      // if that fails lets let the user know: Even for optional payloads, if
+      // we know the metadata but cannot find the file something is fishy and
+      // should be reported.
+      auto loglevel = payload.required ? LogConfig::c_Error : LogConfig::c_Warning;
+      B2LOG(loglevel, 0, "Conditions data: Could not find file for payload"
+            << LogVar("name", payload.name) << LogVar("revision", payload.revision)
+            << LogVar("checksum", payload.checksum) << LogVar("globaltag", payload.globaltag));
+      return not payload.required;
+    }
+    return true;
   }
 
   bool Database::storeData(std::list<DBImportQuery>& query)
@@ -136,6 +252,7 @@ namespace Belle2 {
 
   bool Database::storeData(const std::string& name, TObject* obj, const IntervalOfValidity& iov)
   {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     if (!m_payloadCreation) initialize();
     auto result = m_payloadCreation->storeData(name, obj, iov);
     // we added payloads, make sure we reread testing files on next try
@@ -149,6 +266,7 @@ namespace Belle2 {
 
   std::string Database::getGlobalTags()
   {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     return boost::algorithm::join(m_globalTags, ",");
   }
 
@@ -192,6 +310,7 @@ namespace Belle2 {
 
   void Database::initialize(const EDatabaseState target)
   {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
     if (m_configState >= target) return;
     auto conf = Conditions::Configuration::getInstance();
 
@@ -9,17 +9,41 @@
 #include <framework/database/EventDependency.h>
 #include <framework/dataobjects/EventMetaData.h>
 
+#include <algorithm>
+#include <limits>
+
 using namespace Belle2;
 
 void EventDependency::add(unsigned int event, TObject* object)
 {
-  m_objects.Add(object);
-  m_eventNumbers.push_back(event);
+  if (!isSorted() or m_eventNumbers.empty() or event >= m_eventNumbers.back()) {
+    m_objects.Add(object);
+    m_eventNumbers.push_back(event);
+    return;
+  }
+  // insert the boundary after all boundaries not after the event and shift
+  // the objects valid from the later boundaries by one
+  const int index = std::upper_bound(m_eventNumbers.begin(), m_eventNumbers.end(), event) - m_eventNumbers.begin();
+  m_eventNumbers.insert(m_eventNumbers.begin() + index, event);
+  m_objects.Add(nullptr);
+  for (int i = m_objects.GetLast(); i > index + 1; --i) {
+    m_objects.AddAt(m_objects.At(i - 1), i);
+  }
+  m_objects.AddAt(object, index + 1);
 }
 
+bool EventDependency::isSorted() const
+{
+  if (m_sorted < 0) m_sorted = std::is_sorted(m_eventNumbers.begin(), m_eventNumbers.end());
+  return m_sorted;
+}
 
 int EventDependency::getIndex(const EventMetaData& event) const
 {
+  if (isSorted()) {
+    // the index is the number of boundaries not after the event
+    return std::upper_bound(m_eventNumbers.begin(), m_eventNumbers.end(), event.getEvent()) - m_eventNumbers.begin();
+  }
   int result = 0;
   for (unsigned int eventNumber : m_eventNumbers) {
     if (eventNumber > event.getEvent()) return result;
@@ -28,3 +52,13 @@ int EventDependency::getIndex(const EventMetaData& event) const
   return result;
 }
 
+std::pair<unsigned int, unsigned int> EventDependency::getValidityRange(const EventMetaData& event) const
+{
+  // without sorted boundaries the object has to be looked up again for every event
+  if (!isSorted()) return IntraRunDependency::getValidityRange(event);
+  const int index = getIndex(event);
+  const unsigned int first = (index > 0) ? m_eventNumbers[index - 1] : 0;
+  const unsigned int last = (index < static_cast<int>(m_eventNumbers.size())) ? m_eventNumbers[index] - 1 :
+                            std::numeric_limits<unsigned int>::max();
+  return {first, last};
+}
@@ -0,0 +1,17 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/database/IntraRunDependency.h>
+#include <framework/dataobjects/EventMetaData.h>
+
+using namespace Belle2;
+
+std::pair<unsigned int, unsigned int> IntraRunDependency::getValidityRange(const EventMetaData& event) const
+{
+  return {event.getEvent(), event.getEvent()};
+}
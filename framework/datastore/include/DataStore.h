@@ -21,6 +21,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <mutex>
 
 class TObject;
 class TClass;
@@ -519,6 +520,9 @@ namespace Belle2 {
     /** Return map of depedencies between modules. */
     DependencyMap& getDependencyMap() { return *m_dependencyMap; }
 
+    /** Return the mutex serializing the creation of entries and the relation handling, also used by the RelationIndexManager. */
+    std::recursive_mutex& getMutex() { return m_mutex; }
+
 
     /** creates new datastore with given id, copying the registered objects/arrays from the current one. */
     void createNewDataStoreID(const std::string& id);
@@ -631,6 +635,10 @@ namespace Belle2 {
 
     /** Collect information about the dependencies between modules. */
     DependencyMap* m_dependencyMap;
+
+    /** Serializes creating entries and adding or looking up relations, which use shared caches,
+     *  for modules executed in several threads, see Path.add_concurrent_paths(). */
+    std::recursive_mutex m_mutex;
   };
 
   ADD_BITMASK_OPERATORS(DataStore::EStoreFlags); /**< Add bitmask operators to DataStore::EStoreFlags. */
@@ -13,6 +13,7 @@
 #include <array>
 #include <memory>
 #include <map>
+#include <mutex>
 
 namespace Belle2 {
 
@@ -46,6 +47,7 @@ namespace Belle2 {
 
       const std::string& name = relation.getName();
       DataStore::EDurability durability = relation.getDurability();
+      std::lock_guard<std::recursive_mutex> lock(DataStore::Instance().getMutex());
       RelationMap& relations =  m_cache[durability];
       std::shared_ptr<RelationIndexContainer<FROM, TO>> indexContainer;
       RelationMap::iterator it = relations.find(name);
@@ -76,6 +78,7 @@ namespace Belle2 {
      */
     void reset()
     {
+      std::lock_guard<std::recursive_mutex> lock(DataStore::Instance().getMutex());
       for (int i = 0; i < DataStore::c_NDurabilityTypes; i++)
         m_cache[i].clear();
     }
@@ -97,6 +100,7 @@ namespace Belle2 {
     template<class FROM, class TO> std::shared_ptr<RelationIndexContainer<FROM, TO>> getIndexIfExists(const std::string& name,
         DataStore::EDurability durability) const
     {
+      std::lock_guard<std::recursive_mutex> lock(DataStore::Instance().getMutex());
       const RelationMap& relations =  m_cache[durability];
       RelationMap::const_iterator it = relations.find(name);
       if (it != relations.end()) {
@@ -106,10 +110,11 @@ namespace Belle2 {
       }
     }
 
-    /** Clean cache on exit. */
+    /** Clean cache on exit, without locking as the DataStore might be gone already. */
     ~RelationIndexManager()
     {
-      reset();
+      for (int i = 0; i < DataStore::c_NDurabilityTypes; i++)
+        m_cache[i].clear();
     }
 
     /** Maptype to keep track of all Containers of one durability */
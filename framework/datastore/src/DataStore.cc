@@ -315,6 +315,7 @@ TObject** DataStore::getObject(const StoreAccessorBase& accessor)
 
 bool DataStore::createObject(TObject* object, bool replace, const StoreAccessorBase& accessor)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
   StoreEntry* entry = getEntry(accessor);
   if (!entry) {
     B2ERROR("No " << accessor.readableName() <<
@@ -397,6 +398,7 @@ void DataStore::updateRelationsObjectCache(StoreEntry& entry)
 
 bool DataStore::findStoreEntry(const TObject* object, DataStore::StoreEntry*& entry, int& index)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
   if (!entry or index < 0) {
     //usually entry/index should be passed for RelationsObject,
     //but there are exceptions -> let's check again
@@ -495,6 +497,8 @@ void DataStore::addRelation(const TObject* fromObject, StoreEntry*& fromEntry, i
   if (!fromObject or !toObject)
     return;
 
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
   // get entry from which the relation points
   if (!findStoreEntry(fromObject, fromEntry, fromIndex)) {
     B2FATAL("Couldn't find from-side entry for relation between " << fromObject->ClassName() << " and " << toObject->ClassName() <<
@@ -545,6 +549,7 @@ void DataStore::addRelation(const TObject* fromObject, StoreEntry*& fromEntry, i
 RelationVectorBase DataStore::getRelationsWith(ESearchSide searchSide, const TObject* object, DataStore::StoreEntry*& entry,
                                                int& index, const TClass* withClass, const std::string& withName, const std::string& namedRelation)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
   if (searchSide == c_BothSides) {
     auto result = getRelationsWith(c_ToSide, object, entry, index, withClass, withName, namedRelation);
     const auto& fromResult = getRelationsWith(c_FromSide, object, entry, index, withClass, withName, namedRelation);
@@ -597,6 +602,7 @@ RelationVectorBase DataStore::getRelationsWith(ESearchSide searchSide, const TOb
 RelationEntry DataStore::getRelationWith(ESearchSide searchSide, const TObject* object, DataStore::StoreEntry*& entry, int& index,
                                          const TClass* withClass, const std::string& withName, const std::string& namedRelation)
 {
+  std::lock_guard<std::recursive_mutex> lock(m_mutex);
   if (searchSide == c_BothSides) {
     RelationEntry result = getRelationWith(c_ToSide, object, entry, index, withClass, withName, namedRelation);
     if (!result.object) {
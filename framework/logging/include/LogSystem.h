@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 
 
@@ -179,12 +180,13 @@ namespace Belle2 {
     /**
      * Sets the log configuration to the given module log configuration and sets the module name
      * This method should _only_ be called by the EventProcessor.
+     * The setting is per thread so that modules executed concurrently use their own configuration.
      *
      * @param moduleLogConfig Pointer to the logging configuration object of the module.
      *                        Set to NULL to use the global log configuration.
      * @param moduleName Name of the module.
      */
-    void updateModule(const LogConfig* moduleLogConfig = nullptr, const std::string& moduleName = "") { m_moduleLogConfig = moduleLogConfig; m_moduleName = moduleName; }
+    void updateModule(const LogConfig* moduleLogConfig = nullptr, const std::string& moduleName = "") { s_moduleLogConfig = moduleLogConfig; s_moduleName = moduleName; }
 
     /**
      * Enable debug output.
@@ -201,10 +203,10 @@ namespace Belle2 {
     std::vector<LogConnectionBase*> m_logConnections;
     /** The global log system configuration. */
     LogConfig m_logConfig;
-    /** log config of current module */
-    const LogConfig* m_moduleLogConfig;
-    /** The current module name. */
-    std::string m_moduleName;
+    /** log config of current module, per thread for Path.add_concurrent_paths() */
+    static thread_local const LogConfig* s_moduleLogConfig;
+    /** The current module name, per thread for Path.add_concurrent_paths() */
+    static thread_local std::string s_moduleName;
     /** Stores the log configuration objects for packages. */
     std::map<std::string, LogConfig> m_packageLogConfigs;
     /** Wether to re-print errors-warnings encountered during execution at the end. */
@@ -219,6 +221,8 @@ namespace Belle2 {
     int m_messageCounter[LogConfig::c_Default];
     /** Global flag for fast checking if debug output is enabled */
     static bool s_debugEnabled;
+    /** Serializes sendMessage() for modules executed in several threads, see Path.add_concurrent_paths() */
+    std::recursive_mutex m_sendMutex;
 
     /** The constructor is hidden to avoid that someone creates an instance of this class. */
     LogSystem();
@@ -254,8 +258,8 @@ namespace Belle2 {
   inline const LogConfig& LogSystem::getCurrentLogConfig(const char* package) const
   {
     //module specific config?
-    if (m_moduleLogConfig && (m_moduleLogConfig->getLogLevel() != LogConfig::c_Default)) {
-      return *m_moduleLogConfig;
+    if (s_moduleLogConfig && (s_moduleLogConfig->getLogLevel() != LogConfig::c_Default)) {
+      return *s_moduleLogConfig;
     }
     //package specific config?
     if (package && !m_packageLogConfigs.empty()) {
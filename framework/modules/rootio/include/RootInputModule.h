@@ -17,6 +17,7 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <utility>
 
 #include <TChain.h>
 #include <TFile.h>
@@ -228,5 +229,11 @@ namespace Belle2 {
      * this has to be set to true
      * */
     bool m_isSecondaryInput{false};
+
+    /** Prefetch the conditions data for the next input file when opening a new one */
+    bool m_prefetchConditions{false};
+
+    /** Experiment and run number of the first event in each input file, used for prefetching */
+    std::vector<std::pair<int, int>> m_firstRunOfFile;
   };
 } // end namespace Belle2
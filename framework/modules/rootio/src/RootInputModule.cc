@@ -21,6 +21,7 @@
 #include <framework/utilities/NumberSequence.h>
 #include <framework/utilities/ScopeGuard.h>
 #include <framework/database/Configuration.h>
+#include <framework/database/DBStore.h>
 
 #include <TClonesArray.h>
 #include <TEventList.h>
@@ -94,6 +95,11 @@ RootInputModule::RootInputModule() : Module(), m_nextEntry(0), m_lastPersistentE
            "When using a second RootInputModule in an independent path [usually if you are using add_independent_merge_path(...)] "
            "this has to be set to true",
            false);
+  addParam("prefetchConditions", m_prefetchConditions,
+           "If true, start looking up the conditions data for the first run of the next input file in the background "
+           "as soon as a new input file is opened. This avoids waiting for the conditions database at the beginning "
+           "of each run when processing many input files with short runs. Only has an effect in single process jobs, "
+           "with multi-processing the workers look up their conditions data by themselves.", m_prefetchConditions);
 }
 
 RootInputModule::~RootInputModule() = default;
@@ -339,6 +345,11 @@ void RootInputModule::initialize()
   }
   // And setup global tag replay ...
   Conditions::Configuration::getInstance().setInputMetadata(fileMetaData);
+  // Remember where each file starts for prefetching conditions data
+  m_firstRunOfFile.clear();
+  for (const FileMetaData& meta : fileMetaData) {
+    m_firstRunOfFile.emplace_back(meta.getExperimentLow(), meta.getRunLow());
+  }
 }
 
 
@@ -485,6 +496,11 @@ void RootInputModule::readTree()
     B2INFO("Loading new input file"
            << LogVar("filename", m_tree->GetFile()->GetName())
            << LogVar("metadata LFN", fileMetaData->getLfn()));
+    // and get the conditions data for the next file ready while we process this one
+    if (m_prefetchConditions and !m_isSecondaryInput and treeNum + 1 < static_cast<long>(m_firstRunOfFile.size())) {
+      const auto& [experiment, run] = m_firstRunOfFile[treeNum + 1];
+      DBStore::Instance().prefetch(experiment, run);
+    }
   }
   realDataWorkaround(*fileMetaData);
 
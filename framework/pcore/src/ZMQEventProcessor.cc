@@ -24,6 +24,7 @@
 #include <framework/database/Database.h>
 #include <framework/core/RandomNumbers.h>
 #include <framework/core/MetadataService.h>
+#include <framework/core/EventTracer.h>
 #include <framework/gearbox/Unit.h>
 #include <framework/utilities/Utils.h>
 
@@ -206,6 +207,8 @@ void ZMQEventProcessor::initialize(const ModulePtrList& moduleList, const Module
 void ZMQEventProcessor::terminateAndCleanup(const ModulePtr& histogramManager)
 {
   cleanup();
+  // all processes are finished, combine their traces
+  EventTracer::Instance().merge();
 
   if (histogramManager) {
     B2INFO("HistoManager:: adding histogram files");
@@ -450,13 +453,16 @@ void ZMQEventProcessor::processCore(const PathPtr& startPath, const ModulePtrLis
   m_previousEventMetaData.setEndOfData(); //invalid start state
 
   const bool collectStats = !Environment::Instance().getNoStats();
+  EventTracer& tracer = EventTracer::Instance();
 
   //Loop over the events
   long currEvent = 0;
   bool endProcess = false;
   while (!endProcess) {
     if (collectStats)
-      m_processStatisticsPtr->startGlobal();
+      m_processStatisticsPtr->startGlobal(ModuleStatistics::c_Event);
+    tracer.beginEvent();
+    const int64_t traceStart = tracer.isActive() ? EventTracer::now() : 0;
 
     //    B2INFO ( "processCore:: currEvent = " << currEvent );
 
@@ -477,6 +483,7 @@ void ZMQEventProcessor::processCore(const PathPtr& startPath, const ModulePtrLis
 
     // Original code
     //    endProcess = ZMQEventProcessor::processEvent(moduleIter, isInputProcess && currEvent == 0);
+    if (tracer.isActive()) tracer.record(nullptr, traceStart, EventTracer::now(), m_eventMetaDataPtr.isValid() ? &*m_eventMetaDataPtr : nullptr);
 
     //Delete event related data in DataStore
     DataStore::Instance().invalidateData(DataStore::c_Event);
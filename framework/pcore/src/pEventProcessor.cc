@@ -16,6 +16,7 @@
 
 #include <framework/core/ModuleManager.h>
 #include <framework/core/Environment.h>
+#include <framework/core/EventTracer.h>
 #include <framework/logging/LogSystem.h>
 
 #include <TROOT.h>
@@ -271,6 +272,7 @@ void pEventProcessor::process(const PathPtr& spath, long maxEvent)
   //output process: do final cleanup
   m_procHandler->waitForAllProcesses();
   B2INFO("All processes completed");
+  EventTracer::Instance().merge();
 
   //finished, disable handler again
   installSignalHandler(SIGINT, SIG_IGN);
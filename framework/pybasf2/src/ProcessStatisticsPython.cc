@@ -206,6 +206,34 @@ Time spent or memory used in any module function. This is the sum of all of the
   .export_values()
   ;
 
+  //Define enum for the hardware counters in scope of class
+  enum_<HardwareCounters::ECounter>("HardwareCounters", R"DOCSTRING(
+Available hardware performance counters. They are only collected if basf2 is
+run with ``--stats-hardware-counters`` and the system allows access to them.
+
+.. attribute:: CYCLES
+
+CPU cycles spent in user space
+
+.. attribute:: INSTRUCTIONS
+
+Instructions retired in user space
+
+.. attribute:: CACHE_MISSES
+
+Last level cache misses
+
+.. attribute:: BRANCH_MISSES
+
+Mispredicted branches
+)DOCSTRING")
+  .value("CYCLES", HardwareCounters::c_Cycles)
+  .value("INSTRUCTIONS", HardwareCounters::c_Instructions)
+  .value("CACHE_MISSES", HardwareCounters::c_CacheMisses)
+  .value("BRANCH_MISSES", HardwareCounters::c_BranchMisses)
+  .export_values()
+  ;
+
   {
     // the overloaded __str__ and __call__ give very confusing signatures so hand-craft doc string.
   docstring_options custom_options(true, false, false); //userdef, py sigs, c++ sigs
@@ -265,6 +293,19 @@ Parameters:
        "time_memory_corr(counter=StatisticCounters.TOTAL)\nReturn the correlaction factor between time and memory consumption")
   .def("calls", &ModuleStatistics::getCalls, bp::arg("counter") = ModuleStatistics::c_Total,
        "calls(counter=StatisticCounters.TOTAL)\nReturn the total number of calls")
+  .def("time_percentile", &ModuleStatistics::getEventTimePercentile, bp::arg("fraction"),
+       "time_percentile(fraction)\nReturn the execution time of `Module.event` calls below which the given "
+       "fraction of all calls are, e.g. 0.99 for the 99th percentile. The precision is better than 12.5%")
+  .def("hardware_counter_calls", &ModuleStatistics::getHardwareCounterCalls, bp::arg("counter") = ModuleStatistics::c_Total,
+       "hardware_counter_calls(counter=StatisticCounters.TOTAL)\nReturn the number of calls with hardware counter values")
+  .def("hardware_counter_sum", &ModuleStatistics::getHardwareCounterSum,
+       (bp::arg("hwcounter"), bp::arg("counter") = ModuleStatistics::c_Total),
+       "hardware_counter_sum(hwcounter, counter=StatisticCounters.TOTAL)\nReturn the sum of the given `HardwareCounters` value")
+  .def("hardware_counter_mean", &ModuleStatistics::getHardwareCounterMean,
+       (bp::arg("hwcounter"), bp::arg("counter") = ModuleStatistics::c_Total),
+       "hardware_counter_mean(hwcounter, counter=StatisticCounters.TOTAL)\nReturn the mean of the given `HardwareCounters` value per call")
+  .def("instructions_per_cycle", &ModuleStatistics::getInstructionsPerCycle, bp::arg("counter") = ModuleStatistics::c_Total,
+       "instructions_per_cycle(counter=StatisticCounters.TOTAL)\nReturn the number of instructions per CPU cycle")
   ;
 
   //Expose ProcessStatisticsPython instance as "statistics" object in pybasf2 module
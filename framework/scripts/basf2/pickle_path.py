@@ -28,6 +28,8 @@ def serialize_value(module, parameter):
     """Serialize a single basf2 module parameter"""
     if parameter.name == 'path' and module.type() == 'SubEvent':
         return serialize_path(parameter.values)
+    elif parameter.name == 'paths' and module.type() == 'ConcurrentPaths':
+        return [serialize_path(path) for path in parameter.values]
     else:
         return parameter.values
 
@@ -36,6 +38,8 @@ def deserialize_value(module, parameter_state):
     """Deserialize a single basf2 module paramater"""
     if parameter_state['name'] == 'path' and module.type() == 'SubEvent':
         return deserialize_path(parameter_state['values'])
+    elif parameter_state['name'] == 'paths' and module.type() == 'ConcurrentPaths':
+        return [deserialize_path(path) for path in parameter_state['values']]
     else:
         return parameter_state['values']
 
@@ -73,7 +77,7 @@ def serialize_module(module):
         'flag': module.has_properties(pybasf2.ModulePropFlags.PARALLELPROCESSINGCERTIFIED),
         'parameters': [{'name': parameter.name, 'values': serialize_value(module, parameter)}
                        for parameter in module.available_params()
-                       if parameter.setInSteering or module.type() == 'SubEvent'],
+                       if parameter.setInSteering or module.type() in ('SubEvent', 'ConcurrentPaths')],
         'condition': serialize_conditions(module) if module.has_condition() else None}
 
 
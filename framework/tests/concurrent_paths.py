@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+# @cond
+
+import basf2
+from ROOT import Belle2
+
+
+class CreateData(basf2.Module):
+
+    """create an array with a given name"""
+
+    def __init__(self, name, entries):
+        """remember name and number of entries"""
+        super().__init__()
+        self.set_name(f"CreateData({name})")
+        self.array_name = name
+        self.entries = entries
+
+    def initialize(self):
+        """reimplementation"""
+
+        self.array = Belle2.PyStoreArray(Belle2.EventMetaData.Class(), self.array_name)
+        self.array.registerInDataStore()
+
+    def event(self):
+        """reimplementation"""
+
+        for i in range(self.entries):
+            self.array.appendNew()
+
+
+class CheckData(basf2.Module):
+
+    """check output of all CreateData modules"""
+
+    def event(self):
+        """reimplementation"""
+
+        assert Belle2.PyStoreArray('first').getEntries() == 3
+        assert Belle2.PyStoreArray('second').getEntries() == 5
+
+
+# python modules are fine if executed sequentially
+main = basf2.Path()
+main.add_module('EventInfoSetter', evtNumList=[5])
+first = basf2.Path()
+first.add_module(CreateData('first', 3))
+second = basf2.Path()
+second.add_module(CreateData('second', 5))
+main.add_concurrent_paths([first, second], threads=1)
+main.add_module(CheckData())
+
+basf2.print_path(main)
+basf2.process(main)
+
+# C++ modules which only read can run in several threads
+main = basf2.Path()
+main.add_module('EventInfoSetter', evtNumList=[5])
+first = basf2.Path()
+first.add_module('EventInfoPrinter')
+second = basf2.Path()
+second.add_module('Progress')
+main.add_concurrent_paths([first, second], threads=2)
+
+basf2.print_path(main)
+basf2.process(main)
+
+print(basf2.statistics)
+# @endcond
@@ -25,8 +25,12 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <filesystem>
 #include <list>
+#include <memory>
+#include <string>
+#include <vector>
 #include <cstdio>
 
 using namespace std;
@@ -243,6 +247,28 @@ namespace {
     EXPECT_FALSE(named);
   }
 
+  /** Test that prefetching payloads for upcoming runs gives the same result */
+  TEST_F(DataBaseTest, Prefetch)
+  {
+    StoreObjPtr<EventMetaData> evtPtr;
+    DBObjPtr<TNamed> named;
+
+    evtPtr->setExperiment(1);
+    DBStore::Instance().update();
+    ASSERT_TRUE(named);
+    DBStore::Instance().prefetch(4, 0);
+    // announcing the same run twice is fine
+    DBStore::Instance().prefetch(4, 0);
+    DBStore::Instance().prefetch(7, 0);
+    evtPtr->setExperiment(4);
+    DBStore::Instance().update();
+    ASSERT_TRUE(named);
+    EXPECT_TRUE(strcmp(named->GetName(), "Experiment 4") == 0);
+    evtPtr->setExperiment(7);
+    DBStore::Instance().update();
+    EXPECT_FALSE(named);
+  }
+
   /** Test database access via DBArray */
   TEST_F(DataBaseTest, DBArray)
   {
@@ -357,6 +383,83 @@ namespace {
     EXPECT_TRUE(strcmp(intraRun->GetName(), "X") == 0);
   }
 
+  /** Test that the event boundaries stay sorted if objects are not added in order */
+  TEST_F(DataBaseTest, EventDependencyOrder)
+  {
+    EventDependency intraRunDep(new TNamed("A", "A"));
+    intraRunDep.add(50, new TNamed("C", "C"));
+    intraRunDep.add(10, new TNamed("B", "B"));
+    intraRunDep.add(70, new TNamed("D", "D"));
+    intraRunDep.add(30, new TNamed("E", "E"));
+    EXPECT_EQ(intraRunDep.getEventNumbers(), std::vector<unsigned int>({10, 30, 50, 70}));
+    const std::vector<std::pair<unsigned int, std::string>> expected{
+      {0, "A"}, {9, "A"}, {10, "B"}, {29, "B"}, {30, "E"}, {49, "E"}, {50, "C"}, {69, "C"}, {70, "D"}, {1000, "D"}
+    };
+    for (const auto& [event, name] : expected) {
+      EventMetaData meta(event, 1, 1);
+      EXPECT_EQ(name, intraRunDep.getObject(meta)->GetName()) << "event " << event;
+    }
+    EventMetaData meta(35, 1, 1);
+    EXPECT_EQ(intraRunDep.getValidityRange(meta), std::make_pair(30u, 49u));
+  }
+
+  /** Test and benchmark the per event update with many intra run dependent payloads */
+  TEST_F(DataBaseTest, IntraRunManyPayloads)
+  {
+    const int nPayloads = 300;
+    const int nBoundaries = 20;
+    const unsigned int nEvents = 50000;
+    // payload i changes every i + 100 events
+    auto getBoundary = [](int payload, int boundary) -> unsigned int { return (boundary + 1) * (payload + 100); };
+    std::vector<std::unique_ptr<DBObjPtr<TNamed>>> payloads;
+    for (int i = 0; i < nPayloads; ++i) {
+      const std::string name = "IntraRun" + std::to_string(i);
+      EventDependency intraRunDep(new TNamed("0", "0"));
+      for (int j = 0; j < nBoundaries; ++j) {
+        const std::string objectName = std::to_string(j + 1);
+        intraRunDep.add(getBoundary(i, j), new TNamed(objectName.c_str(), objectName.c_str()));
+      }
+      ASSERT_TRUE(Database::Instance().storeData(name, &intraRunDep, IntervalOfValidity(1, 1, 1, 1)));
+      payloads.emplace_back(std::make_unique<DBObjPtr<TNamed>>(name));
+    }
+
+    StoreObjPtr<EventMetaData> evtPtr;
+    evtPtr->setExperiment(1);
+    evtPtr->setRun(1);
+    evtPtr->setEvent(1);
+    DBStore::Instance().update();
+
+    auto checkAll = [&](unsigned int event) {
+      for (int i = 0; i < nPayloads; ++i) {
+        int expected = 0;
+        while (expected < nBoundaries and getBoundary(i, expected) <= event) ++expected;
+        ASSERT_EQ(std::to_string(expected), (*payloads[i])->GetName()) << "event " << event << ", payload " << i;
+      }
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned int event = 1; event <= nEvents; ++event) {
+      evtPtr->setEvent(event);
+      DBStore::Instance().updateEvent();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    RecordProperty("updateEventNanoseconds",
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count() / nEvents);
+    checkAll(nEvents);
+
+    // and check that jumping around in the run still gives the correct objects
+    for (unsigned int event : {1u, 99u, 100u, 12345u, 101u, 2000u, 1999u, 0u, 7777u}) {
+      evtPtr->setEvent(event);
+      DBStore::Instance().updateEvent();
+      checkAll(event);
+    }
+    for (unsigned int event = 1; event <= nEvents; event += 997) {
+      evtPtr->setEvent(event);
+      DBStore::Instance().updateEvent();
+      checkAll(event);
+    }
+  }
+
   /** Test the database content change notification */
   TEST_F(DataBaseTest, HasChanged)
   {
@@ -0,0 +1,66 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <framework/core/EventTracer.h>
+#include <framework/dataobjects/EventMetaData.h>
+#include <framework/utilities/FileSystem.h>
+#include <framework/utilities/TestHelpers.h>
+
+#include <nlohmann/json.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <unistd.h>
+
+using namespace Belle2;
+
+namespace {
+  /** Only sampled events are recorded, the ring keeps the most recent records
+   * and the merged file is valid Chrome trace json */
+  TEST(EventTracerTest, SampleAndMerge)
+  {
+    TestHelpers::TempDirCreator tempDir;
+    EventTracer& tracer = EventTracer::Instance();
+    tracer.configure("trace.json", 2, 4);
+    ASSERT_TRUE(tracer.isEnabled());
+
+    for (unsigned int i = 0; i < 10; ++i) {
+      tracer.beginEvent();
+      EXPECT_EQ(i % 2 == 0, tracer.isActive());
+      EventMetaData eventMetaData(i, 2, 3);
+      const int64_t start = EventTracer::now();
+      tracer.record(nullptr, start, start + 1000, &eventMetaData);
+    }
+    tracer.writePart();
+    EXPECT_TRUE(FileSystem::fileExists(tracer.getPartFilename(getpid())));
+    // a part file of another job writing to the same file name must not be merged
+    const std::string otherJobPart = "trace.json.0." + std::to_string(getpid()) + ".part";
+    std::ofstream(otherJobPart) << "{\"name\": \"other job\"}\n";
+    tracer.merge();
+    EXPECT_FALSE(FileSystem::fileExists(tracer.getPartFilename(getpid())));
+    EXPECT_TRUE(FileSystem::fileExists(otherJobPart));
+
+    std::ifstream input("trace.json");
+    nlohmann::json trace = nlohmann::json::parse(input);
+    const auto& events = trace["traceEvents"];
+    // process name and the last four of the five sampled events
+    ASSERT_EQ(5u, events.size());
+    EXPECT_EQ("M", events[0]["ph"]);
+    for (unsigned int i = 1; i < 5; ++i) {
+      EXPECT_EQ("X", events[i]["ph"]);
+      EXPECT_EQ("event", events[i]["name"]);
+      EXPECT_EQ(2 * i, events[i]["args"]["evt"].get<unsigned int>());
+      EXPECT_DOUBLE_EQ(1.0, events[i]["dur"].get<double>());
+    }
+
+    tracer.configure("");
+    EXPECT_FALSE(tracer.isEnabled());
+    tracer.beginEvent();
+    EXPECT_FALSE(tracer.isActive());
+  }
+}  // namespace
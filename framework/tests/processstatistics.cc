@@ -10,6 +10,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 using namespace std;
 using namespace Belle2;
 
@@ -90,4 +92,98 @@ namespace {
     EXPECT_EQ(1, a.getStatistics(&dummyMod).getCalls());
     EXPECT_FLOAT_EQ(sum, a.getGlobal().getTimeSum());
   }
+
+  /** Percentiles of the event() time histogram and merging of the histograms */
+  TEST(ProcessStatisticsTest, TimePercentiles)
+  {
+    ModuleStatistics a;
+    ModuleStatistics b;
+    EXPECT_EQ(0, a.getEventTimePercentile(0.5));
+    // 999 fast calls in a and one very slow one in b
+    for (int i = 0; i < 999; ++i) a.add(ModuleStatistics::c_Event, 1000 + i, 0);
+    b.add(ModuleStatistics::c_Event, 1e9, 0);
+    // other counter types don't fill the histogram
+    b.add(ModuleStatistics::c_BeginRun, 1e10, 0);
+
+    const double p50 = a.getEventTimePercentile(0.5);
+    EXPECT_GE(p50, 1499);
+    EXPECT_LE(p50, 1499 * (1 + 1. / ModuleStatistics::c_TimeSubBins));
+    EXPECT_LE(a.getEventTimePercentile(1.0), 1998 * (1 + 1. / ModuleStatistics::c_TimeSubBins));
+
+    a.update(b);
+    EXPECT_LE(a.getEventTimePercentile(0.999), 1998 * (1 + 1. / ModuleStatistics::c_TimeSubBins));
+    const double p100 = a.getEventTimePercentile(1.0);
+    EXPECT_GE(p100, 1e9);
+    EXPECT_LE(p100, 1e9 * (1 + 1. / ModuleStatistics::c_TimeSubBins));
+
+    // very large values end up in the overflow
+    EXPECT_EQ(ModuleStatistics::c_TimeBins - 1, ModuleStatistics::getTimeBin(1e20));
+    EXPECT_EQ(0, ModuleStatistics::getTimeBin(1));
+    for (int bin = 1; bin < ModuleStatistics::c_TimeBins - 1; ++bin) {
+      const double edge = ModuleStatistics::getTimeBinUpperEdge(bin);
+      EXPECT_EQ(bin, ModuleStatistics::getTimeBin(edge * 0.999));
+      EXPECT_EQ(bin + 1, ModuleStatistics::getTimeBin(edge));
+    }
+
+    a.clear();
+    EXPECT_EQ(0, a.getEventTimePercentile(0.99));
+  }
+
+  /** Hardware counters need to be summed when merging statistics from several processes */
+  TEST(ProcessStatisticsTest, HardwareCounters)
+  {
+    ModuleStatistics a;
+    ModuleStatistics b;
+    a.addHardwareCounters(ModuleStatistics::c_Event, {100, 300, 2, 1});
+    a.addHardwareCounters(ModuleStatistics::c_BeginRun, {10, 10, 0, 0});
+    b.addHardwareCounters(ModuleStatistics::c_Event, {300, 500, 4, 3});
+
+    EXPECT_EQ(1, a.getHardwareCounterCalls(ModuleStatistics::c_Event));
+    EXPECT_EQ(2, a.getHardwareCounterCalls());
+    EXPECT_DOUBLE_EQ(110, a.getHardwareCounterSum(HardwareCounters::c_Cycles));
+    EXPECT_DOUBLE_EQ(3, a.getInstructionsPerCycle(ModuleStatistics::c_Event));
+
+    a.update(b);
+    EXPECT_EQ(2, a.getHardwareCounterCalls(ModuleStatistics::c_Event));
+    EXPECT_DOUBLE_EQ(400, a.getHardwareCounterSum(HardwareCounters::c_Cycles, ModuleStatistics::c_Event));
+    EXPECT_DOUBLE_EQ(3, a.getHardwareCounterMean(HardwareCounters::c_CacheMisses, ModuleStatistics::c_Event));
+    EXPECT_DOUBLE_EQ(2, a.getInstructionsPerCycle(ModuleStatistics::c_Event));
+    EXPECT_DOUBLE_EQ(0, a.getInstructionsPerCycle(ModuleStatistics::c_Term));
+
+    a.clear();
+    EXPECT_EQ(0, a.getHardwareCounterCalls());
+    EXPECT_DOUBLE_EQ(0, a.getHardwareCounterSum(HardwareCounters::c_Instructions));
+  }
+
+  /** Calls without memory measurement count for the time but not for the memory statistics */
+  TEST(ProcessStatisticsTest, SampledMemory)
+  {
+    ModuleStatistics a;
+    ModuleStatistics b;
+    a.add(ModuleStatistics::c_Event, 1, 10);
+    a.addTime(ModuleStatistics::c_Event, 3);
+    a.addTime(ModuleStatistics::c_Event, 5);
+    b.add(ModuleStatistics::c_Event, 7, 30);
+
+    EXPECT_EQ(3, a.getCalls(ModuleStatistics::c_Event));
+    EXPECT_DOUBLE_EQ(9, a.getTimeSum());
+    EXPECT_DOUBLE_EQ(3, a.getTimeMean());
+    EXPECT_DOUBLE_EQ(std::sqrt(8. / 3), a.getTimeStddev());
+    EXPECT_DOUBLE_EQ(10, a.getMemoryMean());
+    EXPECT_DOUBLE_EQ(0, a.getMemoryStddev());
+    // extrapolated from the measured calls
+    EXPECT_DOUBLE_EQ(30, a.getMemorySum());
+
+    a.update(b);
+    EXPECT_EQ(4, a.getCalls());
+    EXPECT_DOUBLE_EQ(4, a.getTimeMean(ModuleStatistics::c_Event));
+    EXPECT_DOUBLE_EQ(std::sqrt(5.), a.getTimeStddev(ModuleStatistics::c_Event));
+    EXPECT_DOUBLE_EQ(20, a.getMemoryMean(ModuleStatistics::c_Event));
+    EXPECT_DOUBLE_EQ(80, a.getMemorySum(ModuleStatistics::c_Event));
+    EXPECT_NEAR(1, a.getTimeMemoryCorrelation(ModuleStatistics::c_Event), 1e-12);
+
+    a.clear();
+    EXPECT_EQ(0, a.getCalls());
+    EXPECT_DOUBLE_EQ(0, a.getTimeStddev());
+  }
 }  // namespace
@@ -139,6 +139,14 @@ int main(int argc, char* argv[])
     ("visualize-dataflow", "Generate data flow diagram (dataflow.dot) for the executed steering file.")
     ("no-stats",
      "Disable collection of statistics during event processing. Useful for very high-rate applications, but produces empty table with 'print(statistics)'.")
+    ("stats-hardware-counters",
+     "Collect cycles, instructions, cache misses and branch misses for every module call using the hardware performance counters. Requires perf events to be allowed on the machine.")
+    ("stats-memory-interval", prog::value<unsigned int>(),
+     "Only measure the memory consumption of modules in every N-th event to reduce the overhead of the statistics. Memory means are computed from the measured events only and memory sums are extrapolated to all events.")
+    ("trace-output", prog::value<string>(),
+     "Record the start and end time of each event and of each module event() call and write them to the given file in Chrome trace format (viewable with chrome://tracing or ui.perfetto.dev). In parallel processing the traces of all processes are merged.")
+    ("trace-interval", prog::value<unsigned int>(),
+     "Only record every N-th event of each process with --trace-output.")
     ("dry-run",
      "Read steering file, but do not start any event processing when process(path) is called. Prints information on input/output files that would be used during normal execution.")
     ("dump-path", prog::value<string>(),
@@ -406,6 +414,22 @@ int main(int argc, char* argv[])
       Environment::Instance().setNoStats(true);
     }
 
+    if (varMap.count("stats-hardware-counters")) {
+      Environment::Instance().setStatsHardwareCounters(true);
+    }
+
+    if (varMap.count("stats-memory-interval")) {
+      Environment::Instance().setStatsMemoryInterval(varMap["stats-memory-interval"].as<unsigned int>());
+    }
+
+    if (varMap.count("trace-output")) {
+      Environment::Instance().setTraceOutput(varMap["trace-output"].as<string>());
+    }
+
+    if (varMap.count("trace-interval")) {
+      Environment::Instance().setTraceInterval(varMap["trace-interval"].as<unsigned int>());
+    }
+
     if (varMap.count("dry-run")) {
       Environment::Instance().setDryRun(true);
     }
@@ -0,0 +1,62 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <array>
+
+namespace Belle2 {
+  /**
+   * Access to the hardware performance counters of the current process via the
+   * Linux perf_event_open() interface.
+   *
+   * The counters are opened as one group so all of them are read with a single
+   * system call and are always scheduled together. Only user space is counted
+   * which works with the default perf_event_paranoid setting of most systems.
+   * The counters are reopened automatically after a fork so each process counts
+   * only its own events.
+   *
+   * If the counters cannot be opened, for example in containers which don't
+   * allow perf events, read() returns false and the values are left unchanged.
+   */
+  class HardwareCounters {
+  public:
+    /** Available counters */
+    enum ECounter {
+      /** CPU cycles */
+      c_Cycles,
+      /** retired instructions */
+      c_Instructions,
+      /** last level cache misses */
+      c_CacheMisses,
+      /** mispredicted branches */
+      c_BranchMisses,
+      /** number of counters */
+      c_NCounters
+    };
+
+    /** Type for the counter values */
+    using Values = std::array<double, c_NCounters>;
+
+    /** Return the name of a counter */
+    static const char* getName(ECounter counter);
+
+    /**
+     * Read the current values of all counters.
+     * @param values will be filled with the counter values since the counters were opened
+     * @return false if the counters are not available
+     */
+    static bool read(Values& values);
+
+    /** Check if the hardware counters can be used in this process */
+    static bool isAvailable();
+
+  private:
+    /** Open the counters if not yet done for this process. Returns the group leader fd or -1 */
+    static int open();
+  };
+}
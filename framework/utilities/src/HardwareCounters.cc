@@ -0,0 +1,104 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <framework/utilities/HardwareCounters.h>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+
+using namespace Belle2;
+
+namespace {
+  /** Process for which the counters were opened */
+  pid_t s_pid{0};
+  /** File descriptors of all counters, the first one is the group leader */
+  std::array<int, HardwareCounters::c_NCounters> s_fds{ -1, -1, -1, -1};
+
+  /** Open one counter, return the file descriptor or -1 */
+  int openCounter(uint64_t config, int groupFd)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = (groupFd == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+  }
+
+  /** Close all counters */
+  void closeCounters()
+  {
+    for (int& fd : s_fds) {
+      if (fd >= 0) close(fd);
+      fd = -1;
+    }
+  }
+}
+
+const char* HardwareCounters::getName(ECounter counter)
+{
+  switch (counter) {
+    case c_Cycles: return "cycles";
+    case c_Instructions: return "instructions";
+    case c_CacheMisses: return "cache misses";
+    case c_BranchMisses: return "branch misses";
+    default: return "";
+  }
+}
+
+int HardwareCounters::open()
+{
+  const pid_t pid = getpid();
+  if (pid == s_pid) return s_fds[0];
+  // New process (or first call): counters inherited from the parent would
+  // still count the parent so open new ones
+  closeCounters();
+  s_pid = pid;
+  const uint64_t configs[c_NCounters] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+  };
+  for (int i = 0; i < c_NCounters; ++i) {
+    s_fds[i] = openCounter(configs[i], s_fds[0]);
+    if (s_fds[i] < 0) {
+      closeCounters();
+      return -1;
+    }
+  }
+  ioctl(s_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(s_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return s_fds[0];
+}
+
+bool HardwareCounters::isAvailable()
+{
+  return open() >= 0;
+}
+
+bool HardwareCounters::read(Values& values)
+{
+  const int fd = open();
+  if (fd < 0) return false;
+  // layout for PERF_FORMAT_GROUP with both times: nr, time enabled, time running, values
+  uint64_t buffer[3 + c_NCounters];
+  if (::read(fd, buffer, sizeof(buffer)) != sizeof(buffer) or buffer[0] != c_NCounters) return false;
+  // scale the values if the counters had to share the hardware with others
+  const double scale = (buffer[2] > 0) ? static_cast<double>(buffer[1]) / buffer[2] : 1.0;
+  for (int i = 0; i < c_NCounters; ++i) {
+    values[i] = buffer[3 + i] * scale;
+  }
+  return true;
+}
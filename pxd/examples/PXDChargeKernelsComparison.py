@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""Compare the PXD digitization with charge sharing kernels to the random walk.
+
+The same PXDSimHits are digitized twice, once with the default random walk
+and once with the tabulated charge sharing kernels (ChargeKernels=True), and
+both sets of digits are clustered. Cluster shape variables are histogrammed
+for both modes and compared with a Kolmogorov test; the histograms are saved
+to PXDChargeKernelsComparison.root. The module statistics at the end show
+the time spent in both digitizers.
+
+Usage:
+    $ basf2 PXDChargeKernelsComparison.py -n 2000
+"""
+
+import basf2 as b2
+from ROOT import Belle2, TFile, TH1F
+from simulation import add_simulation
+
+#: Cluster shape variables: name, title, number of bins, range
+variables = [
+    ('size', 'cluster size', 20, 0.5, 20.5),
+    ('uSize', 'cluster size in u', 10, 0.5, 10.5),
+    ('vSize', 'cluster size in v', 15, 0.5, 15.5),
+    ('charge', 'cluster charge [ADU]', 100, 0, 500),
+    ('seedCharge', 'seed charge [ADU]', 64, 0, 256),
+]
+
+
+class PXDClusterShapeComparison(b2.Module):
+    """Fill and compare cluster shape histograms of two cluster collections."""
+
+    def __init__(self, collections):
+        """Constructor, collections maps a label to a PXDClusters collection name."""
+        super().__init__()
+        #: labels and names of the cluster collections
+        self.collections = collections
+        #: histograms, indexed by label and variable
+        self.histograms = {}
+
+    def initialize(self):
+        """Book the histograms."""
+        #: output file
+        self.file = TFile('PXDChargeKernelsComparison.root', 'RECREATE')
+        for label in self.collections:
+            for name, title, bins, low, high in variables:
+                self.histograms[label, name] = TH1F(f'{name}_{label}', f'{title} ({label})', bins, low, high)
+
+    def event(self):
+        """Fill the histograms."""
+        for label, collection in self.collections.items():
+            for cluster in Belle2.PyStoreArray(collection):
+                values = {
+                    'size': cluster.getSize(),
+                    'uSize': cluster.getUSize(),
+                    'vSize': cluster.getVSize(),
+                    'charge': cluster.getCharge(),
+                    'seedCharge': cluster.getSeedCharge(),
+                }
+                for name, value in values.items():
+                    self.histograms[label, name].Fill(value)
+
+    def terminate(self):
+        """Print the comparison and save the histograms."""
+        reference, test = self.collections
+        print(f'{"variable":12s} {"mean " + reference:>18s} {"mean " + test:>18s} '
+              f'{"rms " + reference:>18s} {"rms " + test:>18s} {"KS prob.":>10s}')
+        for name, *_ in variables:
+            h1 = self.histograms[reference, name]
+            h2 = self.histograms[test, name]
+            ks = h1.KolmogorovTest(h2) if h1.GetEntries() > 0 and h2.GetEntries() > 0 else 0
+            print(f'{name:12s} {h1.GetMean():18.3f} {h2.GetMean():18.3f} '
+                  f'{h1.GetRMS():18.3f} {h2.GetRMS():18.3f} {ks:10.3f}')
+        self.file.Write()
+        self.file.Close()
+
+
+b2.set_random_seed(12345)
+
+main = b2.create_path()
+main.add_module('EventInfoSetter')
+main.add_module('ParticleGun', pdgCodes=[211, -211], nTracks=2,
+                momentumGeneration='uniform', momentumParams=[0.1, 2.0],
+                thetaGeneration='uniform', thetaParams=[17, 150])
+add_simulation(main, components=['MagneticField', 'PXD'], forceSetPXDDataReduction=True, usePXDDataReduction=False)
+
+# Digitize the same simhits with the charge sharing kernels
+kernels = main.add_module('PXDDigitizer', Digits='PXDDigitsKernels', ChargeKernels=True)
+kernels.set_name('PXDDigitizer_ChargeKernels')
+
+main.add_module('PXDClusterizer')
+main.add_module('PXDClusterizer', Digits='PXDDigitsKernels', Clusters='PXDClustersKernels').set_name('PXDClusterizer_ChargeKernels')
+
+main.add_module(PXDClusterShapeComparison({'randomWalk': 'PXDClusters', 'kernels': 'PXDClustersKernels'}))
+main.add_module('Progress')
+
+b2.process(main)
+
+print(b2.statistics)
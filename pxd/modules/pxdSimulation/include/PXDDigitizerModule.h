@@ -14,7 +14,9 @@
 #include <pxd/geometry/SensorInfo.h>
 #include <framework/dataobjects/RelationElement.h>
 #include <framework/datastore/StoreObjPtr.h>
+#include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Belle2 {
@@ -79,6 +81,28 @@ namespace Belle2 {
     /** Map of all hits in all Sensors */
     typedef std::map<VxdID, Sensor> Sensors;
 
+    /** One pixel of a charge sharing kernel */
+    struct ChargeKernelEntry {
+      /** Offset in u w.r.t. the reference pixel */
+      short du;
+      /** Offset in v w.r.t. the first row of the reference pixel pair */
+      short dv;
+      /** Probability that an electron group ends up in this pixel */
+      double p;
+    };
+
+    /** Charge sharing kernels of one sensor type, tabulated with the random walk of the digitizer.
+     * There is one kernel per pitch region, depth and position inside a pair of pixel rows
+     * (the internal gates repeat with a period of two rows), the entries of each kernel are
+     * sorted by decreasing probability.
+     */
+    struct ChargeKernelTable {
+      /** Number of bins in depth, u and v (v covers two pixel rows) */
+      int nBins[3] = {0, 0, 0};
+      /** Kernels, index ((region * nBins[0] + iz) * nBins[1] + iu) * nBins[2] + iv */
+      std::vector<std::vector<ChargeKernelEntry>> kernels;
+    };
+
 
     /** The PXD Digitizer module.
      * This module is responsible for converting the simulated energy
@@ -100,6 +124,29 @@ namespace Belle2 {
        * @param electrons number of electrons to drift
        */
       void driftCharge(const ROOT::Math::XYZVector& position, double electrons);
+      /** Deposit the charge using the tabulated charge sharing kernels.
+       * The electron groups are distributed among the pixels of the kernel
+       * by multinomial sampling, instead of following each random walk.
+       * @param position start position of the charge
+       * @param electrons number of electrons to drift
+       */
+      void depositCharge(const ROOT::Math::XYZVector& position, double electrons);
+      /** Follow one electron group in the potential minimum until it is trapped in an internal gate.
+       * @param info sensor info
+       * @param uPos u position of the group after the drift
+       * @param vPos v position of the group after the drift
+       * @param sigmaDiffus diffusion per random walk step
+       * @return pixel which collects the group, the closest one if it is not trapped after m_elMaxSteps
+       */
+      Digit walkElectronGroup(const SensorInfo& info, double uPos, double vPos, double sigmaDiffus) const;
+      /** Return the charge sharing kernels for the current sensor and magnetic field, build them if needed */
+      const ChargeKernelTable* getChargeKernels();
+      /** Tabulate the charge sharing kernels of a sensor with the random walk.
+       * @param info sensor info
+       * @param bField true if the magnetic field is on
+       * @param table kernels to be filled
+       */
+      void buildChargeKernels(const SensorInfo& info, bool bField, ChargeKernelTable& table) const;
       /** Add pure noise digits to the Sensors */
       void addNoiseDigits();
       /** Calculate the noise contribution to one pixel with given charge.
@@ -167,6 +214,12 @@ namespace Belle2 {
       double m_elStepTime;
       /** Maximum number of random walks before abort */
       int    m_elMaxSteps;
+      /** Use tabulated charge sharing kernels instead of the random walk */
+      bool   m_useChargeKernels;
+      /** Number of kernel bins in depth, u and v (two pixel rows) */
+      std::vector<int> m_kernelBins;
+      /** Number of electron groups simulated per kernel */
+      int    m_kernelSamples;
       /** ENC equivalent of 1 ADU */
       double m_eToADU;
       /** g_q of a pixel in nA/electrons.*/
@@ -196,6 +249,12 @@ namespace Belle2 {
       const SensorInfo*  m_currentSensorInfo;
       /** Current magnetic field */
       ROOT::Math::XYZVector m_currentBField;
+      /** Charge sharing kernels, shared by all sensors with the same parameters */
+      std::map<std::vector<double>, ChargeKernelTable> m_chargeKernels;
+      /** Charge sharing kernels of each sensor with and without magnetic field */
+      std::map<std::pair<VxdID, bool>, const ChargeKernelTable*> m_sensorChargeKernels;
+      /** Charge sharing kernels for the current hit */
+      const ChargeKernelTable* m_currentChargeKernels;
 
       /** Number of readout gates (or total number of Switcher channels) */
       int m_nGates;
@@ -23,6 +23,7 @@
 #include <mdst/dataobjects/MCParticle.h>
 #include <pxd/dataobjects/PXDTrueHit.h>
 #include <pxd/dataobjects/PXDDigit.h>
+#include <algorithm>
 #include <cmath>
 
 #include <TRandom.h>
@@ -43,7 +44,7 @@ REG_MODULE(PXDDigitizer);
 PXDDigitizerModule::PXDDigitizerModule() : Module()
   , m_noiseFraction(0), m_eToADU(0), m_chargeThreshold(0), m_chargeThresholdElectrons(0)
   , m_currentHit(nullptr), m_currentParticle(0), m_currentTrueHit(0), m_currentSensor(nullptr)
-  , m_currentSensorInfo(nullptr), m_nGates(0), m_pxdIntegrationTime(0), m_timePerGate(0)
+  , m_currentSensorInfo(nullptr), m_currentChargeKernels(nullptr), m_nGates(0), m_pxdIntegrationTime(0), m_timePerGate(0)
   , m_triggerGate(0), m_gated(false)
 {
   //Set module properties
@@ -76,6 +77,13 @@ PXDDigitizerModule::PXDDigitizerModule() : Module()
            1.0);
   addParam("ElectronMaxSteps", m_elMaxSteps,
            "Maximum number of steps when propagating electrons", 200);
+  addParam("ChargeKernels", m_useChargeKernels,
+           "Deposit the charge with charge sharing kernels tabulated from the random walk instead of "
+           "following each electron group (fast mode)", false);
+  addParam("ChargeKernelBins", m_kernelBins,
+           "Number of charge sharing kernels in depth, u and v (v bins cover two pixel rows)", vector<int>({10, 5, 10}));
+  addParam("ChargeKernelSamples", m_kernelSamples,
+           "Number of electron groups simulated to tabulate each charge sharing kernel", 1000);
   addParam("Gq", m_gq, "Gq of a pixel in nA/electron", 0.6);
   addParam("ADCUnit", m_ADCUnit, "Slope of the linear ADC transfer curve in nA/ADU", 130.0);
   addParam("PedestalMean", m_pedestalMean, "Mean of pedestals in ADU", 100.0);
@@ -123,6 +131,13 @@ void PXDDigitizerModule::initialize()
   m_elStepTime *= Unit::ns;
   m_segmentLength *= Unit::mm;
 
+  if (m_useChargeKernels) {
+    if (m_kernelBins.size() != 3 || *std::min_element(m_kernelBins.begin(), m_kernelBins.end()) < 1)
+      B2FATAL("ChargeKernelBins must contain three positive numbers of bins (depth, u, v)");
+    if (m_kernelSamples < 1)
+      B2FATAL("ChargeKernelSamples must be positive");
+  }
+
   // Get number of PXD gates
   auto gTools = VXD::GeoCache::getInstance().getGeoTools();
   m_nGates = gTools->getNumberOfPXDReadoutGates();
@@ -155,6 +170,7 @@ void PXDDigitizerModule::initialize()
   B2DEBUG(20, " -->  ElectronGroupSize:  " << m_elGroupSize << " e-");
   B2DEBUG(20, " -->  ElectronStepTime:   " << m_elStepTime << " ns");
   B2DEBUG(20, " -->  ElectronMaxSteps:   " << m_elMaxSteps);
+  B2DEBUG(20, " -->  ChargeKernels:      " << (m_useChargeKernels ? "true" : "false"));
   B2DEBUG(20, " -->  ADU unit:           " << m_eToADU << " e-/ADU");
 }
 
@@ -167,6 +183,9 @@ void PXDDigitizerModule::beginRun()
   // frames, but they will stay and will be cleared appropriately, so this is not
   // a problem, and after a few events the performance will stabilize.
   m_sensors.clear();
+  // The kernels depend on the sensor parameters, tabulate them again if needed
+  m_chargeKernels.clear();
+  m_sensorChargeKernels.clear();
   VXD::GeoCache& geo = VXD::GeoCache::getInstance();
   for (VxdID layer : geo.getLayers(SensorInfo::PXD)) {
     for (VxdID ladder : geo.getLadders(layer)) {
@@ -390,10 +409,12 @@ void PXDDigitizerModule::processHit()
 
   // Set magnetic field to save calls to getBField()
   m_currentBField = m_currentSensorInfo->getBField(0.5 * (startPoint + stopPoint));
+  if (m_useChargeKernels) m_currentChargeKernels = getChargeKernels();
 
   if (m_currentHit->getPDGcode() == Const::photon.getPDGCode() || trackLength2 <= 0.01 * Unit::um * Unit::um) {
     //Photons deposit the energy at the end of their step
-    driftCharge(stopPoint, m_currentHit->getElectrons());
+    if (m_useChargeKernels) depositCharge(stopPoint, m_currentHit->getElectrons());
+    else driftCharge(stopPoint, m_currentHit->getElectrons());
   } else {
     //Otherwise, split into segments of (default) max. 5µm and
     //drift the charges from the center of each segment
@@ -411,7 +432,8 @@ void PXDDigitizerModule::processHit()
 
       //And drift charge from that position
       stopPoint.SetXYZ(startPoint.X() + f * dx, startPoint.Y() + f * dy, startPoint.Z() + f * dz);
-      driftCharge(stopPoint, e);
+      if (m_useChargeKernels) depositCharge(stopPoint, e);
+      else driftCharge(stopPoint, e);
     }
   }
 }
@@ -421,17 +443,20 @@ inline double pol3(double x, const double* c)
   return c[0] + x * (c[1] + x * (c[2] + x * c[3]));
 };
 
+/** Parametrization of the drift to the potential minimum and of the diffusion in it */
+namespace {
+  const double cx[] = {0, 2.611995e-01, -1.948316e+01, 9.167064e+02};
+  const double cu[] = {4.223817e-04, -1.041434e-03, 5.139596e-02, -1.180229e+00};
+  const double cv[] = {4.085681e-04, -8.615459e-04, 5.706439e-02, -1.774319e+00};
+  const double ct[] = {2.823743e-04, -1.138627e-06, 4.310888e-09, -1.559542e-11}; // temp range [250, 350] degrees with m_elStepTime = 1 ns
+}
+
 void PXDDigitizerModule::driftCharge(const ROOT::Math::XYZVector& r, double electrons)
 {
   //Get references to current sensor/info for ease of use
   const SensorInfo& info = *m_currentSensorInfo;
   Sensor& sensor = *m_currentSensor;
 
-  static const double cx[] = {0, 2.611995e-01, -1.948316e+01, 9.167064e+02};
-  static const double cu[] = {4.223817e-04, -1.041434e-03, 5.139596e-02, -1.180229e+00};
-  static const double cv[] = {4.085681e-04, -8.615459e-04, 5.706439e-02, -1.774319e+00};
-  static const double ct[] = {2.823743e-04, -1.138627e-06, 4.310888e-09, -1.559542e-11}; // temp range [250, 350] degrees with m_elStepTime = 1 ns
-
   double dz = 0.5 * info.getThickness() - info.getGateDepth() - r.Z(), adz = fabs(dz);
 
   double dx = fabs(m_currentBField.Y()) > Unit::T ? copysign(pol3(adz, cx),
@@ -447,28 +472,140 @@ void PXDDigitizerModule::driftCharge(const ROOT::Math::XYZVector& r, double elec
     double du = gRandom->Gaus(0.0, sigmaDrift_u), dv = gRandom->Gaus(0.0, sigmaDrift_v);
     double uPos = r.X() + du + dx;
     double vPos = r.Y() + dv;
-    int step = 0;
-    for (; step < m_elMaxSteps; ++step) {
-      int id = info.getTrappedID(uPos, vPos);
-      //Check if cloud inside of IG region
-      if (id >= 0) {
-        // Trapped in the internal gate region
-        sensor[Digit(id % 250, id / 250)].add(groupCharge, m_currentParticle, m_currentTrueHit);
-        break;
-      }
-      //Random walk with drift
-      dv = gRandom->Gaus(0.0, sigmaDiffus), du = gRandom->Gaus(0.0, sigmaDiffus);
-      uPos += du;
-      vPos += dv;
+    sensor[walkElectronGroup(info, uPos, vPos, sigmaDiffus)].add(groupCharge, m_currentParticle, m_currentTrueHit);
+  }
+}
+
+Digit PXDDigitizerModule::walkElectronGroup(const SensorInfo& info, double uPos, double vPos, double sigmaDiffus) const
+{
+  for (int step = 0; step < m_elMaxSteps; ++step) {
+    int id = info.getTrappedID(uPos, vPos);
+    //Check if cloud inside of IG region
+    if (id >= 0) {
+      // Trapped in the internal gate region
+      return Digit(id % 250, id / 250);
     }
-    if (step == m_elMaxSteps) {
-      // cloud is not trapped but save it anyway into the closest pixel
-      int iu = info.getUCellID(uPos, vPos, 1), iv = info.getVCellID(vPos, 1);
-      sensor[Digit(iu, iv)].add(groupCharge, m_currentParticle, m_currentTrueHit);
+    //Random walk with drift
+    double dv = gRandom->Gaus(0.0, sigmaDiffus), du = gRandom->Gaus(0.0, sigmaDiffus);
+    uPos += du;
+    vPos += dv;
+  }
+  // cloud is not trapped but save it anyway into the closest pixel
+  int iu = info.getUCellID(uPos, vPos, 1), iv = info.getVCellID(vPos, 1);
+  return Digit(iu, iv);
+}
+
+const ChargeKernelTable* PXDDigitizerModule::getChargeKernels()
+{
+  const SensorInfo& info = *m_currentSensorInfo;
+  bool bField = fabs(m_currentBField.Y()) > Unit::T;
+  const ChargeKernelTable*& kernels = m_sensorChargeKernels[std::make_pair(info.getID(), bField)];
+  if (kernels) return kernels;
+
+  // Sensors with the same parameters share the kernels
+  vector<double> key = {
+    double(bField), info.getThickness(), info.getGateDepth(), info.getTemperature(), info.getWidth(), info.getLength(),
+    double(info.getUCells()), double(info.getVCells()), double(info.getVCells2()),
+    info.getVPitch(-0.5 * info.getLength()), info.getVPitch(0.5 * info.getLength()),
+    info.getSourceBorder(-0.5 * info.getLength()), info.getClearBorder(-0.5 * info.getLength()),
+    info.getDrainBorder(-0.5 * info.getLength()), info.getSourceBorder(0.5 * info.getLength()),
+    info.getClearBorder(0.5 * info.getLength()), info.getDrainBorder(0.5 * info.getLength())
+  };
+  auto it = m_chargeKernels.find(key);
+  if (it == m_chargeKernels.end()) {
+    B2DEBUG(20, "Tabulating charge sharing kernels for sensor " << info.getID() << ", magnetic field " << bField);
+    it = m_chargeKernels.emplace(key, ChargeKernelTable()).first;
+    buildChargeKernels(info, bField, it->second);
+  }
+  kernels = &it->second;
+  return kernels;
+}
+
+void PXDDigitizerModule::buildChargeKernels(const SensorInfo& info, bool bField, ChargeKernelTable& table) const
+{
+  std::copy(m_kernelBins.begin(), m_kernelBins.end(), table.nBins);
+  const int nZ = table.nBins[0], nU = table.nBins[1], nV = table.nBins[2];
+  table.kernels.assign(2 * nZ * nU * nV, vector<ChargeKernelEntry>());
+
+  const double sigmaDiffus = pol3(info.getTemperature() - 300.0, ct);
+  const int nRows[2] = {info.getVCells() - info.getVCells2(), info.getVCells2()};
+  for (int region = 0; region < 2; ++region) {
+    if (nRows[region] < 2) continue;
+    // Reference pixel pair in the middle of the pitch region, far from the sensor edges
+    const int refU = info.getUCells() / 2;
+    const int refV = (region == 0 ? 0 : nRows[0]) + 2 * (nRows[region] / 4);
+    const double vPitch = info.getVPitch(info.getVCellPosition(refV));
+    const double uPitch = info.getUPitch(info.getVCellPosition(refV));
+    const double u0 = info.getUCellPosition(refU, refV) - 0.5 * uPitch;
+    const double v0 = info.getVCellPosition(refV) - 0.5 * vPitch;
+    for (int iz = 0; iz < nZ; ++iz) {
+      double z = ((iz + 0.5) / nZ - 0.5) * info.getThickness();
+      double dz = 0.5 * info.getThickness() - info.getGateDepth() - z, adz = fabs(dz);
+      double dx = bField ? copysign(pol3(adz, cx), dz) : 0;
+      double sigmaDrift_u = pol3(adz, cu);
+      double sigmaDrift_v = pol3(adz, cv);
+      for (int iu = 0; iu < nU; ++iu) {
+        for (int iv = 0; iv < nV; ++iv) {
+          double u = u0 + (iu + 0.5) / nU * uPitch;
+          double v = v0 + (iv + 0.5) / nV * 2 * vPitch;
+          map<pair<short, short>, int> counts;
+          for (int sample = 0; sample < m_kernelSamples; ++sample) {
+            double du = gRandom->Gaus(0.0, sigmaDrift_u), dv = gRandom->Gaus(0.0, sigmaDrift_v);
+            Digit d = walkElectronGroup(info, u + du + dx, v + dv, sigmaDiffus);
+            counts[make_pair(short(d.u() - refU), short(d.v() - refV))]++;
+          }
+          auto& kernel = table.kernels[((region * nZ + iz) * nU + iu) * nV + iv];
+          for (const auto& count : counts) {
+            kernel.push_back({count.first.first, count.first.second, double(count.second) / m_kernelSamples});
+          }
+          std::sort(kernel.begin(), kernel.end(), [](const ChargeKernelEntry & a, const ChargeKernelEntry & b) { return a.p > b.p; });
+        }
+      }
     }
   }
 }
 
+void PXDDigitizerModule::depositCharge(const ROOT::Math::XYZVector& r, double electrons)
+{
+  //Get references to current sensor/info for ease of use
+  const SensorInfo& info = *m_currentSensorInfo;
+  Sensor& sensor = *m_currentSensor;
+  const ChargeKernelTable& table = *m_currentChargeKernels;
+  const int nZ = table.nBins[0], nU = table.nBins[1], nV = table.nBins[2];
+
+  // Find the pixel pair and the position inside it
+  const int nRows0 = info.getVCells() - info.getVCells2();
+  int iv = info.getVCellID(r.Y(), true);
+  int region = iv < nRows0 ? 0 : 1;
+  int pairV = iv - (iv - region * nRows0) % 2;
+  int pairU = info.getUCellID(r.X(), r.Y(), true);
+  double vPitch = info.getVPitch(r.Y());
+  double uPitch = info.getUPitch(r.Y());
+  double fz = r.Z() / info.getThickness() + 0.5;
+  double fu = (r.X() - info.getUCellPosition(pairU, iv)) / uPitch + 0.5;
+  double fv = (r.Y() - info.getVCellPosition(pairV) + 0.5 * vPitch) / (2 * vPitch);
+  int iz = std::min(nZ - 1, std::max(0, int(fz * nZ)));
+  int iu = std::min(nU - 1, std::max(0, int(fu * nU)));
+  int jv = std::min(nV - 1, std::max(0, int(fv * nV)));
+  const auto& kernel = table.kernels[((region * nZ + iz) * nU + iu) * nV + jv];
+
+  // Multinomial sampling of the electron groups among the pixels of the kernel
+  int nGroups = (int)(electrons / m_elGroupSize) + 1;
+  double groupCharge = electrons / nGroups;
+  double pLeft = 1;
+  for (const ChargeKernelEntry& entry : kernel) {
+    if (nGroups <= 0) break;
+    bool last = &entry == &kernel.back() || entry.p >= pLeft;
+    int n = last ? nGroups : gRandom->Binomial(nGroups, entry.p / pLeft);
+    pLeft -= entry.p;
+    nGroups -= n;
+    if (n == 0) continue;
+    int pu = std::min(info.getUCells() - 1, std::max(0, pairU + entry.du));
+    int pv = std::min(info.getVCells() - 1, std::max(0, pairV + entry.dv));
+    sensor[Digit(pu, pv)].add(n * groupCharge, m_currentParticle, m_currentTrueHit);
+  }
+}
+
 
 double PXDDigitizerModule::addNoise(double charge)
 {
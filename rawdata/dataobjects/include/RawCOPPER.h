@@ -739,6 +739,9 @@ namespace Belle2 {
     if (((m_buffer[ POS_FORMAT_VERSION ] & FORMAT_MASK) >> 8)  != m_version
         || m_access == NULL) {
       SetVersion();
+    } else if (m_access->IsBufferSet(m_buffer, m_nwords, m_num_events, m_num_nodes)) {
+      // nothing changed since the last call, skip the virtual call
+      return;
     }
     m_access->SetBuffer(m_buffer, m_nwords, 0, m_num_events, m_num_nodes);
   }
@@ -29,6 +29,13 @@ namespace Belle2 {
     //! set buffer ( delete_flag : m_buffer is freeed( = 0 )/ not freeed( = 1 ) in Destructer )
     virtual void SetBuffer(int* bufin, int nwords, int delete_flag, int num_events, int num_nodes);
 
+    //! check whether SetBuffer() with these arguments and delete_flag = 0 would leave everything unchanged
+    bool IsBufferSet(const int* bufin, int nwords, int num_events, int num_nodes) const
+    {
+      return m_use_prealloc_buf && m_buffer == bufin && m_nwords == nwords
+             && m_num_events == num_events && m_num_nodes == num_nodes;
+    }
+
     //! Get total length of m_buffer
     virtual int TotalBufNwords();
 
@@ -245,6 +245,8 @@ namespace Belle2 {
     if (m_version < 0  || m_access == NULL) {
       // Since both ver.0, 1 and ver.2 will show m_buffer[ POS_NODE_ID ] & FORMAT_MASK == 0x0, I need to ignore the check for ver.0 and 1
       SetVersion();
+    } else if (m_access->IsBufferSet(m_buffer, m_nwords, m_num_events, m_num_nodes)) {
+      return;
     }
     m_access->SetBuffer(m_buffer, m_nwords, 0, m_num_events, m_num_nodes);
   }
@@ -23,9 +23,22 @@ RawCOPPERFormat::RawCOPPERFormat()
 
 unsigned int  RawCOPPERFormat::CalcXORChecksum(int* buf, int nwords)
 {
+  // Independent partial sums so that the compiler can use vector instructions and
+  // the loop is not limited by the latency of a single chain of XORs
+  const unsigned int* words = reinterpret_cast<const unsigned int*>(buf);
+  unsigned int partial[ 8 ] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  int i = 0;
+  for (; i + 8 <= nwords; i += 8) {
+    for (int j = 0; j < 8; j++) {
+      partial[ j ] ^= words[ i + j ];
+    }
+  }
   unsigned int checksum = 0;
-  for (int i = 0; i < nwords; i++) {
-    checksum = checksum ^ buf[ i ];
+  for (; i < nwords; i++) {
+    checksum ^= words[ i ];
+  }
+  for (int j = 0; j < 8; j++) {
+    checksum ^= partial[ j ];
   }
   return checksum;
 }
@@ -64,7 +64,7 @@ def add_packers(path, components=None):
         path.add_module(klmpacker)
 
 
-def add_unpackers(path, components=None, writeKLMDigitRaws=False, addTOPRelations=False):
+def add_unpackers(path, components=None, writeKLMDigitRaws=False, addTOPRelations=False, threads=0):
     """
     This function adds the raw data unpacker modules to a path.
 
@@ -72,6 +72,9 @@ def add_unpackers(path, components=None, writeKLMDigitRaws=False, addTOPRelation
     :param writeKLMDigitRaws: flag for creating the KLMDigitRaw object and storing it in the datastore. The KLMDQM
         module needs it for filling some histograms.
     :param addTOPRelations: flag for creating relations in TOPUnpacker and TOPRawDigitConverter
+    :param threads: if larger than one the unpackers of PXD, SVD, CDC, ECL, TOP, ARICH and KLM are executed
+        concurrently with up to this many threads in each event, see `basf2.Path.add_concurrent_paths`.
+        The trigger unpackers are always executed afterwards.
     """
 
     # Check components.
@@ -88,46 +91,61 @@ def add_unpackers(path, components=None, writeKLMDigitRaws=False, addTOPRelation
     if 'SimulateEventLevelTriggerTimeInfo' not in path:
         path.add_module('TTDUnpacker')
 
+    # When running concurrently each detector gets its own path, otherwise all modules are added to path directly
+    detector_paths = []
+
+    def detector_path():
+        if threads <= 1:
+            return path
+        detector_paths.append(b2.Path())
+        return detector_paths[-1]
+
     # PXD
     if components is None or 'PXD' in components:
-        add_pxd_unpacker(path)
+        add_pxd_unpacker(detector_path())
 
     # SVD
     if components is None or 'SVD' in components:
-        add_svd_unpacker(path)
+        add_svd_unpacker(detector_path())
 
     # CDC
     if components is None or 'CDC' in components:
         cdcunpacker = b2.register_module('CDCUnpacker')
         cdcunpacker.param('enableStoreCDCRawHit', True)
         cdcunpacker.param('enablePrintOut', False)
-        path.add_module(cdcunpacker)
+        detector_path().add_module(cdcunpacker)
 
     # ECL
     if components is None or 'ECL' in components:
         eclunpacker = b2.register_module('ECLUnpacker')
         eclunpacker.param("storeTrigTime", True)
-        path.add_module(eclunpacker)
+        detector_path().add_module(eclunpacker)
 
     # TOP
     if components is None or 'TOP' in components:
+        top_path = detector_path()
         topunpacker = b2.register_module('TOPUnpacker')
         topunpacker.param('addRelations', addTOPRelations)
-        path.add_module(topunpacker)
+        top_path.add_module(topunpacker)
         topconverter = b2.register_module('TOPRawDigitConverter')
         topconverter.param('addRelations', addTOPRelations)
-        path.add_module(topconverter)
+        top_path.add_module(topconverter)
 
     # ARICH
     if components is None or 'ARICH' in components:
         arichunpacker = b2.register_module('ARICHUnpacker')
-        path.add_module(arichunpacker)
+        detector_path().add_module(arichunpacker)
 
     # KLM
     if components is None or 'KLM' in components:
         klmunpacker = b2.register_module('KLMUnpacker')
         klmunpacker.param('WriteDigitRaws', writeKLMDigitRaws)
-        path.add_module(klmunpacker)
+        detector_path().add_module(klmunpacker)
+
+    if len(detector_paths) > 1:
+        path.add_concurrent_paths(detector_paths, threads=threads)
+    elif detector_paths:
+        path.add_path(detector_paths[0])
 
     # TRG
     if components is None or 'TRG' in components:
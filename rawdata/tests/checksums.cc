@@ -0,0 +1,82 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <rawdata/CRCCalculator.h>
+#include <rawdata/dataobjects/PostRawCOPPERFormat_latest.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace Belle2 {
+  /** Bitwise CRC16 with polynomial 0x1021, the bytes of each word from the most significant one */
+  unsigned short referenceCRC16(unsigned short crc16, const std::vector<int>& buf)
+  {
+    for (int word : buf) {
+      for (int shift = 24; shift >= 0; shift -= 8) {
+        crc16 ^= ((static_cast<unsigned int>(word) >> shift) & 0xff) << 8;
+        for (int bit = 0; bit < 8; bit++) {
+          crc16 = (crc16 & 0x8000) ? ((crc16 << 1) ^ 0x1021) : (crc16 << 1);
+        }
+      }
+    }
+    return crc16;
+  }
+
+  /** Plain XOR of all words */
+  unsigned int referenceXOR(const std::vector<int>& buf)
+  {
+    unsigned int checksum = 0;
+    for (int word : buf) checksum ^= word;
+    return checksum;
+  }
+
+  /** The table driven CRC16 agrees with the bitwise definition for all lengths and initial values */
+  TEST(RawDataChecksumTest, CRC16)
+  {
+    std::mt19937 generator(12345);
+    std::uniform_int_distribution<unsigned int> randomWord;
+    for (int nwords = 0; nwords < 70; nwords++) {
+      for (int trial = 0; trial < 20; trial++) {
+        std::vector<int> buf(nwords);
+        for (int& word : buf) word = randomWord(generator);
+        const unsigned short random = randomWord(generator);
+        for (unsigned short initial : {static_cast<unsigned short>(0xffff), static_cast<unsigned short>(0), random}) {
+          EXPECT_EQ(referenceCRC16(initial, buf), CalcCRC16LittleEndian(initial, buf.data(), nwords))
+              << "nwords " << nwords << " initial " << initial;
+        }
+      }
+    }
+    // a long buffer as in real events
+    std::vector<int> buf(100003);
+    for (int& word : buf) word = randomWord(generator);
+    EXPECT_EQ(referenceCRC16(0xffff, buf), CalcCRC16LittleEndian(0xffff, buf.data(), buf.size()));
+    // the CRC of a message followed by its CRC is zero
+    const unsigned short crc16 = CalcCRC16LittleEndian(0xffff, buf.data(), buf.size());
+    buf.push_back(static_cast<unsigned int>(crc16) << 16);
+    EXPECT_EQ(0, CalcCRC16LittleEndian(0xffff, buf.data(), buf.size()));
+    // negative lengths are rejected
+    EXPECT_THROW(CalcCRC16LittleEndian(0xffff, buf.data(), -1), std::string);
+  }
+
+  /** The unrolled XOR checksum agrees with the plain loop */
+  TEST(RawDataChecksumTest, XORChecksum)
+  {
+    PostRawCOPPERFormat_latest format;
+    std::mt19937 generator(54321);
+    std::uniform_int_distribution<unsigned int> randomWord;
+    for (int nwords = 0; nwords < 70; nwords++) {
+      for (int trial = 0; trial < 20; trial++) {
+        std::vector<int> buf(nwords);
+        for (int& word : buf) word = randomWord(generator);
+        EXPECT_EQ(referenceXOR(buf), format.CalcXORChecksum(buf.data(), nwords)) << "nwords " << nwords;
+      }
+    }
+  }
+}
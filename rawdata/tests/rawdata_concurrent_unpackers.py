@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""
+Check that running the unpackers concurrently with add_unpackers(threads=N)
+gives exactly the same DataStore content, including relations, as running
+them sequentially.
+"""
+
+import glob
+import os
+import sys
+
+import basf2
+from ROOT import Belle2, TBufferJSON
+from b2test_utils import require_file, run_in_subprocess, clean_working_directory
+from rawdata import add_unpackers
+
+
+class DumpDataStore(basf2.Module):
+    """Write all event objects, arrays and relations as JSON to a text file"""
+
+    def __init__(self, filename):
+        """remember the output file name"""
+        super().__init__()
+        #: output file
+        self.output = open(filename, "w")
+
+    def event(self):
+        """dump the content of the event"""
+        for name in sorted(Belle2.PyStoreObj.list()):
+            obj = Belle2.PyStoreObj(name)
+            if obj.isValid():
+                self.output.write(f"{name}: {TBufferJSON.ToJSON(obj.obj())}\n")
+        for name in sorted(Belle2.PyStoreArray.list()):
+            array = Belle2.PyStoreArray(name)
+            self.output.write(f"{name}: {array.getEntries()}\n")
+            for i, element in enumerate(array):
+                self.output.write(f"{name}[{i}]: {TBufferJSON.ToJSON(element)}\n")
+
+    def terminate(self):
+        """close the output file"""
+        self.output.close()
+
+
+def unpack(raw_files, threads, filename):
+    """unpack the given files with the given number of threads and dump the DataStore"""
+    basf2.set_log_level(basf2.LogLevel.ERROR)
+    basf2.conditions.disable_globaltag_replay()
+    main = basf2.Path()
+    main.add_module("RootInput", inputFileNames=raw_files)
+    main.add_module("Gearbox")
+    main.add_module("Geometry", useDB=True)
+    add_unpackers(main, addTOPRelations=True, threads=threads)
+    main.add_module(DumpDataStore(filename))
+    basf2.process(main, 20)
+
+
+if __name__ == "__main__":
+    rawdata_path = require_file(os.path.join('rawdata', 'phase3'), "validation")
+    raw_files = [Belle2.FileSystem.findFile(f) for f in sorted(glob.glob(os.path.join(rawdata_path, "mc*.root")))]
+    if not raw_files:
+        print("TEST SKIPPED: No input files for test", file=sys.stderr)
+        sys.exit(1)
+
+    with clean_working_directory():
+        dumps = {}
+        for threads in [1, 4]:
+            filename = f"unpacked_{threads}.txt"
+            assert run_in_subprocess(raw_files, threads, filename, target=unpack) == 0, f"unpacking with {threads} threads failed"
+            with open(filename) as dump:
+                dumps[threads] = dump.readlines()
+
+        assert len(dumps[1]) > 0
+        for line, (sequential, concurrent) in enumerate(zip(dumps[1], dumps[4])):
+            assert sequential == concurrent, f"line {line} differs:\n{sequential}\n{concurrent}"
+        assert len(dumps[1]) == len(dumps[4])
@@ -23,6 +23,7 @@
 #include <framework/dbobjects/HardwareClockSettings.h>
 
 #include <string>
+#include <vector>
 
 #include <Math/Vector3D.h>
 #include <root/TFile.h>
@@ -63,12 +64,15 @@ namespace Belle2 {
        */
       void driftCharge(const ROOT::Math::XYZVector& position, double carriers, SVD::SensorInfo::CarrierType carrierType);
 
-      /** Calculate the noise contribution to one strip with given charge.
-       * @param charge the original charge on the strip
-       * @param noise the standard RMS noise on the strip
-       * @return the new charge of the strip.
+      /** Sample the waveforms of one sensor side into m_sampleBuffer.
+       * The buffer is filled strip by strip (in the order of the map) with nSamples samples
+       * taken at firstTime, firstTime + m_samplingTime, ... The beta-prime contributions
+       * are collected in flat arrays and evaluated with w_betaprime_array.
+       * @param waveforms waveforms of the strips of the sensor side
+       * @param firstTime time of the first sample
+       * @param nSamples number of samples per strip
        */
-      double addNoise(double charge, double noise);
+      void sampleWaveforms(const StripWaveforms& waveforms, double firstTime, int nSamples);
 
       /** Save digits to the DataStore
        * Saves samples of generated waveforms.
@@ -186,6 +190,19 @@ namespace Belle2 {
       /** Structure containing waveforms in all existing sensors */
       Waveforms m_waveforms;
 
+      /** Noiseless samples of the strips of one sensor side, strip by strip */
+      std::vector<double> m_sampleBuffer;
+      /** Buffer row (strip) of the beta-prime contributions of one sensor side */
+      std::vector<unsigned> m_betaprimeRows;
+      /** Start times of the beta-prime contributions */
+      std::vector<double> m_betaprimeTimes;
+      /** Charges of the beta-prime contributions */
+      std::vector<double> m_betaprimeCharges;
+      /** Decay times of the beta-prime contributions */
+      std::vector<double> m_betaprimeTaus;
+      /** Scaled times and waveform values of the beta-prime contributions at one sample */
+      std::vector<double> m_betaprimeValues;
+
       /** Pointer to the SVDSimhit currently digitized */
       const SVDSimHit*   m_currentHit = nullptr;
       /** Index of the particle which caused the current hit */
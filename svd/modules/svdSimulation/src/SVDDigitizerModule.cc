@@ -681,10 +681,46 @@ void SVDDigitizerModule::driftCharge(const ROOT::Math::XYZVector& position, doub
   B2DEBUG(29, "Digitized " << recoveredCharge << " of " << carriers << " original carriers.");
 }
 
-double SVDDigitizerModule::addNoise(double charge, double noise)
+void SVDDigitizerModule::sampleWaveforms(const StripWaveforms& waveforms, double firstTime, int nSamples)
 {
-  charge += gRandom->Gaus(0., noise);
-  return charge;
+  m_sampleBuffer.assign(waveforms.size() * nSamples, 0.);
+  m_betaprimeRows.clear();
+  m_betaprimeTimes.clear();
+  m_betaprimeCharges.clear();
+  m_betaprimeTaus.clear();
+
+  // Collect the beta-prime contributions, the other shapes (adjacent-channel coupling)
+  // are evaluated here one by one.
+  unsigned row = 0;
+  for (const StripWaveforms::value_type& stripWaveform : waveforms) {
+    double* samples = &m_sampleBuffer[row * nSamples];
+    for (const SVDWaveform::ElementaryWaveform& wf : stripWaveform.second.getElementaryWaveforms()) {
+      const auto* shape = wf.m_wfun.target<double(*)(double)>();
+      if (shape and *shape == w_betaprime) {
+        m_betaprimeRows.push_back(row);
+        m_betaprimeTimes.push_back(wf.m_initTime);
+        m_betaprimeCharges.push_back(wf.m_charge);
+        m_betaprimeTaus.push_back(wf.m_tau);
+        continue;
+      }
+      for (int iSample = 0; iSample < nSamples; iSample++)
+        samples[iSample] += wf.m_charge * wf.m_wfun((firstTime + iSample * m_samplingTime - wf.m_initTime) / wf.m_tau);
+    }
+    row++;
+  }
+
+  // Evaluate the beta-prime contributions sample by sample over all strips
+  const std::size_t n = m_betaprimeRows.size();
+  m_betaprimeValues.resize(n);
+  double* values = m_betaprimeValues.data();
+  for (int iSample = 0; iSample < nSamples; iSample++) {
+    const double t = firstTime + iSample * m_samplingTime;
+    for (std::size_t k = 0; k < n; k++)
+      values[k] = (t - m_betaprimeTimes[k]) / m_betaprimeTaus[k];
+    w_betaprime_array(n, values, values);
+    for (std::size_t k = 0; k < n; k++)
+      m_sampleBuffer[m_betaprimeRows[k] * nSamples + iSample] += m_betaprimeCharges[k] * values[k];
+  }
 }
 
 void SVDDigitizerModule::saveDigits()
@@ -698,172 +734,77 @@ void SVDDigitizerModule::saveDigits()
   RelationArray relShaperDigitTrueHit(storeShaperDigits, storeTrueHits,
                                       m_relShaperDigitTrueHitName);
 
-  //Get SVD config from SVDEventInfo
-  //  int runType = (int) modeByte.getRunType();
-  //  int eventType = (int) modeByte.getEventType();
-
-
-  // ... to store digit-digit relations
-  vector<pair<unsigned int, float> > digit_weights;
+  // Only the samples that are read out are generated: in 3-sample events these are the
+  // three starting from m_startingSample, the remaining ones are set to zero.
+  const int firstSample = m_is3sampleEvent ? m_startingSample : 0;
+  const int nSamples = m_is3sampleEvent ? 3 : SVDShaperDigit::c_nAPVSamples;
+  const double firstTime = m_initTime + firstSample * m_samplingTime;
+  B2DEBUG(25, "start sampling at " << firstTime << ", number of samples " << nSamples);
 
   // Take samples at the desired times, add noise, zero-suppress and save digits.
   for (Waveforms::value_type& sensorWaveforms : m_waveforms) {
-    int sensorID = sensorWaveforms.first;
-    // u-side digits:
-
-    // Cycle through signals and generate samples
-    for (StripWaveforms::value_type& stripWaveform : sensorWaveforms.second.first) {
-      short int iStrip = stripWaveform.first;
-      SVDWaveform& s = stripWaveform.second;
-      // Now generate samples in time and save as digits.
-      vector<double> samples;
-      // ... to store digit-digit relations
-      digit_weights.clear();
-      digit_weights.reserve(SVDShaperDigit::c_nAPVSamples);
-
-      double elNoise = m_NoiseCal.getNoiseInElectrons(sensorID, true, iStrip);
-      double gain = 1 / m_PulseShapeCal.getChargeFromADC(sensorID, true, iStrip, 1);
-      double electronWeight = m_ChargeSimCal.getElectronWeight(sensorID, true);
-
-      double t = m_initTime;
-      B2DEBUG(25, "start sampling at " << m_initTime);
-      for (int iSample = 0; iSample < (int) SVDShaperDigit::c_nAPVSamples; iSample ++) {
-        samples.push_back(addNoise(electronWeight * s(t), elNoise));
-        t += m_samplingTime;
-      }
-
-      SVDWaveform::relations_map particles = s.getMCParticleRelations();
-      SVDWaveform::relations_map truehits = s.getTrueHitRelations();
-
-      // Save SVDShaperDigits
-
-      // 1. Convert to ADU
-      SVDShaperDigit::APVRawSamples rawSamples;
-      std::transform(samples.begin(), samples.end(), rawSamples.begin(),
-      [&](double x)->SVDShaperDigit::APVRawSampleType {
-        return SVDShaperDigit::trimToSampleRange(x * gain);
-      });
-
-      // 2.a Check if over threshold
-      auto rawThreshold = m_SNAdjacent * elNoise * gain;
-      if (m_roundZS) rawThreshold = round(rawThreshold);
-      auto n_over = std::count_if(rawSamples.begin(), rawSamples.end(),
-                                  std::bind(std::greater<double>(), _1, rawThreshold)
-                                 );
-      if (n_over < m_nSamplesOverZS) continue;
-
-      // 2.b check if the strip is masked
-      if (m_MaskedStr.isMasked(sensorID, true, iStrip)) continue;
-
-      // 2.c check if the APV is disabled
-      if (!m_map->isAPVinMap(sensorID, true, iStrip)) continue;
-
-      // 2.d.1 check if it's a 3-sample event
-      if (m_is3sampleEvent) {
-        rawSamples[0] = rawSamples[m_startingSample];
-        rawSamples[1] = rawSamples[m_startingSample + 1];
-        rawSamples[2] = rawSamples[m_startingSample + 2];
-        rawSamples[3] = 0.;
-        rawSamples[4] = 0.;
-        rawSamples[5] = 0.;
-        //2.d.2 check if still over threshold
-        n_over = std::count_if(rawSamples.begin(), rawSamples.end(),
-                               std::bind(std::greater<double>(), _1, rawThreshold)
-                              );
-        if (n_over < m_nSamplesOverZS) continue;
-
-      }
-
-      // 3. Save as a new digit
-      int digIndex = storeShaperDigits.getEntries();
-      storeShaperDigits.appendNew(sensorID, true, iStrip, rawSamples, 0);
-
-      //If the digit has any relations to MCParticles, add the Relation
-      if (particles.size() > 0) {
-        relShaperDigitMCParticle.add(digIndex, particles.begin(), particles.end());
-      }
-      //If the digit has any relations to truehits, add the Relations.
-      if (truehits.size() > 0) {
-        relShaperDigitTrueHit.add(digIndex, truehits.begin(), truehits.end());
-      }
-      // generate SVDShaperDigits
-    } // for stripSignals
-
-    // v-side digits:
-
-    // Cycle through signals and generate samples
-    for (StripWaveforms::value_type& stripWaveform : sensorWaveforms.second.second) {
-      short int iStrip = stripWaveform.first;
-      SVDWaveform& s = stripWaveform.second;
-      // Now generate samples in time and save as digits.
-      vector<double> samples;
-      // ... to store digit-digit relations
-      digit_weights.clear();
-      digit_weights.reserve(SVDShaperDigit::c_nAPVSamples);
-
-      double elNoise = m_NoiseCal.getNoiseInElectrons(sensorID, false, iStrip);
-      double gain = 1 / m_PulseShapeCal.getChargeFromADC(sensorID, false, iStrip, 1);
-      double electronWeight = m_ChargeSimCal.getElectronWeight(sensorID, false);
-
-      double t = m_initTime;
-      for (int iSample = 0; iSample < (int)SVDShaperDigit::c_nAPVSamples; iSample ++) {
-        samples.push_back(addNoise(electronWeight * s(t), elNoise));
-        t += m_samplingTime;
-      }
-
-      SVDWaveform::relations_map particles = s.getMCParticleRelations();
-      SVDWaveform::relations_map truehits = s.getTrueHitRelations();
-
-      // Save SVDShaperDigits
-      // 1. Convert to ADU
-      SVDShaperDigit::APVRawSamples rawSamples;
-      std::transform(samples.begin(), samples.end(), rawSamples.begin(),
-      [&](double x)->SVDShaperDigit::APVRawSampleType {
-        return SVDShaperDigit::trimToSampleRange(x * gain);
-      });
-
-      // 2.a Check if over threshold
-      auto rawThreshold = m_SNAdjacent * elNoise * gain;
-      if (m_roundZS) rawThreshold = round(rawThreshold);
-      auto n_over = std::count_if(rawSamples.begin(), rawSamples.end(),
-                                  std::bind(std::greater<double>(), _1, rawThreshold)
-                                 );
-      if (n_over < m_nSamplesOverZS) continue;
-
-      // 2.b check if the strip is masked
-      if (m_MaskedStr.isMasked(sensorID, false, iStrip)) continue;
-
-      // 2.c check if the APV is disabled
-      if (!m_map->isAPVinMap(sensorID, false, iStrip)) continue;
-
-      // 2.d.1 check if it's a 3-sample event
-      if (m_is3sampleEvent) {
-        rawSamples[0] = rawSamples[m_startingSample];
-        rawSamples[1] = rawSamples[m_startingSample + 1];
-        rawSamples[2] = rawSamples[m_startingSample + 2];
-        rawSamples[3] = 0.;
-        rawSamples[4] = 0.;
-        rawSamples[5] = 0.;
-        //2.d.2 check if still over threshold
-        n_over = std::count_if(rawSamples.begin(), rawSamples.end(),
-                               std::bind(std::greater<double>(), _1, rawThreshold)
-                              );
+    VxdID sensorID = sensorWaveforms.first;
+    for (bool isU : {true, false}) {
+      const StripWaveforms& stripWaveforms = isU ? sensorWaveforms.second.first : sensorWaveforms.second.second;
+      sampleWaveforms(stripWaveforms, firstTime, nSamples);
+      double electronWeight = m_ChargeSimCal.getElectronWeight(sensorID, isU);
+
+      unsigned row = 0;
+      for (const StripWaveforms::value_type& stripWaveform : stripWaveforms) {
+        short int iStrip = stripWaveform.first;
+        const SVDWaveform& s = stripWaveform.second;
+        double* samples = &m_sampleBuffer[row * nSamples];
+        row++;
+
+        // 1. check if the strip is masked or the APV is disabled
+        if (m_MaskedStr.isMasked(sensorID, isU, iStrip)) continue;
+        if (!m_map->isAPVinMap(sensorID, isU, iStrip)) continue;
+
+        // 2. Add noise; the noise is generated only for strips that can pass the zero suppression
+        double elNoise = m_NoiseCal.getNoiseInElectrons(sensorID, isU, iStrip);
+        double gain = 1 / m_PulseShapeCal.getChargeFromADC(sensorID, isU, iStrip, 1);
+        auto rawThreshold = m_SNAdjacent * elNoise * gain;
+        if (m_roundZS) rawThreshold = round(rawThreshold);
+
+        for (int iSample = 0; iSample < nSamples; iSample++) samples[iSample] *= electronWeight;
+        if (m_nSamplesOverZS > 0 and rawThreshold >= 0 and gain > 0 and elNoise > 0) {
+          // raw samples are truncated, so a sample is over threshold if it reaches the next ADU
+          double cut = (floor(rawThreshold) + 1) / gain;
+          if (!addNoiseOverCut(samples, nSamples, elNoise, cut, *gRandom)) continue;
+        } else {
+          for (int iSample = 0; iSample < nSamples; iSample++) samples[iSample] += gRandom->Gaus(0., elNoise);
+        }
+
+        // 3. Convert to ADU
+        SVDShaperDigit::APVRawSamples rawSamples;
+        rawSamples.fill(0);
+        std::transform(samples, samples + nSamples, rawSamples.begin(),
+        [&](double x)->SVDShaperDigit::APVRawSampleType {
+          return SVDShaperDigit::trimToSampleRange(x * gain);
+        });
+
+        // 4. Check if over threshold
+        auto n_over = std::count_if(rawSamples.begin(), rawSamples.end(),
+                                    std::bind(std::greater<double>(), _1, rawThreshold)
+                                   );
         if (n_over < m_nSamplesOverZS) continue;
-      }
-
-      // 3. Save as a new digit
-      int digIndex = storeShaperDigits.getEntries();
-      storeShaperDigits.appendNew(sensorID, false, iStrip, rawSamples, 0);
 
-      //If the digit has any relations to MCParticles, add the Relation
-      if (particles.size() > 0) {
-        relShaperDigitMCParticle.add(digIndex, particles.begin(), particles.end());
-      }
-      //If the digit has any relations to truehits, add the Relations.
-      if (truehits.size() > 0) {
-        relShaperDigitTrueHit.add(digIndex, truehits.begin(), truehits.end());
-      }
-    } // for stripSignals
+        // 5. Save as a new digit
+        int digIndex = storeShaperDigits.getEntries();
+        storeShaperDigits.appendNew(sensorID, isU, iStrip, rawSamples, 0);
+
+        //If the digit has any relations to MCParticles, add the Relation
+        const SVDWaveform::relations_map& particles = s.getMCParticleRelations();
+        if (particles.size() > 0) {
+          relShaperDigitMCParticle.add(digIndex, particles.begin(), particles.end());
+        }
+        //If the digit has any relations to truehits, add the Relations.
+        const SVDWaveform::relations_map& truehits = s.getTrueHitRelations();
+        if (truehits.size() > 0) {
+          relShaperDigitTrueHit.add(digIndex, truehits.begin(), truehits.end());
+        }
+      } // for stripWaveforms
+    } // for sides
   } // FOREACH sensor
 }
 
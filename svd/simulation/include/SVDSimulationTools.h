@@ -16,6 +16,8 @@
 #include <functional>
 #include <sstream>
 #include <framework/gearbox/Unit.h>
+#include <TMath.h>
+#include <TRandom.h>
 
 namespace Belle2 {
   namespace SVD {
@@ -83,8 +85,30 @@ namespace Belle2 {
     {
       if (t < 0.0)
         return 0.0;
-      else
-        return 149.012 * pow(t, 2) * pow(1.0 + t, -10);
+      else {
+        double u = 1.0 / (1.0 + t);
+        double u2 = u * u;
+        double u8 = u2 * u2 * u2 * u2;
+        return 149.012 * t * t * u8 * u2;
+      }
+    }
+
+    /** Beta-prime waveform shape evaluated on an array of times.
+     * Gives the same values as w_betaprime, but the loop has no branches
+     * and no library calls, so that the compiler can vectorize it.
+     * @param n Number of times.
+     * @param t Array of n properly scaled times, (t - t0)/tau.
+     * @param w Array of n waveform values (output, may be the same as t).
+     */
+    inline void w_betaprime_array(std::size_t n, const double* t, double* w)
+    {
+      for (std::size_t i = 0; i < n; ++i) {
+        double x = std::max(t[i], 0.0);
+        double u = 1.0 / (1.0 + x);
+        double u2 = u * u;
+        double u8 = u2 * u2 * u2 * u2;
+        w[i] = 149.012 * x * x * u8 * u2;
+      }
     }
 
     /** Adjacent-channel waveform U-side.
@@ -191,6 +215,53 @@ namespace Belle2 {
       return (search_n(a.begin(), a.end(), 3, thr, std::greater<double>()) != a.end());
     }
 
+// ==============================================================================
+// Noise for the zero suppression
+// ------------------------------------------------------------------------------
+
+    /** Add gaussian noise to the samples of one strip, provided it can pass the zero suppression.
+     * First it is decided whether at least one sample exceeds the cut after adding noise;
+     * if none does, no noise is generated and false is returned. Otherwise the noise is
+     * drawn sample by sample from the distribution conditional on this decision, so that
+     * the noisy samples are distributed exactly as if the noise were added unconditionally.
+     * @param samples the noiseless samples in electrons (noise is added in place)
+     * @param nSamples number of samples, at most nAPVSamples
+     * @param noise the RMS noise of the strip
+     * @param cut the smallest sample value in electrons that passes the zero suppression
+     * @param random random number generator
+     * @return true if at least one sample exceeds the cut
+     */
+    inline bool addNoiseOverCut(double* samples, int nSamples, double noise, double cut, TRandom& random)
+    {
+      // probabilities of each sample to exceed the cut (above) and of at least
+      // one of the samples i, ..., nSamples - 1 to exceed it (any)
+      double above[nAPVSamples];
+      double any[nAPVSamples + 1];
+      any[nSamples] = 0;
+      for (int i = nSamples - 1; i >= 0; i--) {
+        above[i] = 0.5 * std::erfc((cut - samples[i]) / noise * M_SQRT1_2);
+        any[i] = any[i + 1] + above[i] * (1 - any[i + 1]);
+      }
+      if (random.Rndm() >= any[0]) return false;
+
+      // Draw the samples one by one under the condition that one of the remaining samples
+      // exceeds the cut, until one does; the rest of them are then unconstrained.
+      // The truncated gaussians are drawn by inverting their cumulative distributions.
+      int i = 0;
+      for (; i < nSamples; i++) {
+        if (random.Rndm() * any[i] < above[i]) {
+          samples[i] -= noise * TMath::NormQuantile(above[i] * random.Rndm());
+          i++;
+          break;
+        }
+        double below = 0.5 * std::erfc((samples[i] - cut) / noise * M_SQRT1_2);
+        samples[i] += noise * TMath::NormQuantile(below * random.Rndm());
+      }
+      for (; i < nSamples; i++) samples[i] += random.Gaus(0., noise);
+
+      return true;
+    }
+
 // ==============================================================================
 // Tau (scale) conversion and encoding
 // ------------------------------------------------------------------------------
@@ -153,7 +153,7 @@ namespace Belle2 {
       double operator()(double t) const
       {
         double total_waveform = 0;
-        for (SVDWaveform::ElementaryWaveform elementary_waveform : m_elementaryWaveforms) {
+        for (const SVDWaveform::ElementaryWaveform& elementary_waveform : m_elementaryWaveforms) {
           total_waveform += waveform(t, elementary_waveform);
         }
         return total_waveform;
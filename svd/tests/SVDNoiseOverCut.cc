@@ -0,0 +1,175 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <svd/simulation/SVDSimulationTools.h>
+#include <TRandom3.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace Belle2 {
+  namespace SVD {
+
+    /** Compare addNoiseOverCut with gaussian noise added to all samples followed by the cut */
+    class SVDNoiseOverCutTest : public ::testing::Test {
+    protected:
+      /** Number of bins of the sample histograms, the last two are under- and overflow */
+      static const int c_nBins = 22;
+
+      /** Distributions of the strips that pass the cut */
+      struct Summary {
+        int nTrials = 0; /**< number of strips */
+        int nPassed = 0; /**< number of strips with at least one sample over the cut */
+        std::vector<double> firstOver; /**< index of the first sample over the cut */
+        std::vector<std::vector<double>> samples; /**< histograms of the noise of each sample */
+      };
+
+      /** Noise of 1, cut at 3.5 noise units (3 sigma + rounding to the next ADU) */
+      const double m_noise = 1;
+      /** the cut */
+      const double m_cut = 3.5;
+
+      /**
+       * Generate the strips
+       * @param noiseless noiseless samples
+       * @param nTrials number of strips
+       * @param conditional use addNoiseOverCut if true, plain gaussian noise otherwise
+       * @return distributions of the strips passing the cut
+       */
+      Summary generate(const std::vector<double>& noiseless, int nTrials, bool conditional) const
+      {
+        const int nSamples = noiseless.size();
+        Summary summary;
+        summary.nTrials = nTrials;
+        summary.firstOver.assign(nSamples, 0);
+        summary.samples.assign(nSamples, std::vector<double>(c_nBins, 0));
+        TRandom3 random(conditional ? 4900 : 4901);
+        double samples[nAPVSamples];
+        for (int n = 0; n < nTrials; n++) {
+          std::copy(noiseless.begin(), noiseless.end(), samples);
+          if (conditional) {
+            if (not addNoiseOverCut(samples, nSamples, m_noise, m_cut, random)) continue;
+          } else {
+            for (int i = 0; i < nSamples; i++) samples[i] += random.Gaus(0., m_noise);
+            if (std::none_of(samples, samples + nSamples, [this](double x) {return x >= m_cut;})) continue;
+          }
+          summary.nPassed++;
+          summary.firstOver[std::find_if(samples, samples + nSamples, [this](double x) {return x >= m_cut;}) - samples]++;
+          for (int i = 0; i < nSamples; i++) {
+            double x = (samples[i] - noiseless[i]) / m_noise;
+            int bin = x < -5 ? c_nBins - 2 : (x >= 5 ? c_nBins - 1 : int((x + 5) * 2));
+            summary.samples[i][bin]++;
+          }
+        }
+        return summary;
+      }
+
+      /**
+       * Chi2 of two histograms with different numbers of entries
+       * @param a first histogram
+       * @param b second histogram
+       * @param ndf number of degrees of freedom (non-empty bins - 1)
+       * @return chi2
+       */
+      static double chi2(const std::vector<double>& a, const std::vector<double>& b, int& ndf)
+      {
+        double na = 0, nb = 0;
+        for (unsigned k = 0; k < a.size(); k++) {
+          na += a[k];
+          nb += b[k];
+        }
+        double chi2 = 0;
+        ndf = -1;
+        for (unsigned k = 0; k < a.size(); k++) {
+          if (a[k] + b[k] == 0) continue;
+          chi2 += pow(a[k] / na - b[k] / nb, 2) / (a[k] / na / na + b[k] / nb / nb);
+          ndf++;
+        }
+        return chi2;
+      }
+
+      /**
+       * Compare the pass rates and the distributions of the passing strips
+       * @param noiseless noiseless samples
+       * @param nTrials number of strips
+       */
+      void compare(const std::vector<double>& noiseless, int nTrials) const
+      {
+        Summary reference = generate(noiseless, nTrials, false);
+        Summary conditional = generate(noiseless, nTrials, true);
+        ASSERT_GT(reference.nPassed, 100);
+
+        double p1 = double(reference.nPassed) / nTrials;
+        double p2 = double(conditional.nPassed) / nTrials;
+        double sigma = sqrt((p1 * (1 - p1) + p2 * (1 - p2)) / nTrials);
+        EXPECT_NEAR(p1, p2, 5 * sigma + 1. / nTrials);
+
+        // 5 sigma upper limit of the chi2 distribution
+        auto maxChi2 = [](int ndf) {return ndf + 5 * sqrt(2. * ndf);};
+        int ndf = 0;
+        double x = chi2(reference.firstOver, conditional.firstOver, ndf);
+        if (ndf > 0) EXPECT_LT(x, maxChi2(ndf)) << "first sample over the cut";
+        for (unsigned i = 0; i < noiseless.size(); i++) {
+          x = chi2(reference.samples[i], conditional.samples[i], ndf);
+          EXPECT_LT(x, maxChi2(ndf)) << "sample " << i << ", ndf " << ndf;
+        }
+      }
+    };
+
+    /** Background strips: the noise alone passes the cut */
+    TEST_F(SVDNoiseOverCutTest, Background)
+    {
+      compare({0, 0, 0, 0, 0, 0}, 2000000);
+      compare({0, 0, 0}, 2000000);
+    }
+
+    /** Signals below, around and well above the cut */
+    TEST_F(SVDNoiseOverCutTest, Signal)
+    {
+      compare({0, 1.5, 3, 2.5, 1.5, 0.5}, 200000);
+      compare({2, 3.5, 4, 3, 2, 1}, 200000);
+      compare({0, 5, 10, 8, 5, 3}, 200000);
+      compare({-1, 2, 3}, 200000);
+    }
+
+    /** Time per background strip of both methods */
+    TEST_F(SVDNoiseOverCutTest, DISABLED_Timing)
+    {
+      const int nTrials = 10000000;
+      const int nSamples = 6;
+      TRandom3 random(4902);
+      double samples[nAPVSamples];
+      int nPassed[2] = {0, 0};
+      double nanoseconds[2] = {0, 0};
+      for (int method = 0; method < 2; method++) {
+        auto start = std::chrono::steady_clock::now();
+        for (int n = 0; n < nTrials; n++) {
+          std::fill(samples, samples + nSamples, 0.);
+          if (method == 1) {
+            if (not addNoiseOverCut(samples, nSamples, m_noise, m_cut, random)) continue;
+          } else {
+            for (int i = 0; i < nSamples; i++) samples[i] += random.Gaus(0., m_noise);
+            if (std::none_of(samples, samples + nSamples, [this](double x) {return x >= m_cut;})) continue;
+          }
+          nPassed[method]++;
+        }
+        auto stop = std::chrono::steady_clock::now();
+        nanoseconds[method] = std::chrono::duration<double, std::nano>(stop - start).count() / nTrials;
+      }
+      std::cout << "gaussian noise and cut: " << nanoseconds[0] << " ns/strip, pass rate " << double(nPassed[0]) / nTrials
+                << std::endl;
+      std::cout << "addNoiseOverCut:        " << nanoseconds[1] << " ns/strip, pass rate " << double(nPassed[1]) / nTrials
+                << std::endl;
+    }
+
+  }
+}
@@ -171,5 +171,21 @@ namespace Belle2 {
       EXPECT_EQ(waveform.toString(), os.str());
     }
 
+    /** Check that the array version of the beta-prime shape agrees with the scalar one. */
+    TEST(SVDWaveform, BetaprimeArray)
+    {
+      vector<double> times;
+      for (int i = -20; i < 200; ++i) times.push_back(0.05 * i);
+      vector<double> values(times.size());
+      w_betaprime_array(times.size(), times.data(), values.data());
+      for (size_t i = 0; i < times.size(); ++i)
+        EXPECT_DOUBLE_EQ(values[i], w_betaprime(times[i]));
+      // the maximum is 1 at t = 2/8
+      EXPECT_NEAR(w_betaprime(0.25), 1.0, 1.0e-4);
+      // in place evaluation
+      w_betaprime_array(times.size(), times.data(), times.data());
+      EXPECT_EQ(times, values);
+    }
+
   } // namespace SVD
 }  // namespace Belle2
@@ -27,6 +27,7 @@
 #include <top/dbobjects/TOPCalFillPatternOffset.h>
 
 #include <top/reconstruction_cpp/PDFConstructor.h>
+#include <top/reconstruction_cpp/SignalPDFCache.h>
 #include <top/utilities/Chi2MinimumFinder1D.h>
 #include <framework/gearbox/Const.h>
 
@@ -135,6 +136,9 @@ namespace Belle2 {
     unsigned m_nTrackLimit; /**< maximum number of tracks (inclusive) to use three particle hypotheses in fine search */
     bool m_useTimeSeed; /**< use CDC or SVD event T0 as seed */
     bool m_useFillPattern; /**< use know fill pattern to enhance efficiency */
+    unsigned m_PDFCacheSize = 0; /**< maximal number of signal PDF's in the cache (0 = no cache) */
+    std::vector<double> m_PDFCacheSteps; /**< quantization steps of signal PDF cache */
+    TOP::SignalPDFCache m_PDFCache; /**< cache of signal PDF's of this module */
 
     // internal variables shared between events
     double m_bunchTimeSep = 0; /**< time between two bunches */
@@ -101,6 +101,13 @@ namespace Belle2 {
              "(only when running in data processing mode and autoRange turned off).", true);
     addParam("useFillPattern", m_useFillPattern, "use known accelerator fill pattern to enhance efficiency "
              "(only when running in data processing mode).", true);
+    addParam("PDFCacheSize", m_PDFCacheSize,
+             "maximal number of signal PDF's kept in the cache of this module "
+             "and reused for tracks with similar parameters (0 = cache switched off)", unsigned(0));
+    addParam("PDFCacheSteps", m_PDFCacheSteps,
+             "quantization steps of PDF cache: emission position [cm], track angles [rad], momentum [GeV/c] "
+             "and time window edges relative to time-of-flight [ns]",
+             std::vector<double>({0.1, 0.002, 0.01, 0.01}));
   }
 
 
@@ -192,6 +199,11 @@ namespace Belle2 {
       B2INFO("TOPBunchFinder: running in data processing mode");
     }
 
+    if (m_PDFCacheSize > 0) {
+      if (m_PDFCacheSteps.size() != 4) B2FATAL("TOPBunchFinder: parameter PDFCacheSteps must have four elements");
+      m_PDFCache.set(m_PDFCacheSize, m_PDFCacheSteps[0], m_PDFCacheSteps[1], m_PDFCacheSteps[2], m_PDFCacheSteps[3]);
+    }
+
   }
 
 
@@ -199,6 +211,8 @@ namespace Belle2 {
   {
     StoreObjPtr<EventMetaData> evtMetaData;
 
+    m_PDFCache.clear(); // calibration constants may have changed
+
     if (not m_commonT0.isValid()) {
       B2FATAL("Common T0 calibration payload requested but not available for run "
               << evtMetaData->getRun()
@@ -312,7 +326,7 @@ namespace Belle2 {
       }
 
       // construct PDF
-      PDFConstructor pdfConstructor(trk, chargedStable, PDFConstructor::c_Rough);
+      PDFConstructor pdfConstructor(trk, chargedStable, PDFConstructor::c_Rough, PDFConstructor::c_Reduced, 0, &m_PDFCache);
       if (not pdfConstructor.isValid()) continue;
       numTrk++;
 
@@ -419,7 +433,7 @@ namespace Belle2 {
           if (momentum < 4.0) other.push_back(Const::proton);
         }
         for (const auto& chargedStable : other) {
-          PDFConstructor pdfConstructor(trk, chargedStable, PDFConstructor::c_Rough);
+          PDFConstructor pdfConstructor(trk, chargedStable, PDFConstructor::c_Rough, PDFConstructor::c_Reduced, 0, &m_PDFCache);
           if (not pdfConstructor.isValid()) continue;
           pdfConstructor.switchOffDeltaRayPDF(); // to speed-up fine search
           if (pdfConstructor.getExpectedSignalPhotons() < m_minSignal) continue;
@@ -554,6 +568,10 @@ namespace Belle2 {
   {
     B2RESULT("TOPBunchFinder: event T0 determined for " << m_success << "/"
              << m_processed << " events");
+    if (m_PDFCache.isEnabled()) {
+      B2RESULT("TOPBunchFinder: signal PDF cache hits " << m_PDFCache.getHits() << "/"
+               << m_PDFCache.getHits() + m_PDFCache.getMisses());
+    }
   }
 
 
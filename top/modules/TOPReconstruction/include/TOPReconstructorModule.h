@@ -19,6 +19,7 @@
 #include <top/dataobjects/TOPLikelihood.h>
 #include <top/dataobjects/TOPPull.h>
 #include <top/reconstruction_cpp/PDFConstructor.h>
+#include <top/reconstruction_cpp/SignalPDFCache.h>
 #include <top/reconstruction_cpp/TOPTrack.h>
 #include <framework/gearbox/Const.h>
 #include <vector>
@@ -52,11 +53,21 @@ namespace Belle2 {
      */
     virtual void initialize() override;
 
+    /**
+     * Called when entering a new run.
+     */
+    virtual void beginRun() override;
+
     /**
      * Event processor.
      */
     virtual void event() override;
 
+    /**
+     * Termination action.
+     */
+    virtual void terminate() override;
+
   private:
 
     /**
@@ -73,12 +84,14 @@ namespace Belle2 {
        * Constructor
        * @param trk given track
        * @param deltaRayModeling include or exclude delta-ray modeling in log likelihood calculation
+       * @param cache cache of signal PDF's
        */
-      PDFCollection(const TOP::TOPTrack& trk, bool deltaRayModeling)
+      PDFCollection(const TOP::TOPTrack& trk, bool deltaRayModeling, TOP::SignalPDFCache* cache)
       {
         topTrack = &trk;
         for (const auto& chargedStable : Const::chargedStableSet) {
-          auto* pdf = new TOP::PDFConstructor(trk, chargedStable);
+          auto* pdf = new TOP::PDFConstructor(trk, chargedStable, TOP::PDFConstructor::c_Optimal,
+                                              TOP::PDFConstructor::c_Reduced, 0, cache);
           if (not pdf->isValid()) {
             delete pdf;
             for (auto PDF : PDFs) delete PDF;
@@ -148,6 +161,9 @@ namespace Belle2 {
     std::string m_topDigitCollectionName; /**< name of the collection of TOPDigits */
     std::string m_topLikelihoodCollectionName; /**< name of the collection of created TOPLikelihoods */
     std::string m_topPullCollectionName; /**< name of the collection of created TOPPulls */
+    unsigned m_PDFCacheSize = 0; /**< maximal number of signal PDF's in the cache (0 = no cache) */
+    std::vector<double> m_PDFCacheSteps; /**< quantization steps of signal PDF cache */
+    TOP::SignalPDFCache m_PDFCache; /**< cache of signal PDF's of this module */
 
     // datastore objects
 
@@ -59,6 +59,13 @@ namespace Belle2 {
     addParam("TOPLikelihoodCollectionName", m_topLikelihoodCollectionName,
              "Name of the produced collection of TOPLikelihoods", string(""));
     addParam("TOPPullCollectionName", m_topPullCollectionName, "Name of the collection of produced TOPPulls", string(""));
+    addParam("PDFCacheSize", m_PDFCacheSize,
+             "maximal number of signal PDF's kept in the cache of this module "
+             "and reused for tracks with similar parameters (0 = cache switched off)", unsigned(0));
+    addParam("PDFCacheSteps", m_PDFCacheSteps,
+             "quantization steps of PDF cache: emission position [cm], track angles [rad], momentum [GeV/c] "
+             "and time window edges relative to time-of-flight [ns]",
+             std::vector<double>({0.1, 0.002, 0.01, 0.01}));
   }
 
 
@@ -81,6 +88,20 @@ namespace Belle2 {
 
     m_topPulls.registerInDataStore(m_topPullCollectionName, DataStore::c_DontWriteOut);
     m_tracks.registerRelationTo(m_topPulls, DataStore::c_Event, DataStore::c_DontWriteOut);
+
+    // signal PDF cache
+
+    if (m_PDFCacheSize > 0) {
+      if (m_PDFCacheSteps.size() != 4) B2FATAL("TOPReconstructor: parameter PDFCacheSteps must have four elements");
+      m_PDFCache.set(m_PDFCacheSize, m_PDFCacheSteps[0], m_PDFCacheSteps[1], m_PDFCacheSteps[2], m_PDFCacheSteps[3]);
+    }
+  }
+
+
+  void TOPReconstructorModule::beginRun()
+  {
+    // calibration constants may have changed
+    m_PDFCache.clear();
   }
 
 
@@ -126,7 +147,7 @@ namespace Belle2 {
       const auto& range = topTracks.equal_range(moduleID);
       for (auto it = range.first; it != range.second; ++it) {
         const auto* trk = it->second;
-        PDFCollection collection(*trk, m_deltaRayModeling);
+        PDFCollection collection(*trk, m_deltaRayModeling, &m_PDFCache);
         if (collection.isValid) pdfCollections.push_back(collection);
       }
       if (pdfCollections.empty()) continue;
@@ -201,5 +222,14 @@ namespace Belle2 {
 
   }
 
+
+  void TOPReconstructorModule::terminate()
+  {
+    if (m_PDFCache.isEnabled()) {
+      B2RESULT("TOPReconstructor: signal PDF cache hits " << m_PDFCache.getHits() << "/"
+               << m_PDFCache.getHits() + m_PDFCache.getMisses());
+    }
+  }
+
 } // end Belle2 namespace
 
@@ -15,11 +15,14 @@
 #include <top/reconstruction_cpp/SignalPDF.h>
 #include <top/reconstruction_cpp/BackgroundPDF.h>
 #include <top/reconstruction_cpp/DeltaRayPDF.h>
+#include <top/reconstruction_cpp/SignalPDFCache.h>
 #include <top/geometry/TOPGeometryPar.h>
 #include <vector>
 #include <map>
 #include <set>
 #include <limits>
+#include <algorithm>
+#include <utility>
 
 namespace Belle2 {
   namespace TOP {
@@ -99,9 +102,11 @@ namespace Belle2 {
        * @param PDFOption signal PDF construction option
        * @param storeOption signal PDF store option
        * @param overrideMass alternative mass value to be used intestead of the one from hypothesis. Ignored if <= 0.
+       * @param cache optional cache of signal PDF's, used only if enabled, with c_Reduced and without overrideMass
        */
       PDFConstructor(const TOPTrack& track, const Const::ChargedStable& hypothesis,
-                     EPDFOption PDFOption = c_Optimal, EStoreOption storeOption = c_Reduced, double overrideMass = 0);
+                     EPDFOption PDFOption = c_Optimal, EStoreOption storeOption = c_Reduced, double overrideMass = 0,
+                     SignalPDFCache* cache = 0);
 
       /**
        * Checks the object status
@@ -362,9 +367,9 @@ namespace Belle2 {
       /**
        * Returns a collection of derivatives for debugging purposes.
        * The derivatives are available only for EStoreOption::c_Full
-       * @return map of xD and derivatives
+       * @return pairs of xD and derivatives, sorted by xD
        */
-      const std::map <double, YScanner::Derivatives>& getDerivatives() const {return m_derivatives;}
+      const std::vector<std::pair<double, YScanner::Derivatives>>& getDerivatives() const {return m_derivatives;}
 
       /**
        * Append most probable PDF of other track in this module
@@ -463,13 +468,20 @@ namespace Belle2 {
        * @param dE energy difference to mean photon energy
        * @return cosine and sine of cerenkov angle
        */
-      const InverseRaytracer::CerenkovAngle& cerenkovAngle(double dE = 0);
+      InverseRaytracer::CerenkovAngle cerenkovAngle(double dE = 0);
 
       /**
        * Sets signal PDF
        */
       void setSignalPDF();
 
+      /**
+       * Sets signal PDF from the cache if a usable entry for this track and hypothesis exists,
+       * otherwise constructs it and stores it in the cache
+       * @param cache cache of signal PDF's
+       */
+      void setSignalPDFCached(SignalPDFCache& cache);
+
       /**
        * Sets signal PDF for direct photons
        */
@@ -693,7 +705,7 @@ namespace Belle2 {
       double m_bkgPhotons = 0; /**< expected number of uniform background photons */
       double m_deltaPhotons = 0; /**< expected number of delta-ray photons */
 
-      std::map<double, InverseRaytracer::CerenkovAngle> m_cerenkovAngles; /**< sine and cosine of Cerenkov angles */
+      std::vector<std::pair<double, InverseRaytracer::CerenkovAngle>> m_cerenkovAngles; /**< sine and cosine of Cerenkov angles, sorted by dE */
       double m_dFic = 0; /**< temporary storage for dFic used in last call to deltaXD */
       double m_Fic = 0;  /**< temporary storage for Cerenkov azimuthal angle */
       mutable std::map <SignalPDF::EPeakType, int> m_ncallsSetPDF; /**< number of calls to setSignalPDF<T> */
@@ -701,8 +713,9 @@ namespace Belle2 {
       mutable std::vector<LogL> m_pixelLLs; /**< pixel log likelihoods (index = pixelID - 1) */
       mutable std::vector<Pull> m_pulls; /**< photon pulls w.r.t PDF peaks */
       mutable bool m_deltaPDFOn = true; /**< include/exclude delta-ray PDF in likelihood calculation */
-      std::map <double, YScanner::Derivatives> m_derivatives; /**< a map of xD and derivatives */
+      std::vector<std::pair<double, YScanner::Derivatives>> m_derivatives; /**< pairs of xD and derivatives, sorted by xD */
       mutable std::set<int> m_zeroPixels; /**< collection of pixelID's with zero pdfValue */
+      std::vector<SignalPDFCache::ScanDecision>* m_scanDecisions = 0; /**< if set, decisions of c_Optimal are recorded here */
 
       std::vector<const PDFConstructor*> m_pdfOtherTracks; /**< most probable PDF's of other tracks in the module */
       mutable double m_f0 = 0; /**< temporary value of signal PDF */
@@ -755,15 +768,17 @@ namespace Belle2 {
       return std::min(1 / m_beta / refind, 1.0);
     }
 
-    inline const InverseRaytracer::CerenkovAngle& PDFConstructor::cerenkovAngle(double dE)
+    inline InverseRaytracer::CerenkovAngle PDFConstructor::cerenkovAngle(double dE)
     {
-      auto& cer = m_cerenkovAngles[dE];
-      if (cer.cosThc == 0 and cer.sinThc == 0) {
+      // only a few different dE are used, a sorted vector is faster than a map
+      auto it = std::lower_bound(m_cerenkovAngles.begin(), m_cerenkovAngles.end(), dE,
+      [](const auto& element, double value) {return element.first < value;});
+      if (it == m_cerenkovAngles.end() or it->first != dE) {
         double meanE = m_yScanner->getMeanEnergy();
         double cosThc = getCosCerenkovAngle(meanE + dE);
-        cer = InverseRaytracer::CerenkovAngle(cosThc);
+        it = m_cerenkovAngles.insert(it, std::make_pair(dE, InverseRaytracer::CerenkovAngle(cosThc)));
       }
-      return cer;
+      return it->second;
     }
 
 
@@ -845,7 +860,12 @@ namespace Belle2 {
                   << LogVar("peak type", t.type));
           continue;
         }
-        if (m_storeOption == c_Full) m_derivatives[xD] = D;
+        if (m_storeOption == c_Full) {
+          auto it = std::lower_bound(m_derivatives.begin(), m_derivatives.end(), xD,
+          [](const auto& element, double value) {return element.first < value;});
+          if (it != m_derivatives.end() and it->first == xD) it->second = D;
+          else m_derivatives.insert(it, std::make_pair(xD, D));
+        }
 
         // expand PDF in y
 
@@ -92,6 +92,12 @@ namespace Belle2 {
        */
       void normalize(double a);
 
+      /**
+       * Shifts PDF peaks in time
+       * @param dt time shift
+       */
+      void shift(double dt);
+
       /**
        * Returns a sum of nph of all peaks
        */
@@ -161,6 +167,11 @@ namespace Belle2 {
       for (auto& peak : m_peaks) peak.nph /= a;
     }
 
+    inline void SignalPDF::shift(double dt)
+    {
+      for (auto& peak : m_peaks) peak.t0 += dt;
+    }
+
     inline double SignalPDF::getSum() const
     {
       double s = 0;
@@ -0,0 +1,174 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#pragma once
+
+#include <top/reconstruction_cpp/TOPTrack.h>
+#include <top/reconstruction_cpp/SignalPDF.h>
+#include <framework/gearbox/Const.h>
+#include <vector>
+#include <map>
+
+namespace Belle2 {
+  namespace TOP {
+
+    /**
+     * Cache of signal PDF's, reused for tracks with similar parameters.
+     *
+     * The key is made of slot ID, particle hypothesis, PDF option and of the local emission point,
+     * track direction, momentum and time window edges relative to the time-of-flight, quantized
+     * with the given steps. PDF's are stored with the time-of-flight of the track that filled
+     * the entry and are shifted to the time-of-flight of the track that reuses them.
+     * With PDF option c_Optimal the entry is reused only if the selection of pixel columns
+     * expanded in y is the same for the reusing track.
+     *
+     * Each module owns its cache, which is disabled by default. The entries are dropped when
+     * the reconstruction objects of TOPRecoManager change.
+     */
+    class SignalPDFCache {
+
+    public:
+
+      /**
+       * Key of a cache entry
+       */
+      struct Key {
+        int moduleID = 0; /**< slot ID */
+        int pdgCode = 0;  /**< PDG code of particle hypothesis */
+        int PDFOption = 0; /**< signal PDF construction option */
+        long itmin = 0; /**< quantized time window lower edge relative to time-of-flight */
+        long itmax = 0; /**< quantized time window upper edge relative to time-of-flight */
+        long ix = 0; /**< quantized emission position in x */
+        long iy = 0; /**< quantized emission position in y */
+        long iz = 0; /**< quantized emission position in z */
+        long ith = 0; /**< quantized track polar angle */
+        long iph = 0; /**< quantized track azimuthal angle */
+        long ip = 0;  /**< quantized momentum */
+
+        /**
+         * Ordering operator
+         * @param other other key
+         * @return true if this key is smaller
+         */
+        bool operator<(const Key& other) const;
+      };
+
+      /**
+       * Decision whether to expand a pixel column in y, made with PDF option c_Optimal
+       */
+      struct ScanDecision {
+        unsigned col = 0; /**< pixel column (0-based) */
+        double time = 0; /**< photon time relative to time-of-flight */
+        double wid = 0; /**< peak width squared */
+        bool doScan = false; /**< decision */
+      };
+
+      /**
+       * Cache entry
+       */
+      struct Entry {
+        std::vector<SignalPDF> signalPDFs; /**< normalized signal PDF in pixels (index = pixelID - 1) */
+        double signalPhotons = 0; /**< expected number of signal photons */
+        double tof = 0; /**< time-of-flight the PDF has been constructed with */
+        std::vector<ScanDecision> scanDecisions; /**< decisions made with PDF option c_Optimal */
+
+        /**
+         * Checks if the entry can be used for a given track: the decisions made with
+         * PDF option c_Optimal must be the same for the hits of this track
+         * @param track track at TOP
+         * @param tof time-of-flight of the track
+         * @return true if the entry can be used
+         */
+        bool isUsableFor(const TOPTrack& track, double tof) const;
+      };
+
+      /**
+       * Enables or disables the cache; the cache is cleared if any of the settings change
+       * @param maxSize maximal number of entries (0 disables the cache)
+       * @param positionStep quantization step of emission position [cm]
+       * @param angleStep quantization step of track polar and azimuthal angles [rad]
+       * @param momentumStep quantization step of momentum [GeV/c]
+       * @param timeStep quantization step of time window edges relative to time-of-flight [ns]
+       */
+      void set(unsigned maxSize, double positionStep, double angleStep, double momentumStep, double timeStep);
+
+      /**
+       * Checks if the cache is enabled
+       * @return true if enabled
+       */
+      bool isEnabled() const {return m_maxSize > 0;}
+
+      /**
+       * Returns the key for a given track and hypothesis
+       * @param track track at TOP
+       * @param hypothesis particle hypothesis
+       * @param PDFOption signal PDF construction option
+       * @param minTime time window lower edge
+       * @param maxTime time window upper edge
+       * @param tof time-of-flight of the track
+       * @return key
+       */
+      Key getKey(const TOPTrack& track, const Const::ChargedStable& hypothesis, int PDFOption,
+                 double minTime, double maxTime, double tof) const;
+
+      /**
+       * Returns cache entry usable for a given track and counts hits and misses;
+       * all entries are dropped first if the reconstruction objects have changed
+       * @param key key
+       * @param track track at TOP
+       * @param tof time-of-flight of the track
+       * @return pointer to the entry or null pointer if not found or not usable
+       */
+      const Entry* get(const Key& key, const TOPTrack& track, double tof);
+
+      /**
+       * Stores an entry; if the cache is full it is cleared first
+       * @param key key
+       * @param entry entry
+       */
+      void store(const Key& key, Entry&& entry);
+
+      /**
+       * Removes all entries
+       */
+      void clear() {m_entries.clear();}
+
+      /**
+       * Returns number of entries
+       * @return number of entries
+       */
+      unsigned size() const {return m_entries.size();}
+
+      /**
+       * Returns number of requests answered with a cached PDF
+       * @return number of hits
+       */
+      unsigned getHits() const {return m_hits;}
+
+      /**
+       * Returns number of requests for which the PDF had to be constructed
+       * @return number of misses
+       */
+      unsigned getMisses() const {return m_misses;}
+
+    private:
+
+      unsigned m_maxSize = 0; /**< maximal number of entries (0 = disabled) */
+      double m_positionStep = 0; /**< quantization step of emission position [cm] */
+      double m_angleStep = 0; /**< quantization step of track angles [rad] */
+      double m_momentumStep = 0; /**< quantization step of momentum [GeV/c] */
+      double m_timeStep = 0; /**< quantization step of time window edges [ns] */
+      unsigned m_revision = 0; /**< revision of the reconstruction objects the entries are made with */
+      std::map<Key, Entry> m_entries; /**< cache entries */
+      unsigned m_hits = 0; /**< number of requests answered from the cache */
+      unsigned m_misses = 0; /**< number of requests not answered from the cache */
+
+    };
+
+  } // namespace TOP
+} // namespace Belle2
@@ -154,6 +154,13 @@ namespace Belle2 {
        */
       static void setMirrorCenter(int moduleID, double xc, double yc);
 
+      /**
+       * Returns the revision of reconstruction objects, incremented each time channel masks,
+       * pixel efficiencies or mirror centers change (used to invalidate the caches of signal PDF's)
+       * @return revision
+       */
+      static unsigned getRevision() {return getInstance().m_revision;}
+
     private:
 
       /** Singleton: private constructor */
@@ -203,6 +210,7 @@ namespace Belle2 {
       double m_minTime = 0; /**< time window lower edge */
       double m_maxTime = 0; /**< time window upper edge */
       bool m_redoBkg = false; /**< flag to signal whether backgroundPDF has to be redone */
+      unsigned m_revision = 0; /**< revision of reconstruction objects */
 
     };
 
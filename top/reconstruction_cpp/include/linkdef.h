@@ -37,6 +37,10 @@
 #pragma link C++ class Belle2::TOP::BackgroundPDF-;
 #pragma link C++ class Belle2::TOP::DeltaRayPDF-;
 #pragma link C++ class Belle2::TOP::TOPRecoManager-;
+#pragma link C++ class Belle2::TOP::SignalPDFCache-;
+#pragma link C++ class Belle2::TOP::SignalPDFCache::Key-;
+#pragma link C++ class Belle2::TOP::SignalPDFCache::ScanDecision-;
+#pragma link C++ class Belle2::TOP::SignalPDFCache::Entry-;
 #pragma link C++ class Belle2::TOP::PDFConstructor-;
 #pragma link C++ class Belle2::TOP::PDFConstructor::LogL-;
 #pragma link C++ class Belle2::TOP::PDFConstructor::Pull-;
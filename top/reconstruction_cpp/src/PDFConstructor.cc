@@ -21,7 +21,8 @@ namespace Belle2 {
   namespace TOP {
 
     PDFConstructor::PDFConstructor(const TOPTrack& track, const Const::ChargedStable& hypothesis,
-                                   EPDFOption PDFOption, EStoreOption storeOption, double overrideMass):
+                                   EPDFOption PDFOption, EStoreOption storeOption, double overrideMass,
+                                   SignalPDFCache* cache):
       m_moduleID(track.getModuleID()), m_track(track), m_hypothesis(hypothesis),
       m_inverseRaytracer(TOPRecoManager::getInverseRaytracer(m_moduleID)),
       m_fastRaytracer(TOPRecoManager::getFastRaytracer(m_moduleID)),
@@ -67,7 +68,11 @@ namespace Belle2 {
       // construct PDF
 
       if (m_yScanner->isAboveThreshold()) {
-        setSignalPDF();
+        if (cache and cache->isEnabled() and m_storeOption == c_Reduced and overrideMass <= 0) {
+          setSignalPDFCached(*cache);
+        } else {
+          setSignalPDF();
+        }
       }
 
       m_deltaRayPDF.prepare(track, hypothesis);
@@ -108,6 +113,32 @@ namespace Belle2 {
       }
     }
 
+    void PDFConstructor::setSignalPDFCached(SignalPDFCache& cache)
+    {
+      auto key = cache.getKey(m_track, m_hypothesis, m_PDFOption, m_minTime, m_maxTime, m_tof);
+
+      const auto* entry = cache.get(key, m_track, m_tof);
+      if (entry) {
+        m_signalPDFs = entry->signalPDFs;
+        m_signalPhotons = entry->signalPhotons;
+        double dt = m_tof - entry->tof;
+        if (dt != 0) {
+          for (auto& signalPDF : m_signalPDFs) signalPDF.shift(dt);
+        }
+        return;
+      }
+
+      SignalPDFCache::Entry newEntry;
+      m_scanDecisions = &newEntry.scanDecisions;
+      setSignalPDF();
+      m_scanDecisions = 0;
+
+      newEntry.signalPDFs = m_signalPDFs;
+      newEntry.signalPhotons = m_signalPhotons;
+      newEntry.tof = m_tof;
+      cache.store(key, std::move(newEntry));
+    }
+
     // signal PDF construction for track crossing bar segments -------------------------------------------
 
     void PDFConstructor::setSignalPDF_direct()
@@ -426,6 +457,7 @@ namespace Belle2 {
       if (m_PDFOption == c_Optimal) {
         double time = m_tof + Len / speedOfLightQuartz;
         doScan = m_track.isScanRequired(col, time, wid);
+        if (m_scanDecisions) m_scanDecisions->push_back({col, time - m_tof, wid, doScan});
       }
 
       m_yScanner->expand(col, yB, dydz, D, Ny_eff, doScan);
@@ -0,0 +1,104 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+
+#include <top/reconstruction_cpp/SignalPDFCache.h>
+#include <top/reconstruction_cpp/TOPRecoManager.h>
+#include <framework/logging/Logger.h>
+#include <cmath>
+#include <tuple>
+
+using namespace std;
+
+namespace Belle2 {
+  namespace TOP {
+
+    bool SignalPDFCache::Key::operator<(const Key& other) const
+    {
+      return std::tie(moduleID, pdgCode, PDFOption, itmin, itmax, ix, iy, iz, ith, iph, ip) <
+             std::tie(other.moduleID, other.pdgCode, other.PDFOption, other.itmin, other.itmax,
+                      other.ix, other.iy, other.iz, other.ith, other.iph, other.ip);
+    }
+
+    bool SignalPDFCache::Entry::isUsableFor(const TOPTrack& track, double tof) const
+    {
+      for (const auto& decision : scanDecisions) {
+        if (track.isScanRequired(decision.col, tof + decision.time, decision.wid) != decision.doScan) return false;
+      }
+      return true;
+    }
+
+    void SignalPDFCache::set(unsigned maxSize, double positionStep, double angleStep, double momentumStep,
+                             double timeStep)
+    {
+      if (maxSize > 0 and (positionStep <= 0 or angleStep <= 0 or momentumStep <= 0 or timeStep <= 0)) {
+        B2ERROR("TOP::SignalPDFCache: quantization steps must be positive, cache is disabled"
+                << LogVar("position step", positionStep)
+                << LogVar("angle step", angleStep)
+                << LogVar("momentum step", momentumStep)
+                << LogVar("time step", timeStep));
+        maxSize = 0;
+      }
+
+      if (maxSize != m_maxSize or positionStep != m_positionStep or angleStep != m_angleStep or
+          momentumStep != m_momentumStep or timeStep != m_timeStep) clear();
+
+      m_maxSize = maxSize;
+      m_positionStep = positionStep;
+      m_angleStep = angleStep;
+      m_momentumStep = momentumStep;
+      m_timeStep = timeStep;
+    }
+
+    SignalPDFCache::Key SignalPDFCache::getKey(const TOPTrack& track, const Const::ChargedStable& hypothesis,
+                                               int PDFOption, double minTime, double maxTime, double tof) const
+    {
+      const auto& emi = track.getEmissionPoint();
+      const auto& trk = emi.trackAngles;
+
+      Key key;
+      key.moduleID = track.getModuleID();
+      key.pdgCode = hypothesis.getPDGCode();
+      key.PDFOption = PDFOption;
+      key.itmin = lround((minTime - tof) / m_timeStep);
+      key.itmax = lround((maxTime - tof) / m_timeStep);
+      key.ix = lround(emi.position.X() / m_positionStep);
+      key.iy = lround(emi.position.Y() / m_positionStep);
+      key.iz = lround(emi.position.Z() / m_positionStep);
+      key.ith = lround(atan2(trk.sinTh, trk.cosTh) / m_angleStep);
+      key.iph = lround(atan2(trk.sinFi, trk.cosFi) / m_angleStep);
+      key.ip = lround(track.getMomentumMag() / m_momentumStep);
+      return key;
+    }
+
+    const SignalPDFCache::Entry* SignalPDFCache::get(const Key& key, const TOPTrack& track, double tof)
+    {
+      if (m_revision != TOPRecoManager::getRevision()) {
+        clear();
+        m_revision = TOPRecoManager::getRevision();
+      }
+      auto it = m_entries.find(key);
+      if (it == m_entries.end() or not it->second.isUsableFor(track, tof)) {
+        m_misses++;
+        return 0;
+      }
+      m_hits++;
+      return &it->second;
+    }
+
+    void SignalPDFCache::store(const Key& key, Entry&& entry)
+    {
+      if (not isEnabled()) return;
+      if (m_entries.size() >= m_maxSize) {
+        B2DEBUG(20, "TOP::SignalPDFCache: cache is full, clearing" << LogVar("size", m_entries.size()));
+        clear();
+      }
+      m_entries[key] = std::move(entry);
+    }
+
+  } // namespace TOP
+} // namespace Belle2
@@ -95,6 +95,7 @@ namespace Belle2 {
         }
       }
       getInstance().m_redoBkg = true;
+      getInstance().m_revision++;
 
       B2INFO("TOPRecoManager: new channel masks have been passed to reconstruction");
     }
@@ -113,6 +114,7 @@ namespace Belle2 {
         }
       }
       getInstance().m_redoBkg = true;
+      getInstance().m_revision++;
 
       B2INFO("TOPRecoManager: channelT0-uncalibrated channels have been masked off");
     }
@@ -139,6 +141,7 @@ namespace Belle2 {
         }
       }
       getInstance().m_redoBkg = true;
+      getInstance().m_revision++;
 
       B2INFO("TOPRecoManager: timebase-uncalibrated channels have been masked off");
     }
@@ -172,6 +175,7 @@ namespace Belle2 {
         }
       }
       getInstance().m_redoBkg = true;
+      getInstance().m_revision++;
 
       B2INFO("TOPRecoManager: new relative pixel efficiencies have been passed to reconstruction");
     }
@@ -186,6 +190,7 @@ namespace Belle2 {
         inverseRaytracers[k].setMirrorCenter(xc, yc);
         fastRaytracers[k].setMirrorCenter(xc, yc);
         yScanners[k].setMirrorCenter(xc, yc);
+        getInstance().m_revision++;
         return;
       }
 
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+
+##########################################################################
+# basf2 (Belle II Analysis Software Framework)                           #
+# Author: The Belle II Collaboration                                     #
+#                                                                        #
+# See git log for contributors and copyright holders.                    #
+# This file is licensed under LGPL-3.0, see LICENSE.md.                  #
+##########################################################################
+
+"""
+Check the signal PDF cache of TOPReconstructor against reconstruction without the cache.
+
+1. Tracks with random parameters are reconstructed twice in a row, such that in the second
+   pass the signal PDF's of the first pass are reused for identical tracks. The log
+   likelihoods, the numbers of photons and the flags must be the same for all tracks.
+2. Tracks with almost the same parameters are reconstructed with coarse quantization steps,
+   such that the tracks share the cache keys. The log likelihoods may then differ, but only
+   by a small amount.
+
+In both cases the cache must have been hit.
+"""
+
+import re
+import basf2 as b2
+from ROOT import Belle2
+import b2test_utils
+
+#: number of simulated events with random track parameters
+N_EVENTS = 20
+
+#: number of simulated events with almost the same track parameters
+N_SIMILAR_EVENTS = 50
+
+#: quantization steps for the similar tracks: emission position [cm], angles [rad], momentum [GeV/c], time [ns]
+COARSE_STEPS = [0.5, 0.01, 0.05, 0.05]
+
+#: allowed log likelihood difference for tracks sharing a cache entry
+MAX_LOGL_DIFFERENCE = 5.0
+
+
+class CompareLikelihoods(b2.Module):
+    """Compare TOPLikelihoods made without and with the signal PDF cache"""
+
+    def __init__(self, nEvents, tolerance=0):
+        """
+        Constructor
+        :param nEvents: expected number of processed events
+        :param tolerance: allowed absolute difference of log likelihoods
+        """
+        super().__init__()
+        #: expected number of processed events
+        self.nExpected = nEvents
+        #: allowed absolute difference of log likelihoods
+        self.tolerance = tolerance
+
+    def initialize(self):
+        """initialize the counters"""
+        #: number of processed events
+        self.nEvents = 0
+        #: number of compared likelihoods with flag = 1
+        self.nCompared = 0
+        #: largest absolute difference of log likelihoods
+        self.maxDifference = 0
+
+    def event(self):
+        """compare the likelihoods of all tracks"""
+        self.nEvents += 1
+        for track in Belle2.PyStoreArray('Tracks'):
+            reference = track.getRelated('TOPLikelihoods')
+            cached = track.getRelated('TOPLikelihoodsCached')
+            assert (reference is None) == (cached is None), 'likelihood is missing for one of the two'
+            if reference is None:
+                continue
+            assert reference.getFlag() == cached.getFlag()
+            if reference.getFlag() != 1:
+                continue
+            assert reference.getNphot() == cached.getNphot()
+            for hypothesis in Belle2.Const.chargedStableSet:
+                logL, logL_cached = reference.getLogL(hypothesis), cached.getLogL(hypothesis)
+                difference = abs(logL - logL_cached)
+                self.maxDifference = max(self.maxDifference, difference)
+                assert difference <= self.tolerance, \
+                    f'event {self.nEvents}, PDG {hypothesis.getPDGCode()}: {logL} != {logL_cached}'
+                if self.tolerance == 0:
+                    assert reference.getEstPhot(hypothesis) == cached.getEstPhot(hypothesis)
+            self.nCompared += 1
+
+    def terminate(self):
+        """make sure that all events were processed and that likelihoods were compared"""
+        assert self.nEvents == self.nExpected, f'{self.nEvents} events processed'
+        assert self.nCompared > 0
+        b2.B2RESULT(f'compared {self.nCompared} likelihoods, largest log likelihood difference {self.maxDifference}')
+
+
+def simulate(fileName, nEvents, **gunParameters):
+    """simulate charged particles hitting TOP"""
+    b2.set_random_seed('TOPPDFCache')
+    main = b2.create_path()
+    main.add_module('EventInfoSetter', evtNumList=[nEvents])
+    main.add_module('Gearbox')
+    main.add_module('Geometry', useDB=False, components=['MagneticField', 'TOP'])
+    main.add_module('ParticleGun', nTracks=1, varyNTracks=False,
+                    vertexGeneration='fixed', xVertexParams=[0], yVertexParams=[0], zVertexParams=[0],
+                    **gunParameters)
+    main.add_module('FullSim')
+    main.add_module('TOPDigitizer')
+    main.add_module('TOPMCTrackMaker')
+    main.add_module('RootOutput', outputFileName=fileName)
+    b2test_utils.safe_process(main)
+
+
+def simulate_random():
+    """simulate single pions and kaons with random momenta and directions"""
+    simulate('events.root', N_EVENTS, pdgCodes=[211, -211, 321, -321],
+             momentumGeneration='uniform', momentumParams=[1, 4],
+             thetaGeneration='uniformCos', thetaParams=[35, 120],
+             phiGeneration='uniform', phiParams=[0, 360])
+
+
+def simulate_similar():
+    """simulate single pions with a spread of about 1 mrad in direction and 5 MeV/c in momentum"""
+    simulate('similar.root', N_SIMILAR_EVENTS, pdgCodes=[211],
+             momentumGeneration='normal', momentumParams=[2, 0.005],
+             thetaGeneration='normal', thetaParams=[80, 0.06],
+             phiGeneration='normal', phiParams=[33.75, 0.06])
+
+
+def reconstruct(inputFileNames, nEvents, logFileName, tolerance=0, **cacheParameters):
+    """reconstruct the events without and with the cache and compare the results"""
+    b2.logging.add_file(logFileName)
+    main = b2.create_path()
+    main.add_module('RootInput', inputFileNames=inputFileNames)
+    main.add_module('Gearbox')
+    main.add_module('Geometry', useDB=False, components=['MagneticField', 'TOP'])
+    main.add_module('TOPChannelMasker')
+    main.add_module('TOPReconstructor')
+    cached = main.add_module('TOPReconstructor', PDFCacheSize=100000,
+                             TOPLikelihoodCollectionName='TOPLikelihoodsCached',
+                             TOPPullCollectionName='TOPPullsCached', **cacheParameters)
+    cached.set_name('TOPReconstructor_cached')
+    cached.set_log_level(b2.LogLevel.RESULT)
+    main.add_module(CompareLikelihoods(nEvents, tolerance))
+    b2test_utils.safe_process(main)
+
+
+def reconstruct_twice():
+    """reconstruct the tracks with random parameters twice in a row, cached PDF's must be identical"""
+    reconstruct(['events.root', 'events.root'], 2 * N_EVENTS, 'random.log')
+
+
+def reconstruct_similar():
+    """reconstruct the similar tracks with coarse steps, cached PDF's are shared between tracks"""
+    reconstruct(['similar.root'], N_SIMILAR_EVENTS, 'similar.log', MAX_LOGL_DIFFERENCE, PDFCacheSteps=COARSE_STEPS)
+
+
+def get_cache_hits(logFileName):
+    """return the number of cache hits reported by TOPReconstructor in the log file"""
+    with open(logFileName) as log:
+        hits = re.findall(r'TOPReconstructor: signal PDF cache hits (\d+)/(\d+)', log.read())
+    assert len(hits) == 1, f'cache statistics not found in {logFileName}'
+    return int(hits[0][0])
+
+
+if __name__ == '__main__':
+    with b2test_utils.clean_working_directory():
+        with b2test_utils.show_only_errors():
+            assert b2test_utils.run_in_subprocess(target=simulate_random) == 0
+            assert b2test_utils.run_in_subprocess(target=reconstruct_twice) == 0
+            assert get_cache_hits('random.log') > 0
+            assert b2test_utils.run_in_subprocess(target=simulate_similar) == 0
+            assert b2test_utils.run_in_subprocess(target=reconstruct_similar) == 0
+            assert get_cache_hits('similar.log') > 0
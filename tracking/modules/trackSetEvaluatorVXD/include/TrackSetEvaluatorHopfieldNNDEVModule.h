@@ -34,6 +34,8 @@ namespace Belle2 {
    *  We recommend to first try with the generic case and use all possible optimizations there,
    *  before complicating the code structure again with the handling of special cases just for small
    *  speed improvements.
+   *  - Optionally, for very large numbers of TCs, the network can be replaced by a greedy selection with
+   *    a repair step (Scrooge::performSelectionWithRepair), see parameter maxNumberOfCandidates (off by default).
    */
   class TrackSetEvaluatorHopfieldNNDEVModule : public Module {
 
@@ -68,6 +70,9 @@ namespace Belle2 {
     /** Minimum of activityState ("Neuron Value") required to be accepted by the algorithm. */
     float m_minActivityState;
 
+    /** Maximal number of TCs for the Hopfield network, above that a greedy selection with repair is used (0: no limit). */
+    unsigned int m_maxNumberOfCandidates = 0;
+
     /** the storeArray for SpacePointTrackCands as member, is faster than recreating link for each event. */
     StoreArray<SpacePointTrackCand> m_spacePointTrackCands;
 
@@ -85,5 +90,8 @@ namespace Belle2 {
 
     /** counts number of times when Hopfield was not able to clean overlaps. */
     unsigned int m_nHopfieldFails     = 0;
+
+    /** counts number of times when the greedy fallback was used instead of the Hopfield network. */
+    unsigned int m_nGreedyFallbacks   = 0;
   };
 }
@@ -9,6 +9,7 @@
 #include "tracking/modules/trackSetEvaluatorVXD/TrackSetEvaluatorHopfieldNNDEVModule.h"
 
 #include "tracking/trackFindingVXD/trackSetEvaluator/HopfieldNetwork.h"
+#include "tracking/trackFindingVXD/trackSetEvaluator/Scrooge.h"
 
 using namespace Belle2;
 
@@ -28,6 +29,10 @@ TrackSetEvaluatorHopfieldNNDEVModule::TrackSetEvaluatorHopfieldNNDEVModule() : M
            std::string(""));
   addParam("minActivityState", m_minActivityState, "Sets the minimal value of activity (Neuron Value) for acceptance.",
            float(0.7));
+  addParam("maxNumberOfCandidates", m_maxNumberOfCandidates,
+           "If there are more SpacePointTrackCands in the event, the Hopfield network is replaced by a greedy selection\
+            with a repair step, which changes the selected candidates. 0 (default): always use the Hopfield network.",
+           m_maxNumberOfCandidates);
 }
 
 
@@ -49,13 +54,23 @@ void TrackSetEvaluatorHopfieldNNDEVModule::event()
                                           m_overlapNetworks[0]->getOverlapForTrackIndex(sPTC.getArrayIndex()), 1.0);
   }
 
-  //Performs the actual HNN.
-  //As the parameter is taken as reference, the values are changed and can be reused below.
-  HopfieldNetwork hopfieldNetwork;
-  unsigned maxIterations = 20;
-  if (hopfieldNetwork.doHopfield(overlapResolverNodeInfos, maxIterations) == maxIterations) {
-    B2INFO("Hopfield Network failed converge.");
-    m_nHopfieldFails++;
+  if (m_maxNumberOfCandidates and overlapResolverNodeInfos.size() > m_maxNumberOfCandidates) {
+    //Too many candidates for the HNN to be run within a reasonable time, so fall back to greedy with repair.
+    //The activity states become 0 or 1 and are evaluated in the same way as the HNN output below.
+    B2DEBUG(20, "Number of SpacePointTrackCands (" << overlapResolverNodeInfos.size() << ") exceeds "
+            << m_maxNumberOfCandidates << ", using greedy selection.");
+    Scrooge scrooge;
+    scrooge.performSelectionWithRepair(overlapResolverNodeInfos);
+    m_nGreedyFallbacks++;
+  } else {
+    //Performs the actual HNN.
+    //As the parameter is taken as reference, the values are changed and can be reused below.
+    HopfieldNetwork hopfieldNetwork;
+    unsigned maxIterations = 20;
+    if (hopfieldNetwork.doHopfield(overlapResolverNodeInfos, maxIterations) == maxIterations) {
+      B2INFO("Hopfield Network failed converge.");
+      m_nHopfieldFails++;
+    }
   }
 
   //Update tcs and kill those which were rejected by the Hopfield algorithm
@@ -87,11 +102,13 @@ void TrackSetEvaluatorHopfieldNNDEVModule::endRun()
          " nFinalTCs per event: " << float(m_nFinalTCs)*invEvents <<
          "\n nTCs total: " << m_nTCsTotal <<
          ", nFinalTCs total: " << m_nFinalTCs <<
-         ", number of times Hopfield did not succeed: " << m_nHopfieldFails);
+         ", number of times Hopfield did not succeed: " << m_nHopfieldFails <<
+         ", number of times greedy fallback was used: " << m_nGreedyFallbacks);
 
   //After having evaluated the counters, we reset them to zero.
   m_eventCounter = 0;
   m_nTCsTotal = 0;
   m_nFinalTCs = 0;
   m_nHopfieldFails = 0;
+  m_nGreedyFallbacks = 0;
 }
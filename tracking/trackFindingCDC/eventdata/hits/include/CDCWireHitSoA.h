@@ -0,0 +1,159 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <tracking/trackFindingCDC/geometry/Vector2D.h>
+
+#include <vector>
+
+namespace Belle2 {
+  namespace TrackFindingCDC {
+
+    class CDCWireHit;
+
+    /**
+     *  Structure of arrays store for the quantities of wire hits, that are read in the hot loops of the hit based finders.
+     *
+     *  The quantities of the i-th hit are laid out in contiguous arrays, such that loops over many hits
+     *  only touch the memory they actually need and can be vectorized by the compiler.
+     *  The index of a hit in the store serves as light weight handle, the original wire hit
+     *  can be retrieved from it with getWireHit().
+     *
+     *  The positions are stored relative to a local origin given at filling time.
+     *  Flags and automaton state are not copied, since they change during the track finding,
+     *  they have to be looked up from the automaton cell of the original wire hit.
+     */
+    class CDCWireHitSoA {
+
+    public:
+      /// Type of the index handles to the hits in the store
+      using Index = unsigned int;
+
+    public:
+      /// Remove all hits from the store
+      void clear();
+
+      /// Reserve space for the given number of hits
+      void reserve(size_t nHits);
+
+      /// Append a wire hit to the store, the position is taken relative to the local origin. Returns the index of the hit.
+      Index push_back(const CDCWireHit* wireHit, const Vector2D& localOrigin = Vector2D(0.0, 0.0));
+
+      /// Clear the store and fill it with the given wire hits, the i-th wire hit gets index i.
+      void fill(const std::vector<const CDCWireHit*>& wireHits, const Vector2D& localOrigin = Vector2D(0.0, 0.0));
+
+      /// Number of hits in the store
+      size_t size() const
+      {
+        return m_wireHits.size();
+      }
+
+      /// Check whether the store contains no hits
+      bool empty() const
+      {
+        return m_wireHits.empty();
+      }
+
+    public:
+      /// Getter for the wire hit with the given index
+      const CDCWireHit* getWireHit(Index index) const
+      {
+        return m_wireHits[index];
+      }
+
+      /// Getter for the x coordinate of the reference position relative to the local origin
+      double getRefX(Index index) const
+      {
+        return m_refX[index];
+      }
+
+      /// Getter for the y coordinate of the reference position relative to the local origin
+      double getRefY(Index index) const
+      {
+        return m_refY[index];
+      }
+
+      /// Getter for the drift length at the reference position
+      double getRefDriftLength(Index index) const
+      {
+        return m_refDriftLength[index];
+      }
+
+      /// Getter for the variance of the drift length at the reference position
+      double getRefDriftLengthVariance(Index index) const
+      {
+        return m_refDriftLengthVariance[index];
+      }
+
+      /**
+       *  Getter for the squared distance of the reference position to the local origin reduced by the squared drift length.
+       *  This is the common factor of the curvature in the Legendre sinograms of the hit.
+       */
+      double getRefR2(Index index) const
+      {
+        return m_refR2[index];
+      }
+
+    public:
+      /// Getter for the array of the wire hits
+      const CDCWireHit* const* getWireHits() const
+      {
+        return m_wireHits.data();
+      }
+
+      /// Getter for the array of the x coordinates of the reference positions
+      const double* getRefXs() const
+      {
+        return m_refX.data();
+      }
+
+      /// Getter for the array of the y coordinates of the reference positions
+      const double* getRefYs() const
+      {
+        return m_refY.data();
+      }
+
+      /// Getter for the array of the drift lengths at the reference positions
+      const double* getRefDriftLengths() const
+      {
+        return m_refDriftLength.data();
+      }
+
+      /// Getter for the array of the variances of the drift lengths at the reference positions
+      const double* getRefDriftLengthVariances() const
+      {
+        return m_refDriftLengthVariance.data();
+      }
+
+      /// Getter for the array of the squared distances reduced by the squared drift lengths
+      const double* getRefR2s() const
+      {
+        return m_refR2.data();
+      }
+
+    private:
+      /// Memory for the back references to the wire hits
+      std::vector<const CDCWireHit*> m_wireHits;
+
+      /// Memory for the x coordinates of the reference positions relative to the local origin
+      std::vector<double> m_refX;
+
+      /// Memory for the y coordinates of the reference positions relative to the local origin
+      std::vector<double> m_refY;
+
+      /// Memory for the drift lengths at the reference positions
+      std::vector<double> m_refDriftLength;
+
+      /// Memory for the variances of the drift lengths at the reference positions
+      std::vector<double> m_refDriftLengthVariance;
+
+      /// Memory for the squared distances to the local origin reduced by the squared drift lengths
+      std::vector<double> m_refR2;
+    };
+  }
+}
@@ -0,0 +1,57 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <tracking/trackFindingCDC/eventdata/hits/CDCWireHitSoA.h>
+
+#include <tracking/trackFindingCDC/eventdata/hits/CDCWireHit.h>
+
+using namespace Belle2;
+using namespace TrackFindingCDC;
+
+void CDCWireHitSoA::clear()
+{
+  m_wireHits.clear();
+  m_refX.clear();
+  m_refY.clear();
+  m_refDriftLength.clear();
+  m_refDriftLengthVariance.clear();
+  m_refR2.clear();
+}
+
+void CDCWireHitSoA::reserve(size_t nHits)
+{
+  m_wireHits.reserve(nHits);
+  m_refX.reserve(nHits);
+  m_refY.reserve(nHits);
+  m_refDriftLength.reserve(nHits);
+  m_refDriftLengthVariance.reserve(nHits);
+  m_refR2.reserve(nHits);
+}
+
+CDCWireHitSoA::Index CDCWireHitSoA::push_back(const CDCWireHit* wireHit, const Vector2D& localOrigin)
+{
+  const Index index = m_wireHits.size();
+  const double& l = wireHit->getRefDriftLength();
+  const Vector2D pos2D = wireHit->getRefPos2D() - localOrigin;
+
+  m_wireHits.push_back(wireHit);
+  m_refX.push_back(pos2D.x());
+  m_refY.push_back(pos2D.y());
+  m_refDriftLength.push_back(l);
+  m_refDriftLengthVariance.push_back(wireHit->getRefDriftLengthVariance());
+  m_refR2.push_back(pos2D.normSquared() - l * l);
+  return index;
+}
+
+void CDCWireHitSoA::fill(const std::vector<const CDCWireHit*>& wireHits, const Vector2D& localOrigin)
+{
+  clear();
+  reserve(wireHits.size());
+  for (const CDCWireHit* wireHit : wireHits) {
+    push_back(wireHit, localOrigin);
+  }
+}
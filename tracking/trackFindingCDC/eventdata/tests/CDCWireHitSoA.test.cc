@@ -0,0 +1,59 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <tracking/trackFindingCDC/testFixtures/TrackFindingCDCTestWithTopology.h>
+
+#include <tracking/trackFindingCDC/eventdata/hits/CDCWireHitSoA.h>
+#include <tracking/trackFindingCDC/eventdata/hits/CDCWireHit.h>
+
+#include <tracking/trackFindingCDC/geometry/Vector2D.h>
+
+#include <cdc/dataobjects/WireID.h>
+
+#include <vector>
+
+using namespace Belle2;
+using namespace TrackFindingCDC;
+
+TEST_F(TrackFindingCDCTestWithTopology, eventdata_hits_CDCWireHitSoA_fill)
+{
+  std::vector<CDCWireHit> wireHits;
+  wireHits.emplace_back(WireID(0, 0, 0), 0.01);
+  wireHits.emplace_back(WireID(0, 1, 5), 0.2);
+  wireHits.emplace_back(WireID(2, 3, 100), 0.5);
+
+  std::vector<const CDCWireHit*> ptrWireHits;
+  for (const CDCWireHit& wireHit : wireHits) {
+    ptrWireHits.push_back(&wireHit);
+  }
+
+  const Vector2D localOrigin(1.0, -2.0);
+  CDCWireHitSoA hits;
+  hits.fill(ptrWireHits, localOrigin);
+  ASSERT_EQ(wireHits.size(), hits.size());
+
+  for (CDCWireHitSoA::Index index = 0; index < hits.size(); ++index) {
+    const CDCWireHit* wireHit = hits.getWireHit(index);
+    EXPECT_EQ(ptrWireHits[index], wireHit);
+
+    const Vector2D pos2D = wireHit->getRefPos2D() - localOrigin;
+    const double l = wireHit->getRefDriftLength();
+    EXPECT_EQ(pos2D.x(), hits.getRefXs()[index]);
+    EXPECT_EQ(pos2D.y(), hits.getRefYs()[index]);
+    EXPECT_EQ(l, hits.getRefDriftLengths()[index]);
+    EXPECT_EQ(wireHit->getRefDriftLengthVariance(), hits.getRefDriftLengthVariance(index));
+    EXPECT_EQ(pos2D.normSquared() - l * l, hits.getRefR2(index));
+  }
+
+  // Appending returns the index handle of the new hit
+  CDCWireHitSoA::Index index = hits.push_back(ptrWireHits.front());
+  EXPECT_EQ(wireHits.size(), index);
+  EXPECT_EQ(wireHits.front().getRefPos2D().x(), hits.getRefX(index));
+
+  hits.clear();
+  EXPECT_TRUE(hits.empty());
+}
@@ -39,6 +39,9 @@ namespace Belle2 {
        *  Reestimate the drift length of all three contained drift circles.
        *  Using the additional flight direction information the accuracy of the drift length
        *  can be increased alot helping the filters following this step
+       *
+       *  Only the facet is changed, the calibration and the event time are only read,
+       *  such that different facets can be updated concurrently.
        */
       void updateDriftLength(CDCFacet& facet);
 
@@ -52,6 +52,9 @@ namespace Belle2 {
       /// Indicates if the filter requires Monte Carlo information.
       bool needsTruthInformation() override;
 
+      /// Indicates if the chosen filter may be evaluated concurrently from several threads.
+      bool isThreadSafe() override;
+
       /**
        *  Function to evaluate the object.
        *  Delegates to the filter chosen by module parameters.
@@ -52,6 +52,14 @@ namespace Belle2 {
       /// Indicates if the filter requires Monte Carlo information.
       virtual bool needsTruthInformation();
 
+      /**
+       *  Indicates if the filter may be evaluated concurrently from several threads.
+       *
+       *  Filters that modify state during the evaluation, e.g. the variable sets of MVA filters,
+       *  or that access Monte Carlo information must not claim to be thread safe.
+       */
+      virtual bool isThreadSafe();
+
     public:
       /**
        *  Function to evaluate the object.
@@ -47,6 +47,12 @@ namespace Belle2 {
        */
       Weight operator()(const CDCFacet& facet) final;
 
+      /// Thread safe, since the fit is done on local copies and the cut values are only read during the evaluation.
+      bool isThreadSafe() final
+      {
+        return true;
+      }
+
     private: // Parameters
       /// Parameter : The chi2 cut values distinguished by superlayer
       std::vector<double> m_param_chi2CutByISuperLayer{75.0};
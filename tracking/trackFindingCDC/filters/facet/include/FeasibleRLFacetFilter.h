@@ -44,6 +44,12 @@ namespace Belle2 {
        */
       Weight operator()(const CDCFacet& facet) final;
 
+      /// Thread safe, the decision depends on the right left passage hypotheses of the facet alone.
+      bool isThreadSafe() final
+      {
+        return true;
+      }
+
     public:
       /// Setter for the flag that the boarderline cases should be excluded.
       void setHardRLCut(bool hardRLCut)
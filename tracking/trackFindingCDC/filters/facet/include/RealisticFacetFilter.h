@@ -42,6 +42,12 @@ namespace Belle2 {
        */
       Weight operator()(const CDCFacet& facet) final;
 
+      /// Evaluation only fits the given facet and compares to the pull cut, so it can run concurrently.
+      bool isThreadSafe() final
+      {
+        return true;
+      }
+
     private:
       /// Memory for the pull cu
       double m_param_phiPullCut;
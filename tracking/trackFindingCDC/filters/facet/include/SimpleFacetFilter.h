@@ -42,6 +42,12 @@ namespace Belle2 {
        */
       Weight operator()(const CDCFacet& facet) final;
 
+      /// Thread safe, since the deviation cut is the only state read during the evaluation.
+      bool isThreadSafe() final
+      {
+        return true;
+      }
+
     private:
       /// Memory for the used direction of flight deviation.
       double m_param_deviationCosCut;
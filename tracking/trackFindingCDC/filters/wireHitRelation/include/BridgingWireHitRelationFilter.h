@@ -59,6 +59,12 @@ namespace Belle2 {
       std::vector<CDCWireHit*> getPossibleTos(CDCWireHit* from,
                                               const std::vector<CDCWireHit*>& wireHits) const final;
 
+      /// The neighborhood lookup only reads the thresholds prepared in initialize.
+      bool isThreadSafe() final
+      {
+        return true;
+      }
+
     private:
       /// Parameter: A map from o'clock direction to the number of missing primary drift cells
       std::map<int, int> m_param_missingPrimaryNeighborThresholdMap =
@@ -15,10 +15,12 @@
 
 #include <tracking/trackFindingCDC/eventdata/utils/DriftLengthEstimator.h>
 
+#include <tracking/trackFindingCDC/utilities/ParallelMap.h>
 #include <tracking/trackFindingCDC/utilities/WeightedRelation.h>
 
 #include <vector>
 #include <string>
+#include <memory>
 
 namespace Belle2 {
 
@@ -44,6 +46,12 @@ namespace Belle2 {
       /// Expose the parameters to a module
       void exposeParameters(ModuleParamList* moduleParamList, const std::string& prefix) final;
 
+      /// Check whether the chosen filters allow to process the clusters in parallel and start the threads
+      void initialize() final;
+
+      /// Join the threads
+      void terminate() final;
+
       /**
        *  Central function creating the hit triplets from the clusters.
        *
@@ -54,6 +62,15 @@ namespace Belle2 {
       void apply(const std::vector<CDCWireHitCluster>& inputClusters, std::vector<CDCFacet>& facets) final;
 
     private:
+      /**
+       *  Generates the facets of a single cluster and appends them to the facets.
+       *  Uses the given relation vector as memory for the wire hit neighborhood.
+       */
+      void createFacetsInCluster(const CDCWireHitCluster& cluster,
+                                 int iCluster,
+                                 std::vector<WeightedRelation<CDCWireHit> >& wireHitRelations,
+                                 std::vector<CDCFacet>& facets);
+
       /**
        *  Generates facets on the given wire hits generating neighboring triples of hits.
        *  Inserts the result to the end of the GenericFacetCollection.
@@ -81,6 +98,15 @@ namespace Belle2 {
       /// Parameter : Switch to fit the facet with least square method for the drift length update
       bool m_param_leastSquareFit = false;
 
+      /// Parameter : Number of threads to process the clusters concurrently, 1 means sequential processing
+      int m_param_nThreads = 1;
+
+      /// Number of threads actually used, falls back to 1 if the chosen filters are not thread safe
+      int m_nThreads = 1;
+
+      /// Threads reused for the concurrent facet creation of all events
+      std::unique_ptr<WorkerPool> m_workerPool;
+
     private:
       /// The filter for the hit neighborhood.
       BridgingWireHitRelationFilter m_wireHitRelationFilter;
@@ -53,45 +53,96 @@ void FacetCreator::exposeParameters(ModuleParamList* moduleParamList, const std:
                                 "Switch to fit the facet with the least square method "
                                 "for drift length estimation",
                                 m_param_leastSquareFit);
+
+  moduleParamList->addParameter(prefixed(prefix, "nThreads"),
+                                m_param_nThreads,
+                                "Number of threads to create the facets of different clusters concurrently. "
+                                "The output does not depend on the number of threads. "
+                                "Requires thread safe filters, otherwise the clusters are processed sequentially.",
+                                m_param_nThreads);
+}
+
+void FacetCreator::initialize()
+{
+  Super::initialize();
+
+  m_nThreads = std::max(m_param_nThreads, 1);
+  if (m_nThreads > 1) {
+    const bool threadSafe = m_wireHitRelationFilter.isThreadSafe() and
+                            m_feasibleRLFacetFilter.isThreadSafe() and
+                            m_facetFilter.isThreadSafe();
+    if (not threadSafe) {
+      B2WARNING("The chosen facet filters are not thread safe. Facets are created sequentially.");
+      m_nThreads = 1;
+    }
+  }
+  if (m_nThreads > 1) {
+    m_workerPool = std::make_unique<WorkerPool>(m_nThreads);
+  }
+}
+
+void FacetCreator::terminate()
+{
+  m_workerPool.reset();
+  Super::terminate();
 }
 
 void FacetCreator::apply(const std::vector<CDCWireHitCluster>& inputClusters, std::vector<CDCFacet>& facets)
 {
-  int iCluster = -1;
-  for (const CDCWireHitCluster& cluster : inputClusters) {
-    ++iCluster;
-    // Skip clusters that have been detected as background
-    if (cluster.getBackgroundFlag()) {
-      continue;
+  if (m_nThreads <= 1) {
+    int iCluster = -1;
+    for (const CDCWireHitCluster& cluster : inputClusters) {
+      ++iCluster;
+      createFacetsInCluster(cluster, iCluster, m_wireHitRelations, facets);
     }
-    B2ASSERT("Expect the clusters to be sorted", std::is_sorted(cluster.begin(), cluster.end()));
+    return;
+  }
+
+  auto createFacetsInClusterConcurrently = [this, &inputClusters](const CDCWireHitCluster & cluster,
+  std::vector<CDCFacet>& facetsInCluster) {
+    const int iCluster = &cluster - inputClusters.data();
+    std::vector<WeightedRelation<CDCWireHit> > wireHitRelations;
+    createFacetsInCluster(cluster, iCluster, wireHitRelations, facetsInCluster);
+  };
+  parallelMap(inputClusters, facets, *m_workerPool, createFacetsInClusterConcurrently);
+}
 
-    // Obtain the set of wire hits as references
-    const std::vector<CDCWireHit*>& wireHits = cluster;
+void FacetCreator::createFacetsInCluster(const CDCWireHitCluster& cluster,
+                                         int iCluster,
+                                         std::vector<WeightedRelation<CDCWireHit> >& wireHitRelations,
+                                         std::vector<CDCFacet>& facets)
+{
+  // Skip clusters that have been detected as background
+  if (cluster.getBackgroundFlag()) {
+    return;
+  }
+  B2ASSERT("Expect the clusters to be sorted", std::is_sorted(cluster.begin(), cluster.end()));
 
-    // Create the neighborhood of wire hits on the cluster
-    m_wireHitRelations.clear();
-    RelationFilterUtil::appendUsing(m_wireHitRelationFilter, wireHits, m_wireHitRelations);
+  // Obtain the set of wire hits as references
+  const std::vector<CDCWireHit*>& wireHits = cluster;
 
-    B2ASSERT("Wire neighborhood is not symmetric. Check the geometry.",
-             WeightedRelationUtil<CDCWireHit>::areSymmetric(m_wireHitRelations));
+  // Create the neighborhood of wire hits on the cluster
+  wireHitRelations.clear();
+  RelationFilterUtil::appendUsing(m_wireHitRelationFilter, wireHits, wireHitRelations);
 
-    // Create the facets
-    std::size_t nBefore = facets.size();
-    createFacets(cluster, m_wireHitRelations, facets);
-    std::size_t nAfter = facets.size();
+  B2ASSERT("Wire neighborhood is not symmetric. Check the geometry.",
+           WeightedRelationUtil<CDCWireHit>::areSymmetric(wireHitRelations));
 
-    VectorRange<CDCFacet> facetsInCluster(facets.begin() + nBefore, facets.begin() + nAfter);
-    // Sort the facets in their cluster
-    std::sort(facetsInCluster.begin(), facetsInCluster.end());
+  // Create the facets
+  std::size_t nBefore = facets.size();
+  createFacets(cluster, wireHitRelations, facets);
+  std::size_t nAfter = facets.size();
 
-    B2ASSERT("Expected all facets to be different",
-             std::adjacent_find(facetsInCluster.begin(), facetsInCluster.end()) ==
-             facetsInCluster.end());
+  VectorRange<CDCFacet> facetsInCluster(facets.begin() + nBefore, facets.begin() + nAfter);
+  // Sort the facets in their cluster
+  std::sort(facetsInCluster.begin(), facetsInCluster.end());
 
-    for (CDCFacet& facet : facetsInCluster) {
-      facet.setICluster(iCluster);
-    }
+  B2ASSERT("Expected all facets to be different",
+           std::adjacent_find(facetsInCluster.begin(), facetsInCluster.end()) ==
+           facetsInCluster.end());
+
+  for (CDCFacet& facet : facetsInCluster) {
+    facet.setICluster(iCluster);
   }
 }
 
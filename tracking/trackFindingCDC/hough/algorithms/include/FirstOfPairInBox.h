@@ -9,6 +9,9 @@
 
 #include <tracking/trackFindingCDC/numerics/Weight.h>
 
+#include <vector>
+#include <utility>
+
 namespace Belle2 {
   namespace TrackFindingCDC {
 
@@ -31,6 +34,25 @@ namespace Belle2 {
         AHitInBoxAlgorithm hitInBoxAlgorithm;
         return hitInBoxAlgorithm(pairObject.first, box);
       }
+
+      /**
+       * Redirect the first elements of a block of pairs to the block version of the next algorithm.
+       * Only available if the next algorithm can weight many objects in many boxes at once.
+       */
+      template<class APairObject, class AFirst = typename APairObject::first_type>
+      auto operator()(const std::vector<const APairObject*>& pairObjects,
+                      const std::vector<const HoughBox*>& boxes,
+                      std::vector<Weight>& weights)
+      -> decltype(std::declval<AHitInBoxAlgorithm&>()(std::declval<const std::vector<const AFirst*>&>(), boxes, weights))
+      {
+        std::vector<const AFirst*> firsts;
+        firsts.reserve(pairObjects.size());
+        for (const APairObject* pairObject : pairObjects) {
+          firsts.push_back(&pairObject->first);
+        }
+        AHitInBoxAlgorithm hitInBoxAlgorithm;
+        return hitInBoxAlgorithm(firsts, boxes, weights);
+      }
     };
   }
 }
@@ -10,6 +10,9 @@
 #include <tracking/trackFindingCDC/hough/boxes/Z0TanLambdaBox.h>
 #include <tracking/trackFindingCDC/hough/baseelements/SameSignChecker.h>
 
+#include <vector>
+#include <cmath>
+
 namespace Belle2 {
   namespace TrackFindingCDC {
 
@@ -54,6 +57,55 @@ namespace Belle2 {
         }
       }
 
+      /**
+       *  Checks the containment of a block of hits in many z0 tan lambda hough spaces at once.
+       *  The arc lengths and z positions of the hits are gathered into flat arrays first, such that
+       *  the decision for each box is a branch free loop over the hits, which the compiler can vectorize.
+       *  The weight of the i-th hit in the j-th box is written to weights[j * recoHits.size() + i]
+       *  and is 1.0 if the hit is contained and NAN otherwise - exactly as the single hit version.
+       */
+      void operator()(const std::vector<const CDCRecoHit3D*>& recoHits,
+                      const std::vector<const HoughBox*>& z0TanLambdaBoxes,
+                      std::vector<Weight>& weights)
+      {
+        const size_t nHits = recoHits.size();
+        std::vector<float> perpSs;
+        std::vector<float> reconstructedZs;
+        perpSs.reserve(nHits);
+        reconstructedZs.reserve(nHits);
+        for (const CDCRecoHit3D* recoHit : recoHits) {
+          perpSs.push_back(recoHit->getArcLength2D());
+          reconstructedZs.push_back(recoHit->getRecoZ());
+        }
+
+        weights.resize(z0TanLambdaBoxes.size() * nHits);
+        for (size_t iBox = 0; iBox < z0TanLambdaBoxes.size(); ++iBox) {
+          const HoughBox* z0TanLambdaBox = z0TanLambdaBoxes[iBox];
+          const float lowerZ0 = z0TanLambdaBox->getLowerZ0();
+          const float upperZ0 = z0TanLambdaBox->getUpperZ0();
+
+          const float lowerTanLambda = z0TanLambdaBox->getLowerTanLambda();
+          const float upperTanLambda = z0TanLambdaBox->getUpperTanLambda();
+
+          Weight* boxWeights = weights.data() + iBox * nHits;
+          for (size_t iHit = 0; iHit < nHits; ++iHit) {
+            const float perpS = perpSs[iHit];
+            const float reconstructedZ = reconstructedZs[iHit];
+
+            const float distLowerZ0LowerTanLambda = perpS * lowerTanLambda - reconstructedZ + lowerZ0;
+            const float distUpperZ0LowerTanLambda = perpS * lowerTanLambda - reconstructedZ + upperZ0;
+            const float distLowerZ0UpperTanLambda = perpS * upperTanLambda - reconstructedZ + lowerZ0;
+            const float distUpperZ0UpperTanLambda = perpS * upperTanLambda - reconstructedZ + upperZ0;
+
+            const bool allPositive = (distLowerZ0LowerTanLambda > 0) & (distUpperZ0LowerTanLambda > 0) &
+                                     (distLowerZ0UpperTanLambda > 0) & (distUpperZ0UpperTanLambda > 0);
+            const bool allNegative = (distLowerZ0LowerTanLambda < 0) & (distUpperZ0LowerTanLambda < 0) &
+                                     (distLowerZ0UpperTanLambda < 0) & (distUpperZ0UpperTanLambda < 0);
+            boxWeights[iHit] = (allPositive | allNegative) ? NAN : 1.0;
+          }
+        }
+      }
+
       /**
        * Compares distances from two hits to the track represented by the given box.
        * The comparison is done based on reconstructed Z coordinates of hits and track Z position.
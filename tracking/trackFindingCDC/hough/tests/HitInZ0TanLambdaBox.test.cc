@@ -0,0 +1,83 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <tracking/trackFindingCDC/testFixtures/TrackFindingCDCTestWithTopology.h>
+
+#include <tracking/trackFindingCDC/hough/algorithms/HitInZ0TanLambdaBox.h>
+#include <tracking/trackFindingCDC/hough/algorithms/FirstOfPairInBox.h>
+#include <tracking/trackFindingCDC/hough/boxes/Z0TanLambdaBox.h>
+
+#include <tracking/trackFindingCDC/eventdata/hits/CDCRecoHit3D.h>
+#include <tracking/trackFindingCDC/eventdata/hits/CDCRLWireHit.h>
+#include <tracking/trackFindingCDC/eventdata/hits/CDCWireHit.h>
+
+#include <tracking/trackFindingCDC/numerics/LookupTable.h>
+
+#include <cdc/dataobjects/WireID.h>
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+#include <cmath>
+
+using namespace Belle2;
+using namespace TrackFindingCDC;
+
+TEST_F(TrackFindingCDCTestWithTopology, hough_HitInZ0TanLambdaBox_blockAgreesWithSingle)
+{
+  // Boxes on a small grid in z0 and tan lambda
+  std::vector<float> z0s = linspace<float>(-40, 40, 9);
+  std::vector<float> tanLambdas = linspace<float>(-2, 2, 9);
+
+  std::vector<Z0TanLambdaBox> boxes;
+  for (size_t iZ0 = 0; iZ0 + 1 < z0s.size(); ++iZ0) {
+    for (size_t iTanL = 0; iTanL + 1 < tanLambdas.size(); ++iTanL) {
+      boxes.emplace_back(std::array<DiscreteZ0, 2>({DiscreteZ0(z0s[iZ0]), DiscreteZ0(z0s[iZ0 + 1])}),
+                         std::array<DiscreteTanL, 2>({DiscreteTanL(tanLambdas[iTanL]), DiscreteTanL(tanLambdas[iTanL + 1])}));
+    }
+  }
+  std::vector<const Z0TanLambdaBox*> ptrBoxes;
+  for (const Z0TanLambdaBox& box : boxes) {
+    ptrBoxes.push_back(&box);
+  }
+
+  // Hits along a few lines in the s-z plane
+  CDCWireHit wireHit(WireID(1, 0, 0), 0.1);
+  CDCRLWireHit rlWireHit(&wireHit, ERightLeft::c_Right);
+
+  std::vector<std::pair<CDCRecoHit3D, const CDCRLWireHit*>> hits;
+  for (int iHit = 0; iHit < 50; ++iHit) {
+    const double arcLength2D = 20 + 2 * iHit;
+    const double z = (iHit % 3 - 1) * 15 + (iHit % 5 - 2) * 0.3 * arcLength2D;
+    const Vector3D recoPos3D(arcLength2D, 0, z);
+    hits.emplace_back(CDCRecoHit3D(rlWireHit, recoPos3D, arcLength2D), &rlWireHit);
+  }
+  std::vector<const std::pair<CDCRecoHit3D, const CDCRLWireHit*>*> ptrHits;
+  for (const auto& hit : hits) {
+    ptrHits.push_back(&hit);
+  }
+
+  FirstOfPairInBox<HitInZ0TanLambdaBox> hitInBox;
+  std::vector<Weight> weights;
+  hitInBox(ptrHits, ptrBoxes, weights);
+  ASSERT_EQ(hits.size() * boxes.size(), weights.size());
+
+  int nContained = 0;
+  for (size_t iBox = 0; iBox < boxes.size(); ++iBox) {
+    for (size_t iHit = 0; iHit < hits.size(); ++iHit) {
+      const Weight singleWeight = hitInBox(hits[iHit], &boxes[iBox]);
+      const Weight blockWeight = weights[iBox * hits.size() + iHit];
+      EXPECT_EQ(std::isnan(singleWeight), std::isnan(blockWeight));
+      if (not std::isnan(singleWeight)) {
+        EXPECT_EQ(singleWeight, blockWeight);
+        ++nContained;
+      }
+    }
+  }
+  EXPECT_GT(nContained, 0);
+}
@@ -13,6 +13,7 @@
 
 #include <vector>
 #include <memory>
+#include <utility>
 #include <cassert>
 #include <cfloat>
 #include <cmath>
@@ -250,17 +251,7 @@ namespace Belle2 {
           if (not children) {
             node->createChildren();
             children = node->getChildren();
-            for (Node& childNode : *children) {
-              assert(childNode.getChildren() == nullptr);
-              assert(childNode.size() == 0);
-              auto measure =
-              [&childNode, &weightItemInDomain](WithSharedMark<T>& markableItem) -> Weight {
-                // Weighting function should not see the mark, but only the item itself.
-                T & item(markableItem);
-                return weightItemInDomain(item, &childNode);
-              };
-              childNode.insert(*node, measure);
-            }
+            fillChildren(weightItemInDomain, *node, *children, 0);
           }
           // Continue to walk the children.
           return true;
@@ -268,6 +259,81 @@ namespace Belle2 {
         walkHeighWeightFirst(walker);
       }
 
+    private:
+      /**
+       *  Fill the items of the node into its freshly created children.
+       *  Version for measures that can weight a block of items in many domains at once.
+       *  The measure is invoked once per node with all items and all children domains and
+       *  is expected to write the weight of item i in child j to weights[j * nItems + i].
+       */
+      template<class AItemInDomainMeasure>
+      static auto fillChildren(AItemInDomainMeasure& weightItemInDomain,
+                               Node& node,
+                               typename Node::Children& children,
+                               int)
+      -> decltype(weightItemInDomain(std::declval<const std::vector<const T*>&>(),
+                                     std::declval<const std::vector<const ADomain*>&>(),
+                                     std::declval<std::vector<Weight>&>()), void())
+      {
+        // Weighting function should not see the mark, but only the item itself.
+        std::vector<const T*> items;
+        items.reserve(node.size());
+        for (const WithSharedMark<T>& markableItem : node) {
+          const T& item(markableItem);
+          items.push_back(&item);
+        }
+
+        std::vector<const ADomain*> domains;
+        for (Node& childNode : children) {
+          assert(childNode.getChildren() == nullptr);
+          assert(childNode.size() == 0);
+          domains.push_back(&childNode);
+        }
+
+        std::vector<Weight> weights;
+        weightItemInDomain(items, domains, weights);
+        assert(weights.size() == items.size() * domains.size());
+
+        const size_t nItems = items.size();
+        size_t iChild = 0;
+        for (Node& childNode : children) {
+          const Weight* childWeights = weights.data() + iChild * nItems;
+          size_t iItem = 0;
+          for (const WithSharedMark<T>& markableItem : node) {
+            const Weight weight = childWeights[iItem];
+            if (not std::isnan(weight)) {
+              childNode.insert(markableItem, weight);
+            }
+            ++iItem;
+          }
+          ++iChild;
+        }
+      }
+
+      /**
+       *  Fill the items of the node into its freshly created children.
+       *  Version for measures that weight a single item in a single domain.
+       */
+      template<class AItemInDomainMeasure>
+      static void fillChildren(AItemInDomainMeasure& weightItemInDomain,
+                               Node& node,
+                               typename Node::Children& children,
+                               long)
+      {
+        for (Node& childNode : children) {
+          assert(childNode.getChildren() == nullptr);
+          assert(childNode.size() == 0);
+          auto measure =
+          [&childNode, &weightItemInDomain](WithSharedMark<T>& markableItem) -> Weight {
+            // Weighting function should not see the mark, but only the item itself.
+            T & item(markableItem);
+            return weightItemInDomain(item, &childNode);
+          };
+          childNode.insert(node, measure);
+        }
+      }
+
+    public:
       /// Walk the tree investigating the heaviest children with priority.
       template<class ATreeWalker>
       void walkHeighWeightFirst(ATreeWalker& walker)
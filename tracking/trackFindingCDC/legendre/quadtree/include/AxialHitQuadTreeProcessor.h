@@ -10,6 +10,8 @@
 #include <tracking/trackFindingCDC/legendre/quadtree/QuadTreeProcessor.h>
 #include <tracking/trackFindingCDC/legendre/precisionFunctions/PrecisionUtil.h>
 
+#include <tracking/trackFindingCDC/eventdata/hits/CDCWireHitSoA.h>
+
 #include <tracking/trackFindingCDC/numerics/LookupTable.h>
 #include <tracking/trackFindingCDC/geometry/Vector2D.h>
 
@@ -72,6 +74,19 @@ namespace Belle2 {
        */
       bool isInNode(QuadTree* node, const CDCWireHit* wireHit) const final;
 
+      /**
+       * Fill the items of the node into its children.
+       * Same decision as isInNode, but the hit quantities are read from the flat arrays of m_hits
+       * and every child is tested against a block of hits at once, such that the sinogram crossing test
+       * is free of branches and can be vectorized. Only the rare extremum and derivative checks fall back to the scalar code.
+       * @param node quadtree node, which children should be filled
+       * @param items the items of the node
+       */
+      void fillChildren(QuadTree* node, const std::vector<Item*>& items) final;
+
+      /// Copy the quantities of the seeded hits into the structure of arrays store m_hits
+      void afterSeedItemsHook() final;
+
     protected: // Implementation details
       /**
        * Check derivative of the sinogram.
@@ -117,6 +132,9 @@ namespace Belle2 {
 
       /// Lambda which holds resolution function for the quadtree
       PrecisionUtil::PrecisionFunction m_precisionFunction;
+
+      /// Hit quantities relative to the local origin in the order of m_items, indexed by QuadTreeItem::getIndex()
+      CDCWireHitSoA m_hits;
     };
   }
 }
@@ -7,6 +7,8 @@
  **************************************************************************/
 #pragma once
 
+#include <cstddef>
+
 namespace Belle2 {
   namespace TrackFindingCDC {
 
@@ -23,8 +25,9 @@ namespace Belle2 {
     class QuadTreeItem {
     public:
       /// Constructor
-      explicit QuadTreeItem(AData* data)
+      explicit QuadTreeItem(AData* data, size_t index = 0)
         : m_data(data)
+        , m_index(index)
         , m_usedFlag(false) {};
 
     private:
@@ -41,6 +44,15 @@ namespace Belle2 {
         return m_data;
       }
 
+      /**
+       * Returns the position of the item in the storage of the processor.
+       * Can be used as index handle into flat arrays of precomputed item properties.
+       */
+      size_t getIndex() const
+      {
+        return m_index;
+      }
+
       /**
        * Flag is set if the item was used as a result of the quad tree search and
        * should not be used in the next quad tree search round.
@@ -66,6 +78,9 @@ namespace Belle2 {
       /// A pointer to the underlying item data
       AData* m_data;
 
+      /// Position of the item in the storage of the processor
+      size_t m_index;
+
       /// This flag can be set to not use the item in the next quad tree search round
       bool m_usedFlag;
     };
@@ -100,8 +100,9 @@ namespace Belle2 {
       {
         // Create the items
         for (AData* data : datas) {
-          m_items.emplace_back(data);
+          m_items.emplace_back(data, m_items.size());
         }
+        afterSeedItemsHook();
 
         // Creating the seed level
         long nSeedBins = pow(2, m_seedLevel);
@@ -254,11 +255,31 @@ namespace Belle2 {
         }
       }
 
+      /**
+       * When a node is accepted as a result, we extract a vector with the items (back transformed to AData*)
+       * and pass it together with the result node to the candidate receiver function.
+       */
+      void callResultFunction(QuadTree* node, const CandidateReceiver& candidateReceiver) const
+      {
+        const std::vector<Item*>& foundItems = node->getItems();
+        std::vector<AData*> candidate;
+        candidate.reserve(foundItems.size());
+
+        for (Item* item : foundItems) {
+          item->setUsedFlag();
+          candidate.push_back(item->getPointer());
+        }
+
+        candidateReceiver(candidate, node);
+      }
+
+    protected: // Section of specialisable functions
       /**
        * This function is called by fillGivenTree and fills the items into the corresponding children.
        * For this the user-defined method isInNode is called.
+       * Override it if the containment test can be done more efficiently for many items at once.
        */
-      void fillChildren(QuadTree* node, const std::vector<Item*>& items)
+      virtual void fillChildren(QuadTree* node, const std::vector<Item*>& items)
       {
         const size_t neededSize = 2 * items.size();
         for (QuadTree& child : node->getChildren()) {
@@ -278,24 +299,13 @@ namespace Belle2 {
       }
 
       /**
-       * When a node is accepted as a result, we extract a vector with the items (back transformed to AData*)
-       * and pass it together with the result node to the candidate receiver function.
+       * Override that function if you want to precompute properties of the items.
+       * It is called after new items have been appended to m_items in seed and before they are filled into the tree.
        */
-      void callResultFunction(QuadTree* node, const CandidateReceiver& candidateReceiver) const
+      virtual void afterSeedItemsHook()
       {
-        const std::vector<Item*>& foundItems = node->getItems();
-        std::vector<AData*> candidate;
-        candidate.reserve(foundItems.size());
-
-        for (Item* item : foundItems) {
-          item->setUsedFlag();
-          candidate.push_back(item->getPointer());
-        }
-
-        candidateReceiver(candidate, node);
       }
 
-    protected: // Section of specialisable functions
       /**
        * Implement that function if you want to provide a new processor. It decides which node-spans the n * m children of the node should have.
        * It is called when creating the nodes. The two indices iX and iY tell you where the new node will be created (as node.children[iX][iY]).
@@ -258,6 +258,124 @@ bool AxialHitQuadTreeProcessor::isInNode(QuadTree* node, const CDCWireHit* wireH
   return false;
 }
 
+void AxialHitQuadTreeProcessor::afterSeedItemsHook()
+{
+  m_hits.clear();
+  m_hits.reserve(m_items.size());
+  for (const Item& item : m_items) {
+    m_hits.push_back(item.getPointer(), m_localOrigin);
+  }
+}
+
+void AxialHitQuadTreeProcessor::fillChildren(QuadTree* node, const std::vector<Item*>& items)
+{
+  QuadTreeChildren& children = node->getChildren();
+  const size_t neededSize = 2 * items.size();
+  for (QuadTree& child : children) {
+    child.reserveItems(neededSize);
+  }
+
+  // Number of hits that are gathered from the store and tested against the children at once
+  constexpr size_t c_blockSize = 64;
+  std::array<Item*, c_blockSize> blockItems{};
+  std::array<double, c_blockSize> xs{};
+  std::array<double, c_blockSize> ys{};
+  std::array<double, c_blockSize> ls{};
+  std::array<double, c_blockSize> r2s{};
+  std::array<unsigned char, c_blockSize> crosses{};
+  std::array<unsigned char, c_blockSize> hasExtremum{};
+
+  const double* refXs = m_hits.getRefXs();
+  const double* refYs = m_hits.getRefYs();
+  const double* refDriftLengths = m_hits.getRefDriftLengths();
+  const double* refR2s = m_hits.getRefR2s();
+
+  auto itItem = items.begin();
+  while (itItem != items.end()) {
+    // Gather the next block of unused hits
+    size_t nBlock = 0;
+    for (; itItem != items.end() and nBlock < c_blockSize; ++itItem) {
+      Item* item = *itItem;
+      if (item->isUsed()) continue;
+      const size_t index = item->getIndex();
+      blockItems[nBlock] = item;
+      xs[nBlock] = refXs[index];
+      ys[nBlock] = refYs[index];
+      ls[nBlock] = refDriftLengths[index];
+      r2s[nBlock] = refR2s[index];
+      ++nBlock;
+    }
+
+    for (QuadTree& child : children) {
+      // The forward direction check is only done for few low level nodes - use the scalar version there
+      if (child.getLevel() <= 4 and m_twoSidedPhaseSpace and child.getYMin() > -c_curlCurv and
+          child.getYMax() < c_curlCurv) {
+        for (size_t iHit = 0; iHit < nBlock; ++iHit) {
+          if (isInNode(&child, blockItems[iHit]->getPointer())) {
+            child.insertItem(blockItems[iHit]);
+          }
+        }
+        continue;
+      }
+
+      const float yMin = child.getYMin();
+      const float yMax = child.getYMax();
+      const Vector2D& thetaVecMin = m_cosSinLookupTable->at(child.getXMin());
+      const Vector2D& thetaVecMax = m_cosSinLookupTable->at(child.getXMax());
+      const double cosMin = thetaVecMin.x();
+      const double sinMin = thetaVecMin.y();
+      const double cosMax = thetaVecMax.x();
+      const double sinMax = thetaVecMax.y();
+
+      // Same arithmetic as in isInNode, but without branches
+      for (size_t iHit = 0; iHit < nBlock; ++iHit) {
+        const double x = xs[iHit];
+        const double y = ys[iHit];
+        const double l = ls[iHit];
+        const double r2 = r2s[iHit];
+
+        const float rMin = yMin * r2 / 2;
+        const float rMax = yMax * r2 / 2;
+
+        const float rHitMin = cosMin * x + sinMin * y;
+        const float rHitMax = cosMax * x + sinMax * y;
+
+        const float rHitMinRight = rHitMin - l;
+        const float rHitMaxRight = rHitMax - l;
+        const float rHitMinLeft = rHitMin + l;
+        const float rHitMaxLeft = rHitMax + l;
+
+        const float distRight00 = rMin - rHitMinRight;
+        const float distRight01 = rMin - rHitMaxRight;
+        const float distRight10 = rMax - rHitMinRight;
+        const float distRight11 = rMax - rHitMaxRight;
+
+        const float distLeft00 = rMin - rHitMinLeft;
+        const float distLeft01 = rMin - rHitMaxLeft;
+        const float distLeft10 = rMax - rHitMinLeft;
+        const float distLeft11 = rMax - rHitMaxLeft;
+
+        const bool allRightPositive = (distRight00 > 0) & (distRight01 > 0) & (distRight10 > 0) & (distRight11 > 0);
+        const bool allRightNegative = (distRight00 < 0) & (distRight01 < 0) & (distRight10 < 0) & (distRight11 < 0);
+        const bool allLeftPositive = (distLeft00 > 0) & (distLeft01 > 0) & (distLeft10 > 0) & (distLeft11 > 0);
+        const bool allLeftNegative = (distLeft00 < 0) & (distLeft01 < 0) & (distLeft10 < 0) & (distLeft11 < 0);
+        crosses[iHit] = not(allRightPositive | allRightNegative) | not(allLeftPositive | allLeftNegative);
+
+        const float rHitMinExtr = cosMin * y - sinMin * x;
+        const float rHitMaxExtr = cosMax * y - sinMax * x;
+        hasExtremum[iHit] = rHitMinExtr * rHitMaxExtr < 0.;
+      }
+
+      for (size_t iHit = 0; iHit < nBlock; ++iHit) {
+        if (crosses[iHit] or (hasExtremum[iHit] and checkExtremum(&child, blockItems[iHit]->getPointer()))) {
+          child.insertItem(blockItems[iHit]);
+        }
+      }
+    }
+  }
+  afterFillDebugHook(children);
+}
+
 bool AxialHitQuadTreeProcessor::checkDerivative(QuadTree* node, const CDCWireHit* wireHit) const
 {
   const Vector2D& pos2D = wireHit->getRefPos2D() - m_localOrigin;
@@ -0,0 +1,214 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Belle2 {
+  namespace TrackFindingCDC {
+
+    /**
+     *  Set of worker threads that are started once and reused for many parallel jobs.
+     *
+     *  The pool of n threads holds n - 1 worker threads, the calling thread of run() takes part in the work.
+     *  The threads are joined on destruction.
+     */
+    class WorkerPool {
+    public:
+      /// Start the worker threads
+      explicit WorkerPool(int nThreads)
+        : m_nThreads(std::max(nThreads, 1))
+      {
+        m_workers.reserve(m_nThreads - 1);
+        for (int iWorker = 1; iWorker < m_nThreads; ++iWorker) {
+          m_workers.emplace_back([this]() { this->loop(); });
+        }
+      }
+
+      /// Stop and join the worker threads
+      ~WorkerPool()
+      {
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_stop = true;
+        }
+        m_startCondition.notify_all();
+        for (std::thread& worker : m_workers) {
+          worker.join();
+        }
+      }
+
+      /// The pool is bound to its threads
+      WorkerPool(const WorkerPool&) = delete;
+
+      /// The pool is bound to its threads
+      WorkerPool& operator=(const WorkerPool&) = delete;
+
+      /// Number of threads including the calling thread
+      int getNThreads() const
+      {
+        return m_nThreads;
+      }
+
+      /**
+       *  Execute the job once on every thread of the pool including the calling thread.
+       *  Returns after all threads have finished the job. The job must not throw.
+       */
+      void run(const std::function<void()>& job)
+      {
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_job = &job;
+          m_nBusy = m_workers.size();
+          ++m_generation;
+        }
+        m_startCondition.notify_all();
+        job();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_nBusy == 0; });
+        m_job = nullptr;
+      }
+
+    private:
+      /// Main loop of a worker thread waiting for jobs
+      void loop()
+      {
+        unsigned int generation = 0;
+        while (true) {
+          const std::function<void()>* job = nullptr;
+          {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCondition.wait(lock, [this, generation]() { return m_stop or m_generation != generation; });
+            if (m_stop) return;
+            generation = m_generation;
+            job = m_job;
+          }
+          (*job)();
+          {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_nBusy;
+          }
+          m_doneCondition.notify_one();
+        }
+      }
+
+      /// Number of threads including the calling thread
+      int m_nThreads;
+
+      /// The worker threads
+      std::vector<std::thread> m_workers;
+
+      /// Mutex guarding the job state
+      std::mutex m_mutex;
+
+      /// Signals a new job or the stop to the workers
+      std::condition_variable m_startCondition;
+
+      /// Signals the completion of the job by a worker
+      std::condition_variable m_doneCondition;
+
+      /// The current job
+      const std::function<void()>* m_job = nullptr;
+
+      /// Counter of the jobs to distinguish a new job from a spurious wake up
+      unsigned int m_generation = 0;
+
+      /// Number of workers still executing the current job
+      size_t m_nBusy = 0;
+
+      /// Flag to stop the workers
+      bool m_stop = false;
+    };
+
+    /**
+     *  Apply a function to each input using up to nThreads threads and append the results in input order.
+     *
+     *  The function is invoked as function(input, outputs) and should append its results for the input to the outputs.
+     *  Each input is processed by exactly one thread into a separate output vector.
+     *  Afterwards the outputs are moved to the end of the given outputs in the order of the inputs,
+     *  such that the result does not depend on the number of threads or on the scheduling.
+     *
+     *  With nThreads <= 1 the function is applied sequentially on the given outputs directly.
+     *  Otherwise the function must only modify its arguments and state that is private to the call.
+     *  If a call throws, the first exception is rethrown after all threads have finished.
+     *
+     *  The threads of the given pool are reused, such that no threads are started per call.
+     */
+    template <class AInputs, class AOutput, class AFunction>
+    void parallelMap(AInputs& inputs,
+                     std::vector<AOutput>& outputs,
+                     WorkerPool& pool,
+                     const AFunction& function)
+    {
+      const size_t nInputs = std::distance(std::begin(inputs), std::end(inputs));
+      if (pool.getNThreads() <= 1 or nInputs <= 1) {
+        for (auto&& input : inputs) {
+          function(input, outputs);
+        }
+        return;
+      }
+
+      std::vector<std::vector<AOutput>> outputsByInput(nInputs);
+      std::atomic<size_t> nextInput{0};
+      std::exception_ptr firstException = nullptr;
+      std::atomic<bool> hasException{false};
+
+      const std::function<void()> work = [&]() {
+        for (size_t iInput = nextInput++; iInput < nInputs; iInput = nextInput++) {
+          if (hasException) return;
+          try {
+            function(*std::next(std::begin(inputs), iInput), outputsByInput[iInput]);
+          } catch (...) {
+            if (not hasException.exchange(true)) {
+              firstException = std::current_exception();
+            }
+            return;
+          }
+        }
+      };
+
+      pool.run(work);
+
+      if (firstException) {
+        std::rethrow_exception(firstException);
+      }
+
+      size_t nOutputs = outputs.size();
+      for (const std::vector<AOutput>& outputsOfInput : outputsByInput) {
+        nOutputs += outputsOfInput.size();
+      }
+      outputs.reserve(nOutputs);
+      for (std::vector<AOutput>& outputsOfInput : outputsByInput) {
+        std::move(outputsOfInput.begin(), outputsOfInput.end(), std::back_inserter(outputs));
+      }
+    }
+
+    /**
+     *  Apply a function to each input using up to nThreads threads and append the results in input order.
+     *  Starts the threads for this call only, prefer the version with a WorkerPool for repeated calls.
+     */
+    template <class AInputs, class AOutput, class AFunction>
+    void parallelMap(AInputs& inputs,
+                     std::vector<AOutput>& outputs,
+                     int nThreads,
+                     const AFunction& function)
+    {
+      const size_t nInputs = std::distance(std::begin(inputs), std::end(inputs));
+      WorkerPool pool(std::min<size_t>(std::max(nThreads, 1), std::max<size_t>(nInputs, 1)));
+      parallelMap(inputs, outputs, pool, function);
+    }
+  }
+}
@@ -0,0 +1,85 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#include <gtest/gtest.h>
+
+#include <tracking/trackFindingCDC/utilities/ParallelMap.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace Belle2;
+using namespace TrackFindingCDC;
+
+namespace {
+  TEST(TrackFindingCDCTest, utilities_parallelMap_output_independent_of_threads)
+  {
+    std::vector<int> inputs;
+    for (int i = 0; i < 1000; ++i) {
+      inputs.push_back(i);
+    }
+
+    // Variable number of outputs per input
+    auto function = [](const int & input, std::vector<int>& outputs) {
+      for (int i = 0; i < input % 5; ++i) {
+        outputs.push_back(10 * input + i);
+      }
+    };
+
+    std::vector<int> sequentialOutputs{ -1};
+    parallelMap(inputs, sequentialOutputs, 1, function);
+
+    std::vector<int> parallelOutputs{ -1};
+    parallelMap(inputs, parallelOutputs, 8, function);
+
+    EXPECT_EQ(2001u, sequentialOutputs.size());
+    EXPECT_EQ(sequentialOutputs, parallelOutputs);
+  }
+
+  TEST(TrackFindingCDCTest, utilities_parallelMap_forwards_exceptions)
+  {
+    std::vector<int> inputs(100, 0);
+    inputs[50] = 1;
+
+    auto function = [](const int & input, std::vector<int>& outputs __attribute__((unused))) {
+      if (input == 1) throw std::runtime_error("failure in worker");
+    };
+
+    std::vector<int> outputs;
+    EXPECT_THROW(parallelMap(inputs, outputs, 4, function), std::runtime_error);
+  }
+
+  TEST(TrackFindingCDCTest, utilities_parallelMap_reuses_worker_pool)
+  {
+    std::vector<int> inputs;
+    for (int i = 0; i < 100; ++i) {
+      inputs.push_back(i);
+    }
+
+    auto function = [](const int & input, std::vector<int>& outputs) {
+      if (input == -1) throw std::runtime_error("failure in worker");
+      outputs.push_back(2 * input);
+    };
+
+    std::vector<int> expectedOutputs;
+    parallelMap(inputs, expectedOutputs, 1, function);
+
+    // The pool must stay usable for many jobs, also after a job failed
+    WorkerPool pool(4);
+    for (int iJob = 0; iJob < 200; ++iJob) {
+      std::vector<int> outputs;
+      parallelMap(inputs, outputs, pool, function);
+      EXPECT_EQ(expectedOutputs, outputs);
+
+      if (iJob == 100) {
+        std::vector<int> failingInputs(inputs);
+        failingInputs[17] = -1;
+        EXPECT_THROW(parallelMap(failingInputs, outputs, pool, function), std::runtime_error);
+      }
+    }
+  }
+}
@@ -18,6 +18,8 @@ namespace Belle2 {
    *  In contrast to Jakob's original greedy implementation, this one doesn't use a recursive
    *  algorithm, but sorts according to QI and simply goes from the top and kills all overlapping
    *  SpacePointTrackCands.
+   *  The overlapping tracks are looked up via their position in the sorted vector, so the selection
+   *  scales with the number of overlaps rather than quadratically with the number of tracks.
    */
   class Scrooge {
   public:
@@ -34,17 +36,102 @@ namespace Belle2 {
         return lhs.qualityIndicator > rhs.qualityIndicator;
       });
 
+      //map the track indices to the position in the sorted vector:
+      const std::vector<int> positions = getPositions(overlapResolverNodeInfo);
+
       //kill all tracks, that have overlaps and lower QI:
-      auto endOfOverlapResolverNodeInfo   = overlapResolverNodeInfo.cend();
-      for (auto trackIter = overlapResolverNodeInfo.begin(); trackIter != endOfOverlapResolverNodeInfo; trackIter++) {
-        if (!trackIter->activityState) continue;
-        for (auto testTrackIter = trackIter; testTrackIter != endOfOverlapResolverNodeInfo; testTrackIter++) {
-          if (std::find(trackIter->overlaps.begin(), trackIter->overlaps.end(), testTrackIter->trackIndex) !=
-              trackIter->overlaps.end()) {
-            testTrackIter->activityState = 0.;
+      for (size_t iTrack = 0; iTrack < overlapResolverNodeInfo.size(); ++iTrack) {
+        auto const& track = overlapResolverNodeInfo[iTrack];
+        if (!track.activityState) continue;
+        for (unsigned short overlapIndex : track.overlaps) {
+          const int overlapPosition = overlapIndex < positions.size() ? positions[overlapIndex] : -1;
+          if (overlapPosition >= static_cast<int>(iTrack)) {
+            overlapResolverNodeInfo[overlapPosition].activityState = 0.;
           }
         }
       }
     }
+
+    /** Greedy selection as in performSelection followed by a repair step.
+     *
+     *  The greedy selection can accept a track, which blocks several rejected tracks, that are better
+     *  together than the accepted one. The repair step loops over the accepted tracks (highest QI first)
+     *  and collects the rejected competitors, that are blocked by this track only. If the best
+     *  non-overlapping subset of them (again selected greedily) has a larger sum of QI, it replaces the accepted track.
+     *  Each swap increases the sum of QI of the accepted tracks, so the result is never worse than
+     *  the one of the plain greedy algorithm.
+     *  The overlaps are expected to be symmetric, as created by the OverlapMatrixCreator.
+     */
+    void performSelectionWithRepair(std::vector <OverlapResolverNodeInfo>& overlapResolverNodeInfo)
+    {
+      performSelection(overlapResolverNodeInfo);
+
+      const std::vector<int> positions = getPositions(overlapResolverNodeInfo);
+      auto getPosition = [&positions](unsigned short trackIndex) {
+        return trackIndex < positions.size() ? positions[trackIndex] : -1;
+      };
+      auto isActive = [&](int position) {
+        return position >= 0 and overlapResolverNodeInfo[position].activityState;
+      };
+
+      std::vector<int> blockedTracks;
+      std::vector<int> replacements;
+      for (size_t iTrack = 0; iTrack < overlapResolverNodeInfo.size(); ++iTrack) {
+        auto& track = overlapResolverNodeInfo[iTrack];
+        if (!track.activityState) continue;
+
+        //A): Collect the rejected competitors, that are blocked by this track only.
+        //As the vector is sorted, they are collected with the highest QI first.
+        blockedTracks.clear();
+        for (unsigned short overlapIndex : track.overlaps) {
+          const int overlapPosition = getPosition(overlapIndex);
+          if (overlapPosition < 0 or isActive(overlapPosition)) continue;
+          const auto& competitorOverlaps = overlapResolverNodeInfo[overlapPosition].overlaps;
+          const auto nActive = std::count_if(competitorOverlaps.begin(), competitorOverlaps.end(),
+          [&](unsigned short competitorIndex) { return isActive(getPosition(competitorIndex)); });
+          if (nActive == 1) blockedTracks.push_back(overlapPosition);
+        }
+        if (blockedTracks.size() < 2) continue;
+        std::sort(blockedTracks.begin(), blockedTracks.end());
+        blockedTracks.erase(std::unique(blockedTracks.begin(), blockedTracks.end()), blockedTracks.end());
+
+        //B): Greedily select non-overlapping replacements among them:
+        replacements.clear();
+        float replacementQI = 0.;
+        for (int blockedPosition : blockedTracks) {
+          const auto& blockedOverlaps = overlapResolverNodeInfo[blockedPosition].overlaps;
+          const bool overlapsReplacement = std::any_of(replacements.begin(), replacements.end(),
+          [&](int replacementPosition) {
+            return std::find(blockedOverlaps.begin(), blockedOverlaps.end(),
+                             overlapResolverNodeInfo[replacementPosition].trackIndex) != blockedOverlaps.end();
+          });
+          if (overlapsReplacement) continue;
+          replacements.push_back(blockedPosition);
+          replacementQI += overlapResolverNodeInfo[blockedPosition].qualityIndicator;
+        }
+
+        //C): Swap, if the replacements are better together:
+        if (replacementQI <= track.qualityIndicator) continue;
+        track.activityState = 0.;
+        for (int replacementPosition : replacements) {
+          overlapResolverNodeInfo[replacementPosition].activityState = 1.;
+        }
+      }
+    }
+
+  private:
+    /** Returns for each trackIndex the position of the corresponding node in overlapResolverNodeInfo (-1 if not present). */
+    std::vector<int> getPositions(std::vector <OverlapResolverNodeInfo> const& overlapResolverNodeInfo) const
+    {
+      unsigned short maxTrackIndex = 0;
+      for (auto const& track : overlapResolverNodeInfo) {
+        maxTrackIndex = std::max(maxTrackIndex, track.trackIndex);
+      }
+      std::vector<int> positions(maxTrackIndex + 1, -1);
+      for (size_t iTrack = 0; iTrack < overlapResolverNodeInfo.size(); ++iTrack) {
+        positions[overlapResolverNodeInfo[iTrack].trackIndex] = iTrack;
+      }
+      return positions;
+    }
   };
 }
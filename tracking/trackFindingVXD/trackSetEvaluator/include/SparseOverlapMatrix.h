@@ -0,0 +1,88 @@
+/**************************************************************************
+ * basf2 (Belle II Analysis Software Framework)                           *
+ * Author: The Belle II Collaboration                                     *
+ *                                                                        *
+ * See git log for contributors and copyright holders.                    *
+ * This file is licensed under LGPL-3.0, see LICENSE.md.                  *
+ **************************************************************************/
+#pragma once
+
+#include <tracking/trackFindingVXD/trackSetEvaluator/OverlapResolverNodeInfo.h>
+
+#include <vector>
+#include <algorithm>
+
+namespace Belle2 {
+  /** Overlap matrix of track candidates in compressed sparse row (CSR) format.
+   *
+   *  Row i holds the sorted and unique indices of all nodes, that are incompatible with node i.
+   *  The column indices of row i are stored in m_columns[m_rowOffsets[i]] ... m_columns[m_rowOffsets[i + 1] - 1].
+   *  In contrast to a dense nxn matrix, memory and iteration time scale with the number of overlaps,
+   *  which stays small even for thousands of candidates.
+   *
+   *  Rows are indexed with OverlapResolverNodeInfo::trackIndex, so the trackIndex of all nodes
+   *  has to be smaller than the number of nodes.
+   */
+  class SparseOverlapMatrix {
+  public:
+    /** Fills the CSR structure from the overlap lists of the OverlapResolverNodeInfos. */
+    explicit SparseOverlapMatrix(std::vector<OverlapResolverNodeInfo> const& overlapResolverNodeInfos) :
+      m_rowOffsets(overlapResolverNodeInfos.size() + 1, 0)
+    {
+      //A): Count the number of (possibly duplicated) entries per row:
+      for (auto const& node : overlapResolverNodeInfos) {
+        m_rowOffsets[node.trackIndex + 1] += node.overlaps.size();
+      }
+      for (size_t iRow = 1; iRow < m_rowOffsets.size(); ++iRow) {
+        m_rowOffsets[iRow] += m_rowOffsets[iRow - 1];
+      }
+
+      //B): Copy all overlaps into their rows:
+      m_columns.resize(m_rowOffsets.back());
+      for (auto const& node : overlapResolverNodeInfos) {
+        std::copy(node.overlaps.begin(), node.overlaps.end(), m_columns.begin() + m_rowOffsets[node.trackIndex]);
+      }
+
+      //C): Sort and remove duplicates within every row and compact the column array:
+      unsigned int writePosition = 0;
+      for (size_t iRow = 0; iRow + 1 < m_rowOffsets.size(); ++iRow) {
+        auto rowBegin = m_columns.begin() + m_rowOffsets[iRow];
+        auto rowEnd = m_columns.begin() + m_rowOffsets[iRow + 1];
+        std::sort(rowBegin, rowEnd);
+        rowEnd = std::unique(rowBegin, rowEnd);
+        m_rowOffsets[iRow] = writePosition;
+        writePosition = std::copy(rowBegin, rowEnd, m_columns.begin() + writePosition) - m_columns.begin();
+      }
+      m_rowOffsets.back() = writePosition;
+      m_columns.resize(writePosition);
+    }
+
+    /** Number of rows (i.e. nodes) of the matrix. */
+    size_t getNRows() const { return m_rowOffsets.size() - 1; }
+
+    /** Total number of non-zero entries (i.e. unique overlaps). */
+    size_t getNEntries() const { return m_columns.size(); }
+
+    /** Pointer to the first column index of row iRow. */
+    unsigned short const* rowBegin(unsigned int iRow) const { return m_columns.data() + m_rowOffsets[iRow]; }
+
+    /** Pointer behind the last column index of row iRow. */
+    unsigned short const* rowEnd(unsigned int iRow) const { return m_columns.data() + m_rowOffsets[iRow + 1]; }
+
+    /** Sum of the values at the column positions of row iRow, added in column order. */
+    template <class AValue>
+    AValue rowSum(unsigned int iRow, AValue const* values) const
+    {
+      AValue sum = 0;
+      unsigned short const* columns = m_columns.data();
+      for (unsigned int iEntry = m_rowOffsets[iRow]; iEntry < m_rowOffsets[iRow + 1]; ++iEntry) {
+        sum += values[columns[iEntry]];
+      }
+      return sum;
+    }
+
+  private:
+    std::vector<unsigned int> m_rowOffsets; ///< Start of each row in m_columns, the last entry is the total size.
+    std::vector<unsigned short> m_columns;  ///< Column indices of all rows, stored consecutively.
+  };
+}
@@ -7,6 +7,7 @@
  **************************************************************************/
 
 #include <tracking/trackFindingVXD/trackSetEvaluator/HopfieldNetwork.h>
+#include <tracking/trackFindingVXD/trackSetEvaluator/SparseOverlapMatrix.h>
 
 #include <framework/logging/Logger.h>
 #include <framework/utilities/TRandomWrapper.h>
@@ -35,18 +36,10 @@ unsigned short HopfieldNetwork::doHopfield(
 
   const size_t overlapSize = overlapResolverNodeInfos.size();
 
-  //Weight matrix; knows compatibility between each possible pair of Nodes
-  Eigen::MatrixXd W(overlapSize, overlapSize);
-  //A): Set all elements to compatible:
-  W.fill(compatibilityValue);
-
-  //B): Inform weight matrix elements of incompatible neurons:
-  for (const auto& aTC : overlapResolverNodeInfos) {
-    for (unsigned int overlapIndex : aTC.overlaps) {
-      W(aTC.trackIndex, overlapIndex) = -1.0;
-    }
-  }
-
+  //Weight matrix; knows compatibility between each possible pair of Nodes.
+  //All pairs are compatible (weight compatibilityValue) except for the overlapping ones (weight -1),
+  //so only the incompatible pairs are stored in a sparse matrix.
+  const SparseOverlapMatrix W(overlapResolverNodeInfos);
 
   // Neuron values
   Eigen::VectorXd x(overlapSize);
@@ -86,10 +79,15 @@ unsigned short HopfieldNetwork::doHopfield(
 
     xOld = x;
 
+    //The dense product W.row(i).dot(x) equals compatibilityValue * sum(x) for the compatible part,
+    //corrected by the sparse incompatible entries. The sum is updated with every changed neuron.
+    double xSum = x.sum();
     for (unsigned int i : sequenceVector) {
-      float aTempVal = W.row(i).dot(x);
+      float aTempVal = compatibilityValue * xSum - (compatibilityValue + 1.0) * W.rowSum(i, x.data());
       float act = aTempVal + m_omega * overlapResolverNodeInfos[i].qualityIndicator;
-      x(i) = 0.5 * (1. + tanh(act / T));
+      const double xNew = 0.5 * (1. + tanh(act / T));
+      xSum += xNew - x(i);
+      x(i) = xNew;
     }
 
     T = 0.5 * (T + m_Tmin);
@@ -10,6 +10,8 @@
 
 #include <tracking/trackFindingVXD/trackSetEvaluator/HopfieldNetwork.h>
 #include <tracking/trackFindingVXD/trackSetEvaluator/OverlapResolverNodeInfo.h>
+#include <tracking/trackFindingVXD/trackSetEvaluator/Scrooge.h>
+#include <tracking/trackFindingVXD/trackSetEvaluator/SparseOverlapMatrix.h>
 
 #include <framework/logging/Logger.h>
 
@@ -98,3 +100,51 @@ TEST_F(HopfieldNetworkTest, TestScrooge)
   }
   */
 }
+
+/// The repair step has to replace an accepted track by two better ones, that are only blocked by it.
+TEST_F(HopfieldNetworkTest, TestScroogeWithRepair)
+{
+  //Track 0 has the highest QI, but overlaps with 1 and 2, which together are better.
+  vector<OverlapResolverNodeInfo> overlapResolverNodeInfos;
+  overlapResolverNodeInfos.emplace_back(0.6, 0, vector<unsigned short> {1, 2}, 1);
+  overlapResolverNodeInfos.emplace_back(0.5, 1, vector<unsigned short> {0}, 1);
+  overlapResolverNodeInfos.emplace_back(0.4, 2, vector<unsigned short> {0}, 1);
+  overlapResolverNodeInfos.emplace_back(0.1, 3, vector<unsigned short> {}, 1);
+
+  //Plain greedy selection takes track 0 and 3.
+  vector<OverlapResolverNodeInfo> greedyInfos = overlapResolverNodeInfos;
+  Scrooge scrooge;
+  scrooge.performSelection(greedyInfos);
+  for (auto const& info : greedyInfos) {
+    EXPECT_EQ(info.trackIndex == 0 or info.trackIndex == 3, info.activityState > 0.5) << info.trackIndex;
+  }
+
+  //The repair step swaps track 0 for track 1 and 2.
+  scrooge.performSelectionWithRepair(overlapResolverNodeInfos);
+  for (auto const& info : overlapResolverNodeInfos) {
+    EXPECT_EQ(info.trackIndex != 0, info.activityState > 0.5) << info.trackIndex;
+  }
+}
+
+/// The Hopfield network with sparse weights has to resolve a simple conflict in favour of the better track.
+TEST_F(HopfieldNetworkTest, TestSparseOverlaps)
+{
+  vector<OverlapResolverNodeInfo> overlapResolverNodeInfos;
+  overlapResolverNodeInfos.emplace_back(0.9, 0, vector<unsigned short> {1, 1}, 1);
+  overlapResolverNodeInfos.emplace_back(0.1, 1, vector<unsigned short> {0}, 1);
+  overlapResolverNodeInfos.emplace_back(0.8, 2, vector<unsigned short> {}, 1);
+
+  SparseOverlapMatrix overlapMatrix(overlapResolverNodeInfos);
+  EXPECT_EQ(overlapMatrix.getNRows(), 3u);
+  EXPECT_EQ(overlapMatrix.getNEntries(), 2u);
+  const double values[3] = {1., 2., 4.};
+  EXPECT_EQ(overlapMatrix.rowSum(0, values), 2.);
+  EXPECT_EQ(overlapMatrix.rowSum(1, values), 1.);
+  EXPECT_EQ(overlapMatrix.rowSum(2, values), 0.);
+
+  HopfieldNetwork hopfieldNetwork;
+  hopfieldNetwork.doHopfield(overlapResolverNodeInfos);
+  EXPECT_GT(overlapResolverNodeInfos[0].activityState, 0.7);
+  EXPECT_LT(overlapResolverNodeInfos[1].activityState, 0.7);
+  EXPECT_GT(overlapResolverNodeInfos[2].activityState, 0.7);
+}